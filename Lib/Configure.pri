@@ -1,6 +1,13 @@
 DEFINES += XML_BACKEND
 DEFINES += NOMINMAX
 
+# Enable XML::GZipWriter (requires zlib)
+#DEFINES += OAK_ZLIB
+#LIBS += -lz
+
+# Enable the counters and scoped timers of ServiceFunctions/Instrumentation.h
+#DEFINES += OAK_INSTRUMENTATION
+
 # Enable c++17 features
 CONFIG += c++1z
 
@@ -18,222 +18,255 @@
 
 #pragma once
 
-#include <map>
+#include <cassert>
 #include <functional>
+#include <vector>
 
 #include "Node.h"
 #include "NodeIndex.h"
 
+#include "../ServiceFunctions/Instrumentation.h"
+
 
 namespace Oak::Model {
 
+class NodePath;
+
 // =============================================================================
 // Class definition
 // =============================================================================
-class Callback
+// Limits the events passed to a subscriber to the nodes with one name and/or
+//  one leaf name. The ids are the name ids of NodePath, -1 matches any name.
+//  The model describes each event with a filter of the same type.
+class CallbackFilter
 {
 public:
-    Callback();
+    explicit CallbackFilter(int nodeNameId = -1, int leafNameId = -1)
+        : m_nodeNameId(nodeNameId), m_leafNameId(leafNameId) {}
 
-    template<typename T>
-    void add(T* funcObj, void (T::*func)(void)) const
-    {
-        if (funcObj == nullptr) {
-            assert(false);
-            return;
-        }
-        m_functionMap[funcObj] = std::bind(func, funcObj);
-    }
-
-    void remove(void* funcObj = nullptr) const;
-
-    void trigger() const;
+    static CallbackFilter create(const NodeDef *nodeDef, const std::string &leafName = std::string());
+    // Describes an event of the last node in the path
+    static CallbackFilter create(const NodePath &nodePath, int leafNameId = -1);
 
-protected:
-    mutable std::map<void*, std::function<void(void)>> m_functionMap;
-};
+    bool operator==(const CallbackFilter &filter) const { return m_nodeNameId == filter.m_nodeNameId && m_leafNameId == filter.m_leafNameId; }
 
-// =============================================================================
-// Class definition
-// =============================================================================
-class Callback_NodeIntNodeInt
-{
-public:
-    Callback_NodeIntNodeInt();
+    bool isEmpty() const { return m_nodeNameId == -1 && m_leafNameId == -1; }
 
-    template<typename T>
-    void add(T* funcObj, void (T::*func)(const Node&, int, const Node&, int)) const
+    // An event that does not know a name is passed to everyone
+    bool accepts(const CallbackFilter &event) const
     {
-        if (funcObj == nullptr) {
-            assert(false);
-            return;
-        }
-        m_functionMap[funcObj] = std::bind(func, funcObj, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3, std::placeholders::_4);
+        return (m_nodeNameId == -1 || event.m_nodeNameId == -1 || m_nodeNameId == event.m_nodeNameId) &&
+               (m_leafNameId == -1 || event.m_leafNameId == -1 || m_leafNameId == event.m_leafNameId);
     }
 
-    void remove(void* funcObj = nullptr) const;
-
-    void trigger(const Node& sourceNode, int sourceIndex, const Node& targetNode, int targetIndex) const;
+    int nodeNameId() const { return m_nodeNameId; }
+    int leafNameId() const { return m_leafNameId; }
 
 protected:
-    mutable std::map<void*, std::function<void(const Node&, int, const Node&, int)>> m_functionMap;
+    int m_nodeNameId;
+    int m_leafNameId;
 };
 
+// 0 is never used as a handle
+typedef unsigned int CallbackHandle;
+
 // =============================================================================
 // Class definition
 // =============================================================================
-class Callback_NodeInt
+// Subscribers are stored in a vector and called in the order they are added.
+//  Subscribers can be added and removed by a subscriber while it is called:
+//  Removed subscribers are skipped and erased when the outermost trigger
+//  returns, and added subscribers are not called until the next trigger.
+template<typename... Args>
+class CallbackTable
 {
 public:
-    Callback_NodeInt();
+    CallbackTable() {}
+    CallbackTable(const CallbackTable &copy) = delete;
+    CallbackTable& operator=(const CallbackTable &copy) = delete;
 
+    // Replaces the function if 'funcObj' is already added with the same filter
     template<typename T>
-    void add(T* funcObj, void (T::*func)(const Node&, int)) const
+    CallbackHandle add(T* funcObj, void (T::*func)(Args...), const CallbackFilter &filter = CallbackFilter()) const
     {
         if (funcObj == nullptr) {
             assert(false);
-            return;
+            return 0;
         }
-        m_functionMap[funcObj] = std::bind(func, funcObj, std::placeholders::_1, std::placeholders::_2);
+        return addFunction(funcObj, [funcObj, func](Args... args) { (funcObj->*func)(args...); }, filter);
     }
 
-    void remove(void* funcObj = nullptr) const;
-
-    void trigger(const Node &parentNode, int index) const;
-
-protected:
-    mutable std::map<void*, std::function<void(const Node&, int)>> m_functionMap;
-};
-
-// =============================================================================
-// Class definition
-// =============================================================================
-class Callback_Node
-{
-public:
-    Callback_Node();
+    // Functions that are not bound to an object can only be removed by their handle
+    CallbackHandle add(std::function<void(Args...)> func, const CallbackFilter &filter = CallbackFilter()) const
+    {
+        return addFunction(nullptr, std::move(func), filter);
+    }
 
-    template<typename T>
-    void add(T* funcObj, void (T::*func)(const Node&)) const
+    // Removes all the functions of 'funcObj' or everything if 'funcObj' is nullptr
+    void remove(void* funcObj = nullptr) const
     {
-        if (funcObj == nullptr) {
-            assert(false);
-            return;
+        for (std::vector<Subscriber> *list: { &m_subscriberList, &m_addedList })
+        {
+            for (Subscriber &subscriber: *list)
+            {
+                if (funcObj == nullptr || subscriber.funcObj == funcObj) {
+                    removeSubscriber(subscriber);
+                }
+            }
         }
-        m_functionMap[funcObj] = std::bind(func, funcObj, std::placeholders::_1);
+        if (m_triggerDepth == 0) { eraseRemoved(); }
     }
 
-    void remove(void* funcObj = nullptr) const;
-
-    void trigger(const Node &parentNode) const;
-
-protected:
-    mutable std::map<void*, std::function<void(const Node&)>> m_functionMap;
-};
-
-// =============================================================================
-// Class definition
-// =============================================================================
-class Callback_NodeIndex
-{
-public:
-    Callback_NodeIndex();
-
-    template<typename T>
-    void add(T* funcObj, void (T::*func)(const NodeIndex&)) const
+    void removeHandle(CallbackHandle handle) const
     {
-        if (funcObj == nullptr) {
-            assert(false);
-            return;
+        if (handle == 0) { return; }
+        for (std::vector<Subscriber> *list: { &m_subscriberList, &m_addedList })
+        {
+            for (Subscriber &subscriber: *list)
+            {
+                if (subscriber.handle == handle) {
+                    removeSubscriber(subscriber);
+                }
+            }
         }
-        m_functionMap[funcObj] = std::bind(func, funcObj, std::placeholders::_1);
+        if (m_triggerDepth == 0) { eraseRemoved(); }
     }
 
-    void remove(void* funcObj = nullptr) const;
+    bool isEmpty() const { return m_activeCount == 0; }
 
-    void trigger(const NodeIndex &nodeIndex) const;
-
-protected:
-    mutable std::map<void*, std::function<void(const NodeIndex&)>> m_functionMap;
-};
-
-// =============================================================================
-// Class definition
-// =============================================================================
-class Callback_NodeIndexNodeIndex
-{
-public:
-    Callback_NodeIndexNodeIndex();
-
-    template<typename T>
-    void add(T* funcObj, void (T::*func)(const NodeIndex&, const NodeIndex&)) const
+    // Returns true if no subscriber accepts the event.
+    //  Used to skip the work of creating the arguments of the event
+    bool isEmpty(const CallbackFilter &event) const
     {
-        if (funcObj == nullptr) {
-            assert(false);
-            return;
+        if (m_activeCount == 0) { return true; }
+        for (const Subscriber &subscriber: m_subscriberList)
+        {
+            if (subscriber.handle != 0 && subscriber.filter.accepts(event)) { return false; }
         }
-        m_functionMap[funcObj] = std::bind(func, funcObj, std::placeholders::_1, std::placeholders::_2);
+        return true;
     }
 
-    void remove(void* funcObj = nullptr) const;
-
-    void trigger(const NodeIndex &nodeIndex1, const NodeIndex &nodeIndex2) const;
-
-protected:
-    mutable std::map<void*, std::function<void(const NodeIndex&, const NodeIndex&)>> m_functionMap;
-};
-
-// =============================================================================
-// Class definition
-// =============================================================================
-class Callback_NodeIndexInt
-{
-public:
-    Callback_NodeIndexInt();
+    void trigger(Args... args) const
+    {
+        trigger(CallbackFilter(), args...);
+    }
 
-    template<typename T>
-    void add(T* funcObj, void (T::*func)(const NodeIndex&, int)) const
+    void trigger(const CallbackFilter &event, Args... args) const
     {
-        if (funcObj == nullptr) {
-            assert(false);
-            return;
+        OAK_COUNT(Notification);
+        if (m_activeCount == 0) { return; }
+
+        // The list is not reallocated while it is iterated, added subscribers
+        //  are appended when the outermost trigger returns
+        m_triggerDepth++;
+        size_t count = m_subscriberList.size();
+        for (size_t i = 0; i < count; i++)
+        {
+            const Subscriber &subscriber = m_subscriberList[i];
+            if (subscriber.handle != 0 && subscriber.filter.accepts(event)) {
+                subscriber.func(args...);
+            }
+        }
+        m_triggerDepth--;
+
+        if (m_triggerDepth == 0) {
+            eraseRemoved();
+            if (!m_addedList.empty()) {
+                for (Subscriber &subscriber: m_addedList)
+                {
+                    m_subscriberList.push_back(std::move(subscriber));
+                }
+                m_addedList.clear();
+            }
         }
-        m_functionMap[funcObj] = std::bind(func, funcObj, std::placeholders::_1, std::placeholders::_2);
     }
 
-    void remove(void* funcObj = nullptr) const;
-
-    void trigger(const NodeIndex &nodeIndex, int index) const;
-
 protected:
-    mutable std::map<void*, std::function<void(const NodeIndex&, int)>> m_functionMap;
-};
-
-// =============================================================================
-// Class definition
-// =============================================================================
-class Callback_NodeIndexString
-{
-public:
-    Callback_NodeIndexString();
+    struct Subscriber
+    {
+        void *funcObj;
+        std::function<void(Args...)> func;
+        CallbackFilter filter;
+        CallbackHandle handle; // 0 when removed
+    };
 
-    template<typename T>
-    void add(T* funcObj, void (T::*func)(const NodeIndex&, const std::string &)) const
+    CallbackHandle addFunction(void *funcObj, std::function<void(Args...)> func, const CallbackFilter &filter) const
     {
-        if (funcObj == nullptr) {
-            assert(false);
-            return;
+        if (funcObj != nullptr) {
+            for (Subscriber &subscriber: m_subscriberList)
+            {
+                if (subscriber.handle != 0 && subscriber.funcObj == funcObj && subscriber.filter == filter) {
+                    if (m_triggerDepth == 0) {
+                        subscriber.func = std::move(func);
+                        return subscriber.handle;
+                    }
+                    // The function can be the one that is called
+                    removeSubscriber(subscriber);
+                    break;
+                }
+            }
+            for (Subscriber &subscriber: m_addedList)
+            {
+                if (subscriber.funcObj == funcObj && subscriber.filter == filter) {
+                    subscriber.func = std::move(func);
+                    return subscriber.handle;
+                }
+            }
         }
-        m_functionMap[funcObj] = std::bind(func, funcObj, std::placeholders::_1, std::placeholders::_2);
+
+        CallbackHandle handle = ++m_lastHandle;
+        if (handle == 0) { handle = ++m_lastHandle; }
+        if (m_triggerDepth == 0) {
+            m_subscriberList.push_back({ funcObj, std::move(func), filter, handle });
+        } else {
+            m_addedList.push_back({ funcObj, std::move(func), filter, handle });
+        }
+        m_activeCount++;
+        return handle;
     }
 
-    void remove(void* funcObj = nullptr) const;
+    void removeSubscriber(Subscriber &subscriber) const
+    {
+        if (subscriber.handle == 0) { return; }
+        subscriber.handle = 0;
+        m_activeCount--;
+        m_hasRemoved = true;
+    }
 
-    void trigger(const NodeIndex &nodeIndex, const std::string & name) const;
+    void eraseRemoved() const
+    {
+        for (auto it = m_addedList.begin(); it != m_addedList.end();)
+        {
+            it = it->handle == 0 ? m_addedList.erase(it) : it + 1;
+        }
+        if (!m_hasRemoved) { return; }
+        size_t j = 0;
+        for (size_t i = 0; i < m_subscriberList.size(); i++)
+        {
+            if (m_subscriberList[i].handle == 0) { continue; }
+            if (i != j) { m_subscriberList[j] = std::move(m_subscriberList[i]); }
+            j++;
+        }
+        m_subscriberList.resize(j);
+        m_hasRemoved = false;
+    }
 
 protected:
-    mutable std::map<void*, std::function<void(const NodeIndex&, const std::string &)>> m_functionMap;
+    mutable std::vector<Subscriber> m_subscriberList;
+    mutable std::vector<Subscriber> m_addedList;
+    mutable size_t m_activeCount = 0;
+    mutable int m_triggerDepth = 0;
+    mutable bool m_hasRemoved = false;
+    mutable CallbackHandle m_lastHandle = 0;
 };
 
-} // namespace Oak::Model
+typedef CallbackTable<> Callback;
+typedef CallbackTable<const Node&, int, const Node&, int> Callback_NodeIntNodeInt;
+typedef CallbackTable<const Node&, int> Callback_NodeInt;
+typedef CallbackTable<const Node&> Callback_Node;
+typedef CallbackTable<const NodeIndex&> Callback_NodeIndex;
+typedef CallbackTable<const NodeIndex&, const NodeIndex&> Callback_NodeIndexNodeIndex;
+typedef CallbackTable<const NodeIndex&, int> Callback_NodeIndexInt;
+typedef CallbackTable<const NodeIndex&, const std::string &> Callback_NodeIndexString;
 
+} // namespace Oak::Model
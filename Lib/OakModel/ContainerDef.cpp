@@ -154,7 +154,7 @@ bool ContainerDef::validate(const NodeData &_nodeData) const
 #ifdef XML_BACKEND
     case NodeData::Type::XML: {
         if (!m_containerDef) { return false; }
-        if (_nodeData.xmlNode().compareTagName(containerDef()->tagName()) != 0) { return false; }
+        if (!_nodeData.xmlNode().hasTagName(containerDef()->tagNameId())) { return false; }
         return m_containerDef->validate(_nodeData, false, true);
     }
 #endif // XML_BACKEND
@@ -357,7 +357,7 @@ NodeData ContainerDef::hostNode(const NodeData &refNodeData) const
 
         if (hostElement.empty()) { return NodeData(); }
 
-        if (hostDef()->tagName().compare(hostElement.tagName()) != 0) { return NodeData(); }
+        if (!hostElement.hasTagName(hostDef()->tagNameId())) { return NodeData(); }
         return hostElement;
     }
 #endif // XML_BACKEND
@@ -456,6 +456,27 @@ NodeData ContainerDef::cloneNode(const NodeData &_nodeData, int &index, const No
     return newNode;
 }
 
+// =============================================================================
+// (public)
+NodeData ContainerDef::insertNodeCopy(const NodeData &_nodeData, int &index, const NodeData &copyNode) const
+{
+    NodeData newNode;
+    if (!copyNode.isNull() && canInsertNode(_nodeData, index)) {
+        switch (_nodeData.type()) {
+#ifdef XML_BACKEND
+        case NodeData::Type::XML:
+            newNode = m_elementListRef.clone(_nodeData.xmlNode(), index, copyNode.xmlNode());
+            break;
+#endif // XML_BACKEND
+        default:
+            // _nodeData.type() returns an unhandled type that needs to be implemented
+            ASSERT(false);
+            return newNode;
+        }
+    }
+    return newNode;
+}
+
 // =============================================================================
 // (public)
 bool ContainerDef::canMoveNode(const NodeData &_nodeData, int &index, const NodeData &moveNode) const
@@ -469,6 +490,9 @@ bool ContainerDef::canMoveNode(const NodeData &_nodeData, int &index, const Node
 
     if (index > count) { return false; }
 
+    // Nodes are relinked so they can not be moved to another document
+    if (!_nodeData.isSameDocument(moveNode)) { return false; }
+
     // Find the definition that match the 'moveNode'
     const NodeDef* moveDef = containerDef(moveNode);
     if (!moveDef) { return false; }
@@ -502,7 +526,7 @@ bool ContainerDef::canMoveNode(const NodeData &_nodeData, int &index, const Node
     // Check if the 'moveNode' can be removed
     if (!moveParentContainer->canRemoveNode(moveNodeParent, moveIndex)) { return false; }
 
-    // Check if the 'moveNode' can be cloned
+    // Check if the 'moveNode' can be inserted (It is relinked, not copied)
     return canCloneNode(_nodeData, index, moveNode);
 }
 
@@ -119,6 +119,11 @@ public:
     /// The return value is the inserted data node, or an empty Node if the operation failed
     virtual NodeData cloneNode(const NodeData &_nodeData, int &index, const NodeData &cloneNode) const;
 
+    /// Inserts a deep copy of 'copyNode' that does not have to be part of the document (F.eks. a node restored
+    ///  from a serialized copy). Only the insert position is checked, 'copyNode' is expected to match the definition.
+    /// The return value is the inserted data node, or an empty Node if the operation failed
+    virtual NodeData insertNodeCopy(const NodeData &_nodeData, int &index, const NodeData &copyNode) const;
+
     /// Se the function 'moveChildDataNode' bellow
     virtual bool canMoveNode(const NodeData &_nodeData, int &index, const NodeData &moveNode) const;
 
@@ -137,6 +137,17 @@ ContainerDefBuilderSPtr ContainerDefBuilder::setElementListRef(XML::ListRef list
     m_containerDef->m_elementListRef = listRef;
     return m_thisWPtr.lock();
 }
+
+// =============================================================================
+// (public)
+ContainerDefBuilderSPtr ContainerDefBuilder::setElementListIndexed(bool value)
+{
+    ASSERT(m_containerDef);
+
+    // Large lists of child nodes can be accessed by index without iterating the siblings
+    m_containerDef->m_elementListRef.setIndexEnabled(value);
+    return m_thisWPtr.lock();
+}
 #endif // XML_BACKEND
 
 } // namespace Oak::Model
@@ -54,6 +54,7 @@ public:
 
 #ifdef XML_BACKEND
     ContainerDefBuilderSPtr setElementListRef(XML::ListRef listRef);
+    ContainerDefBuilderSPtr setElementListIndexed(bool value = true);
 #endif // XML_BACKEND
 
 private:
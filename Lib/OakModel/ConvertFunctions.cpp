@@ -21,6 +21,8 @@
 #include <iomanip>
 #include <ctime>
 #include <sstream>
+#include <charconv>
+#include <cstring>
 #include "../ServiceFunctions/Assert.h"
 
 
@@ -179,6 +181,54 @@ bool convert(std::string &dest, const char *source, Conversion* )
     return true;
 }
 
+// =============================================================================
+// (public)
+bool convert(bool& dest, const char *source, Conversion* properties)
+{
+    if (source == nullptr) { return false; }
+    if (properties == nullptr) { properties = Conversion::globalDefault2(); }
+    if (std::strcmp(source, properties->boolTrue().c_str()) == 0) {
+        dest = true;
+        return true;
+    } else if (std::strcmp(source, properties->boolFalse().c_str()) == 0) {
+        dest = false;
+        return true;
+    }
+    return false;
+}
+
+// =============================================================================
+// (public)
+bool convert(int& dest, const char *source, Conversion* properties)
+{
+    if (source == nullptr) { return false; }
+    const char *end = source + std::strlen(source);
+    int value;
+    auto result = std::from_chars(source, end, value);
+    if (result.ec == std::errc() && result.ptr == end) {
+        dest = value;
+        return true;
+    }
+    // Leading white spaces, plus signs and trailing characters are handled by 'std::stoi()'
+    return convert(dest, std::string(source), properties);
+}
+
+// =============================================================================
+// (public)
+bool convert(double& dest, const char *source, Conversion* properties)
+{
+    if (source == nullptr) { return false; }
+    const char *end = source + std::strlen(source);
+    double value;
+    auto result = std::from_chars(source, end, value);
+    if (result.ec == std::errc() && result.ptr == end) {
+        dest = value;
+        return true;
+    }
+    // Leading white spaces, plus signs, hex values and trailing characters are handled by 'std::stod()'
+    return convert(dest, std::string(source), properties);
+}
+
 // =============================================================================
 // (public)
 bool convert(std::string &dest, const DateTime &src, Conversion *properties)
@@ -195,11 +245,58 @@ bool convert(DateTime &dest, const std::string &src, Conversion *properties)
 {
     UNUSED(properties);
     DateTime dt(src, DateTime::TimeZone::UTC);
-    if (dt.isNull()) { return false; }
+    if (dt.isNull()) {
+        // Also accept ISO 8601 strings (E.g. "2020-06-01T12:00:00Z")
+        dt = DateTime::fromIsoString(src, DateTime::TimeZone::UTC);
+        if (dt.isNull()) { return false; }
+    }
     dest = dt;
     return true;
 }
 
+// =============================================================================
+// toChars()
+// =============================================================================
+
+// =============================================================================
+// (public)
+bool toChars(char *buffer, int size, int src, Conversion *)
+{
+    ASSERT(buffer && size > 0);
+    auto result = std::to_chars(buffer, buffer + size - 1, src);
+    if (result.ec != std::errc()) { return false; }
+    *result.ptr = '\0';
+    return true;
+}
+
+// =============================================================================
+// (public)
+bool toChars(char *buffer, int size, double src, Conversion *properties)
+{
+    ASSERT(buffer && size > 0);
+    if (properties == nullptr) { properties = Conversion::globalDefault2(); }
+    std::chars_format format;
+    switch (properties->doubleToStringMode()) {
+    case Conversion::DoubleToString_Default:
+        format = std::chars_format::general;
+        break;
+    case Conversion::DoubleToString_Scientific:
+        format = std::chars_format::scientific;
+        break;
+    case Conversion::DoubleToString_Fixed:
+        format = std::chars_format::fixed;
+        break;
+    default:
+        ASSERT(false);
+        return false;
+    }
+    // Same output as the stream in 'convert()' which formats like 'printf()'
+    auto result = std::to_chars(buffer, buffer + size - 1, src, format, properties->doubleToStringPrecision());
+    if (result.ec != std::errc()) { return false; }
+    *result.ptr = '\0';
+    return true;
+}
+
 // =============================================================================
 // canConvert()
 // =============================================================================
@@ -285,7 +382,8 @@ bool canConvert(std::string &, const DateTime &src, Conversion *)
 // (public)
 bool canConvert(DateTime &, const std::string &src, Conversion *)
 {
-    return !DateTime(src, DateTime::TimeZone::UTC).isNull();
+    return !DateTime(src, DateTime::TimeZone::UTC).isNull() ||
+           !DateTime::fromIsoString(src, DateTime::TimeZone::UTC).isNull();
 }
 
 } // namespace Oak::Model
@@ -52,6 +52,11 @@ bool convert(std::string& dest, double src, Conversion* properties = nullptr);
 
 bool convert(std::string& dest, const char * source, Conversion* properties = nullptr);
 
+// Parses the value directly from the character buffer without creating a temporary string
+bool convert(bool& dest, const char * source, Conversion* properties = nullptr);
+bool convert(int& dest, const char * source, Conversion* properties = nullptr);
+bool convert(double& dest, const char * source, Conversion* properties = nullptr);
+
 bool convert(std::string& dest, const DateTime &src, Conversion* properties = nullptr);
 bool convert(DateTime &dest, const std::string &src, Conversion* properties = nullptr);
 
@@ -112,6 +117,14 @@ bool convert(T1 &dest, const T2 &source, Conversion* properties = nullptr)
     return false;
 }
 
+// =============================================================================
+// toChars()
+// =============================================================================
+// Writes the value as a null terminated string into 'buffer' with the same format as 'convert()'
+// Returns false if the buffer is too small
+bool toChars(char* buffer, int size, int src, Conversion* properties = nullptr);
+bool toChars(char* buffer, int size, double src, Conversion* properties = nullptr);
+
 // =============================================================================
 // canConvert()
 // =============================================================================
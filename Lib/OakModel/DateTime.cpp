@@ -15,7 +15,6 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
-
 #include "DateTime.h"
 
 #include <iostream>
@@ -43,56 +42,50 @@ DateTime::DateTime()
 // =============================================================================
 // (public)
 DateTime::DateTime(int year, int month, int day, int hour, int minute, int secound, TimeZone timeZone)
-    : DateTime(toString(ProcessedDateTime{ year, month, day, hour, minute, secound }), timeZone, "%Y-%m-%d %H:%M:%S")
+    : m_time { _emptyTimePoint() }
 {
+    ProcessedDateTime pdt { year, month, day, hour, minute, secound };
+    if (!_isValid(pdt)) {
+        TRACE(L"Faild to construct DateTime from %S", toString(pdt).c_str());
+        return;
+    }
+
+    long long seconds;
+    if (timeZone == TimeZone::UTC) {
+        seconds = _secondsFromStruct(pdt);
+    } else if (!_localToSeconds(pdt, seconds)) {
+        return;
+    }
+    if (!_timePointFromSeconds(seconds, 0, m_time)) {
+        TRACE(L"DateTime out of range %S", toString(pdt).c_str());
+    }
 }
 
 // =============================================================================
 // (public)
-DateTime::DateTime(const std::string &inputStr, TimeZone timeZone, const char * format)
+DateTime::DateTime(std::string_view str, TimeZone timeZone, const char * format)
+    : m_time { _emptyTimePoint() }
 {
     //TRACE(L"Constructor(%S, %S, %S)", str.c_str(), timeZone == TimeZone::UTC ? "UTC" : "Local", format);
-    std::tm tm = {};
-    std::istringstream iss(inputStr);
-    iss >> std::get_time(&tm, format);
-
-    if (iss.fail()) {
-        m_time = _emptyTimePoint();
-        TRACE(L"Faild to construct DateTime from string %S (%S)", inputStr.c_str(), format);
+    if (!_isFastFormat(format)) {
+        _parseStream(std::string(str), timeZone, format);
         return;
     }
-    std::time_t tt = std::mktime(&tm);
-    m_time = std::chrono::system_clock::from_time_t(tt);
-
-    // Time is parsed without taking account for daylight savings flag
-    if (tm.tm_isdst) { m_time -= std::chrono::hours(1); }
 
+    ProcessedDateTime pdt;
+    long long seconds;
+    if (!_parse(str, format, pdt)) {
+        TRACE(L"Faild to construct DateTime from string %S (%S)", std::string(str).c_str(), format);
+        return;
+    }
     if (timeZone == TimeZone::UTC) {
-        // Time is parsed as local time and needs to be adjusted to UTC time
-        std::tm tm_UTC;
-        gmtime_s(&tm_UTC, &tt);
-
-        int offset = tm.tm_hour - tm_UTC.tm_hour;
-
-        // Adjust for changing day/year
-        if (tm.tm_year != tm_UTC.tm_year) {
-            offset += tm.tm_year > tm_UTC.tm_year ? 24 : -24;
-        } else if (tm.tm_yday != tm_UTC.tm_yday) {
-            offset += tm.tm_yday > tm_UTC.tm_yday ? 24 : -24;
-        }
-
-        //TRACE(L"Local time zone offset: %i", offset);
-        m_time += std::chrono::hours(offset);
+        seconds = _secondsFromStruct(pdt);
+    } else if (!_localToSeconds(pdt, seconds)) {
+        return;
     }
-
-    // End to end testing: toString() result should be equal to 'inputStr'
-    std::string outputStr = toString(timeZone, format);
-    if (inputStr != outputStr) {
-        TRACE(L"Testing faild: %S != %S", inputStr.c_str(), outputStr.c_str());
-        m_time = _emptyTimePoint();
-        //ASSERT(false);
+    if (!_timePointFromSeconds(seconds, 0, m_time)) {
+        TRACE(L"DateTime out of range %S", toString(pdt).c_str());
     }
-    // TESTING END
 }
 
 // =============================================================================
@@ -178,56 +171,28 @@ void DateTime::swap(DateTime &other) noexcept
 // (public)
 int DateTime::year(DateTime::TimeZone timeZone) const
 {
-    time_t tt = std::chrono::system_clock::to_time_t(m_time);
-    tm tm;
-    if (timeZone == TimeZone::UTC) {
-        gmtime_s(&tm, &tt);
-    } else if (timeZone == TimeZone::Local) {
-        localtime_s(&tm, &tt);
-    }
-    return 1900 +  tm.tm_year;
+    return toStruct(timeZone).year;
 }
 
 // =============================================================================
 // (public)
 int DateTime::month(TimeZone timeZone) const
 {
-    time_t tt = std::chrono::system_clock::to_time_t(m_time);
-    tm tm;
-    if (timeZone == TimeZone::UTC) {
-        gmtime_s(&tm, &tt);
-    } else if (timeZone == TimeZone::Local) {
-        localtime_s(&tm, &tt);
-    }
-    return 1 +  tm.tm_mon;
+    return toStruct(timeZone).month;
 }
 
 // =============================================================================
 // (public)
 int DateTime::day(DateTime::TimeZone timeZone) const
 {
-    time_t tt = std::chrono::system_clock::to_time_t(m_time);
-    tm tm;
-    if (timeZone == TimeZone::UTC) {
-        gmtime_s(&tm, &tt);
-    } else if (timeZone == TimeZone::Local) {
-        localtime_s(&tm, &tt);
-    }
-    return tm.tm_mday;
+    return toStruct(timeZone).day;
 }
 
 // =============================================================================
 // (public)
 int DateTime::hour(DateTime::TimeZone timeZone) const
 {
-    time_t tt = std::chrono::system_clock::to_time_t(m_time);
-    tm tm;
-    if (timeZone == TimeZone::UTC) {
-        gmtime_s(&tm, &tt);
-    } else if (timeZone == TimeZone::Local) {
-        localtime_s(&tm, &tt);
-    }
-    return tm.tm_hour;
+    return toStruct(timeZone).hour;
 }
 
 // =============================================================================
@@ -266,25 +231,12 @@ void DateTime::setMSecsSinceEpoch(long long ms)
 // (public)
 ProcessedDateTime DateTime::toStruct(DateTime::TimeZone timeZone) const
 {
-    std::time_t tt = std::chrono::system_clock::to_time_t(m_time);
-    std::tm tm;
-
     if (timeZone == TimeZone::UTC) {
-        gmtime_s(&tm, &tt);
-    } else if (timeZone == TimeZone::Local) {
-        localtime_s(&tm, &tt);
+        return _structFromSeconds(_seconds());
     }
 
-    ProcessedDateTime pdt;
-
-    pdt.year = 1900 + tm.tm_year;
-    pdt.month = 1 + tm.tm_mon;
-    pdt.day = tm.tm_mday;
-
-    pdt.hour = tm.tm_hour;
-    pdt.minute = tm.tm_min;
-    pdt.secound = tm.tm_sec;
-
+    ProcessedDateTime pdt {};
+    _secondsToLocal(_seconds(), pdt);
     return pdt;
 }
 
@@ -295,18 +247,18 @@ std::string DateTime::toString(TimeZone timeZone, const char *format) const
     if (format == nullptr) {
         return toString(toStruct(timeZone));
     }
-    std::time_t tt = std::chrono::system_clock::to_time_t(m_time);
-    std::tm tm;
+    if (!_isFastFormat(format)) {
+        return _formatStream(timeZone, format);
+    }
 
-    if (timeZone == TimeZone::UTC) {
-        gmtime_s(&tm, &tt);
-    } else if (timeZone == TimeZone::Local) {
-        localtime_s(&tm, &tt);
+    ProcessedDateTime pdt = toStruct(timeZone);
+    if (pdt.year < 0 || pdt.year > 9999) {
+        return _formatStream(timeZone, format);
     }
 
-    std::ostringstream ss;
-    ss << std::put_time(&tm, format);
-    return ss.str();
+    std::string str;
+    _format(pdt, format, str);
+    return str;
 }
 
 // =============================================================================
@@ -339,6 +291,158 @@ std::string DateTime::toString(const ProcessedDateTime &pdt) const
     return std::string(dateTime);
 }
 
+// =============================================================================
+// (public)
+DateTime DateTime::fromIsoString(std::string_view str, TimeZone timeZone)
+{
+    DateTime dt;
+    ProcessedDateTime pdt { 0, 1, 1, 0, 0, 0 };
+    size_t pos = 0;
+
+    if (!_readNumber(str, pos, 4, pdt.year) || !_readChar(str, pos, '-') ||
+        !_readNumber(str, pos, 2, pdt.month) || !_readChar(str, pos, '-') ||
+        !_readNumber(str, pos, 2, pdt.day)) {
+        return dt;
+    }
+
+    int ms = 0;
+    if (_readChar(str, pos, 'T') || _readChar(str, pos, ' ')) {
+        if (!_readNumber(str, pos, 2, pdt.hour) || !_readChar(str, pos, ':') ||
+            !_readNumber(str, pos, 2, pdt.minute)) {
+            return dt;
+        }
+        if (_readChar(str, pos, ':')) {
+            if (!_readNumber(str, pos, 2, pdt.secound)) { return dt; }
+
+            if (_readChar(str, pos, '.') || _readChar(str, pos, ',')) {
+                // Digits after the milliseconds are ignored
+                int digits = 0;
+                while (pos < str.size() && str[pos] >= '0' && str[pos] <= '9') {
+                    if (digits < 3) { ms = ms * 10 + (str[pos] - '0'); }
+                    digits++;
+                    pos++;
+                }
+                if (digits == 0) { return dt; }
+                for (; digits < 3; digits++) { ms *= 10; }
+            }
+        }
+    }
+
+    if (!_isValid(pdt)) { return dt; }
+
+    long long seconds;
+    if (_readChar(str, pos, 'Z')) {
+        seconds = _secondsFromStruct(pdt);
+    } else if (pos < str.size() && (str[pos] == '+' || str[pos] == '-')) {
+        int sign = (str[pos++] == '-') ? -1 : 1;
+        int offsetHour = 0;
+        int offsetMinute = 0;
+        if (!_readNumber(str, pos, 2, offsetHour)) { return dt; }
+        if (pos < str.size()) {
+            _readChar(str, pos, ':');
+            if (!_readNumber(str, pos, 2, offsetMinute)) { return dt; }
+        }
+        if (offsetHour > 23 || offsetMinute > 59) { return dt; }
+        seconds = _secondsFromStruct(pdt) - sign * (offsetHour * 3600 + offsetMinute * 60);
+    } else if (timeZone == TimeZone::UTC) {
+        seconds = _secondsFromStruct(pdt);
+    } else if (!_localToSeconds(pdt, seconds)) {
+        return dt;
+    }
+
+    if (pos != str.size()) { return dt; }
+
+    _timePointFromSeconds(seconds, ms, dt.m_time);
+    return dt;
+}
+
+// =============================================================================
+// (public)
+std::string DateTime::toIsoString() const
+{
+    if (isNull()) { return std::string(); }
+
+    long long seconds = _seconds();
+    int ms = static_cast<int>(mSecsSinceEpoch() - seconds * 1000);
+
+    std::string str;
+    _format(_structFromSeconds(seconds), "%Y-%m-%dT%H:%M:%S", str);
+    if (ms > 0 && ms < 1000) {
+        char buffer[] = ".000";
+        buffer[1] += static_cast<char>(ms / 100);
+        buffer[2] += static_cast<char>(ms / 10 % 10);
+        buffer[3] += static_cast<char>(ms % 10);
+        str.append(buffer, 4);
+    }
+    str.push_back('Z');
+    return str;
+}
+
+// =============================================================================
+// (public)
+int DateTime::fromStringList(const std::vector<std::string_view> &strList, std::vector<DateTime> &dateTimeList, TimeZone timeZone, const char *format)
+{
+    return _fromStringList(strList, dateTimeList, timeZone, format);
+}
+
+// =============================================================================
+// (public)
+int DateTime::fromStringList(const std::vector<std::string> &strList, std::vector<DateTime> &dateTimeList, TimeZone timeZone, const char *format)
+{
+    return _fromStringList(strList, dateTimeList, timeZone, format);
+}
+
+// =============================================================================
+// (public)
+// Null date times become empty strings
+void DateTime::toStringList(const std::vector<DateTime> &dateTimeList, std::vector<std::string> &strList, TimeZone timeZone, const char *format)
+{
+    strList.resize(dateTimeList.size());
+    bool isFast = _isFastFormat(format);
+
+    // The offset of the local time zone found for the last quarter of an hour.
+    //  Time zones change offset on whole quarters of an hour
+    long long offsetQuarter = 0;
+    long long offset = 0;
+    bool hasOffset = false;
+
+    ProcessedDateTime pdt;
+    for (size_t i = 0; i < dateTimeList.size(); i++)
+    {
+        const DateTime &dt = dateTimeList[i];
+        if (dt.isNull()) {
+            strList[i].clear();
+            continue;
+        }
+        if (!isFast) {
+            strList[i] = dt.toString(timeZone, format);
+            continue;
+        }
+
+        long long seconds = dt._seconds();
+        if (timeZone == TimeZone::Local) {
+            long long quarter = std::chrono::floor<std::chrono::minutes>(std::chrono::seconds(seconds)).count() / 15;
+            if (!hasOffset || quarter != offsetQuarter) {
+                if (!_secondsToLocal(seconds, pdt)) {
+                    strList[i] = dt.toString(timeZone, format);
+                    continue;
+                }
+                offset = _secondsFromStruct(pdt) - seconds;
+                offsetQuarter = quarter;
+                hasOffset = true;
+            }
+            seconds += offset;
+        }
+
+        pdt = _structFromSeconds(seconds);
+        if (pdt.year < 0 || pdt.year > 9999) {
+            strList[i] = dt.toString(timeZone, format);
+        } else {
+            _format(pdt, format, strList[i]);
+        }
+    }
+}
+
 // =============================================================================
 // (public)
 const DateTime &DateTime::emptyDateTime()
@@ -356,48 +460,452 @@ const DateTime &DateTime::defaultDateTime()
 }
 
 // =============================================================================
-// (public)
+// (protected)
 // Return the number of days of the previous months
 int DateTime::_monthDaySum(size_t month)
 {
     ASSERT(month >= 1 && month <= 12);
-    static std::vector<int> s_monthDaySum;
-    if (s_monthDaySum.empty()) {
-        s_monthDaySum.resize(13);
-        s_monthDaySum[1] = 0;
-        for (size_t i = 2; i < 13; i++) {
-            s_monthDaySum[i] = s_monthDaySum[i-1] + _monthDays(i-1);
-        }
-    }
+    static const int s_monthDaySum[13] = { 0, 0, 31, 59, 90, 120, 151, 181, 212, 243, 273, 304, 334 };
     return s_monthDaySum[month];
 }
 
 // =============================================================================
-// (public)
+// (protected)
 int DateTime::_monthDays(size_t month)
 {
     ASSERT(month >= 1 && month <= 12);
-    static std::vector<int> s_monthDays;
-    if (s_monthDays.empty()) {
-        s_monthDays.resize(13);
-        s_monthDays[1] = 31;
-        s_monthDays[2] = 28;
-        s_monthDays[3] = 31;
-        s_monthDays[4] = 30;
-        s_monthDays[5] = 31;
-        s_monthDays[6] = 30;
-        s_monthDays[7] = 31;
-        s_monthDays[8] = 31;
-        s_monthDays[9] = 30;
-        s_monthDays[10] = 31;
-        s_monthDays[11] = 30;
-        s_monthDays[12] = 31;
-    }
+    static const int s_monthDays[13] = { 0, 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
     return s_monthDays[month];
 }
 
 // =============================================================================
-// (public)
+// (protected)
+bool DateTime::_isLeapYear(int year)
+{
+    return (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+}
+
+// =============================================================================
+// (protected)
+bool DateTime::_isValid(const ProcessedDateTime &pdt)
+{
+    if (pdt.year < 0 || pdt.year > 9999) { return false; }
+    if (pdt.month < 1 || pdt.month > 12) { return false; }
+
+    int days = _monthDays(static_cast<size_t>(pdt.month));
+    if (pdt.month == 2 && _isLeapYear(pdt.year)) { days++; }
+    if (pdt.day < 1 || pdt.day > days) { return false; }
+
+    return pdt.hour >= 0 && pdt.hour < 24 &&
+           pdt.minute >= 0 && pdt.minute < 60 &&
+           pdt.secound >= 0 && pdt.secound < 60;
+}
+
+// =============================================================================
+// (protected)
+// See http://howardhinnant.github.io/date_algorithms.html (days_from_civil)
+long long DateTime::_daysFromCivil(int year, int month, int day)
+{
+    year -= month <= 2;
+    const long long era = (year >= 0 ? year : year - 399) / 400;
+    const long long yoe = year - era * 400;                                 // [0, 399]
+    const long long doy = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;  // [0, 365]
+    const long long doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;            // [0, 146096]
+    return era * 146097 + doe - 719468;
+}
+
+// =============================================================================
+// (protected)
+// See http://howardhinnant.github.io/date_algorithms.html (civil_from_days)
+void DateTime::_civilFromDays(long long days, int &year, int &month, int &day)
+{
+    days += 719468;
+    const long long era = (days >= 0 ? days : days - 146096) / 146097;
+    const long long doe = days - era * 146097;                                  // [0, 146096]
+    const long long yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;  // [0, 399]
+    const long long doy = doe - (365 * yoe + yoe / 4 - yoe / 100);              // [0, 365]
+    const long long mp = (5 * doy + 2) / 153;                                   // [0, 11]
+
+    day = static_cast<int>(doy - (153 * mp + 2) / 5 + 1);
+    month = static_cast<int>(mp < 10 ? mp + 3 : mp - 9);
+    year = static_cast<int>(yoe + era * 400 + (month <= 2));
+}
+
+// =============================================================================
+// (protected)
+long long DateTime::_secondsFromStruct(const ProcessedDateTime &pdt)
+{
+    return _daysFromCivil(pdt.year, pdt.month, pdt.day) * 86400 + pdt.hour * 3600 + pdt.minute * 60 + pdt.secound;
+}
+
+// =============================================================================
+// (protected)
+// 'timePoint' is unchanged if the time is out of range
+bool DateTime::_timePointFromSeconds(long long seconds, int ms, std::chrono::system_clock::time_point &timePoint)
+{
+    using Duration = std::chrono::system_clock::duration;
+    // The last whole second in range is left out so the milliseconds can be added
+    constexpr long long maxSeconds = std::chrono::duration_cast<std::chrono::seconds>(Duration::max()).count();
+    constexpr long long minSeconds = std::chrono::duration_cast<std::chrono::seconds>(Duration::min()).count();
+    if (seconds >= maxSeconds || seconds <= minSeconds) { return false; }
+
+    timePoint = std::chrono::system_clock::time_point(std::chrono::duration_cast<Duration>(std::chrono::seconds(seconds) + std::chrono::milliseconds(ms)));
+    return true;
+}
+
+// =============================================================================
+// (protected)
+ProcessedDateTime DateTime::_structFromSeconds(long long seconds)
+{
+    long long days = std::chrono::floor<chrono_days>(std::chrono::seconds(seconds)).count();
+    int secondOfDay = static_cast<int>(seconds - days * 86400);
+
+    ProcessedDateTime pdt;
+    _civilFromDays(days, pdt.year, pdt.month, pdt.day);
+    pdt.hour = secondOfDay / 3600;
+    pdt.minute = secondOfDay / 60 % 60;
+    pdt.secound = secondOfDay % 60;
+    return pdt;
+}
+
+// =============================================================================
+// (protected)
+long long DateTime::_seconds() const
+{
+    return std::chrono::floor<std::chrono::seconds>(m_time.time_since_epoch()).count();
+}
+
+// =============================================================================
+// (protected)
+bool DateTime::_localToSeconds(const ProcessedDateTime &pdt, long long &seconds)
+{
+    std::tm tm = {};
+    tm.tm_year = pdt.year - 1900;
+    tm.tm_mon = pdt.month - 1;
+    tm.tm_mday = pdt.day;
+    tm.tm_hour = pdt.hour;
+    tm.tm_min = pdt.minute;
+    tm.tm_sec = pdt.secound;
+    tm.tm_isdst = -1;
+
+    std::time_t tt = std::mktime(&tm);
+
+    // 'mktime()' moves times skipped by daylight saving time
+    if (tm.tm_year != pdt.year - 1900 || tm.tm_mon != pdt.month - 1 || tm.tm_mday != pdt.day ||
+        tm.tm_hour != pdt.hour || tm.tm_min != pdt.minute || tm.tm_sec != pdt.secound) {
+        TRACE(L"Local time does not exist: %S", DateTime().toString(pdt).c_str());
+        return false;
+    }
+
+    seconds = static_cast<long long>(tt);
+    return true;
+}
+
+// =============================================================================
+// (protected)
+bool DateTime::_secondsToLocal(long long seconds, ProcessedDateTime &pdt)
+{
+    std::time_t tt = static_cast<std::time_t>(seconds);
+    std::tm tm;
+    if (localtime_s(&tm, &tt) != 0) { return false; }
+
+    pdt.year = 1900 + tm.tm_year;
+    pdt.month = 1 + tm.tm_mon;
+    pdt.day = tm.tm_mday;
+
+    pdt.hour = tm.tm_hour;
+    pdt.minute = tm.tm_min;
+    pdt.secound = tm.tm_sec;
+    return true;
+}
+
+// =============================================================================
+// (protected)
+bool DateTime::_readNumber(std::string_view str, size_t &pos, int digits, int &value)
+{
+    if (pos + static_cast<size_t>(digits) > str.size()) { return false; }
+
+    value = 0;
+    for (int i = 0; i < digits; i++)
+    {
+        char c = str[pos++];
+        if (c < '0' || c > '9') { return false; }
+        value = value * 10 + (c - '0');
+    }
+    return true;
+}
+
+// =============================================================================
+// (protected)
+bool DateTime::_readChar(std::string_view str, size_t &pos, char c)
+{
+    if (pos >= str.size() || str[pos] != c) { return false; }
+    pos++;
+    return true;
+}
+
+// =============================================================================
+// (protected)
+bool DateTime::_isFastFormat(const char *format)
+{
+    if (format == nullptr) { return false; }
+
+    for (const char *f = format; *f != '\0'; f++)
+    {
+        if (*f != '%') { continue; }
+        f++;
+        switch (*f) {
+            case 'Y': case 'm': case 'd': case 'H': case 'M': case 'S': case 'F': case 'T': case '%':
+                break;
+            default:
+                return false;
+        }
+    }
+    return true;
+}
+
+// =============================================================================
+// (protected)
+// Numbers must have all their digits (E.g. "2020-06-01" and not "2020-6-1"),
+//  so the same strings are accepted as 'toString()' returns
+bool DateTime::_parse(std::string_view str, const char *format, ProcessedDateTime &pdt)
+{
+    pdt = ProcessedDateTime { 1970, 1, 1, 0, 0, 0 };
+    size_t pos = 0;
+
+    for (const char *f = format; *f != '\0'; f++)
+    {
+        if (*f != '%') {
+            if (!_readChar(str, pos, *f)) { return false; }
+            continue;
+        }
+        f++;
+        bool ok = false;
+        switch (*f) {
+            case 'Y':
+                ok = _readNumber(str, pos, 4, pdt.year);
+                break;
+            case 'm':
+                ok = _readNumber(str, pos, 2, pdt.month);
+                break;
+            case 'd':
+                ok = _readNumber(str, pos, 2, pdt.day);
+                break;
+            case 'H':
+                ok = _readNumber(str, pos, 2, pdt.hour);
+                break;
+            case 'M':
+                ok = _readNumber(str, pos, 2, pdt.minute);
+                break;
+            case 'S':
+                ok = _readNumber(str, pos, 2, pdt.secound);
+                break;
+            case 'F':
+                ok = _readNumber(str, pos, 4, pdt.year) && _readChar(str, pos, '-') &&
+                     _readNumber(str, pos, 2, pdt.month) && _readChar(str, pos, '-') &&
+                     _readNumber(str, pos, 2, pdt.day);
+                break;
+            case 'T':
+                ok = _readNumber(str, pos, 2, pdt.hour) && _readChar(str, pos, ':') &&
+                     _readNumber(str, pos, 2, pdt.minute) && _readChar(str, pos, ':') &&
+                     _readNumber(str, pos, 2, pdt.secound);
+                break;
+            case '%':
+                ok = _readChar(str, pos, '%');
+                break;
+            default:
+                break;
+        }
+        if (!ok) { return false; }
+    }
+
+    return pos == str.size() && _isValid(pdt);
+}
+
+// =============================================================================
+// (protected)
+void DateTime::_format(const ProcessedDateTime &pdt, const char *format, std::string &str)
+{
+    str.clear();
+
+    auto write = [&str](int value, int digits) {
+        char buffer[4];
+        for (int i = digits - 1; i >= 0; i--) {
+            buffer[i] = static_cast<char>('0' + value % 10);
+            value /= 10;
+        }
+        str.append(buffer, static_cast<size_t>(digits));
+    };
+
+    for (const char *f = format; *f != '\0'; f++)
+    {
+        if (*f != '%') {
+            str.push_back(*f);
+            continue;
+        }
+        f++;
+        switch (*f) {
+            case 'Y':
+                write(pdt.year, 4);
+                break;
+            case 'm':
+                write(pdt.month, 2);
+                break;
+            case 'd':
+                write(pdt.day, 2);
+                break;
+            case 'H':
+                write(pdt.hour, 2);
+                break;
+            case 'M':
+                write(pdt.minute, 2);
+                break;
+            case 'S':
+                write(pdt.secound, 2);
+                break;
+            case 'F':
+                write(pdt.year, 4);
+                str.push_back('-');
+                write(pdt.month, 2);
+                str.push_back('-');
+                write(pdt.day, 2);
+                break;
+            case 'T':
+                write(pdt.hour, 2);
+                str.push_back(':');
+                write(pdt.minute, 2);
+                str.push_back(':');
+                write(pdt.secound, 2);
+                break;
+            case '%':
+                str.push_back('%');
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+// =============================================================================
+// (protected)
+void DateTime::_parseStream(const std::string &inputStr, TimeZone timeZone, const char *format)
+{
+    std::tm tm = {};
+    std::istringstream iss(inputStr);
+    iss >> std::get_time(&tm, format);
+
+    if (iss.fail()) {
+        m_time = _emptyTimePoint();
+        TRACE(L"Faild to construct DateTime from string %S (%S)", inputStr.c_str(), format);
+        return;
+    }
+    std::time_t tt = std::mktime(&tm);
+    m_time = std::chrono::system_clock::from_time_t(tt);
+
+    // Time is parsed without taking account for daylight savings flag
+    if (tm.tm_isdst) { m_time -= std::chrono::hours(1); }
+
+    if (timeZone == TimeZone::UTC) {
+        // Time is parsed as local time and needs to be adjusted to UTC time
+        std::tm tm_UTC;
+        gmtime_s(&tm_UTC, &tt);
+
+        int offset = tm.tm_hour - tm_UTC.tm_hour;
+
+        // Adjust for changing day/year
+        if (tm.tm_year != tm_UTC.tm_year) {
+            offset += tm.tm_year > tm_UTC.tm_year ? 24 : -24;
+        } else if (tm.tm_yday != tm_UTC.tm_yday) {
+            offset += tm.tm_yday > tm_UTC.tm_yday ? 24 : -24;
+        }
+
+        //TRACE(L"Local time zone offset: %i", offset);
+        m_time += std::chrono::hours(offset);
+    }
+
+    // End to end testing: toString() result should be equal to 'inputStr'
+    std::string outputStr = toString(timeZone, format);
+    if (inputStr != outputStr) {
+        TRACE(L"Testing faild: %S != %S", inputStr.c_str(), outputStr.c_str());
+        m_time = _emptyTimePoint();
+        //ASSERT(false);
+    }
+    // TESTING END
+}
+
+// =============================================================================
+// (protected)
+std::string DateTime::_formatStream(TimeZone timeZone, const char *format) const
+{
+    std::time_t tt = std::chrono::system_clock::to_time_t(m_time);
+    std::tm tm;
+
+    if (timeZone == TimeZone::UTC) {
+        gmtime_s(&tm, &tt);
+    } else if (timeZone == TimeZone::Local) {
+        localtime_s(&tm, &tt);
+    }
+
+    std::ostringstream ss;
+    ss << std::put_time(&tm, format);
+    return ss.str();
+}
+
+// =============================================================================
+// (protected)
+template<typename StringList>
+int DateTime::_fromStringList(const StringList &strList, std::vector<DateTime> &dateTimeList, TimeZone timeZone, const char *format)
+{
+    dateTimeList.clear();
+    dateTimeList.reserve(strList.size());
+
+    int failCount = 0;
+    if (!_isFastFormat(format)) {
+        for (const auto &str: strList)
+        {
+            dateTimeList.emplace_back(std::string_view(str), timeZone, format);
+            if (dateTimeList.back().isNull()) { failCount++; }
+        }
+        return failCount;
+    }
+
+    // The offset of the local time zone found for the last quarter of an hour.
+    //  Time zones change offset on whole quarters of an hour
+    long long offsetQuarter = 0;
+    long long offset = 0;
+    bool hasOffset = false;
+
+    ProcessedDateTime pdt;
+    for (const auto &str: strList)
+    {
+        dateTimeList.emplace_back();
+        if (!_parse(std::string_view(str), format, pdt)) {
+            failCount++;
+            continue;
+        }
+
+        long long seconds = _secondsFromStruct(pdt);
+        if (timeZone == TimeZone::Local) {
+            long long quarter = std::chrono::floor<std::chrono::minutes>(std::chrono::seconds(seconds)).count() / 15;
+            if (!hasOffset || quarter != offsetQuarter) {
+                long long localSeconds;
+                if (!_localToSeconds(pdt, localSeconds)) {
+                    failCount++;
+                    continue;
+                }
+                offset = seconds - localSeconds;
+                offsetQuarter = quarter;
+                hasOffset = true;
+            }
+            seconds -= offset;
+        }
+        if (!_timePointFromSeconds(seconds, 0, dateTimeList.back().m_time)) { failCount++; }
+    }
+    return failCount;
+}
+
+// =============================================================================
+// (protected)
 const std::chrono::system_clock::time_point &DateTime::_emptyTimePoint()
 {
     static auto s_emptyTimePoint = std::chrono::system_clock::time_point(std::chrono::seconds(-1));
@@ -411,4 +919,3 @@ void swap(DateTime &left, DateTime &right) noexcept {
 }
 
 } // namespace Oak::Model
-
@@ -19,7 +19,9 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <chrono>
+#include <vector>
 
 
 namespace Oak::Model {
@@ -73,7 +75,10 @@ public:
 
     DateTime();
     DateTime(int year, int month, int day, int hour = 0, int minute = 0, int secound = 0, TimeZone timeZone = TimeZone::Local);
-    DateTime(const std::string &str, TimeZone timeZone = TimeZone::Local, const char *format = "%Y-%m-%d %H:%M:%S");
+    // Formats with only %Y, %m, %d, %H, %M, %S, %F, %T and %% are parsed and
+    //  formatted directly, other formats go through 'std::get_time()' and
+    //  'std::put_time()'. The string must match the format exactly
+    DateTime(std::string_view str, TimeZone timeZone = TimeZone::Local, const char *format = "%Y-%m-%d %H:%M:%S");
 
     DateTime(const DateTime &copy) noexcept;
     DateTime(DateTime &&move) noexcept;
@@ -108,6 +113,21 @@ public:
     std::string toString(TimeZone timeZone = TimeZone::Local, const char *format = "%Y-%m-%d %H:%M:%S") const;
     std::string toString(const ProcessedDateTime & pdt) const;
 
+    // Parses ISO 8601 date times like "2020-06-15", "2020-06-15T12:30:00",
+    //  "2020-06-15 12:30:00.250" and "2020-06-15T12:30:00+02:00". Values without
+    //  'Z' or an offset are in 'timeZone'
+    static DateTime fromIsoString(std::string_view str, TimeZone timeZone = TimeZone::UTC);
+    // Returns the UTC time like "2020-06-15T12:30:00Z" (Milliseconds are added if not zero)
+    //  or an empty string if the date time is null
+    std::string toIsoString() const;
+
+    // Converts a column of values. The format is checked once and local time
+    //  zone offsets are reused for values within the same quarter of an hour.
+    //  Values that can not be converted become null; the number of those is returned
+    static int fromStringList(const std::vector<std::string_view> &strList, std::vector<DateTime> &dateTimeList, TimeZone timeZone = TimeZone::Local, const char *format = "%Y-%m-%d %H:%M:%S");
+    static int fromStringList(const std::vector<std::string> &strList, std::vector<DateTime> &dateTimeList, TimeZone timeZone = TimeZone::Local, const char *format = "%Y-%m-%d %H:%M:%S");
+    static void toStringList(const std::vector<DateTime> &dateTimeList, std::vector<std::string> &strList, TimeZone timeZone = TimeZone::Local, const char *format = "%Y-%m-%d %H:%M:%S");
+
     static const DateTime & emptyDateTime();
     static const DateTime & defaultDateTime();
 
@@ -115,6 +135,36 @@ protected:
     static int _monthDaySum(size_t month);
     static int _monthDays(size_t month);
 
+    static bool _isLeapYear(int year);
+    static bool _isValid(const ProcessedDateTime &pdt);
+    // Days since 1970-01-01 in the proleptic Gregorian calendar
+    static long long _daysFromCivil(int year, int month, int day);
+    static void _civilFromDays(long long days, int &year, int &month, int &day);
+
+    static long long _secondsFromStruct(const ProcessedDateTime &pdt);
+    // Returns false if the time can not be held by the clock (With nanoseconds
+    //  only years from 1678 to 2261 can)
+    static bool _timePointFromSeconds(long long seconds, int ms, std::chrono::system_clock::time_point &timePoint);
+    static ProcessedDateTime _structFromSeconds(long long seconds);
+    long long _seconds() const;
+
+    // Returns false if the local time does not exist (Skipped by daylight saving time)
+    static bool _localToSeconds(const ProcessedDateTime &pdt, long long &seconds);
+    static bool _secondsToLocal(long long seconds, ProcessedDateTime &pdt);
+
+    static bool _readNumber(std::string_view str, size_t &pos, int digits, int &value);
+    static bool _readChar(std::string_view str, size_t &pos, char c);
+
+    static bool _isFastFormat(const char *format);
+    static bool _parse(std::string_view str, const char *format, ProcessedDateTime &pdt);
+    static void _format(const ProcessedDateTime &pdt, const char *format, std::string &str);
+
+    void _parseStream(const std::string &str, TimeZone timeZone, const char *format);
+    std::string _formatStream(TimeZone timeZone, const char *format) const;
+
+    template<typename StringList>
+    static int _fromStringList(const StringList &strList, std::vector<DateTime> &dateTimeList, TimeZone timeZone, const char *format);
+
     static const std::chrono::system_clock::time_point & _emptyTimePoint();
 
 protected:
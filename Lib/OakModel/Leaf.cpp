@@ -19,7 +19,7 @@
 #include "Leaf.h"
 #include "Node.h"
 #include "OakModel.h"
-#include "NodeIndex.h"
+#include "NodePath.h"
 
 #include "../ServiceFunctions/Assert.h"
 
@@ -30,17 +30,19 @@ namespace Oak::Model {
 // (public)
 Leaf::Leaf()
     : m_def(nullptr),
-      m_node(nullptr)
+      m_nodeDef(nullptr),
+      m_model(nullptr)
 {
 
 }
 
 // =============================================================================
 // (public)
-Leaf::Leaf(const LeafDef* leafDef, const NodeData &nodeData, const Node *model)
+Leaf::Leaf(const LeafDef* leafDef, const NodeData &nodeData, const Node &node)
     : m_def(leafDef),
       m_nodeData(nodeData),
-      m_node(model)
+      m_nodeDef(node.def()),
+      m_model(node.model())
 {
 
 }
@@ -50,7 +52,8 @@ Leaf::Leaf(const LeafDef* leafDef, const NodeData &nodeData, const Node *model)
 Leaf::Leaf(const Leaf &copy)
     : m_def(copy.m_def),
       m_nodeData(copy.m_nodeData),
-      m_node(copy.m_node)
+      m_nodeDef(copy.m_nodeDef),
+      m_model(copy.m_model)
 {
 
 }
@@ -60,7 +63,8 @@ Leaf::Leaf(const Leaf &copy)
 Leaf::Leaf(Leaf&& move)
     : m_def(move.m_def),
       m_nodeData(std::move(move.m_nodeData)),
-      m_node(move.m_node)
+      m_nodeDef(move.m_nodeDef),
+      m_model(move.m_model)
 {
 
 }
@@ -71,7 +75,8 @@ Leaf& Leaf::operator=(const Leaf& copy)
 {
     m_def = copy.m_def;
     m_nodeData = copy.m_nodeData;
-    m_node = copy.m_node;
+    m_nodeDef = copy.m_nodeDef;
+    m_model = copy.m_model;
     return *this;
 }
 
@@ -81,7 +86,8 @@ Leaf& Leaf::operator=(Leaf&& move)
 {
     m_def = move.m_def;
     m_nodeData = std::move(move.m_nodeData);
-    m_node = move.m_node;
+    m_nodeDef = move.m_nodeDef;
+    m_model = move.m_model;
     return *this;
 }
 
@@ -162,9 +168,12 @@ const LeafDef* Leaf::def() const
 
 // =============================================================================
 // (public)
-const Node* Leaf::node() const
+Node Leaf::node() const
 {
-    return m_node;
+    // The definition is already the valid variant of the node
+    Node n(nullptr, m_nodeData, m_model);
+    n.m_def = m_nodeDef;
+    return n;
 }
 
 // =============================================================================
@@ -183,6 +192,24 @@ std::string Leaf::toString(bool useDefault) const
     return m_def->toString(m_nodeData, useDefault);
 }
 
+// =============================================================================
+// (public)
+bool Leaf::setValue(const UnionRef &value) const
+{
+    ASSERT(m_def != nullptr);
+
+    // The write lock is held until the change and its notifications are done
+    OakModel::WriteLock writeLock(m_model);
+    if (m_model) {
+        onLeafChangeBefore();
+    }
+    bool result = m_def->setValue(m_nodeData, value, true);
+    if (m_model) {
+        onLeafChangeAfter();
+    }
+    return result;
+}
+
 // =============================================================================
 // (public)
 bool Leaf::hasDefaultValue() const
@@ -199,6 +226,24 @@ bool Leaf::hasOptions() const
     return m_def->options().isUsed();
 }
 
+// =============================================================================
+// (public)
+bool Leaf::hasOption(const UnionRef &value) const
+{
+    ASSERT(m_def != nullptr);
+    Node n = node();
+    return m_def->options().hasOption(value, &n);
+}
+
+// =============================================================================
+// (public)
+bool Leaf::getOptions(std::vector<UnionValue> &value) const
+{
+    ASSERT(m_def != nullptr);
+    Node n = node();
+    return m_def->options().getOptions(value, &n);
+}
+
 // =============================================================================
 // (public)
 const LeafSettings &Leaf::settings() const
@@ -219,27 +264,26 @@ Leaf& Leaf::emptyLeaf()
 // (protected)
 void Leaf::onLeafChangeBefore() const
 {
-    if (m_node->model() == nullptr) { return; }
-    NodeIndexUPtr iIndex = NodeIndex::create(*m_node);
-    m_node->model()->onLeafChangeBefore(*iIndex.get(), m_def->name());
+    if (m_model == nullptr) { return; }
+    m_model->onLeafChangeBefore(NodePath::create(node()), *m_def);
 }
 
 // =============================================================================
 // (protected)
 void Leaf::onLeafChangeAfter() const
 {
-    if (m_node->model() == nullptr) { return; }
+    if (m_model == nullptr) { return; }
 
-    int index = m_node->leafIndex(*this);
-    NodeIndexUPtr iIndex = NodeIndex::create(*m_node);
+    int index = m_nodeDef->valueIndex(m_def);
+    NodePath path = NodePath::create(node());
 
-    if (m_node->def()->indexOfVariantLeafDef() == index) {
-        m_node->model()->onVariantLeafChangeAfter(*iIndex.get());
-    } else if (m_node->def()->indexOfKeyLeafDef() == index) {
-        m_node->model()->onKeyLeafChangeAfter(*iIndex.get());
+    if (m_nodeDef->indexOfVariantLeafDef() == index) {
+        m_model->onVariantLeafChangeAfter(path);
+    } else if (m_nodeDef->indexOfKeyLeafDef() == index) {
+        m_model->onKeyLeafChangeAfter(path);
     }
 
-    m_node->model()->onLeafChangeAfter(*iIndex.get(), m_def->name());
+    m_model->onLeafChangeAfter(path, *m_def);
 }
 
 } // namespace Oak::Model
@@ -27,6 +27,8 @@
 namespace Oak::Model {
 
 class Node;
+class NodeDef;
+class OakModel;
 
 // =============================================================================
 // Class definition
@@ -35,7 +37,7 @@ class Leaf
 {
 public:
     Leaf();
-    Leaf(const LeafDef* leafDef, const NodeData &nodeData, const Node* node/* = nullptr*/);
+    Leaf(const LeafDef* leafDef, const NodeData &nodeData, const Node &node);
     Leaf(const Leaf& copy);
     Leaf(Leaf&& move);
 
@@ -56,7 +58,7 @@ public:
 
     const NodeData& nodeData() const;
     const LeafDef* def() const;
-    const Node* node() const;
+    Node node() const;
 
     template<typename T>
     bool canGetValue(T &value, bool useDefault = true) const;
@@ -73,6 +75,7 @@ public:
     bool canSetValue(const T &value) const;
     template<typename T>
     bool setValue(const T &value) const;
+    bool setValue(const UnionRef &value) const;
 
     bool hasDefaultValue() const;
     template<typename T>
@@ -82,9 +85,11 @@ public:
     T defaultValue() const;
 
     bool hasOptions() const;
+    bool hasOption(const UnionRef &value) const;
     template<typename T>
     bool hasOption(const T &value) const;
     
+    bool getOptions(std::vector<UnionValue>& value) const;
     template<typename T>
     bool getOptions(std::vector<T>& value) const;
 
@@ -102,7 +107,10 @@ protected:
 protected:
     const LeafDef* m_def;
     NodeData m_nodeData;
-    const Node* m_node;
+    // The leaf refers to the definition and model of its node instead of the node
+    //  itself, so it stays valid when the node it was made from goes away
+    const NodeDef* m_nodeDef;
+    const OakModel* m_model;
 
     friend class Node;
 };
@@ -148,16 +156,7 @@ bool Leaf::canSetValue(const T &value) const
 template<typename T>
 bool Leaf::setValue(const T &value) const
 {
-    assert(m_def != nullptr);
-
-    if (m_node) {
-        onLeafChangeBefore();
-    }
-    bool result = m_def->setValue(m_nodeData, value, true);
-    if (m_node) {
-        onLeafChangeAfter();
-    }
-    return result;
+    return setValue(UnionRef(value));
 }
 
 // =============================================================================
@@ -185,7 +184,7 @@ T Leaf::defaultValue() const
 template<typename T>
 bool Leaf::hasOption(const T& value) const
 {
-    return m_def->options().hasOption(value, m_node);
+    return hasOption(UnionRef(value));
 }
 
 // =============================================================================
@@ -194,7 +193,14 @@ template<typename T>
 bool Leaf::getOptions(std::vector<T>& value) const
 {
     assert(m_def != nullptr);
-    return m_def->options().getOptions(value, m_node);
+    std::vector<UnionValue> oList;
+    getOptions(oList);
+    value.resize(oList.size());
+    for (std::vector<UnionValue>::size_type i = 0; i < oList.size(); i++)
+    {
+        oList[i].get(value[i], false);
+    }
+    return true;
 }
 
 // =============================================================================
@@ -53,6 +53,7 @@ LeafDef::LeafDef(const LeafDef &copy)
 {
     m_defaultValue = copy.m_defaultValue;
     m_name = copy.m_name;
+    m_nameId = copy.m_nameId;
     m_defaultConversion = copy.m_defaultConversion;
     m_options = new ValueOptions(*copy.m_options);
 
@@ -68,6 +69,7 @@ LeafDef::LeafDef(LeafDef&& move)
 {
     m_defaultValue = std::move(move.m_defaultValue);
     m_name = std::move(move.m_name);
+    m_nameId = move.m_nameId;
     m_defaultConversion = move.m_defaultConversion;
     m_options = move.m_options;
     move.m_options = nullptr;
@@ -268,15 +270,15 @@ bool LeafDef::getValue(const NodeData &_node, UnionRef value, bool useDefault, b
     switch (_node.type()) {
 #ifdef XML_BACKEND
     case NodeData::Type::XML: {
-        if (m_valueRef->hasValue(_node.xmlNode())) {
+        // The value is read directly from the document without a temporary string
+        const char *str = m_valueRef->valueCString(_node.xmlNode());
+        if (str) {
             // Check if the returned value type is string or string list
             // Strings can always be returned
             if (value.type() == UnionType::String) {
-                m_valueRef->getValue(_node.xmlNode(), value.getString());
+                value.getString().assign(str);
             } else {
-                std::string string;
-                m_valueRef->getValue(_node.xmlNode(), string);
-                UnionRef(string).get(value);
+                UnionRef(str).get(value);
                 //value.set(string, true, conversion.get());
             }
             return true;
@@ -306,6 +308,24 @@ UnionValue LeafDef::value(const NodeData &_node, bool useDefault, bool allowConv
     return val;
 }
 
+// =============================================================================
+// (public)
+const char *LeafDef::valueCString(const NodeData &_node) const
+{
+    if (_node.isNull()) { return nullptr; }
+
+    switch (_node.type()) {
+#ifdef XML_BACKEND
+    case NodeData::Type::XML:
+        return m_valueRef->valueCString(_node.xmlNode());
+#endif // XML_BACKEND
+    default:
+        // _node.type() returns an unhandled type that needs to be implemented
+        ASSERT(false);
+    }
+    return nullptr;
+}
+
 // =============================================================================
 // (public)
 std::string LeafDef::toString(const NodeData &_node, bool useDefault, bool allowConversion, ConversionSPtr conversion) const
@@ -373,19 +393,30 @@ bool LeafDef::setValue(const NodeData &_node, const UnionRef &value, bool allowC
         if (value.type() == m_valueTemplate.type()) {
             if (m_valueTemplate.type() == UnionType::String) {
                 return m_valueRef->setValue(_node.xmlNode(), value.getCString());
-            } else {
-                std::string tempStr;
-                if (value.get(tempStr, true, conversion.get())) {
-                    return m_valueRef->setValue(_node.xmlNode(), tempStr);
-                }
+            } else if (m_valueTemplate.type() == UnionType::Bool) {
+                Conversion *properties = conversion ? conversion.get() : Conversion::globalDefault2();
+                return m_valueRef->setValue(_node.xmlNode(), value.getBool() ? properties->boolTrue() : properties->boolFalse());
+            }
+
+            // Numbers are formatted on the stack without a temporary string
+            char buffer[64];
+            if (m_valueTemplate.type() == UnionType::Integer &&
+                toChars(buffer, static_cast<int>(sizeof(buffer)), value.getInt(), conversion.get())) {
+                return m_valueRef->setValue(_node.xmlNode(), static_cast<const char*>(buffer));
+            }
+            if (m_valueTemplate.type() == UnionType::Double &&
+                toChars(buffer, static_cast<int>(sizeof(buffer)), value.getDouble(), conversion.get())) {
+                return m_valueRef->setValue(_node.xmlNode(), static_cast<const char*>(buffer));
+            }
+
+            std::string tempStr;
+            if (value.get(tempStr, true, conversion.get())) {
+                return m_valueRef->setValue(_node.xmlNode(), tempStr);
             }
         } else if (allowConversion) {
             UnionValue tempVariant(m_valueTemplate);
             if (value.get(tempVariant, allowConversion, conversion.get())) {
-                std::string tempStr;
-                if (tempVariant.get(tempStr, true, conversion.get())) {
-                    return m_valueRef->setValue(_node.xmlNode(), tempStr);
-                }
+                return setValue(_node, tempVariant, false, conversion);
             }
         }
         return false;
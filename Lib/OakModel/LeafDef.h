@@ -56,6 +56,8 @@ public:
     UnionType valueType() const;
     const UnionRef valueTemplate() const;
     const std::string &name() const;
+    // The id of the name in the name registry of NodePath
+    int nameId() const { return m_nameId; }
     const std::string &displayName() const;
     const std::string &tooltip() const;
 
@@ -72,6 +74,8 @@ public:
     virtual bool canGetValue(const NodeData &_node, const UnionRef& value, bool useDefault = true, bool allowConversion = false, ConversionSPtr conversion = ConversionSPtr()) const;
     virtual bool getValue(const NodeData &_node, UnionRef value, bool useDefault = true, bool allowConversion = false, ConversionSPtr conversion = ConversionSPtr()) const;
     virtual UnionValue value(const NodeData &_node, bool useDefault = true, bool allowConversion = false, ConversionSPtr conversion = ConversionSPtr()) const;
+    // Returns the value stored in the data without copying it or nullptr if there is no value (The default value is not used)
+    const char *valueCString(const NodeData &_node) const;
     virtual std::string toString(const NodeData &_node, bool useDefault = true, bool allowConversion = false, ConversionSPtr conversion = ConversionSPtr()) const;
 
     template<typename T>
@@ -95,6 +99,7 @@ protected:
     UnionValue m_valueTemplate;
     LeafSettings m_settings;
     std::string m_name;
+    int m_nameId = -1;
     std::string m_displayName;
     UnionValue m_defaultValue;
     ConversionSPtr m_defaultConversion;
@@ -18,6 +18,7 @@
 
 #include "LeafDefBuilder.h"
 
+#include "NodePath.h"
 #include "XMLChildRef.h"
 
 #include "../ServiceFunctions/Assert.h"
@@ -32,6 +33,7 @@ LeafDefBuilder::LeafDefBuilder(UnionType type, const std::string &name)
     m_leafDefUPtr = LeafDef::MakeUPtr(type);
     m_leafDef = m_leafDefUPtr.get();
     m_leafDef->m_name = name;
+    m_leafDef->m_nameId = NodePath::nameId(name);
     m_leafDef->m_defaultConversion = Conversion::globalDefault();
 
 #ifdef XML_BACKEND
@@ -72,6 +74,7 @@ LeafDefBuilderSPtr LeafDefBuilder::setName(const std::string &value)
 {
     ASSERT(m_leafDef);
     m_leafDef->m_name = value;
+    m_leafDef->m_nameId = NodePath::nameId(value);
     return m_thisWPtr.lock();
 }
 
@@ -0,0 +1,74 @@
+/*
+ * OakModelView (http://oakmodelview.com/)
+ * Author: Mikkel Nøhr Løvgreen (mikkel@oakmodelview.com)
+ * ------------------------------------------------------------------------
+ * Licensed to Vilaversoftware IVS who licenses this file to you under the
+ * Apache License, Version 2.0 (the "License"); you may not use this file
+ * except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "LeafHandle.h"
+
+#include "NodeDef.h"
+
+
+namespace Oak::Model {
+
+// =============================================================================
+// (public)
+LeafHandle::LeafHandle(const std::string &name)
+    : m_name(name)
+{
+}
+
+// =============================================================================
+// (public)
+LeafHandle::LeafHandle(const LeafHandle &copy)
+    : m_name(copy.m_name)
+{
+}
+
+// =============================================================================
+// (public)
+LeafHandle &LeafHandle::operator=(const LeafHandle &copy)
+{
+    setName(copy.m_name);
+    return *this;
+}
+
+// =============================================================================
+// (public)
+void LeafHandle::setName(const std::string &name)
+{
+    m_name = name;
+    m_def = nullptr;
+    m_index = -1;
+}
+
+// =============================================================================
+// (public)
+int LeafHandle::index(const NodeDef *def) const
+{
+    if (def == nullptr || m_name.empty()) { return -1; }
+    if (m_cacheBusy.test_and_set(std::memory_order_acquire)) {
+        return def->valueIndex(m_name);
+    }
+    if (def != m_def) {
+        m_index = def->valueIndex(m_name);
+        m_def = def;
+    }
+    int index = m_index;
+    m_cacheBusy.clear(std::memory_order_release);
+    return index;
+}
+
+} // namespace Oak::Model
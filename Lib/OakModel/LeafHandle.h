@@ -0,0 +1,57 @@
+/*
+ * OakModelView (http://oakmodelview.com/)
+ * Author: Mikkel Nøhr Løvgreen (mikkel@oakmodelview.com)
+ * ------------------------------------------------------------------------
+ * Licensed to Vilaversoftware IVS who licenses this file to you under the
+ * Apache License, Version 2.0 (the "License"); you may not use this file
+ * except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <string>
+
+
+namespace Oak::Model {
+
+class NodeDef;
+
+// =============================================================================
+// Class definition
+// =============================================================================
+class LeafHandle
+{
+public:
+    explicit LeafHandle(const std::string &name = std::string());
+    LeafHandle(const LeafHandle &copy);
+    LeafHandle &operator=(const LeafHandle &copy);
+
+    const std::string &name() const { return m_name; }
+    void setName(const std::string &name);
+
+    bool isNull() const { return m_name.empty(); }
+
+    // Returns the index of the leaf in the leaf list of nodes defined by 'def' or -1 if it is not found.
+    // The index is cached for the last 'NodeDef' so repeated lookups on the same node type are free.
+    // Reading threads can share a handle; a thread that finds the cache busy looks the index up itself.
+    int index(const NodeDef *def) const;
+
+protected:
+    std::string m_name;
+
+    mutable const NodeDef *m_def = nullptr;
+    mutable int m_index = -1;
+    mutable std::atomic_flag m_cacheBusy = ATOMIC_FLAG_INIT;
+};
+
+} // namespace Oak::Model
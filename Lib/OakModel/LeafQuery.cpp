@@ -20,17 +20,20 @@
 
 #include "NodeQueryChildren.h"
 #include "NodeQueryParent.h"
+#include "QueryBuilder.h"
 
 #include "../ServiceFunctions/Assert.h"
 
+#include <iterator>
+
 
 namespace Oak::Model {
 
 // =============================================================================
 // (protected)
 LeafQuery::LeafQuery(const std::string &leafName)
+    : m_leaf(leafName)
 {
-    m_leafName = leafName;
 }
 
 // =============================================================================
@@ -38,7 +41,7 @@ LeafQuery::LeafQuery(const std::string &leafName)
 LeafQuery::LeafQuery(NodeQueryUPtr nodeQueryUPtr, const std::string &leafName)
 {
     m_nodeQueryPtr = std::move(nodeQueryUPtr);
-    m_leafName = leafName;
+    m_leaf.setName(leafName);
 }
 
 // =============================================================================
@@ -51,14 +54,14 @@ LeafQuery::~LeafQuery()
 // (public)
 const std::string &LeafQuery::valueName() const
 {
-    return m_leafName;
+    return m_leaf.name();
 }
 
 // =============================================================================
 // (public)
 LeafQuerySPtr LeafQuery::setValueName(const std::string &leafName)
 {
-    m_leafName = leafName;
+    m_leaf.setName(leafName);
     return m_thisWPtr.lock();
 }
 
@@ -72,9 +75,9 @@ int LeafQuery::count(const Node &node)
 
 // =============================================================================
 // (public)
-const Leaf &LeafQuery::leaf(const Node &node, int index) const
+Leaf LeafQuery::leaf(const Node &node, int index) const
 {
-    ASSERT(!m_leafName.empty());
+    ASSERT(!m_leaf.isNull());
 
     int i = 0;
     auto it = iterator(node);
@@ -89,19 +92,21 @@ const Leaf &LeafQuery::leaf(const Node &node, int index) const
 // (public)
 void LeafQuery::getValueList(const Node &node, std::vector<UnionValue> &valueList) const
 {
-    ASSERT(!m_leafName.empty());
+    ASSERT(!m_leaf.isNull());
 
     if (m_nodeQueryPtr) {
         auto it = m_nodeQueryPtr->iterator(node);
         while (it->next()) {
             auto tempNode = it->node();
-            if (tempNode.hasLeaf(m_leafName)) {
-                valueList.push_back(tempNode.leaf(m_leafName).value());
+            int leafIndex = m_leaf.index(tempNode.def());
+            if (leafIndex != -1) {
+                valueList.push_back(tempNode.leafAt(leafIndex).value());
             }
         }
     } else {
-        if (node.hasLeaf(m_leafName)) {
-            valueList.push_back(node.leaf(m_leafName).value());
+        int leafIndex = m_leaf.index(node.def());
+        if (leafIndex != -1) {
+            valueList.push_back(node.leafAt(leafIndex).value());
         }
     }
 }
@@ -115,11 +120,41 @@ std::vector<UnionValue> LeafQuery::valueList(const Node &node) const
     return valueList;
 }
 
+// =============================================================================
+// (public)
+std::vector<UnionValue> LeafQuery::valueListParallel(const Node &node, ThreadPool &pool) const
+{
+    ASSERT(!m_leaf.isNull());
+
+    if (!m_nodeQueryPtr) { return valueList(node); }
+
+    // Every range has its own values and its own leaf handle as the handle caches the last index
+    std::vector<std::vector<UnionValue>> rangeValueList;
+    std::vector<LeafHandle> rangeLeafList;
+    m_nodeQueryPtr->forEachRangeParallel(node, [&](int rangeCount) {
+        rangeValueList.resize(static_cast<vSize>(rangeCount));
+        rangeLeafList.assign(static_cast<vSize>(rangeCount), m_leaf);
+    }, [&](int range, const Node &tempNode) {
+        const vSize r = static_cast<vSize>(range);
+        int leafIndex = rangeLeafList[r].index(tempNode.def());
+        if (leafIndex != -1) {
+            rangeValueList[r].push_back(tempNode.leafAt(leafIndex).value());
+        }
+    }, pool);
+
+    std::vector<UnionValue> valueList;
+    for (std::vector<UnionValue> &values: rangeValueList)
+    {
+        valueList.insert(valueList.end(), std::make_move_iterator(values.begin()), std::make_move_iterator(values.end()));
+    }
+    return valueList;
+}
+
 // =============================================================================
 // (public)
 void LeafQuery::getValue(const Node &node, int index, UnionValue value) const
 {
-    ASSERT(!m_leafName.empty());
+    ASSERT(!m_leaf.isNull());
 
     if (m_nodeQueryPtr) {
         int i = 0;
@@ -127,8 +162,9 @@ void LeafQuery::getValue(const Node &node, int index, UnionValue value) const
         while (it->next()) {
             if (i == index) {
                 auto tempNode = it->node();
-                if (tempNode.hasLeaf(m_leafName)) {
-                    node.leaf(m_leafName).getValue(value);
+                int leafIndex = m_leaf.index(tempNode.def());
+                if (leafIndex != -1) {
+                    tempNode.leafAt(leafIndex).getValue(value);
                 }
                 return;
             }
@@ -137,8 +173,9 @@ void LeafQuery::getValue(const Node &node, int index, UnionValue value) const
         ASSERT(false);
     } else {
         ASSERT(index == 0);
-        if (node.hasLeaf(m_leafName)) {
-            node.leaf(m_leafName).getValue(value);
+        int leafIndex = m_leaf.index(node.def());
+        if (leafIndex != -1) {
+            node.leafAt(leafIndex).getValue(value);
         }
     }
 }
@@ -165,6 +202,16 @@ const NodeQuery &LeafQuery::nodeQuery() const
     return *m_nodeQueryPtr.get();
 }
 
+// =============================================================================
+// (public)
+LeafQuerySPtr LeafQuery::duplicate() const
+{
+    if (m_nodeQueryPtr) {
+        return create(QueryBuilder::duplicate(m_nodeQueryPtr), m_leaf.name());
+    }
+    return create(m_leaf.name());
+}
+
 // =============================================================================
 // (public static)
 LeafQuerySPtr LeafQuery::create(const std::string &valueName)
@@ -227,7 +274,6 @@ LeafQuery::Iterator::Iterator(const LeafQuery &leafQuery, const Node *refNode)
 LeafQuery::Iterator::~Iterator()
 {
     m_leafQuery = nullptr;
-    NodeQuery::Iterator::~Iterator();
 }
 
 // =============================================================================
@@ -239,10 +285,10 @@ void LeafQuery::Iterator::getValue(UnionValue value) const
 
 // =============================================================================
 // (public)
-const Leaf &LeafQuery::Iterator::leaf() const
+Leaf LeafQuery::Iterator::leaf() const
 {
-    ASSERT(!m_leafQuery->m_leafName.empty());
-    return this->node().leaf(m_leafQuery->m_leafName);
+    ASSERT(!m_leafQuery->m_leaf.isNull());
+    return this->node().leaf(m_leafQuery->m_leaf);
 }
 
 } // namespace Oak::Model
@@ -42,12 +42,17 @@ public:
     const std::string &valueName() const;
     LeafQuerySPtr setValueName(const std::string &leafName);
 
+    const LeafHandle &leafHandle() const { return m_leaf; }
+
     int count(const Node &node);
 
-    const Leaf &leaf(const Node &node, int index) const;
+    Leaf leaf(const Node &node, int index) const;
 
     void getValueList(const Node &node, std::vector<UnionValue> &valueList) const;
     std::vector<UnionValue> valueList(const Node &node) const;
+    // Returns the same values as valueList() but the nodes are traversed on
+    //  the threads of 'pool' (See NodeQuery::forEachParallel())
+    std::vector<UnionValue> valueListParallel(const Node &node, ThreadPool &pool = ThreadPool::global()) const;
 
     void getValue(const Node &node, int index, UnionValue value) const;
 
@@ -60,13 +65,17 @@ public:
 
     std::vector<Node> toNodeList(const Node &node);
 
+    bool hasNodeQuery() const { return static_cast<bool>(m_nodeQueryPtr); }
     const NodeQuery &nodeQuery() const;
 
+    // Returns a copy with its own copy of the node query
+    LeafQuerySPtr duplicate() const;
+
     static LeafQuerySPtr create(const std::string &valueName = "");
     static LeafQuerySPtr create(NodeQueryUPtr nodeQueryUPtr, const std::string &leafName = "");
 
 protected:
-    std::string m_leafName;
+    LeafHandle m_leaf;
     NodeQueryUPtr m_nodeQueryPtr = NodeQueryUPtr();
 
     LeafQueryWPtr m_thisWPtr;
@@ -85,7 +94,7 @@ public:
         template<typename T>
         T value() const;
 
-        const Leaf &leaf() const;
+        Leaf leaf() const;
 
     protected:
         const LeafQuery *m_leafQuery;
@@ -106,7 +115,7 @@ public:
 template<typename T>
 T LeafQuery::value(const Node &node, int index) const
 {
-    assert(!m_leafName.empty());
+    assert(!m_leaf.isNull());
 
     if (m_nodeQueryPtr) {
 
@@ -115,8 +124,9 @@ T LeafQuery::value(const Node &node, int index) const
         while(it->next()) {
             if (i == index) {
                 auto tempNode = it->node();
-                if (tempNode.hasLeaf(m_leafName)) {
-                    return node.leaf(m_leafName).value<T>();
+                int leafIndex = m_leaf.index(tempNode.def());
+                if (leafIndex != -1) {
+                    return tempNode.leafAt(leafIndex).value<T>();
                 }
                 return T();
             }
@@ -125,8 +135,9 @@ T LeafQuery::value(const Node &node, int index) const
         assert(false);
     } else {
         assert(index == 0);
-        if (node.hasLeaf(m_leafName)) {
-            return node.leaf(m_leafName).value<T>();
+        int leafIndex = m_leaf.index(node.def());
+        if (leafIndex != -1) {
+            return node.leafAt(leafIndex).value<T>();
         }
     }
     return T();
@@ -137,20 +148,22 @@ T LeafQuery::value(const Node &node, int index) const
 template<typename T>
 std::vector<T> LeafQuery::toValueList(const Node &node)
 {
-    assert(!m_leafName.empty());
+    assert(!m_leaf.isNull());
 
     std::vector<T> valueList;
     if (m_nodeQueryPtr) {
         auto it = m_nodeQueryPtr->iterator(node);
         while (it->next()) {
             Node tempNode = it->node();
-            if (tempNode.hasLeaf(m_leafName)) {
-                valueList.push_back(tempNode.leaf(m_leafName).value<T>());
+            int leafIndex = m_leaf.index(tempNode.def());
+            if (leafIndex != -1) {
+                valueList.push_back(tempNode.leafAt(leafIndex).value<T>());
             }
         }
     } else {
-        if (node.hasLeaf(m_leafName)) {
-            valueList.push_back(node.leaf(m_leafName).value<T>());
+        int leafIndex = m_leaf.index(node.def());
+        if (leafIndex != -1) {
+            valueList.push_back(node.leafAt(leafIndex).value<T>());
         }
     }
 
@@ -34,7 +34,7 @@ namespace Oak::Model {
 ModelDesignDef::ModelDesignDef()
     : NodeDef("Design")
 {
-    m_tagName = "Design";
+    m_tagName = XML::NameId("Design");
 }
 
 // =============================================================================
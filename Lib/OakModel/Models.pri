@@ -1,5 +1,7 @@
 SOURCES += \
-    $$PWD/OakModel.cpp
+    $$PWD/OakModel.cpp \
+    $$PWD/ReadWriteLock.cpp
 
 HEADERS += \
-    $$PWD/OakModel.h
+    $$PWD/OakModel.h \
+    $$PWD/ReadWriteLock.h
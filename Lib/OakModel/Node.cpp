@@ -19,8 +19,10 @@
 #include "Node.h"
 
 #include <algorithm>
+#include <type_traits>
 
 #include "OakModel.h"
+#include "NodePath.h"
 #include "LeafQuery.h"
 #include "OakModelServiceFunctions.h"
 #include "QueryBuilder.h"
@@ -29,6 +31,8 @@
 
 namespace Oak::Model {
 
+static_assert(std::is_trivially_copyable<Node>::value, "Node is copied as a plain value");
+
 // =============================================================================
 // (public)
 Node::Node()
@@ -54,62 +58,6 @@ Node::Node(const NodeDef* nodeDef, const NodeData &nodeData, const OakModel* mod
     }
 }
 
-// =============================================================================
-// (public)
-Node::Node(const Node& copy)
-    : m_def(copy.m_def),
-      m_nodeData(copy.m_nodeData),
-      m_model(copy.m_model),
-      m_leafList(copy.m_leafList)
-{
-
-}
-
-// =============================================================================
-// (public)
-Node::Node(Node &&move)
-    : m_def(std::move(move.m_def)),
-      m_nodeData(std::move(move.m_nodeData)),
-      m_model(move.m_model),
-      m_leafList(std::move(move.m_leafList))
-{
-
-}
-
-// =============================================================================
-// (public)
-Node& Node::operator=(const Node& copy)
-{
-    m_nodeData = copy.m_nodeData;
-    m_model = copy.m_model;
-
-    if (m_def == copy.m_def) {  // NodeDef is the same: Leaf list is still valid
-        if (!m_leafList.empty()) { // Leaf list is initialized
-            // Update node for leaf lists
-            for (auto &leaf: m_leafList) {
-                leaf.m_nodeData = m_nodeData;
-            }
-        }
-    } else {
-        m_leafList.assign(copy.m_leafList.begin(), copy.m_leafList.end());
-    }
-
-    m_def = copy.m_def;
-
-    return *this;
-}
-
-// =============================================================================
-// (public)
-Node& Node::operator=(Node&& move)
-{
-    m_leafList = std::move(move.m_leafList);
-    m_def = std::move(move.m_def);
-    m_nodeData = std::move(move.m_nodeData);
-    m_model = move.m_model;
-    return *this;
-}
-
 // =============================================================================
 // (public)
 bool Node::operator==(const Node& _node) const
@@ -126,7 +74,7 @@ bool Node::operator!=(const Node& _node) const
 
 // =============================================================================
 // (public)
-const Leaf& Node::operator()(const std::string &valueName) const
+Leaf Node::operator()(const std::string &valueName) const
 {
     return leaf(valueName);
 }
@@ -166,7 +114,6 @@ void Node::clear()
     m_def = nullptr;
     m_nodeData.clear();
     m_model = nullptr;
-    m_leafList.clear();
 }
 
 // =============================================================================
@@ -190,11 +137,11 @@ void Node::setCurrent()
 // (public)
 std::vector<std::string> Node::valueNameList() const
 {
-    initLeafList();
     std::vector<std::string> nameList;
-    for (const Leaf& iv: m_leafList)
+    int count = leafCount();
+    for (int i = 0; i < count; i++)
     {
-        nameList.push_back(iv.name());
+        nameList.push_back(m_def->value(i).name());
     }
     return nameList;
 }
@@ -218,8 +165,8 @@ std::vector<std::string> Node::childNameList() const
 // (public)
 int Node::leafCount() const
 {
-    initLeafList();
-    return static_cast<int>(m_leafList.size());
+    if (!m_def || m_nodeData.isNull()) { return 0; }
+    return m_def->valueCount();
 }
 
 // =============================================================================
@@ -233,91 +180,45 @@ bool Node::hasLeaf(const std::string &leafName) const
 // (public)
 int Node::leafIndex(const Leaf &leaf) const
 {
-    initLeafList();
-    auto it = std::find(m_leafList.begin(), m_leafList.end(), leaf);
-    if (it == m_leafList.end()) {
-        return -1;
-    } else {
-        return static_cast<int>(std::distance(m_leafList.begin(), it));
-    }
-}
-
-// =============================================================================
-// (public)
-const Leaf& Node::leafAt(int index) const
-{
-    initLeafList();
-    if (index < 0 || index >= static_cast<int>(m_leafList.size())) { return Leaf::emptyLeaf(); }
-    return m_leafList.at(static_cast<vSize>(index));
+    if (!m_def || m_nodeData.isNull() || leaf.m_nodeData != m_nodeData) { return -1; }
+    return m_def->valueIndex(leaf.m_def);
 }
 
 // =============================================================================
 // (public)
-Leaf &Node::leafAt(int index)
+Leaf Node::leafAt(int index) const
 {
-    initLeafList();
-    if (index < 0 || index >= static_cast<int>(m_leafList.size())) { return Leaf::emptyLeaf(); }
-    return m_leafList.at(static_cast<vSize>(index));
+    if (index < 0 || index >= leafCount()) { return Leaf::emptyLeaf(); }
+    return Leaf(&m_def->value(index), m_nodeData, *this);
 }
 
 // =============================================================================
 // (public)
-const Leaf& Node::leaf(const std::string &leafName) const
+Leaf Node::leaf(const std::string &leafName) const
 {
-    initLeafList();
-    for (const Leaf& iv: m_leafList)
-    {
-        if (iv.name() == leafName) {
-            return iv;
-        }
-    }
-    return Leaf::emptyLeaf();
+    if (!m_def) { return Leaf::emptyLeaf(); }
+    return leafAt(m_def->valueIndex(leafName));
 }
 
 // =============================================================================
 // (public)
-Leaf &Node::leaf(const std::string &leafName)
+Leaf Node::leaf(const LeafHandle &handle) const
 {
-    initLeafList();
-    for (Leaf& iv: m_leafList)
-    {
-        if (iv.name() == leafName) {
-            return iv;
-        }
-    }
-    return Leaf::emptyLeaf();
+    return leafAt(handle.index(m_def));
 }
 
 // =============================================================================
 // (public)
-const Node::LeafIterator Node::leafBegin() const
+Node::LeafIterator Node::leafBegin() const
 {
-    initLeafList();
-    return m_leafList.begin();
+    return LeafIterator(this, 0);
 }
 
 // =============================================================================
 // (public)
-Node::LeafIterator Node::leafBegin()
+Node::LeafIterator Node::leafEnd() const
 {
-    initLeafList();
-    return m_leafList.begin();
-}
-
-// =============================================================================
-// (public)
-const Node::LeafIterator Node::leafEnd() const
-{
-    initLeafList();
-    return m_leafList.end();
-}
-
-// =============================================================================
-// (public)
-Node::LeafIterator Node::leafEnd()
-{
-    initLeafList();
-    return m_leafList.end();
+    return LeafIterator(this, leafCount());
 }
 
 // =============================================================================
@@ -330,10 +231,9 @@ bool Node::hasKey() const
 
 // =============================================================================
 // (public)
-const Leaf& Node::keyLeaf() const
+Leaf Node::keyLeaf() const
 {
-    initLeafList();
-    if (hasKey()) { return m_leafList[static_cast<vSize>(m_def->indexOfKeyLeafDef())]; }
+    if (hasKey()) { return leafAt(m_def->indexOfKeyLeafDef()); }
     return Leaf::emptyLeaf();
 }
 
@@ -347,10 +247,9 @@ bool Node::hasVariants() const
 
 // =============================================================================
 // (public)
-const Leaf& Node::variantLeaf() const
+Leaf Node::variantLeaf() const
 {
-    initLeafList();
-    if (hasVariants()) { return m_leafList[static_cast<vSize>(m_def->indexOfVariantLeafDef())]; }
+    if (hasVariants()) { return leafAt(m_def->indexOfVariantLeafDef()); }
     return Leaf::emptyLeaf();
 }
 
@@ -509,12 +408,13 @@ bool Node::canInsertChild(const std::string &name, int &index) const
 Node Node::insertChild(const std::string &name, int &index) const
 {
     ASSERT(m_def);
+    OakModel::WriteLock writeLock(m_model);
     const auto& container = m_def->container(name);
     if (m_model) {
         if (!container.canInsertNode(m_nodeData, index)) { return Node(); }
-        NodeIndexUPtr iIndex = NodeIndex::create(*this);
-        iIndex->lastNodeIndex().setChildNodeIndex(new NodeIndex(container.containerDef()->name(), index));
-        m_model->onNodeInserteBefore(*iIndex.get());
+        NodePath path = NodePath::create(*this);
+        path.append(container.containerDef()->nameId(), index);
+        m_model->onNodeInserteBefore(path);
     }
 
     NodeData nodeData = container.insertNode(m_nodeData, index);
@@ -522,8 +422,7 @@ Node Node::insertChild(const std::string &name, int &index) const
 
     Node childNode(container.containerDef(), nodeData, m_model);
     if (m_model && !childNode.isNull()) {
-        NodeIndexUPtr iIndex = NodeIndex::create(childNode);
-        m_model->onNodeInserteAfter(*iIndex.get());
+        m_model->onNodeInserteAfter(NodePath::create(childNode));
     }
     return childNode;
 }
@@ -549,15 +448,16 @@ bool Node::canCloneChild(const std::string &name, int &index, const Node &cloneN
 Node Node::cloneChild(int& index, const Node &cloneNode) const
 {
     ASSERT(m_def);
+    OakModel::WriteLock writeLock(m_model);
     if (m_model) {
         // Cash data needed to notify change
-        NodeIndexUPtr sourceNodeIndex = NodeIndex::create(cloneNode);
+        NodePath sourceNodePath = NodePath::create(cloneNode);
 
         {
             if (!m_def->containerGroup().canCloneNode(m_nodeData, index, cloneNode.nodeData())) { return Node(); }
-            NodeIndexUPtr targetNodeIndex = NodeIndex::create(*this);
-            targetNodeIndex->lastNodeIndex().setChildNodeIndex(new NodeIndex(index));
-            m_model->onNodeCloneBefore(*sourceNodeIndex.get(), *targetNodeIndex.get());
+            NodePath targetNodePath = NodePath::create(*this);
+            targetNodePath.append(-1, index);
+            m_model->onNodeCloneBefore(sourceNodePath, targetNodePath);
         }
 
         // Perform the cloneing
@@ -565,8 +465,7 @@ Node Node::cloneChild(int& index, const Node &cloneNode) const
 
         // Notify everyone if cloning did not fail
         if (!node.isNull()) {
-            NodeIndexUPtr targetNodeIndex = NodeIndex::create(node);
-            m_model->onNodeCloneAfter(*sourceNodeIndex.get(), *targetNodeIndex.get());
+            m_model->onNodeCloneAfter(sourceNodePath, NodePath::create(node));
         }
         updateUniqueValues(node);
 
@@ -581,15 +480,16 @@ Node Node::cloneChild(int& index, const Node &cloneNode) const
 Node Node::cloneChild(const std::string &name, int &index, const Node &cloneNode) const
 {
     ASSERT(m_def);
+    OakModel::WriteLock writeLock(m_model);
     if (m_model) {
         // Cash data needed to notify change
-        NodeIndexUPtr sourceNodeIndex = NodeIndex::create(cloneNode);
+        NodePath sourceNodePath = NodePath::create(cloneNode);
         const ContainerDef &container = m_def->container(name);
         {
             if (!container.canCloneNode(m_nodeData, index, cloneNode.nodeData())) { return Node(); }
-            NodeIndexUPtr targetNodeIndex = NodeIndex::create(*this);
-            targetNodeIndex->lastNodeIndex().setChildNodeIndex(new NodeIndex(container.containerDef()->name(), index));
-            m_model->onNodeCloneBefore(*sourceNodeIndex.get(), *targetNodeIndex.get());
+            NodePath targetNodePath = NodePath::create(*this);
+            targetNodePath.append(container.containerDef()->nameId(), index);
+            m_model->onNodeCloneBefore(sourceNodePath, targetNodePath);
         }
 
         // Perform the cloneing
@@ -597,8 +497,7 @@ Node Node::cloneChild(const std::string &name, int &index, const Node &cloneNode
 
         // Notify everyone if cloning did not fail
         if (!node.isNull()) {
-            NodeIndexUPtr targetNodeIndex = NodeIndex::create(node);
-            m_model->onNodeCloneAfter(*sourceNodeIndex.get(), *targetNodeIndex.get());
+            m_model->onNodeCloneAfter(sourceNodePath, NodePath::create(node));
         }
         updateUniqueValues(node);
 
@@ -608,6 +507,34 @@ Node Node::cloneChild(const std::string &name, int &index, const Node &cloneNode
     }
 }
 
+// =============================================================================
+// (public)
+Node Node::insertChildCopy(const std::string &name, int &index, const NodeData &copyData) const
+{
+    ASSERT(m_def);
+    OakModel::WriteLock writeLock(m_model);
+    const ContainerDef &container = m_def->container(name);
+    if (copyData.isNull() || !container.canInsertNode(m_nodeData, index)) { return Node(); }
+    if (m_model) {
+        NodePath path = NodePath::create(*this);
+        path.append(container.containerDef()->nameId(), index);
+        m_model->onNodeInserteBefore(path);
+    }
+
+    NodeData nodeData = container.insertNodeCopy(m_nodeData, index, copyData);
+
+    // The copy can be any variant of the container definition
+    Node childNode;
+    if (!nodeData.isNull()) {
+        const NodeDef *def = container.containerDef(nodeData);
+        childNode = Node(def ? def : container.containerDef(), nodeData, m_model);
+    }
+    if (m_model && !childNode.isNull()) {
+        m_model->onNodeInserteAfter(NodePath::create(childNode));
+    }
+    return childNode;
+}
+
 // =============================================================================
 // (public)
 bool Node::canMoveChild(int& index, const Node &moveNode) const
@@ -629,27 +556,28 @@ bool Node::canMoveChild(const std::string &name, int &index, const Node &moveNod
 Node Node::moveChild(int& index, const Node &moveNode) const
 {
     ASSERT(m_def);
+    OakModel::WriteLock writeLock(m_model);
     if (m_model) {
         // Check if node can be moved
         if (!m_def->containerGroup().canMoveNode(m_nodeData, index, moveNode.m_nodeData)) { return Node(); }
 
         // Cash data needed to notify change
-        NodeIndexUPtr sourceNodeIndex = NodeIndex::create(moveNode);
-        NodeIndexUPtr targetNodeIndex = NodeIndex::create(*this);
-        targetNodeIndex->setChildNodeIndex(new NodeIndex(index));
+        NodePath sourceNodePath = NodePath::create(moveNode);
+        NodePath targetNodePath = NodePath::create(*this);
+        targetNodePath.append(-1, index);
 
         // Notify before move
-        m_model->onNodeMoveBefore(*sourceNodeIndex.get(), *targetNodeIndex.get());
+        m_model->onNodeMoveBefore(sourceNodePath, targetNodePath);
 
         // Perform the move
         Node node = Node(moveNode.m_def, m_def->containerGroup().moveNode(m_nodeData, index, moveNode.m_nodeData), m_model);
 
         ASSERT(!node.isNull());
 
-        targetNodeIndex = NodeIndex::create(node);
+        targetNodePath = NodePath::create(node);
 
         // Notify after move
-        m_model->onNodeMoveAfter(*sourceNodeIndex.get(), *targetNodeIndex.get());
+        m_model->onNodeMoveAfter(sourceNodePath, targetNodePath);
 
         updateUniqueValues(node);
 
@@ -664,27 +592,28 @@ Node Node::moveChild(int& index, const Node &moveNode) const
 Node Node::moveChild(const std::string &name, int &index, const Node &moveNode) const
 {
     ASSERT(m_def);
+    OakModel::WriteLock writeLock(m_model);
     if (m_model) {
         // Check if node can be moved
         if (!m_def->container(name).canMoveNode(m_nodeData, index, moveNode.m_nodeData)) { return Node(); }
 
         // Cash data needed to notify change
-        NodeIndexUPtr sourceNodeIndex = NodeIndex::create(moveNode);
-        NodeIndexUPtr targetNodeIndex = NodeIndex::create(*this);
-        targetNodeIndex->setChildNodeIndex(new NodeIndex(name, index));
+        NodePath sourceNodePath = NodePath::create(moveNode);
+        NodePath targetNodePath = NodePath::create(*this);
+        targetNodePath.append(name, index);
 
         // Notify before move
-        m_model->onNodeMoveBefore(*sourceNodeIndex.get(), *targetNodeIndex.get());
+        m_model->onNodeMoveBefore(sourceNodePath, targetNodePath);
 
         // Perform the move
         Node node = Node(moveNode.m_def, m_def->container(name).moveNode(m_nodeData, index, moveNode.m_nodeData), m_model);
 
         ASSERT(!node.isNull());
 
-        targetNodeIndex = NodeIndex::create(node);
+        targetNodePath = NodePath::create(node);
 
         // Notify after move
-        m_model->onNodeMoveAfter(*sourceNodeIndex.get(), *targetNodeIndex.get());
+        m_model->onNodeMoveAfter(sourceNodePath, targetNodePath);
 
         updateUniqueValues(node);
 
@@ -715,16 +644,18 @@ bool Node::canRemoveChild(const std::string &name, int index) const
 bool Node::removeChild(int index) const
 {
     ASSERT(m_def);
+    OakModel::WriteLock writeLock(m_model);
     if (m_def->containerGroup().canRemoveNode(m_nodeData, index)) {
 
-        NodeIndexUPtr iIndex = NodeIndex::create(childAt(index));
+        NodePath path;
         if (m_model) {
-            m_model->onNodeRemoveBefore(*iIndex.get());
+            path = NodePath::create(childAt(index));
+            m_model->onNodeRemoveBefore(path);
         }
 
         m_def->containerGroup().removeNode(m_nodeData, index);
         if (m_model) {
-            m_model->onNodeRemoveAfter(*iIndex.get());
+            m_model->onNodeRemoveAfter(path);
         }
         return true;
     }
@@ -736,16 +667,18 @@ bool Node::removeChild(int index) const
 bool Node::removeChild(const std::string &name, int index) const
 {
     ASSERT(m_def);
+    OakModel::WriteLock writeLock(m_model);
     if (m_def->container(name).canRemoveNode(m_nodeData, index)) {
 
-        NodeIndexUPtr iIndex = NodeIndex::create(childAt(name, index));
+        NodePath path;
         if (m_model) {
-            m_model->onNodeRemoveBefore(*iIndex.get());
+            path = NodePath::create(childAt(name, index));
+            m_model->onNodeRemoveBefore(path);
         }
 
         m_def->container(name).removeNode(m_nodeData, index);
         if (m_model) {
-            m_model->onNodeRemoveAfter(*iIndex.get());
+            m_model->onNodeRemoveAfter(path);
         }
         return true;
     }
@@ -774,19 +707,6 @@ int Node::convertChildIndexToNamed(std::string &name, int index) const
     return childIndex(name, childNode);
 }
 
-// =============================================================================
-// (protected)
-void Node::initLeafList() const
-{
-    ASSERT(m_def);
-    if (m_leafList.empty() && m_def && !m_nodeData.isNull()) {
-        auto vList = m_def->valueList();
-        for (const LeafDef* vi: vList) {
-            m_leafList.push_back(Leaf(vi, m_nodeData, this));
-        }
-    }
-}
-
 // =============================================================================
 // (protected)
 void Node::updateUniqueValues(const Node &node)
@@ -817,5 +737,32 @@ void Node::updateUniqueValues(const Node &node)
     }
 }
 
+// =============================================================================
+// (public)
+Node::LeafIterator::LeafIterator(const Node *node, int index)
+    : m_node(node),
+      m_index(index)
+{
+    if (m_node) { m_leaf = m_node->leafAt(m_index); }
+}
+
+// =============================================================================
+// (public)
+Node::LeafIterator &Node::LeafIterator::operator++()
+{
+    m_index++;
+    m_leaf = m_node->leafAt(m_index);
+    return *this;
+}
+
+// =============================================================================
+// (public)
+Node::LeafIterator Node::LeafIterator::operator++(int)
+{
+    LeafIterator it = *this;
+    operator++();
+    return it;
+}
+
 } // namespace Oak::Model
 
@@ -18,9 +18,12 @@
 
 #pragma once
 
+#include <iterator>
+
 #include "NodeData.h"
 #include "NodeDef.h"
 #include "Leaf.h"
+#include "LeafHandle.h"
 
 
 namespace Oak::Model {
@@ -30,21 +33,24 @@ class OakModel;
 // =============================================================================
 // Class definition
 // =============================================================================
+// A node is a small value that refers to its data and definition. Leafs are not
+// stored in the node but made from the flattened 'LeafDef' list of its definition
+// when they are accessed, so nodes are cheap to copy and return by value.
 class Node
 {
 public:
     Node();
     Node(const NodeDef* def, const NodeData &nodeData, const OakModel* model = nullptr);
-    Node(const Node &copy);
-    Node(Node&& move);
+    Node(const Node &copy) = default;
+    Node(Node&& move) = default;
 
-    Node& operator=(const Node& copy);
-    Node& operator=(Node&& move);
+    Node& operator=(const Node& copy) = default;
+    Node& operator=(Node&& move) = default;
 
     bool operator==(const Node& _node) const;
     bool operator!=(const Node& _node) const;
 
-    const Leaf& operator()(const std::string &name) const;
+    Leaf operator()(const std::string &name) const;
 
     Node operator[](int index) const;
 
@@ -70,25 +76,46 @@ public:
     bool hasLeaf(const std::string &leafName) const;
     int leafIndex(const Leaf& leaf) const;
 
-    const Leaf& leafAt(int index) const;
-    Leaf& leafAt(int index);
+    Leaf leafAt(int index) const;
+
+    Leaf leaf(const std::string &leafName) const;
+    Leaf leaf(const LeafHandle &handle) const;
+
+    // Iterates the leafs of a node without storing them. The node must outlive the iterator
+    class LeafIterator
+    {
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef Leaf value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const Leaf* pointer;
+        typedef const Leaf& reference;
+
+        LeafIterator(const Node *node = nullptr, int index = 0);
 
-    const Leaf& leaf(const std::string &leafName) const;
-    Leaf& leaf(const std::string &leafName);
+        const Leaf& operator*() const { return m_leaf; }
+        const Leaf* operator->() const { return &m_leaf; }
 
-    typedef std::vector<Leaf>::const_iterator LeafIterator;
+        LeafIterator& operator++();
+        LeafIterator operator++(int);
 
-    const LeafIterator leafBegin() const;
-    Node::LeafIterator leafBegin();
+        bool operator==(const LeafIterator &it) const { return m_node == it.m_node && m_index == it.m_index; }
+        bool operator!=(const LeafIterator &it) const { return !operator==(it); }
 
-    const LeafIterator leafEnd() const;
-    LeafIterator leafEnd();
+    protected:
+        const Node *m_node;
+        int m_index;
+        Leaf m_leaf;
+    };
+
+    LeafIterator leafBegin() const;
+    LeafIterator leafEnd() const;
 
     bool hasKey() const;
-    const Leaf& keyLeaf() const;
+    Leaf keyLeaf() const;
 
     bool hasVariants() const;
-    const Leaf& variantLeaf() const;
+    Leaf variantLeaf() const;
 
     // ************* Child Node access *************
     int childCount() const;
@@ -126,6 +153,10 @@ public:
     Node cloneChild(int &index, const Node &cloneNode) const;
     Node cloneChild(const std::string &name, int &index, const Node &cloneNode) const;
 
+    // Inserts a copy of 'copyData' that does not have to be part of the model.
+    //  Unlike cloneChild() it is reported as an insert and unique values are kept
+    Node insertChildCopy(const std::string &name, int &index, const NodeData &copyData) const;
+
     bool canMoveChild(int &index, const Node &moveNode) const;
     bool canMoveChild(const std::string &name, int &index, const Node &moveNode) const;
 
@@ -144,16 +175,13 @@ public:
     int convertChildIndexToNamed(std::string &name, int index) const;
 
 protected:
-    inline void initLeafList() const;
-
     static void updateUniqueValues(const Node &node);
 
 protected:
     const NodeDef* m_def;
     NodeData m_nodeData;
     const OakModel* m_model;
-
-    mutable std::vector<Leaf> m_leafList;
+    friend class Leaf;
 };
 
 } // namespace Oak::Model
@@ -49,38 +49,6 @@ NodeData::NodeData(void *dataPointer, NodeData::Type type)
     }
 }
 
-// =============================================================================
-// (public)
-NodeData::NodeData(const NodeData &copy)
-{
-    memcpy(this, &copy, sizeof(NodeData));
-}
-
-// =============================================================================
-// (public)
-NodeData::NodeData(NodeData &&move)
-{
-    memcpy(this, &move, sizeof(NodeData));
-    move.m_type = Type::UNDEFINED;
-}
-
-// =============================================================================
-// (public)
-NodeData &NodeData::operator=(const NodeData &copy)
-{
-    memcpy(this, &copy, sizeof(NodeData));
-    return *this;
-}
-
-// =============================================================================
-// (public)
-NodeData &NodeData::operator=(NodeData &&move)
-{
-    memcpy(this, &move, sizeof(NodeData));
-    move.m_type = Type::UNDEFINED;
-    return *this;
-}
-
 // =============================================================================
 // (public)
 bool NodeData::operator==(const NodeData &_node) const
@@ -169,6 +137,27 @@ void *NodeData::internalPtr() const
     return nullptr;
 }
 
+// =============================================================================
+// (public)
+bool NodeData::isSameDocument(const NodeData &_node) const
+{
+    if (m_type != _node.m_type) { return false; }
+
+    switch (m_type) {
+    case Type::UNDEFINED:
+        return false;
+#ifdef XML_BACKEND
+    case Type::XML:
+        return m_xmlNode.isSameDocument(_node.m_xmlNode);
+#endif // XML_BACKEND
+    default:
+        // m_type contains an unhandled type that needs to be implemented
+        ASSERT(false);
+    }
+
+    return false;
+}
+
 #ifdef XML_BACKEND
 // =============================================================================
 // (public)
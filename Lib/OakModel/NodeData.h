@@ -35,13 +35,13 @@ public:
 
     NodeData();
     NodeData(void * internalPtr, Type type);
-    NodeData(const NodeData& copy);
-    NodeData(NodeData&& move);
+    NodeData(const NodeData& copy) = default;
+    NodeData(NodeData&& move) = default;
 
-    ~NodeData() {}
+    ~NodeData() = default;
 
-    NodeData& operator=(const NodeData& copy);
-    NodeData& operator=(NodeData&& move);
+    NodeData& operator=(const NodeData& copy) = default;
+    NodeData& operator=(NodeData&& move) = default;
 
     bool operator==(const NodeData& _node) const;
     bool operator!=(const NodeData& _node) const;
@@ -54,6 +54,9 @@ public:
 
     void * internalPtr() const;
 
+    // Returns true if both nodes are part of the same document
+    bool isSameDocument(const NodeData &_node) const;
+
 #ifdef XML_BACKEND
     NodeData(XML::Element _xmlNode);
     bool isXML() const;
@@ -20,6 +20,7 @@
 #include <functional>
 
 #include "NodeDef.h"
+#include "NodePath.h"
 #include "LeafDefBuilder.h"
 #include "LeafQuery.h"
 #include "OakModelServiceFunctions.h"
@@ -41,10 +42,11 @@ NodeDef::NodeDef(const std::string &_name)
     ASSERT(!_name.empty());
 
     m_name = _name;
+    m_nameId = NodePath::nameId(_name);
 
 #ifdef XML_BACKEND
     if (XML::Element::validateTagName(_name)) {
-        m_tagName = _name;
+        m_tagName = XML::NameId(_name);
     }
 #endif // XML_BACKEND
 }
@@ -57,11 +59,12 @@ NodeDef::NodeDef(const std::string &_name, const UnionRef &_variantId)
     ASSERT(!_variantId.isNull());
 
     m_name = _name;
+    m_nameId = NodePath::nameId(_name);
     m_variantId = _variantId;
 
 #ifdef XML_BACKEND
     if (XML::Element::validateTagName(_name)) {
-        m_tagName = _name;
+        m_tagName = XML::NameId(_name);
     }
 #endif // XML_BACKEND
 }
@@ -95,6 +98,7 @@ NodeDef &NodeDef::operator=(const NodeDef &copy)
     ASSERT(this != &copy);
 
     m_name = copy.m_name;
+    m_nameId = copy.m_nameId;
     m_tagName = copy.m_tagName;
     m_variantId = copy.m_variantId;
     m_displayName = copy.m_displayName;
@@ -114,6 +118,7 @@ NodeDef &NodeDef::operator=(const NodeDef &copy)
     }
     m_indexOfKeyLeafDef = copy.m_indexOfKeyLeafDef;
     m_indexOfVariantLeafDef = copy.m_indexOfVariantLeafDef;
+    clearLeafSlots();
 
     m_containerList.clear();
     for (const auto& container: copy.m_containerList) {
@@ -125,6 +130,9 @@ NodeDef &NodeDef::operator=(const NodeDef &copy)
     for (const ContainerDef* container: copy.m_parentContainerDefs) {
         m_parentContainerDefs.push_back(container);
     }
+
+    // The map of the copy points to the copy itself
+    updateVariantMap();
     return *this;
 }
 
@@ -133,9 +141,10 @@ NodeDef &NodeDef::operator=(const NodeDef &copy)
 NodeDef &NodeDef::operator=(NodeDef &&move)
 {
     m_name = std::move(move.m_name);
+    m_nameId = move.m_nameId;
     m_displayName = std::move(move.m_displayName);
     m_color = std::move(move.m_color);
-    m_tagName = std::move(move.m_tagName);
+    m_tagName = move.m_tagName;
     m_variantId = std::move(move.m_variantId);
 
     m_base = move.m_base;
@@ -144,11 +153,19 @@ NodeDef &NodeDef::operator=(NodeDef &&move)
     m_valueList = std::move(move.m_valueList);
     m_indexOfKeyLeafDef = move.m_indexOfKeyLeafDef;
     m_indexOfVariantLeafDef = move.m_indexOfVariantLeafDef;
+    m_leafSlotList = std::move(move.m_leafSlotList);
+    m_leafSlotMap = std::move(move.m_leafSlotMap);
+    m_leafSlotsValid = move.m_leafSlotsValid;
+    move.m_leafSlotsValid = false;
 
     m_containerList = std::move(move.m_containerList);
     m_containerGroup = std::move(move.m_containerGroup);
 
     m_parentContainerDefs = std::move(move.m_parentContainerDefs);
+
+    move.m_variantMap.clear();
+    move.m_variantKeyList.clear();
+    updateVariantMap();
     return *this;
 }
 
@@ -197,7 +214,7 @@ const std::string&NodeDef::tooltip() const
 // (public)
 const std::string& NodeDef::tagName() const
 {
-    return m_tagName;
+    return m_tagName.str();
 }
 #endif // XML_BACKEND
 
@@ -341,7 +358,7 @@ const NodeDef *NodeDef::validVariant(const NodeData &nodeData, bool includeBase,
     switch (nodeData.type()) {
 #ifdef XML_BACKEND
     case NodeData::Type::XML:
-        if (nodeData.xmlNode().compareTagName(tagName()) != 0) { return nullptr; }
+        if (!nodeData.xmlNode().hasTagName(m_tagName)) { return nullptr; }
         break;
 #endif // XML_BACKEND
     default:
@@ -362,12 +379,67 @@ const NodeDef *NodeDef::validVariant(const NodeData &nodeData, bool includeBase,
         return this;
     }
 
+    // Look up the variant id in the data without copying it
+    if (!includeBase && includeDerived && m_indexOfVariantLeafDef >= 0 && !m_variantMap.empty()) {
+        const LeafDef &leafDef = variantLeafDef();
+        const char *str = leafDef.valueCString(nodeData);
+        if (str == nullptr && leafDef.hasDefaultValue() && leafDef.defaultValue().type() == UnionType::String) {
+            str = leafDef.defaultValue().getCString().c_str();
+        }
+        if (str) {
+            auto it = m_variantMap.find(std::string_view(str));
+            if (it != m_variantMap.end()) {
+                return it->second;
+            }
+        }
+    }
+
     // Check if the part id of the variant type matches
     UnionValue variantId = variantLeafDef().value(nodeData);
 
     return validVariant(variantId, includeBase, includeDerived);
 }
 
+// =============================================================================
+// (protected)
+void NodeDef::updateVariantMap()
+{
+    m_variantMap.clear();
+    m_variantKeyList.clear();
+    if (!hasVariants()) { return; }
+
+    for (const NodeDef *variant: variantList(false, true))
+    {
+        std::string variantId;
+        if (!variant->variantId().get(variantId)) { continue; }
+        const NodeDef *validDef = validVariant(variant->variantId(), false, true);
+        if (validDef == nullptr) { continue; }
+
+        // The keys point to strings owned by the definition
+        m_variantKeyList.push_back(std::move(variantId));
+        m_variantMap.emplace(std::string_view(m_variantKeyList.back()), validDef);
+    }
+}
+
+// =============================================================================
+// (protected)
+void NodeDef::updateVariantMaps()
+{
+    NodeDef *root = this;
+    while (root->hasBase()) {
+        root = root->m_base.lock().get();
+    }
+
+    std::function<void(NodeDef*)> update = [&update](NodeDef *def) {
+        def->updateVariantMap();
+        for (const auto &dNodeDef: def->m_derivedList)
+        {
+            update(dNodeDef.get());
+        }
+    };
+    update(root);
+}
+
 // =============================================================================
 // (public)
 std::vector<const NodeDef *> NodeDef::variantList(bool includeBase, bool includeDerived) const
@@ -433,7 +505,7 @@ bool NodeDef::validate(const NodeData &_nodeData, bool includeBase, bool include
     switch (_nodeData.type()) {
 #ifdef XML_BACKEND
     case NodeData::Type::XML:
-        if (_nodeData.xmlNode().compareTagName(tagName()) != 0) { return false; }
+        if (!_nodeData.xmlNode().hasTagName(m_tagName)) { return false; }
         break;
 #endif // XML_BACKEND
     default:
@@ -511,6 +583,10 @@ ValidationState NodeDef::validationState(const NodeData &nodeData) const
 // (public)
 int NodeDef::valueCount(bool includeBase, bool includeDerived) const
 {
+    if (m_leafSlotsValid && includeBase && !includeDerived) {
+        return static_cast<int>(m_leafSlotList.size());
+    }
+
     int count = static_cast<int>(m_valueList.size());
 
     if (includeBase && hasBase()) {
@@ -531,6 +607,10 @@ int NodeDef::valueCount(bool includeBase, bool includeDerived) const
 // (public)
 bool NodeDef::hasValue(const std::string &valueName, bool includeBase, bool includeDerived) const
 {
+    if (m_leafSlotsValid && includeBase && !includeDerived) {
+        return m_leafSlotMap.find(valueName) != m_leafSlotMap.end();
+    }
+
     for (const auto &value: m_valueList) {
         if (value->name() == valueName) {
             return true;
@@ -559,6 +639,12 @@ bool NodeDef::hasValue(const std::string &valueName, bool includeBase, bool incl
 // (public)
 int NodeDef::valueIndex(const LeafDef *leafDef, bool includeBase, bool includeDerived) const
 {
+    if (m_leafSlotsValid && includeBase && !includeDerived) {
+        auto it = std::find(m_leafSlotList.begin(), m_leafSlotList.end(), leafDef);
+        if (it == m_leafSlotList.end()) { return -1; }
+        return static_cast<int>(std::distance(m_leafSlotList.begin(), it));
+    }
+
     int i = 0;
     for (const LeafDefUPtr &value: m_valueList)
     {
@@ -598,6 +684,11 @@ int NodeDef::valueIndex(const LeafDef *leafDef, bool includeBase, bool includeDe
 // (public)
 const LeafDef &NodeDef::value(int index, bool includeBase, bool includeDerived) const
 {
+    if (m_leafSlotsValid && includeBase && !includeDerived) {
+        if (index < 0 || index >= static_cast<int>(m_leafSlotList.size())) { return LeafDef::emptyDef(); }
+        return *m_leafSlotList[static_cast<vSize>(index)];
+    }
+
     if (includeBase && hasBase()) {
         int baseDefCount = m_base.lock()->valueCount(true, false);
         if (index < baseDefCount) {
@@ -630,6 +721,12 @@ const LeafDef &NodeDef::value(int index, bool includeBase, bool includeDerived)
 // (public)
 const LeafDef &NodeDef::value(const std::string &valueName, bool includeBase, bool includeDerived) const
 {
+    if (m_leafSlotsValid && includeBase && !includeDerived) {
+        auto it = m_leafSlotMap.find(valueName);
+        if (it == m_leafSlotMap.end()) { return LeafDef::emptyDef(); }
+        return *m_leafSlotList[static_cast<vSize>(it->second)];
+    }
+
     for (const auto &value: m_valueList) {
         if (value->name() == valueName) {
             return *value.get();
@@ -660,6 +757,11 @@ const LeafDef &NodeDef::value(const std::string &valueName, bool includeBase, bo
 // (public)
 LeafDef &NodeDef::value(int index, bool includeBase, bool includeDerived)
 {
+    if (m_leafSlotsValid && includeBase && !includeDerived) {
+        if (index < 0 || index >= static_cast<int>(m_leafSlotList.size())) { return LeafDef::emptyDef(); }
+        return *m_leafSlotList[static_cast<vSize>(index)];
+    }
+
     if (includeBase && hasBase()) {
         int baseDefCount = m_base.lock()->valueCount(true, false);
         if (index < baseDefCount) {
@@ -692,6 +794,12 @@ LeafDef &NodeDef::value(int index, bool includeBase, bool includeDerived)
 // (public)
 LeafDef &NodeDef::value(const std::string &valueName, bool includeBase, bool includeDerived)
 {
+    if (m_leafSlotsValid && includeBase && !includeDerived) {
+        auto it = m_leafSlotMap.find(valueName);
+        if (it == m_leafSlotMap.end()) { return LeafDef::emptyDef(); }
+        return *m_leafSlotList[static_cast<vSize>(it->second)];
+    }
+
     for (const auto &value: m_valueList) {
         if (value->name() == valueName) {
             return *value.get();
@@ -785,6 +893,76 @@ LeafDef& NodeDef::variantLeafDef()
     else { return value(m_indexOfVariantLeafDef); }
 }
 
+// =============================================================================
+// (public)
+int NodeDef::valueIndex(const std::string &valueName) const
+{
+    if (m_leafSlotsValid) {
+        auto it = m_leafSlotMap.find(valueName);
+        return (it == m_leafSlotMap.end()) ? -1 : it->second;
+    }
+
+    const LeafDef &leafDef = value(valueName);
+    if (leafDef.isNull()) { return -1; }
+    return valueIndex(&leafDef);
+}
+
+// =============================================================================
+// (protected)
+void NodeDef::updateLeafSlots()
+{
+    m_leafSlotList.clear();
+    m_leafSlotMap.clear();
+
+    // The base definitions are listed before this definition like in 'valueList()'
+    std::vector<NodeDef*> defList;
+    NodeDef *def = this;
+    while (def) {
+        defList.insert(defList.begin(), def);
+        def = def->m_base.lock().get();
+    }
+
+    std::vector<int> offsetList;
+    for (NodeDef *nodeDef: defList)
+    {
+        offsetList.push_back(static_cast<int>(m_leafSlotList.size()));
+        for (const auto &leafDef: nodeDef->m_valueList)
+        {
+            m_leafSlotList.push_back(leafDef.get());
+        }
+    }
+
+    // The first match searching from this definition towards the root wins like in 'value()'
+    for (vSize i = defList.size(); i > 0; i--)
+    {
+        int index = offsetList[i-1];
+        for (const auto &leafDef: defList[i-1]->m_valueList)
+        {
+            m_leafSlotMap.emplace(leafDef->name(), index++);
+        }
+    }
+    m_leafSlotsValid = true;
+
+    for (const auto &dNodeDef: m_derivedList)
+    {
+        dNodeDef->updateLeafSlots();
+    }
+}
+
+// =============================================================================
+// (protected)
+void NodeDef::clearLeafSlots()
+{
+    m_leafSlotList.clear();
+    m_leafSlotMap.clear();
+    m_leafSlotsValid = false;
+
+    for (const auto &dNodeDef: m_derivedList)
+    {
+        dNodeDef->clearLeafSlots();
+    }
+}
+
 // =============================================================================
 // (public)
 int NodeDef::containerCount(bool includeBase, bool includeDerived) const
@@ -24,8 +24,11 @@
 // =============================================================================
 
 
+#include <deque>
 #include <string>
+#include <string_view>
 #include <vector>
+#include <unordered_map>
 
 #include "NodeData.h"
 #include "NodeSettings.h"
@@ -80,12 +83,15 @@ public:
     bool isNull() const;
 
     const std::string &name() const;
+    /// Interned id of the 'name' used by 'NodePath'
+    int nameId() const { return m_nameId; }
     virtual std::string displayName(bool basic = false) const;
 
     const std::string& tooltip() const;
 
 #ifdef XML_BACKEND
     const std::string &tagName() const;
+    const XML::NameId &tagNameId() const { return m_tagName; }
 #endif // XML_BACKEND
 
     bool hasColor() const;
@@ -101,6 +107,7 @@ protected:
 
     /// The 'm_name' is a unike identifier for the node definition
     std::string m_name;
+    int m_nameId = -1;
     std::string m_displayName;
     std::string m_tooltip;
     Color m_color;
@@ -109,7 +116,7 @@ protected:
 
 #ifdef XML_BACKEND
     /// The 'm_tagName' is the name of the XMLElement tag that the definition controls
-    std::string m_tagName;
+    XML::NameId m_tagName;
 #endif // XML_BACKEND
 
 // *****************************************************************************
@@ -140,10 +147,20 @@ public:
     std::vector<const NodeDef *> variantList(bool includeBase = false, bool includeDerived = false) const;
     void getVariantList(std::vector<const NodeDef *> &vList, bool includeBase = false, bool includeDerived = false) const;
 
+protected:
+    void updateVariantMap();
+    void updateVariantMaps();
+
 protected:
     UnionValue m_variantId;
     NodeDefWPtr m_base = NodeDefWPtr();
     std::vector<NodeDefSPtr> m_derivedList;
+
+    /// Maps the variant id, as it is stored in the data, to the 'NodeDef' returned by 'validVariant()' when
+    /// derived definitions are included. It is built by the 'NodeDefBuilder' when variants are added and
+    /// values that are not found (e.g. only match after conversion) are validated the slow way.
+    std::unordered_map<std::string_view, const NodeDef*> m_variantMap;
+    std::deque<std::string> m_variantKeyList;
 // *****************************************************************************
 
 
@@ -183,10 +200,23 @@ public:
     LeafDef &variantLeafDef();
     int indexOfVariantLeafDef() const { return m_indexOfVariantLeafDef; }
 
+    /// Returns the index of the 'LeafDef' in 'valueList()' (base included) or -1 if it is not found
+    int valueIndex(const std::string &valueName) const;
+
+protected:
+    void updateLeafSlots();
+    void clearLeafSlots();
+
 protected:
     std::vector<LeafDefUPtr> m_valueList;
     int m_indexOfKeyLeafDef = -1;
     int m_indexOfVariantLeafDef = -1;
+
+    /// Flattened list of the 'LeafDef's of the base definitions and this definition with a name lookup.
+    /// It is built by the 'NodeDefBuilder' and the lookup falls back to searching the 'LeafDef's when it is not.
+    std::vector<LeafDef*> m_leafSlotList;
+    std::unordered_map<std::string, int> m_leafSlotMap;
+    bool m_leafSlotsValid = false;
 // *****************************************************************************
 
 
@@ -62,6 +62,7 @@ NodeDefBuilder::NodeDefBuilder(NodeDefSPtr variantRoot, const UnionRef &variantI
     // Adds the variant definition to the inheritance heiraki
     m_nodeDef->m_base = variantRoot;
     variantRoot->m_derivedList.push_back(m_nodeDef);
+    m_nodeDef->updateVariantMaps();
 
     // The name is the same for all definitions in the inheritance heiraki
     m_nodeDef->m_name = variantRoot->m_name;
@@ -127,6 +128,7 @@ NodeDefBuilderSPtr NodeDefBuilder::use(NodeDefSPtr nodeDef)
 NodeDefSPtr NodeDefBuilder::get()
 {
     ASSERT(m_nodeDef);
+    m_nodeDef->updateLeafSlots();
     return m_nodeDef;
 }
 
@@ -140,6 +142,7 @@ NodeDefBuilderSPtr NodeDefBuilder::addLeafDef(LeafDefBuilderSPtr leafDef)
     ASSERT(!m_nodeDef->hasValue(leafDef->leafDef().name()));
 
     m_nodeDef->m_valueList.push_back(leafDef->get());
+    m_nodeDef->clearLeafSlots();
 
     return m_thisWPtr.lock();
 }
@@ -274,7 +277,7 @@ NodeDefBuilderSPtr NodeDefBuilder::setTagName(const std::string &tagName)
 {
     ASSERT(m_nodeDef);
     ASSERT(XML::Element::validateTagName(tagName));
-    if (m_nodeDef->m_tagName == tagName) { return m_thisWPtr.lock(); }
+    if (m_nodeDef->m_tagName.str() == tagName) { return m_thisWPtr.lock(); }
 
     NodeDefSPtr baseRoot = m_nodeDef;
     while (baseRoot->hasBase()) {
@@ -316,8 +319,10 @@ LeafDefUPtr NodeDefBuilder::takeLeafDef(NodeDefSPtr nodeDef, const std::string &
         if ((*it)->name() == valueName) {
             LeafDefUPtr movedValue(std::move(*it));
             nodeDef->m_valueList.erase(it);
+            nodeDef->clearLeafSlots();
             return movedValue;
         }
+        it++;
     }
 
     return LeafDefUPtr();
@@ -378,7 +383,7 @@ void NodeDefBuilder::setVariantLeafDefForAllVariants(NodeDefSPtr nodeDef, int in
 // (protected)
 void NodeDefBuilder::setTagNameForAllVariants(NodeDefSPtr nodeDef, const std::string &tagName)
 {
-    nodeDef->m_tagName = tagName;
+    nodeDef->m_tagName = XML::NameId(tagName);
     if (nodeDef->hasDerived()) {
         for (NodeDefSPtr ni: nodeDef->m_derivedList)
         {
@@ -19,6 +19,7 @@
 #include "NodeIndex.h"
 
 #include "../ServiceFunctions/Assert.h"
+#include "../ServiceFunctions/Instrumentation.h"
 #include <sstream>
 
 namespace Oak::Model {
@@ -29,6 +30,7 @@ NodeIndex NodeIndex::s_nodeIndex = NodeIndex();
 // (public)
 NodeIndex::NodeIndex()
 {
+    OAK_COUNT(NodeIndexAllocation);
     m_index = -1;
     m_childIndex = nullptr;
 }
@@ -37,6 +39,7 @@ NodeIndex::NodeIndex()
 // (public)
 NodeIndex::NodeIndex(int index)
 {
+    OAK_COUNT(NodeIndexAllocation);
     m_index = index;
     m_childIndex = nullptr;
 }
@@ -45,6 +48,7 @@ NodeIndex::NodeIndex(int index)
 // (public)
 NodeIndex::NodeIndex(const std::string &name, int index)
 {
+    OAK_COUNT(NodeIndexAllocation);
     m_name = name;
     m_index = index;
     m_childIndex = nullptr;
@@ -54,6 +58,7 @@ NodeIndex::NodeIndex(const std::string &name, int index)
 // (public)
 NodeIndex::NodeIndex(const NodeIndex &nodeIndex)
 {
+    OAK_COUNT(NodeIndexAllocation);
     m_name = nodeIndex.m_name;
     m_index = nodeIndex.m_index;
     if (nodeIndex.m_childIndex) {
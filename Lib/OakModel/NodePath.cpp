@@ -0,0 +1,403 @@
+/*
+ * OakModelView (http://oakmodelview.com/)
+ * Author: Mikkel Nøhr Løvgreen (mikkel@oakmodelview.com)
+ * ------------------------------------------------------------------------
+ * Licensed to Vilaversoftware IVS who licenses this file to you under the
+ * Apache License, Version 2.0 (the "License"); you may not use this file
+ * except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "NodePath.h"
+
+#include <algorithm>
+#include <deque>
+#include <mutex>
+#include <sstream>
+#include <unordered_map>
+
+#include "../ServiceFunctions/Assert.h"
+
+
+namespace Oak::Model {
+
+// =============================================================================
+// (public)
+NodePath::NodePath()
+{
+}
+
+// =============================================================================
+// (public)
+NodePath::NodePath(const NodePath &copy)
+{
+    *this = copy;
+}
+
+// =============================================================================
+// (public)
+NodePath::NodePath(NodePath &&move)
+{
+    *this = std::move(move);
+}
+
+// =============================================================================
+// (public)
+NodePath &NodePath::operator=(const NodePath &copy)
+{
+    m_depth = copy.m_depth;
+    m_heapList = copy.m_heapList;
+    if (m_heapList.empty()) {
+        for (int i = 0; i < m_depth; i++)
+        {
+            m_inlineList[i] = copy.m_inlineList[i];
+        }
+    }
+    return *this;
+}
+
+// =============================================================================
+// (public)
+NodePath &NodePath::operator=(NodePath &&move)
+{
+    m_depth = move.m_depth;
+    m_heapList = std::move(move.m_heapList);
+    if (m_heapList.empty()) {
+        for (int i = 0; i < m_depth; i++)
+        {
+            m_inlineList[i] = move.m_inlineList[i];
+        }
+    }
+    move.m_depth = -1;
+    move.m_heapList.clear();
+    return *this;
+}
+
+// =============================================================================
+// (public)
+bool NodePath::operator==(const NodePath &other) const
+{
+    if (m_depth != other.m_depth) { return false; }
+    const Entry *e1 = data();
+    const Entry *e2 = other.data();
+    for (int i = 0; i < m_depth; i++)
+    {
+        if (e1[i] != e2[i]) { return false; }
+    }
+    return true;
+}
+
+// =============================================================================
+// (public)
+bool NodePath::operator!=(const NodePath &other) const
+{
+    return !(*this == other);
+}
+
+// =============================================================================
+// (public)
+const NodePath::Entry &NodePath::at(int level) const
+{
+    ASSERT(level >= 0 && level < m_depth);
+    return data()[level];
+}
+
+// =============================================================================
+// (public)
+const NodePath::Entry &NodePath::last() const
+{
+    ASSERT(m_depth > 0);
+    return data()[m_depth-1];
+}
+
+// =============================================================================
+// (public)
+const std::string &NodePath::name(int level) const
+{
+    return nameFromId(at(level).nameId);
+}
+
+// =============================================================================
+// (public)
+void NodePath::append(int nameId, int index)
+{
+    if (m_depth == -1) { m_depth = 0; }
+
+    if (m_heapList.empty() && m_depth < InlineDepth) {
+        m_inlineList[m_depth] = Entry{nameId, index};
+    } else {
+        if (m_heapList.empty()) {
+            m_heapList.assign(m_inlineList, m_inlineList + m_depth);
+        }
+        m_heapList.push_back(Entry{nameId, index});
+    }
+    m_depth++;
+}
+
+// =============================================================================
+// (public)
+void NodePath::append(const std::string &name, int index)
+{
+    append(name.empty() ? -1 : nameId(name), index);
+}
+
+// =============================================================================
+// (public)
+void NodePath::removeLast()
+{
+    if (m_depth <= 0) { return; }
+
+    m_depth--;
+    if (!m_heapList.empty()) {
+        m_heapList.pop_back();
+        if (m_depth == InlineDepth) {
+            for (int i = 0; i < m_depth; i++)
+            {
+                m_inlineList[i] = m_heapList[static_cast<vSize>(i)];
+            }
+            m_heapList.clear();
+        }
+    }
+}
+
+// =============================================================================
+// (public)
+void NodePath::setIndex(int level, int index)
+{
+    ASSERT(level >= 0 && level < m_depth);
+    data()[level].index = index;
+}
+
+// =============================================================================
+// (public)
+bool NodePath::contains(const NodePath &path) const
+{
+    if (isNull() || path.isNull() || m_depth < path.m_depth) { return false; }
+
+    const Entry *e1 = data();
+    const Entry *e2 = path.data();
+    for (int i = 0; i < path.m_depth; i++)
+    {
+        if (e1[i].nameId != e2[i].nameId) { return false; }
+        if (e1[i].index != -1 && e1[i].index != e2[i].index) { return false; }
+    }
+    return true;
+}
+
+// =============================================================================
+// (public)
+int NodePath::depthWhereEqual(const NodePath &path) const
+{
+    const Entry *e1 = data();
+    const Entry *e2 = path.data();
+    int count = std::min(m_depth, path.m_depth);
+    int d = 0;
+    while (d < count && e1[d] == e2[d]) {
+        d++;
+    }
+    return d;
+}
+
+// =============================================================================
+// (public)
+size_t NodePath::hash() const
+{
+    size_t h = static_cast<size_t>(m_depth + 1);
+    const Entry *e = data();
+    for (int i = 0; i < m_depth; i++)
+    {
+        h ^= std::hash<long long>()((static_cast<long long>(e[i].nameId) << 32) | static_cast<unsigned int>(e[i].index)) + 0x9e3779b9 + (h << 6) + (h >> 2);
+    }
+    return h;
+}
+
+// =============================================================================
+// (public)
+Node NodePath::node(const Node &rootNode, int depth) const
+{
+    if (isNull() || rootNode.isNull()) { return Node(); }
+    if (depth < 0 || depth > m_depth) { depth = m_depth; }
+
+    // Walks the definitions and data directly so only the returned node is created
+    const NodeDef *def = rootNode.def();
+    NodeData nodeData = rootNode.nodeData();
+    const Entry *e = data();
+    for (int i = 0; i < depth; i++)
+    {
+        const NodeDef *childDef = nullptr;
+        if (e[i].nameId == -1) {
+            nodeData = def->containerGroup().node(nodeData, e[i].index, &childDef);
+        } else {
+            nodeData = def->container(nameFromId(e[i].nameId)).node(nodeData, e[i].index, &childDef);
+        }
+        if (nodeData.isNull() || childDef == nullptr) { return Node(); }
+        def = childDef;
+    }
+    return Node(def, nodeData, rootNode.model());
+}
+
+// =============================================================================
+// (public)
+Node NodePath::nodeParent(const Node &rootNode) const
+{
+    if (m_depth <= 0) { return Node(); }
+    return node(rootNode, m_depth-1);
+}
+
+// =============================================================================
+// (public)
+NodeIndexUPtr NodePath::toNodeIndex() const
+{
+    if (m_depth <= 0) { return NodeIndexUPtr(new NodeIndex()); }
+
+    const Entry *e = data();
+    NodeIndex *cIndex = nullptr;
+    for (int i = m_depth-1; i >= 0; i--)
+    {
+        NodeIndex *pIndex = (e[i].nameId == -1) ? new NodeIndex(e[i].index) : new NodeIndex(nameFromId(e[i].nameId), e[i].index);
+        pIndex->setChildNodeIndex(cIndex);
+        cIndex = pIndex;
+    }
+    return NodeIndexUPtr(cIndex);
+}
+
+// =============================================================================
+// (public)
+std::string NodePath::toString() const
+{
+    std::stringstream ss;
+    const Entry *e = data();
+    for (int i = 0; i < m_depth; i++)
+    {
+        if (i > 0) { ss << ";"; }
+        if (e[i].nameId != -1) { ss << nameFromId(e[i].nameId); }
+        ss << "[" << e[i].index << "]";
+    }
+    return ss.str();
+}
+
+// =============================================================================
+// (public static)
+NodePath NodePath::create(const Node &node, bool namedIndex)
+{
+    NodePath path;
+    if (node.isNull()) { return path; }
+
+    // The entries are added from the node up to the root and reversed at the end
+    path.m_depth = 0;
+    const NodeDef *def = node.def();
+    NodeData nodeData = node.nodeData();
+    const NodeDef *parentDef = nullptr;
+    NodeData parentData = def->parentNode(nodeData, &parentDef);
+    while (!parentData.isNull()) {
+        int index;
+        if (namedIndex) {
+            index = parentDef->container(def->name()).nodeIndex(parentData, nodeData);
+        } else {
+            index = parentDef->containerGroup().nodeIndex(parentData, nodeData);
+        }
+        if (index == -1) { // If node is invalid (F.eks can be invalid after a move)
+            return NodePath();
+        }
+        path.append(namedIndex ? def->nameId() : -1, index);
+
+        def = parentDef;
+        nodeData = parentData;
+        parentData = def->parentNode(nodeData, &parentDef);
+    }
+
+    Entry *e = path.data();
+    std::reverse(e, e + path.m_depth);
+    return path;
+}
+
+// =============================================================================
+// (public static)
+NodePath NodePath::create(const NodeIndex &nodeIndex)
+{
+    NodePath path;
+    path.m_depth = 0;
+    if (nodeIndex.isNull()) { return path; }
+
+    const NodeIndex *ni = &nodeIndex;
+    while (ni) {
+        path.append(ni->name(), ni->index());
+        ni = ni->hasChildNodeIndex() ? &ni->childNodeIndex() : nullptr;
+    }
+    return path;
+}
+
+// =============================================================================
+// Name registry
+// =============================================================================
+
+struct NodePath::NameRegistry
+{
+    std::mutex mutex;
+    std::deque<std::string> nameList;
+    std::unordered_map<std::string, int> idMap;
+};
+
+// =============================================================================
+// (protected static)
+NodePath::NameRegistry &NodePath::nameRegistry()
+{
+    // Created on first use so definitions created during static initialization can use it
+    static NameRegistry registry;
+    return registry;
+}
+
+// =============================================================================
+// (public static)
+int NodePath::nameId(const std::string &name)
+{
+    if (name.empty()) { return -1; }
+
+    NameRegistry &registry = nameRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    auto it = registry.idMap.find(name);
+    if (it != registry.idMap.end()) { return it->second; }
+
+    int id = static_cast<int>(registry.nameList.size());
+    registry.nameList.push_back(name);
+    registry.idMap.emplace(name, id);
+    return id;
+}
+
+// =============================================================================
+// (public static)
+const std::string &NodePath::nameFromId(int nameId)
+{
+    static const std::string emptyName;
+    if (nameId < 0) { return emptyName; }
+
+    NameRegistry &registry = nameRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    ASSERT(nameId < static_cast<int>(registry.nameList.size()));
+    // Elements in a deque are not moved when new names are added
+    return registry.nameList[static_cast<vSize>(nameId)];
+}
+
+// =============================================================================
+// (protected)
+const NodePath::Entry *NodePath::data() const
+{
+    return m_heapList.empty() ? m_inlineList : m_heapList.data();
+}
+
+// =============================================================================
+// (protected)
+NodePath::Entry *NodePath::data()
+{
+    return m_heapList.empty() ? m_inlineList : m_heapList.data();
+}
+
+} // namespace Oak::Model
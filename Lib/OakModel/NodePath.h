@@ -0,0 +1,110 @@
+/*
+ * OakModelView (http://oakmodelview.com/)
+ * Author: Mikkel Nøhr Løvgreen (mikkel@oakmodelview.com)
+ * ------------------------------------------------------------------------
+ * Licensed to Vilaversoftware IVS who licenses this file to you under the
+ * Apache License, Version 2.0 (the "License"); you may not use this file
+ * except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <vector>
+#include <string>
+
+#include "Node.h"
+#include "NodeIndex.h"
+
+
+namespace Oak::Model {
+
+// =============================================================================
+// Class definition
+// =============================================================================
+// Compact value type version of 'NodeIndex' that holds the path as a flat list
+//  of (container name id, index) pairs. Paths up to 'InlineDepth' levels deep
+//  are stored without allocating.
+class NodePath
+{
+public:
+    struct Entry
+    {
+        int nameId; // -1 if the index is unnamed
+        int index;
+
+        bool operator==(const Entry &other) const { return nameId == other.nameId && index == other.index; }
+        bool operator!=(const Entry &other) const { return !(*this == other); }
+    };
+
+    NodePath();
+    NodePath(const NodePath &copy);
+    NodePath(NodePath &&move);
+
+    NodePath& operator=(const NodePath &copy);
+    NodePath& operator=(NodePath &&move);
+
+    bool operator==(const NodePath &other) const;
+    bool operator!=(const NodePath &other) const;
+
+    // A null path does not point to any node where an empty path points to the root node
+    bool isNull() const { return m_depth == -1; }
+    int depth() const { return m_depth; }
+
+    const Entry &at(int level) const;
+    const Entry &last() const;
+    const std::string &name(int level) const;
+
+    void append(int nameId, int index);
+    void append(const std::string &name, int index);
+    void removeLast();
+    void setIndex(int level, int index);
+
+    // Returns true if 'path' is the beginning of this path
+    bool contains(const NodePath &path) const;
+    int depthWhereEqual(const NodePath &path) const;
+
+    size_t hash() const;
+
+    Node node(const Node &rootNode, int depth = -1) const;
+    Node nodeParent(const Node &rootNode) const;
+
+    NodeIndexUPtr toNodeIndex() const;
+    std::string toString() const;
+
+    static NodePath create(const Node &node, bool namedIndex = true);
+    static NodePath create(const NodeIndex &nodeIndex);
+
+    // Container names are interned so the path only stores an int per level
+    static int nameId(const std::string &name);
+    static const std::string &nameFromId(int nameId);
+
+    struct Hash
+    {
+        size_t operator()(const NodePath &path) const { return path.hash(); }
+    };
+
+protected:
+    const Entry *data() const;
+    Entry *data();
+
+    struct NameRegistry;
+    static NameRegistry &nameRegistry();
+
+protected:
+    static const int InlineDepth = 8;
+
+    int m_depth = -1;
+    Entry m_inlineList[InlineDepth];
+    std::vector<Entry> m_heapList;
+};
+
+} // namespace Oak::Model
@@ -18,10 +18,18 @@
 
 #include "NodeQuery.h"
 #include "QueryBuilder.h"
+#include "OakModel.h"
 
+#ifdef XML_BACKEND
+#include "XMLListRef.h"
+#endif // XML_BACKEND
+
+#include <algorithm>
 #include <utility>
 #include <iterator>
 
+#include "../ServiceFunctions/Instrumentation.h"
+
 namespace Oak::Model {
 
 // =============================================================================
@@ -261,6 +269,59 @@ bool NodeQuery::removeNode(Node &refNode, int index)
     }
 }
 
+// =============================================================================
+// (public)
+void NodeQuery::forEachParallel(const Node &refNode, const std::function<void(const Node&)> &function, ThreadPool &pool) const
+{
+    forEachRangeParallel(refNode, [](int) {}, [&function](int, const Node &node) { function(node); }, pool);
+}
+
+// =============================================================================
+// (public)
+void NodeQuery::forEachRangeParallel(const Node &refNode,
+                                     const std::function<void(int rangeCount)> &prepare,
+                                     const std::function<void(int range, const Node&)> &function,
+                                     ThreadPool &pool) const
+{
+    OAK_SCOPED_TIMER("NodeQuery::forEachRangeParallel");
+    OakModel::ReadLock readLock(refNode.model());
+
+    // More ranges than threads lets the threads that finish early take over ranges
+    const size_t targetCount = static_cast<size_t>(pool.threadCount() + 1) * 4;
+
+    const NodeQueryUPtr *remainingQuery = nullptr;
+    std::vector<Node> nodeList = splitQuery(refNode, targetCount, remainingQuery);
+
+    const size_t rangeCount = std::min(nodeList.size(), targetCount);
+    prepare(static_cast<int>(rangeCount));
+    if (rangeCount == 0) { return; }
+
+    std::vector<ThreadPool::Task> taskList;
+    for (size_t range = 0; range < rangeCount; range++) {
+        const size_t begin = nodeList.size() * range / rangeCount;
+        const size_t end = nodeList.size() * (range + 1) / rangeCount;
+        taskList.push_back([&, range, begin, end]() {
+            OAK_SCOPED_TIMER("NodeQuery::forEachRangeParallel(range)");
+#ifdef XML_BACKEND
+            XML::ListRef::SharedRead sharedRead;
+#endif // XML_BACKEND
+            // Queries keep state while they are traversed so every range runs its own copy
+            NodeQueryUPtr query = *remainingQuery ? QueryBuilder::duplicate(*remainingQuery) : NodeQueryUPtr();
+            for (size_t i = begin; i < end; i++) {
+                if (query) {
+                    Iterator it(*query, &nodeList[i]);
+                    while (it.next()) {
+                        function(static_cast<int>(range), it.node());
+                    }
+                } else {
+                    function(static_cast<int>(range), nodeList[i]);
+                }
+            }
+        });
+    }
+    pool.run(taskList);
+}
+
 // =============================================================================
 // (protected)
 void NodeQuery::addChildQuery(NodeQueryUPtr query)
@@ -302,6 +363,32 @@ Node NodeQuery::next(const Node &refNode, const Node &cNode) const
     return Node();
 }
 
+// =============================================================================
+// (protected)
+std::vector<Node> NodeQuery::splitQuery(const Node &refNode, size_t minCount, const NodeQueryUPtr *&remainingQuery) const
+{
+    std::vector<Node> nodeList;
+    for (Node node = first(refNode); !node.isNull(); node = next(refNode, node)) {
+        nodeList.push_back(node);
+    }
+    remainingQuery = &m_childQueryUPtr;
+
+    while (*remainingQuery && !nodeList.empty() && nodeList.size() < minCount) {
+        const NodeQuery *query = remainingQuery->get();
+        std::vector<Node> childList;
+        for (const Node &parent: nodeList)
+        {
+            for (Node node = query->first(parent); !node.isNull(); node = query->next(parent, node)) {
+                childList.push_back(node);
+            }
+        }
+        nodeList.swap(childList);
+        remainingQuery = &query->m_childQueryUPtr;
+    }
+
+    return nodeList;
+}
+
 // =============================================================================
 // (protected)
 const NodeDef *NodeQuery::_nodeDef(const NodeDef *nDef) const
@@ -449,13 +536,13 @@ bool NodeQuery::Iterator::first(const Node &refNode)
         m_currentNode = *m_refNode;
     }
 
-    if (m_currentNode.isNull()) { return false; }
-
-    if (!m_childIterator) { return true; }
+    if (!m_childIterator) { return isValid(); }
 
-    if (m_childIterator->first(m_currentNode)) { return true; }
-
-    m_currentNode.clear();
+    // Moves on until the child query finds a node
+    while (!m_currentNode.isNull()) {
+        if (m_childIterator->first(m_currentNode)) { return true; }
+        m_currentNode = m_query ? m_query->next(*m_refNode, m_currentNode) : Node();
+    }
 
     return false;
 }
@@ -472,13 +559,13 @@ bool NodeQuery::Iterator::last(const Node &refNode)
         m_currentNode = *m_refNode;
     }
 
-    if (m_currentNode.isNull()) { return false; }
+    if (!m_childIterator) { return isValid(); }
 
-    if (!m_childIterator) { return true; }
-
-    if (m_childIterator->last(m_currentNode)) { return true; }
-
-    m_currentNode.clear();
+    // Moves on until the child query finds a node
+    while (!m_currentNode.isNull()) {
+        if (m_childIterator->last(m_currentNode)) { return true; }
+        m_currentNode = m_query ? m_query->previous(*m_refNode, m_currentNode) : Node();
+    }
 
     return false;
 }
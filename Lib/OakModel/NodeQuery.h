@@ -18,7 +18,10 @@
 
 #pragma once
 
+#include <functional>
+
 #include "Node.h"
+#include "ThreadPool.h"
 
 
 namespace Oak::Model {
@@ -58,9 +61,28 @@ public:
     virtual bool canRemoveNode(const Node &refNode, int index) const;
     virtual bool removeNode(Node &refNode, int index);
 
+    // Calls 'function' for every node found by the query. The nodes are split
+    //  into ranges of siblings that are traversed on the threads of 'pool', so
+    //  'function' is called concurrently and not in the order of the query.
+    //  The model of 'refNode' is read locked until all nodes are visited
+    void forEachParallel(const Node &refNode, const std::function<void(const Node&)> &function, ThreadPool &pool = ThreadPool::global()) const;
+
+    // Same as forEachParallel() but 'function' also gets the index of the range.
+    //  The ranges follow the order of the query and the nodes of a range are
+    //  visited in order by one thread. 'prepare' gets the number of ranges
+    //  before the traversal starts
+    void forEachRangeParallel(const Node &refNode,
+                              const std::function<void(int rangeCount)> &prepare,
+                              const std::function<void(int range, const Node&)> &function,
+                              ThreadPool &pool = ThreadPool::global()) const;
+
 protected:
     void addChildQuery(NodeQueryUPtr query);
 
+    // Runs the first levels of the query until at least 'minCount' nodes are found.
+    //  'remainingQuery' is set to the part of the query that is not run yet
+    std::vector<Node> splitQuery(const Node &refNode, size_t minCount, const NodeQueryUPtr *&remainingQuery) const;
+
     virtual Node first(const Node &refNode) const;
     virtual Node last(const Node &refNode) const;
     virtual Node next(const Node &refNode, const Node &cNode) const;
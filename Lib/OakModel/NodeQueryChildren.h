@@ -33,6 +33,8 @@ public:
     NodeQueryChildren(const NodeQueryChildren& copy);
     NodeQueryChildren(NodeQueryChildren&& move);
 
+    const std::string &nodeName() const { return m_nodeName; }
+
     virtual bool canInsertNode(const Node &refNode, int &index) const override;
     virtual Node insertNode(const Node &refNode, int index) const override;
 
@@ -47,8 +47,7 @@ NodeQuerySiblings::NodeQuerySiblings(NodeQuerySiblings &&move)
 // (protected)
 Node NodeQuerySiblings::first(const Node &refNode) const
 {
-    m_parent = refNode.parent();
-    Node sibling = m_parent.firstChild(refNode.def()->name());
+    Node sibling = refNode.parent().firstChild(refNode.def()->name());
 
     if (refNode == sibling) {
         // Skip self
@@ -62,8 +61,7 @@ Node NodeQuerySiblings::first(const Node &refNode) const
 // (protected)
 Node NodeQuerySiblings::last(const Node &refNode) const
 {
-    m_parent = refNode.parent();
-    Node sibling = m_parent.lastChild(refNode.def()->name());
+    Node sibling = refNode.parent().lastChild(refNode.def()->name());
 
     if (refNode == sibling) {
         // Skip self
@@ -77,7 +75,8 @@ Node NodeQuerySiblings::last(const Node &refNode) const
 // (protected)
 Node NodeQuerySiblings::next(const Node &refNode, const Node &cNode) const
 {
-    Node sibling = m_parent.nextChild(refNode.def()->name(), cNode);
+    // The parent is not kept between calls, so the query can be shared by reading threads
+    Node sibling = refNode.parent().nextChild(refNode.def()->name(), cNode);
 
     if (refNode == sibling) {
         // Skip self
@@ -91,7 +90,7 @@ Node NodeQuerySiblings::next(const Node &refNode, const Node &cNode) const
 // (protected)
 Node NodeQuerySiblings::previous(const Node &refNode, const Node &cNode) const
 {
-    Node sibling = m_parent.previousChild(refNode.def()->name(), cNode);
+    Node sibling = refNode.parent().previousChild(refNode.def()->name(), cNode);
 
     if (refNode == sibling) {
         // Skip self
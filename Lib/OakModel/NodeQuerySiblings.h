@@ -40,9 +40,6 @@ protected:
     virtual Node previous(const Node &refNode, const Node &cNode) const override;
 
     virtual const NodeDef * _nodeDef(const NodeDef *nDef) const override;
-
-protected:
-    mutable Node m_parent;
 };
 
 } // namespace Oak::Model
@@ -1,11 +1,15 @@
 HEADERS += \
     $$PWD/Leaf.h \
+    $$PWD/LeafHandle.h \
     $$PWD/Node.h \
     $$PWD/NodeIndex.h \
+    $$PWD/NodePath.h \
     $$PWD/NodeServiceFunctions.h
 
 SOURCES += \
     $$PWD/Leaf.cpp \
+    $$PWD/LeafHandle.cpp \
     $$PWD/Node.cpp \
     $$PWD/NodeIndex.cpp \
+    $$PWD/NodePath.cpp \
     $$PWD/NodeServiceFunctions.cpp
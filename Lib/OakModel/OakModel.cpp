@@ -19,11 +19,14 @@
 #include "OakModel.h"
 
 #include <list>
+#include <algorithm>
 #include <QDebug>
 
 #include "../ServiceFunctions/Trace.h"
+#include "../ServiceFunctions/Instrumentation.h"
 #include "NodeServiceFunctions.h"
 #include "OptionsObserver.h"
+#include "ObserverInterface.h"
 
 
 namespace Oak::Model {
@@ -68,11 +71,16 @@ bool OakModel::isNodeNull() const
 // (public)
 bool OakModel::createNewRootDocument(NodeData::Type backendType, bool setAsCurrent)
 {
+    WriteLock writeLock(this);
+
     if (m_rootNode.isDefNull()) {
         return false;
     }
 
     if (backendType == NodeData::Type::XML) {
+        // The new document element can get the address of the old one, so
+        //  the observers would not see that the root node is replaced
+        if (m_rootNode.nodeData() == m_rootNodeXML) { setRootNode(NodeData()); }
         m_xmlDoc.clear();
         NodeData documentNode(m_xmlDoc.appendChild(m_rootNode.def()->tagName()));
         m_rootNode.def()->onNodeInserted(documentNode);
@@ -124,6 +132,9 @@ void OakModel::setRootNodeDef(NodeDefSPtr def)
 // (public)
 void OakModel::setRootNodeDef(const NodeDef *def)
 {
+    OAK_SCOPED_TIMER("OakModel::setRootNodeDef");
+    WriteLock writeLock(this);
+
     if (m_rootNode.def() != def) {
         NodeData currentNode = m_currentNode.nodeData();
         // Clear the current node before it becomes invalid
@@ -134,6 +145,8 @@ void OakModel::setRootNodeDef(const NodeDef *def)
         // Update the root definition and trigger event
         m_rootNode = Node(def, m_rootNode.nodeData(), this);
 
+        updateNodeDefLookup();
+
         createObservers();
 
         notifier_rootNodeDefChanged.trigger();
@@ -153,9 +166,17 @@ void OakModel::setRootNodeDef(const NodeDef *def)
 // (public)
 void OakModel::setRootNode(const NodeData &nodeData)
 {
+    WriteLock writeLock(this);
+
     if (m_rootNode.nodeData() != nodeData) {
         setCurrentNode(Node());
         m_rootNode = Node(m_rootNode.def(), nodeData, this);
+        clearNodeDefCache();
+
+        for (ObserverInterface *observer: m_connectedObserverList)
+        {
+            observer->onRootNodeChanged();
+        }
 
         notifier_rootNodeDataChanged.trigger();
         setCurrentNode(rootNode());
@@ -192,18 +213,64 @@ const NodeIndex &OakModel::currentNodeIndex() const
 // (public)
 void OakModel::setCurrentNode(const Node &node, bool forceUpdate) const
 {
+    WriteLock writeLock(this);
+
     if (m_currentNode != node || forceUpdate) {
         m_currentNode = node;
-        m_currentNodeIndex = NodeIndex::create(m_currentNode);
+        m_currentNodePath = NodePath::create(m_currentNode);
+        m_currentNodeIndex = m_currentNodePath.isNull() ? NodeIndexUPtr() : m_currentNodePath.toNodeIndex();
         notifier_currentNodeChanged.trigger();
     }
 }
 
+// =============================================================================
+// (public)
+void OakModel::beginBatch() const
+{
+    // The write lock is held until the batch ends
+    lockWrite();
+
+    if (m_batchDepth == 0) {
+        for (ObserverInterface *observer: m_connectedObserverList)
+        {
+            observer->onBatchBegin();
+        }
+    }
+    m_batchDepth++;
+}
+
+// =============================================================================
+// (public)
+void OakModel::endBatch() const
+{
+    ASSERT(m_batchDepth > 0);
+    if (m_batchDepth <= 0) { return; }
+    m_batchDepth--;
+    if (m_batchDepth > 0) {
+        unlockWrite();
+        return;
+    }
+
+    OAK_SCOPED_TIMER("OakModel::endBatch");
+
+    for (ObserverInterface *observer: m_connectedObserverList)
+    {
+        observer->onBatchEnd();
+    }
+
+    notifier_batchEnd.trigger();
+    flushBatchChanges();
+
+    unlockWrite();
+}
+
 #ifdef XML_BACKEND
 // =============================================================================
 // (public)
 void OakModel::setRootNodeXML(const NodeData &rootNodeData, bool setAsCurrent)
 {
+    WriteLock writeLock(this);
+
     m_rootNodeXML = rootNodeData;
 
     if (setAsCurrent) { setRootNode(m_rootNodeXML); }
@@ -211,9 +278,14 @@ void OakModel::setRootNodeXML(const NodeData &rootNodeData, bool setAsCurrent)
 
 // =============================================================================
 // (public)
-bool OakModel::loadRootNodeXML(const std::string& filePath, bool setAsCurrent)
+bool OakModel::loadRootNodeXML(const std::string& filePath, bool setAsCurrent, XML::Document::LoadMode mode)
 {
-    if (!m_xmlDoc.load(filePath)) { return false; }
+    OAK_SCOPED_TIMER("OakModel::loadRootNodeXML");
+    WriteLock writeLock(this);
+
+    // The document is reset even if the file can not be loaded (See createNewRootDocument())
+    if (m_rootNode.nodeData() == m_rootNodeXML) { setRootNode(NodeData()); }
+    if (!m_xmlDoc.load(filePath, mode)) { return false; }
 
     m_xmlDocFilePath = filePath;
 
@@ -226,20 +298,37 @@ bool OakModel::loadRootNodeXML(const std::string& filePath, bool setAsCurrent)
 // (public)
 bool OakModel::saveRootNodeXML(const std::string& filePath)
 {
-    if (m_xmlDoc.isNull()) {
-        // Implement this
-        return false;
-    }
-    if (filePath.empty()) {
-        if (m_xmlDocFilePath.empty()) { return false; }
-        return m_xmlDoc.save(m_xmlDocFilePath);
-    } else {
-        if (m_xmlDoc.save(filePath)) {
-            m_xmlDocFilePath = filePath;
-            return true;
+    {
+        // Saving only reads the document, so other threads can keep reading
+        ReadLock readLock(this);
+
+        if (m_xmlDoc.isNull()) {
+            // Implement this
+            return false;
         }
-        return false;
+        if (filePath.empty()) {
+            if (m_xmlDocFilePath.empty()) { return false; }
+            return m_xmlDoc.save(m_xmlDocFilePath);
+        }
+        if (!m_xmlDoc.save(filePath)) { return false; }
     }
+
+    // The file path of the document is changed
+    WriteLock writeLock(this);
+    m_xmlDocFilePath = filePath;
+    return true;
+}
+
+// =============================================================================
+// (public)
+bool OakModel::saveRootNodeXML(XML::Writer &writer, XML::SaveFormat format)
+{
+    ReadLock readLock(this);
+
+    if (m_xmlDoc.isNull()) { return false; }
+
+    bool result = m_xmlDoc.save(writer, format);
+    return writer.finish() && result;
 }
 
 #endif // XML_BACKEND
@@ -248,37 +337,29 @@ bool OakModel::saveRootNodeXML(const std::string& filePath)
 // (public)
 const NodeDef* OakModel::findNodeDef(const NodeData &nodeData) const
 {
+    OAK_COUNT(FindNodeDef);
     if (m_rootNode.isDefNull() || nodeData.isNull()) { return nullptr; }
 
-    // Check if the root definition match
-    const NodeDef* def = m_rootNode.def()->baseRoot()->validVariant(nodeData, false, true);
-    if (def) { return def; }
-
-    std::list<const NodeDef*> defList;
-    std::vector<const NodeDef*> ignoreList;
-    defList.push_back(m_rootNode.def());
+    std::string tagName;
+    switch (nodeData.type()) {
+#ifdef XML_BACKEND
+    case NodeData::Type::XML:
+        tagName = nodeData.xmlNode().tagName();
+        break;
+#endif // XML_BACKEND
+    default:
+        // nodeData.type() returns an unhandled type that needs to be implemented
+        ASSERT(false);
+        return nullptr;
+    }
 
-    // Recursive check if any child definition match the node
-    const NodeDef * currentDef;
-    while (!defList.empty()) {
-        currentDef = defList.front();
-        defList.remove(currentDef);
+    auto it = m_nodeDefLookupMap.find(tagName);
+    if (it == m_nodeDefLookupMap.end()) { return nullptr; }
 
-        // Check if on of the child definitions match
-        def = currentDef->containerGroup().containerDef(nodeData);
+    for (const NodeDef *lookupDef: it->second)
+    {
+        const NodeDef *def = findNodeDef(lookupDef, nodeData);
         if (def) { return def; }
-        ignoreList.push_back(currentDef);
-
-        // Add child definitions to the list
-        auto cList = currentDef->containerList();
-        for(const ContainerDef* c: cList)
-        {
-            // Only add the definition if it is not in the ignore list
-            //  to avoid checking an definition twice and enter an infinete loop
-            if (std::find(ignoreList.begin(), ignoreList.end(), c->containerDef()) == ignoreList.end()) {
-                defList.push_back(c->containerDef());
-            }
-        }
     }
     return nullptr;
 }
@@ -290,10 +371,40 @@ Node OakModel::nodeFromDataPtr(void *dPtr) const
     if (dPtr == nullptr) { return Node(); }
 
     Oak::Model::NodeData node(dPtr, m_rootNode.nodeData().type());
+
+    if (!m_nodeDefCacheEnabled) {
+        return Oak::Model::Node(findNodeDef(node), node, this);
+    }
+
+    // Readers on different threads share the cache
+    std::unique_lock<std::mutex> lock(m_nodeDefCacheMutex);
+    auto it = m_nodeDefCache.find(dPtr);
+    if (it != m_nodeDefCache.end()) {
+        const Oak::Model::NodeDef *nDef = it->second;
+        lock.unlock();
+        return Oak::Model::Node(nDef, node, this);
+    }
+    lock.unlock();
+
     const Oak::Model::NodeDef *nDef = findNodeDef(node);
+    if (nDef) {
+        lock.lock();
+        m_nodeDefCache[dPtr] = nDef;
+        lock.unlock();
+    }
     return Oak::Model::Node(nDef, node, this);
 }
 
+// =============================================================================
+// (public)
+void OakModel::setNodeDefCacheEnabled(bool value)
+{
+    WriteLock writeLock(this);
+
+    m_nodeDefCacheEnabled = value;
+    clearNodeDefCache();
+}
+
 // =============================================================================
 // (public)
 NodeIndexUPtr OakModel::convertNodeIndexToNamed(const NodeIndex &nodeIndex) const
@@ -391,91 +502,232 @@ NodeIndexUPtr OakModel::convertNodeIndexToUnnamed(const NodeIndex &nodeIndex) co
     return NodeIndexUPtr(newRootNodeIndex);
 }
 
+// =============================================================================
+// (public)
+void OakModel::addObserver(ObserverInterface *observer) const
+{
+    ASSERT(observer);
+    WriteLock writeLock(this);
+    if (std::find(m_connectedObserverList.begin(), m_connectedObserverList.end(), observer) == m_connectedObserverList.end()) {
+        m_connectedObserverList.push_back(observer);
+    }
+}
+
+// =============================================================================
+// (public)
+void OakModel::removeObserver(ObserverInterface *observer) const
+{
+    WriteLock writeLock(this);
+
+    auto it = std::find(m_connectedObserverList.begin(), m_connectedObserverList.end(), observer);
+    if (it != m_connectedObserverList.end()) {
+        m_connectedObserverList.erase(it);
+    }
+}
+
+// =============================================================================
+// (public)
+bool OakModel::addOptionsIndex(const LeafQuery *query, const OptionsIndex *index) const
+{
+    ASSERT(query);
+    ASSERT(index);
+    WriteLock writeLock(this);
+    // The query can be observed once for each variant of the node definition
+    return m_optionsIndexMap.emplace(query, index).second;
+}
+
+// =============================================================================
+// (public)
+void OakModel::removeOptionsIndex(const LeafQuery *query) const
+{
+    WriteLock writeLock(this);
+    m_optionsIndexMap.erase(query);
+}
+
+// =============================================================================
+// (public)
+const OptionsIndex *OakModel::optionsIndex(const LeafQuery *query) const
+{
+    auto it = m_optionsIndexMap.find(query);
+    if (it == m_optionsIndexMap.end()) { return nullptr; }
+    return it->second;
+}
+
 // =============================================================================
 // (protected)
-void OakModel::onNodeRemoveBefore(const NodeIndex &nodeIndex) const
+void OakModel::onNodeRemoveBefore(const NodePath &nodePath) const
 {
-    notifier_nodeRemoveBefore.trigger(nodeIndex);
+    ASSERT(isWriting());
+
+    for (ObserverInterface *observer: m_connectedObserverList)
+    {
+        observer->onNodeRemoveBefore(nodePath);
+    }
+
+    if (isBatching()) { beforeBatchNodeChange(nodePath, NodePath()); }
+    if (!notifier_nodeRemoveBefore.isEmpty(CallbackFilter::create(nodePath))) {
+        notifier_nodeRemoveBefore.trigger(CallbackFilter::create(nodePath), *nodePath.toNodeIndex());
+    }
 }
 
 // =============================================================================
 // (protected)
-void OakModel::onNodeInserteBefore(const NodeIndex &nodeIndex) const
+void OakModel::onNodeInserteBefore(const NodePath &nodePath) const
 {
-    notifier_nodeInserteBefore.trigger(nodeIndex);
+    ASSERT(isWriting());
+
+    for (ObserverInterface *observer: m_connectedObserverList)
+    {
+        observer->onNodeInserteBefore(nodePath);
+    }
+
+    if (isBatching()) { beforeBatchNodeChange(NodePath(), nodePath, true); }
+    if (!notifier_nodeInserteBefore.isEmpty(CallbackFilter::create(nodePath))) {
+        notifier_nodeInserteBefore.trigger(CallbackFilter::create(nodePath), *nodePath.toNodeIndex());
+    }
 }
 
 // =============================================================================
 // (protected)
-void OakModel::onNodeInserteAfter(const NodeIndex &nodeIndex) const
+void OakModel::onNodeInserteAfter(const NodePath &nodePath) const
 {
-    notifier_nodeInserteAfter.trigger(nodeIndex);
+    clearNodeDefCache();
+
+    for (ObserverInterface *observer: m_connectedObserverList)
+    {
+        observer->onNodeInserteAfter(nodePath);
+    }
+
+    if (isBatching()) {
+        updateBatchLeafChanges(BatchChange::Type::NodeInserte, nodePath);
+        addBatchNodeChange(BatchChange::Type::NodeInserte, nodePath);
+    } else if (!notifier_nodeInserteAfter.isEmpty(CallbackFilter::create(nodePath))) {
+        notifier_nodeInserteAfter.trigger(CallbackFilter::create(nodePath), *nodePath.toNodeIndex());
+    }
 }
 
 // =============================================================================
 // (protected)
-void OakModel::onNodeMoveBefore(const NodeIndex &sourceNodeIndex, const NodeIndex &targetNodeIndex) const
+void OakModel::onNodeMoveBefore(const NodePath &sourceNodePath, const NodePath &targetNodePath) const
 {
-    notifier_nodeMoveBefore.trigger(sourceNodeIndex, targetNodeIndex);
+    ASSERT(isWriting());
+
+    for (ObserverInterface *observer: m_connectedObserverList)
+    {
+        observer->onNodeMoveBefore(sourceNodePath, targetNodePath);
+    }
+
+    if (isBatching()) { beforeBatchNodeChange(sourceNodePath, targetNodePath); }
+    if (!notifier_nodeMoveBefore.isEmpty(CallbackFilter::create(sourceNodePath))) {
+        notifier_nodeMoveBefore.trigger(CallbackFilter::create(sourceNodePath), *sourceNodePath.toNodeIndex(), *targetNodePath.toNodeIndex());
+    }
 }
 
 // =============================================================================
 // (protected)
-void OakModel::onNodeMoveAfter(const NodeIndex &sourceNodeIndex, const NodeIndex &targetNodeIndex) const
+void OakModel::onNodeMoveAfter(const NodePath &sourceNodePath, const NodePath &targetNodePath) const
 {
-    notifier_nodeMoveAfter.trigger(sourceNodeIndex, targetNodeIndex);
+    clearNodeDefCache();
+
+    for (ObserverInterface *observer: m_connectedObserverList)
+    {
+        observer->onNodeMoveAfter(sourceNodePath, targetNodePath);
+    }
+
+    if (isBatching()) {
+        updateBatchLeafChanges(BatchChange::Type::NodeMove, sourceNodePath, targetNodePath);
+        addBatchNodeChange(BatchChange::Type::NodeMove, sourceNodePath, targetNodePath);
+    } else if (!notifier_nodeMoveAfter.isEmpty(CallbackFilter::create(sourceNodePath))) {
+        notifier_nodeMoveAfter.trigger(CallbackFilter::create(sourceNodePath), *sourceNodePath.toNodeIndex(), *targetNodePath.toNodeIndex());
+    }
 
     // Check if the current node have moved and update it if so
-    NodeIndexUPtr currentNodeIndex = NodeIndex::create(m_currentNode);
-    if (!currentNodeIndex) {
-        setCurrentNode(targetNodeIndex.node(m_rootNode));
-    } else if (!m_currentNodeIndex->equal(*currentNodeIndex.get())) {
+    NodePath currentNodePath = NodePath::create(m_currentNode);
+    if (currentNodePath.isNull()) {
+        setCurrentNode(targetNodePath.node(m_rootNode));
+    } else if (m_currentNodePath != currentNodePath) {
         setCurrentNode(m_currentNode, true);
     }
 }
 
 // =============================================================================
 // (protected)
-void OakModel::onNodeCloneBefore(const NodeIndex &sourceNodeIndex, const NodeIndex &targetNodeIndex) const
+void OakModel::onNodeCloneBefore(const NodePath &sourceNodePath, const NodePath &targetNodePath) const
 {
-    notifier_nodeCloneBefore.trigger(sourceNodeIndex, targetNodeIndex);
+    ASSERT(isWriting());
+
+    for (ObserverInterface *observer: m_connectedObserverList)
+    {
+        observer->onNodeCloneBefore(sourceNodePath, targetNodePath);
+    }
+
+    if (isBatching()) { beforeBatchNodeChange(NodePath(), targetNodePath); }
+    if (!notifier_nodeCloneBefore.isEmpty(CallbackFilter::create(sourceNodePath))) {
+        notifier_nodeCloneBefore.trigger(CallbackFilter::create(sourceNodePath), *sourceNodePath.toNodeIndex(), *targetNodePath.toNodeIndex());
+    }
 }
 
 // =============================================================================
 // (protected)
-void OakModel::onNodeCloneAfter(const NodeIndex &sourceNodeIndex, const NodeIndex &targetNodeIndex) const
+void OakModel::onNodeCloneAfter(const NodePath &sourceNodePath, const NodePath &targetNodePath) const
 {
-    notifier_nodeCloneAfter.trigger(sourceNodeIndex, targetNodeIndex);
+    clearNodeDefCache();
+
+    for (ObserverInterface *observer: m_connectedObserverList)
+    {
+        observer->onNodeCloneAfter(sourceNodePath, targetNodePath);
+    }
+
+    if (isBatching()) {
+        updateBatchLeafChanges(BatchChange::Type::NodeClone, sourceNodePath, targetNodePath);
+        addBatchNodeChange(BatchChange::Type::NodeClone, sourceNodePath, targetNodePath);
+    } else if (!notifier_nodeCloneAfter.isEmpty(CallbackFilter::create(sourceNodePath))) {
+        notifier_nodeCloneAfter.trigger(CallbackFilter::create(sourceNodePath), *sourceNodePath.toNodeIndex(), *targetNodePath.toNodeIndex());
+    }
 
     // Change the current node to the clone if it was the one cloned
-    if (m_currentNodeIndex->equal(sourceNodeIndex)) {
-        setCurrentNode(targetNodeIndex.node(m_rootNode));
+    if (m_currentNodePath == sourceNodePath) {
+        setCurrentNode(targetNodePath.node(m_rootNode));
     }
 }
 
 // =============================================================================
 // (protected)
-void OakModel::onNodeRemoveAfter(const NodeIndex &nodeIndex) const
+void OakModel::onNodeRemoveAfter(const NodePath &nodePath) const
 {
+    // Removed data pointers can be reused by new nodes
+    clearNodeDefCache();
+
+    for (ObserverInterface *observer: m_connectedObserverList)
+    {
+        observer->onNodeRemoveAfter(nodePath);
+    }
+
     // Notify the view
-    notifier_nodeRemoveAfter.trigger(nodeIndex);
+    if (isBatching()) {
+        updateBatchLeafChanges(BatchChange::Type::NodeRemove, nodePath);
+        addBatchNodeChange(BatchChange::Type::NodeRemove, nodePath);
+    } else if (!notifier_nodeRemoveAfter.isEmpty(CallbackFilter::create(nodePath))) {
+        notifier_nodeRemoveAfter.trigger(CallbackFilter::create(nodePath), *nodePath.toNodeIndex());
+    }
 
     // Check if the current node is removed and update it if so
     if (m_currentNode.isNull()) { return; }
 
-    if (m_currentNodeIndex->contains(nodeIndex)) {
+    if (m_currentNodePath.contains(nodePath)) {
         // The current node is no longer valid
-        if (m_currentNodeIndex->depth() == nodeIndex.depth()) {
+        if (m_currentNodePath.depth() == nodePath.depth()) {
             // The deleted node is the current node
-            Node parentNode = nodeIndex.nodeParent(m_rootNode);
-            const NodeIndex &lastNodeIndex = nodeIndex.lastNodeIndex();
-            int count = parentNode.childCount(lastNodeIndex.name());
-            if (count > lastNodeIndex.index()) {
+            Node parentNode = nodePath.nodeParent(m_rootNode);
+            const std::string &name = nodePath.name(nodePath.depth()-1);
+            int index = nodePath.last().index;
+            int count = parentNode.childCount(name);
+            if (count > index) {
                 // Set the next sibling as the current node
-                setCurrentNode(parentNode.childAt(lastNodeIndex.name(), lastNodeIndex.index()));
+                setCurrentNode(parentNode.childAt(name, index));
             } else if (count > 0) {
                 // Set the previous sibling as the current node
-                setCurrentNode(parentNode.childAt(lastNodeIndex.name(), count-1));
+                setCurrentNode(parentNode.childAt(name, count-1));
             } else {
                 // Set the parent node as the current node
                 setCurrentNode(parentNode);
@@ -491,30 +743,61 @@ void OakModel::onNodeRemoveAfter(const NodeIndex &nodeIndex) const
 
 // =============================================================================
 // (protected)
-void OakModel::onLeafChangeBefore(const NodeIndex &nodeIndex, const std::string &valueName) const
+void OakModel::onLeafChangeBefore(const NodePath &nodePath, const LeafDef &leafDef) const
 {
-    notifier_leafChangeBefore.trigger(nodeIndex, valueName);
+    ASSERT(isWriting());
+
+    CallbackFilter event = CallbackFilter::create(nodePath, leafDef.nameId());
+    for (ObserverInterface *observer: m_connectedObserverList)
+    {
+        if (observer->leafChangeFilter().accepts(event)) {
+            observer->onLeafChangeBefore(nodePath, leafDef.name());
+        }
+    }
+
+    if (isBatching()) { return; }
+    if (!notifier_leafChangeBefore.isEmpty(event)) {
+        notifier_leafChangeBefore.trigger(event, *nodePath.toNodeIndex(), leafDef.name());
+    }
 }
 
 // =============================================================================
 // (protected)
-void OakModel::onLeafChangeAfter(const NodeIndex &nodeIndex, const std::string &valueName) const
+void OakModel::onLeafChangeAfter(const NodePath &nodePath, const LeafDef &leafDef) const
 {
-    notifier_leafChangeAfter.trigger(nodeIndex, valueName);
+    CallbackFilter event = CallbackFilter::create(nodePath, leafDef.nameId());
+    for (ObserverInterface *observer: m_connectedObserverList)
+    {
+        if (observer->leafChangeFilter().accepts(event)) {
+            observer->onLeafChangeAfter(nodePath, leafDef.name());
+        }
+    }
+
+    if (isBatching()) {
+        addBatchLeafChange(BatchChange::Type::LeafChange, nodePath, &leafDef);
+    } else if (!notifier_leafChangeAfter.isEmpty(event)) {
+        notifier_leafChangeAfter.trigger(event, *nodePath.toNodeIndex(), leafDef.name());
+    }
 }
 
 // =============================================================================
 // (protected)
-void OakModel::onVariantLeafChangeAfter(const NodeIndex &nodeIndex) const
+void OakModel::onVariantLeafChangeAfter(const NodePath &nodePath) const
 {
-    Node node = nodeIndex.node(m_rootNode);
+    clearNodeDefCache();
+
+    Node node = nodePath.node(m_rootNode);
     const NodeDef* def = findNodeDef(node.nodeData());
     // ASSERTION can be caused by the variantValue being changed to a value that do not corespond to a node definition variant
     // Make sure the variantLeaf optionsOnly setting is set to true
     ASSERT(def);
     Node newNode(def, node.nodeData(), this);
 
-    notifier_variantLeafChangeAfter.trigger(nodeIndex);
+    if (isBatching()) {
+        addBatchLeafChange(BatchChange::Type::VariantLeafChange, nodePath);
+    } else if (!notifier_variantLeafChangeAfter.isEmpty(CallbackFilter::create(nodePath))) {
+        notifier_variantLeafChangeAfter.trigger(CallbackFilter::create(nodePath), *nodePath.toNodeIndex());
+    }
     if (node == m_currentNode) {
         setCurrentNode(newNode);
     }
@@ -522,9 +805,346 @@ void OakModel::onVariantLeafChangeAfter(const NodeIndex &nodeIndex) const
 
 // =============================================================================
 // (protected)
-void OakModel::onKeyLeafChangeAfter(const NodeIndex &nodeIndex) const
+void OakModel::onKeyLeafChangeAfter(const NodePath &nodePath) const
+{
+    if (isBatching()) {
+        addBatchLeafChange(BatchChange::Type::KeyLeafChange, nodePath);
+    } else if (!notifier_keyLeafChangeAfter.isEmpty(CallbackFilter::create(nodePath))) {
+        notifier_keyLeafChangeAfter.trigger(CallbackFilter::create(nodePath), *nodePath.toNodeIndex());
+    }
+}
+
+// =============================================================================
+// (protected)
+// Called before a node is removed at 'removePath' and/or inserted at 'insertPath' in a batch.
+//  The pending changes that can not be reported correctly after the change are reported now
+void OakModel::beforeBatchNodeChange(const NodePath &removePath, const NodePath &insertPath, bool isInserte) const
+{
+    m_batchAbsorb = false;
+
+    bool conflict = false;
+    bool absorb = false;
+    for (size_t i = 0; i < m_batchChangeList.size() && !conflict; i++)
+    {
+        const BatchChange &change = m_batchChangeList[i];
+        const NodePath *first = nullptr;
+        int count = 1;
+        if (change.type == BatchChange::Type::NodeInserte) {
+            first = &change.nodePath;
+            count = change.count;
+        } else if (change.type == BatchChange::Type::NodeMove || change.type == BatchChange::Type::NodeClone) {
+            first = &change.targetNodePath;
+        } else {
+            // Removed nodes are not looked up when the change is reported
+            continue;
+        }
+
+        bool removeInside = !removePath.isNull() && _isInside(removePath, *first, count);
+        bool insertInside = !insertPath.isNull() && _isInside(insertPath, *first, count);
+        if (removeInside || insertInside) {
+            // Listeners create inserted nodes from the model when the insert is reported, so
+            //  changes inside them are included. Moved and cloned nodes can be copied from
+            //  the listeners own nodes, and they would miss the change
+            if (change.type == BatchChange::Type::NodeInserte &&
+                (removePath.isNull() || removeInside) &&
+                (insertPath.isNull() || insertInside)) {
+                absorb = true;
+            } else {
+                conflict = true;
+            }
+            continue;
+        }
+
+        if (!removePath.isNull() && _isAffected(*first, count, removePath)) {
+            conflict = true;
+        } else if (!insertPath.isNull() && _isAffected(*first, count, insertPath)) {
+            // Inserting next to the last range of inserted nodes extends it
+            bool extends = isInserte &&
+                           i + 1 == m_batchChangeList.size() &&
+                           change.type == BatchChange::Type::NodeInserte &&
+                           insertPath.depth() == first->depth() &&
+                           _listLevel(*first, insertPath) == first->depth() - 1 &&
+                           insertPath.last().index >= first->last().index &&
+                           insertPath.last().index <= first->last().index + count;
+            if (!extends) { conflict = true; }
+        }
+    }
+
+    if (conflict) {
+        flushBatchChanges();
+    } else {
+        m_batchAbsorb = absorb;
+    }
+}
+
+// =============================================================================
+// (protected)
+void OakModel::addBatchNodeChange(BatchChange::Type type, const NodePath &nodePath, const NodePath &targetNodePath) const
+{
+    if (m_batchAbsorb) {
+        // The change is inside a node that is reported as inserted
+        m_batchAbsorb = false;
+        return;
+    }
+
+    if (!m_batchChangeList.empty() && nodePath.depth() > 0) {
+        BatchChange &last = m_batchChangeList.back();
+        int depth = nodePath.depth();
+        if (last.type == type &&
+            last.nodePath.depth() == depth &&
+            last.nodePath.depthWhereEqual(nodePath) >= depth-1 &&
+            last.nodePath.last().nameId == nodePath.last().nameId) {
+            int first = last.nodePath.last().index;
+            int index = nodePath.last().index;
+            if (type == BatchChange::Type::NodeInserte) {
+                // Inserting anywhere inside or next to the range keeps it continuous
+                if (index >= first && index <= first + last.count) {
+                    last.count++;
+                    return;
+                }
+            } else if (type == BatchChange::Type::NodeRemove) {
+                // The range is removed so the next node has the index of the first
+                if (index == first) {
+                    last.count++;
+                    return;
+                } else if (index == first-1) {
+                    last.nodePath.removeLast();
+                    last.nodePath.append(nodePath.last().nameId, index);
+                    last.count++;
+                    return;
+                }
+            }
+        }
+    }
+
+    BatchChange change;
+    change.type = type;
+    change.nodePath = nodePath;
+    change.targetNodePath = targetNodePath;
+    m_batchChangeList.push_back(std::move(change));
+}
+
+// =============================================================================
+// (protected)
+void OakModel::addBatchLeafChange(BatchChange::Type type, const NodePath &nodePath, const LeafDef *leafDef) const
+{
+    // Nodes are read from the model when they are reported as inserted, so the
+    //  common case of filling in the leafs of a new node needs no extra report
+    if (!m_batchChangeList.empty()) {
+        const BatchChange &last = m_batchChangeList.back();
+        if (last.type == BatchChange::Type::NodeInserte) {
+            int level = _listLevel(nodePath, last.nodePath);
+            if (level >= 0) {
+                int index = nodePath.at(level).index;
+                if (index >= last.nodePath.last().index && index < last.nodePath.last().index + last.count) { return; }
+            }
+        }
+    }
+
+    int valueNameId = leafDef ? leafDef->nameId() : -1;
+    std::vector<size_t> &changeIndexList = m_batchLeafMap[nodePath];
+    for (size_t i: changeIndexList)
+    {
+        const BatchChange &change = m_batchLeafChangeList[i];
+        if (change.type == type && change.valueNameId == valueNameId) { return; }
+    }
+
+    changeIndexList.push_back(m_batchLeafChangeList.size());
+    BatchChange change;
+    change.type = type;
+    change.nodePath = nodePath;
+    if (leafDef) {
+        change.valueName = leafDef->name();
+        change.valueNameId = valueNameId;
+    }
+    m_batchLeafChangeList.push_back(std::move(change));
+}
+
+// =============================================================================
+// (protected)
+// Updates the paths of the pending leaf changes after a node change, so they keep
+//  pointing to the changed node. Leaf changes of removed nodes are dropped
+void OakModel::updateBatchLeafChanges(BatchChange::Type type, const NodePath &nodePath, const NodePath &targetNodePath) const
 {
-    notifier_keyLeafChangeAfter.trigger(nodeIndex);
+    if (m_batchLeafChangeList.empty()) { return; }
+
+    std::vector<BatchChange> changeList;
+    changeList.reserve(m_batchLeafChangeList.size());
+    for (BatchChange &change: m_batchLeafChangeList)
+    {
+        NodePath &path = change.nodePath;
+        bool keep = true;
+        switch (type) {
+        case BatchChange::Type::NodeInserte:
+            _updatePath(path, nodePath, false);
+            break;
+        case BatchChange::Type::NodeRemove:
+            keep = _updatePath(path, nodePath, true);
+            break;
+        case BatchChange::Type::NodeClone:
+            _updatePath(path, targetNodePath, false);
+            break;
+        case BatchChange::Type::NodeMove:
+            if (path.contains(nodePath)) {
+                // The node is inside the moved node
+                NodePath movedPath = targetNodePath;
+                for (int level = nodePath.depth(); level < path.depth(); level++)
+                {
+                    movedPath.append(path.at(level).nameId, path.at(level).index);
+                }
+                path = std::move(movedPath);
+            } else {
+                _updatePath(path, nodePath, true);
+                _updatePath(path, targetNodePath, false);
+            }
+            break;
+        default:
+            break;
+        }
+        if (keep) { changeList.push_back(std::move(change)); }
+    }
+    m_batchLeafChangeList.swap(changeList);
+
+    m_batchLeafMap.clear();
+    for (size_t i = 0; i < m_batchLeafChangeList.size(); i++)
+    {
+        m_batchLeafMap[m_batchLeafChangeList[i].nodePath].push_back(i);
+    }
+}
+
+// =============================================================================
+// (protected)
+void OakModel::flushBatchChanges() const
+{
+    // Listeners can change the model so the lists are moved out before triggering
+    std::vector<BatchChange> changeList;
+    changeList.swap(m_batchChangeList);
+    std::vector<BatchChange> leafChangeList;
+    leafChangeList.swap(m_batchLeafChangeList);
+    m_batchLeafMap.clear();
+    m_batchAbsorb = false;
+
+    for (const BatchChange &change: changeList)
+    {
+        triggerBatchChange(change);
+    }
+    for (const BatchChange &change: leafChangeList)
+    {
+        triggerBatchChange(change);
+    }
+}
+
+// =============================================================================
+// (protected)
+void OakModel::triggerBatchChange(const BatchChange &change) const
+{
+    switch (change.type) {
+    case BatchChange::Type::NodeInserte:
+        if (!notifier_nodesInserteAfter.isEmpty(CallbackFilter::create(change.nodePath))) {
+            notifier_nodesInserteAfter.trigger(CallbackFilter::create(change.nodePath), *change.nodePath.toNodeIndex(), change.count);
+        }
+        break;
+    case BatchChange::Type::NodeRemove:
+        if (!notifier_nodesRemoveAfter.isEmpty(CallbackFilter::create(change.nodePath))) {
+            notifier_nodesRemoveAfter.trigger(CallbackFilter::create(change.nodePath), *change.nodePath.toNodeIndex(), change.count);
+        }
+        break;
+    case BatchChange::Type::NodeMove:
+        if (!notifier_nodeMoveAfter.isEmpty(CallbackFilter::create(change.nodePath))) {
+            notifier_nodeMoveAfter.trigger(CallbackFilter::create(change.nodePath), *change.nodePath.toNodeIndex(), *change.targetNodePath.toNodeIndex());
+        }
+        break;
+    case BatchChange::Type::NodeClone:
+        if (!notifier_nodeCloneAfter.isEmpty(CallbackFilter::create(change.nodePath))) {
+            notifier_nodeCloneAfter.trigger(CallbackFilter::create(change.nodePath), *change.nodePath.toNodeIndex(), *change.targetNodePath.toNodeIndex());
+        }
+        break;
+    case BatchChange::Type::LeafChange:
+        if (!notifier_leafChangeAfter.isEmpty(CallbackFilter::create(change.nodePath, change.valueNameId))) {
+            notifier_leafChangeAfter.trigger(CallbackFilter::create(change.nodePath, change.valueNameId), *change.nodePath.toNodeIndex(), change.valueName);
+        }
+        break;
+    case BatchChange::Type::VariantLeafChange:
+        if (!notifier_variantLeafChangeAfter.isEmpty(CallbackFilter::create(change.nodePath))) {
+            notifier_variantLeafChangeAfter.trigger(CallbackFilter::create(change.nodePath), *change.nodePath.toNodeIndex());
+        }
+        break;
+    case BatchChange::Type::KeyLeafChange:
+        if (!notifier_keyLeafChangeAfter.isEmpty(CallbackFilter::create(change.nodePath))) {
+            notifier_keyLeafChangeAfter.trigger(CallbackFilter::create(change.nodePath), *change.nodePath.toNodeIndex());
+        }
+        break;
+    }
+}
+
+// =============================================================================
+// (protected static)
+int OakModel::_listLevel(const NodePath &path, const NodePath &position)
+{
+    int level = position.depth() - 1;
+    if (level < 0 || path.depth() <= level) { return -1; }
+
+    for (int i = 0; i < level; i++)
+    {
+        if (path.at(i) != position.at(i)) { return -1; }
+    }
+    // An unnamed index can point to any of the lists
+    int nameId = position.last().nameId;
+    if (nameId != -1 && path.at(level).nameId != nameId) { return -1; }
+    return level;
+}
+
+// =============================================================================
+// (protected static)
+bool OakModel::_isInside(const NodePath &path, const NodePath &first, int count)
+{
+    int level = first.depth() - 1;
+    if (level < 0 || path.depth() <= first.depth()) { return false; }
+
+    for (int i = 0; i < level; i++)
+    {
+        if (path.at(i) != first.at(i)) { return false; }
+    }
+    const NodePath::Entry &entry = path.at(level);
+    return entry.nameId == first.last().nameId &&
+           entry.index >= first.last().index &&
+           entry.index < first.last().index + count;
+}
+
+// =============================================================================
+// (protected static)
+bool OakModel::_isAffected(const NodePath &first, int count, const NodePath &position)
+{
+    int level = _listLevel(first, position);
+    if (level < 0) { return false; }
+
+    // An unnamed index can not be compared with the named indexes
+    if (position.last().nameId == -1) { return true; }
+
+    int index = position.last().index;
+    if (level == first.depth() - 1) {
+        // The nodes are in the same list
+        return index < first.last().index + count;
+    }
+    return index <= first.at(level).index;
+}
+
+// =============================================================================
+// (protected static)
+bool OakModel::_updatePath(NodePath &path, const NodePath &position, bool removed)
+{
+    int level = _listLevel(path, position);
+    if (level < 0) { return true; }
+
+    int index = path.at(level).index;
+    int positionIndex = position.last().index;
+    if (removed) {
+        if (index == positionIndex) { return false; }
+        if (index > positionIndex) { path.setIndex(level, index - 1); }
+    } else if (index >= positionIndex) {
+        path.setIndex(level, index + 1);
+    }
+    return true;
 }
 
 // =============================================================================
@@ -542,6 +1162,10 @@ void OakModel::createObservers()
     {
         m_observerList.push_back(std::make_unique<OptionsObserver>(this, query.first, query.second));
     }
+    for (const auto & query: queryExcludedList)
+    {
+        m_observerList.push_back(std::make_unique<OptionsObserver>(this, query.first, query.second, true));
+    }
     //
 
     for (ObserverInterfaceUPtr &observer: m_observerList)
@@ -561,5 +1185,78 @@ void OakModel::clearObservers()
     m_observerList.clear();
 }
 
+// =============================================================================
+// (protected)
+// Builds the NodeDef lookup in the same order findNodeDef() used to search
+//  the definition tree, so the first valid definition is still returned
+void OakModel::updateNodeDefLookup()
+{
+    m_nodeDefLookupMap.clear();
+    clearNodeDefCache();
+
+    if (m_rootNode.isDefNull()) { return; }
+
+    // The root definition match first
+    addNodeDefLookup(m_rootNode.def()->baseRoot());
+
+    std::list<const NodeDef*> defList;
+    std::vector<const NodeDef*> ignoreList;
+    defList.push_back(m_rootNode.def());
+
+    const NodeDef * currentDef;
+    while (!defList.empty()) {
+        currentDef = defList.front();
+        defList.remove(currentDef);
+        ignoreList.push_back(currentDef);
+
+        auto cList = currentDef->containerList();
+        for(const ContainerDef* c: cList)
+        {
+            addNodeDefLookup(c->containerDef());
+
+            // Only add the definition if it is not in the ignore list
+            //  to avoid checking an definition twice and enter an infinete loop
+            if (std::find(ignoreList.begin(), ignoreList.end(), c->containerDef()) == ignoreList.end()) {
+                defList.push_back(c->containerDef());
+            }
+        }
+    }
+}
+
+// =============================================================================
+// (protected)
+void OakModel::addNodeDefLookup(const NodeDef *def)
+{
+    if (def == nullptr) { return; }
+
+    std::vector<const NodeDef*> &lookupList = m_nodeDefLookupMap[def->tagName()];
+    if (std::find(lookupList.begin(), lookupList.end(), def) != lookupList.end()) { return; }
+    lookupList.push_back(def);
+}
+
+// =============================================================================
+// (protected)
+const NodeDef *OakModel::findNodeDef(const NodeDef *def, const NodeData &nodeData) const
+{
+    if (def->hasVariants()) {
+        // The variant id is looked up in the variant map of the definition
+        //  without copying it out of the data
+        const NodeDef *variantDef = def->validVariant(nodeData);
+        if (variantDef) { return variantDef; }
+        return def->validate(nodeData) ? def : nullptr;
+    }
+
+    if (def->validate(nodeData)) { return def; }
+    return def->validVariant(nodeData);
+}
+
+// =============================================================================
+// (protected)
+void OakModel::clearNodeDefCache() const
+{
+    std::lock_guard<std::mutex> lock(m_nodeDefCacheMutex);
+    m_nodeDefCache.clear();
+}
+
 } // namespace Oak::Model
 
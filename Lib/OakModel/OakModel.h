@@ -18,9 +18,14 @@
 
 #pragma once
 
+#include <mutex>
+#include <unordered_map>
+
 #include "NodeDef.h"
 #include "Node.h"
 #include "CallbackFunctions.h"
+#include "NodePath.h"
+#include "ReadWriteLock.h"
 
 #ifdef XML_BACKEND
 #include "XMLDocument.h"
@@ -31,6 +36,8 @@ namespace Oak::Model {
 
 class ObserverInterface;
 typedef std::unique_ptr<ObserverInterface> ObserverInterfaceUPtr;
+class OptionsIndex;
+class LeafQuery;
 
 // =============================================================================
 // Class definition
@@ -63,41 +70,169 @@ public:
     const NodeIndex& currentNodeIndex() const;
     void setCurrentNode(const Node &node, bool forceUpdate = false) const;
 
+    // Changes made between beginBatch() and endBatch() are reported when the
+    //  outermost batch ends. Consecutive inserts or removes under one parent
+    //  are reported once through 'notifier_nodesInserteAfter' and
+    //  'notifier_nodesRemoveAfter', and repeated changes to a leaf are
+    //  reported once. Node changes are reported in the order they were made,
+    //  followed by the leaf changes, which point to where the node is after the
+    //  node changes. Pending changes are reported early if a later change in the
+    //  batch would move or change the nodes they inserted or moved.
+    //  The 'Before' notifiers are triggered when the change is made, also in a
+    //  batch. Listeners that handle both use isBatching() to tell them apart
+    void beginBatch() const;
+    void endBatch() const;
+    bool isBatching() const { return m_batchDepth > 0; }
+
+    // Calls beginBatch() when created and endBatch() when destroyed
+    class Batch
+    {
+    public:
+        Batch(const OakModel *model) : m_model(model) { if (m_model) { m_model->beginBatch(); } }
+        ~Batch() { if (m_model) { m_model->endBatch(); } }
+
+        Batch(const Batch &copy) = delete;
+        Batch& operator=(const Batch &copy) = delete;
+
+    protected:
+        const OakModel *m_model;
+    };
+
+    // Many threads can read the model while one thread changes it. Readers on
+    //  other threads than the writing thread hold a read lock while they use
+    //  nodes, leafs and queries of the model. Node, Leaf and OakModel take the
+    //  write lock when they change the model, so a change and its notifications
+    //  are never seen half done, and a batch holds the write lock until it ends.
+    //  The writing thread reads without a read lock, and a thread that holds a
+    //  read lock must not change the model. Observers and callbacks are called
+    //  on the writing thread with the write lock held.
+    void lockRead() const { m_lock.lockRead(); }
+    void unlockRead() const { m_lock.unlockRead(); }
+    void lockWrite() const { m_lock.lockWrite(); }
+    void unlockWrite() const { m_lock.unlockWrite(); }
+
+    // Returns true if any thread holds a read lock
+    bool isReading() const { return m_lock.isReading(); }
+    // Returns true if the calling thread holds the write lock
+    bool isWriting() const { return m_lock.isWriting(); }
+
+    // Calls lockRead() when created and unlockRead() when destroyed
+    class ReadLock
+    {
+    public:
+        ReadLock(const OakModel *model) : m_model(model) { if (m_model) { m_model->lockRead(); } }
+        ~ReadLock() { if (m_model) { m_model->unlockRead(); } }
+
+        ReadLock(const ReadLock &copy) = delete;
+        ReadLock& operator=(const ReadLock &copy) = delete;
+
+    protected:
+        const OakModel *m_model;
+    };
+
+    // Calls lockWrite() when created and unlockWrite() when destroyed
+    class WriteLock
+    {
+    public:
+        WriteLock(const OakModel *model) : m_model(model) { if (m_model) { m_model->lockWrite(); } }
+        ~WriteLock() { if (m_model) { m_model->unlockWrite(); } }
+
+        WriteLock(const WriteLock &copy) = delete;
+        WriteLock& operator=(const WriteLock &copy) = delete;
+
+    protected:
+        const OakModel *m_model;
+    };
+
 #ifdef XML_BACKEND
     const std::string& docFilePathXML() { return m_xmlDocFilePath; }
     void setDocFilePathXML(const std::string xmlDocFilePath) { m_xmlDocFilePath = xmlDocFilePath; }
     void setRootNodeXML(const NodeData &rootNodeData, bool setAsCurrent = true);
-    bool loadRootNodeXML(const std::string& filePath, bool setAsCurrent = true);
+    // LoadMode::Mapped uses less memory on large files but drops comments and PIs
+    bool loadRootNodeXML(const std::string& filePath, bool setAsCurrent = true, XML::Document::LoadMode mode = XML::Document::LoadMode::Copy);
     bool saveRootNodeXML(const std::string& filePath = "");
+    // Streams the document to 'writer' and finishes it, e.g. a XML::GZipWriter over a XML::FileWriter
+    bool saveRootNodeXML(XML::Writer &writer, XML::SaveFormat format = XML::SaveFormat::Indented);
 #endif // XML_BACKEND
 
-    // Starting with the root NodeDef and look through all NodeDefs recursive
-    //  untill a match is found
+    // Looks up the NodeDefs with the tag name of the node data and returns
+    //  the first valid variant. The lookup is build in setRootNodeDef()
     const NodeDef *findNodeDef(const NodeData &nodeData) const;
     Node nodeFromDataPtr(void * dPtr) const;
 
+    // Remembers the NodeDef found by nodeFromDataPtr() for each data pointer
+    //  until nodes are inserted, moved, removed or change variant
+    bool nodeDefCacheEnabled() const { return m_nodeDefCacheEnabled; }
+    void setNodeDefCacheEnabled(bool value);
+
     NodeIndexUPtr convertNodeIndexToNamed(const NodeIndex &nodeIndex) const;
     NodeIndexUPtr convertNodeIndexToUnnamed(const NodeIndex &nodeIndex) const;
 
-protected:
-    void onNodeInserteBefore(const NodeIndex& nodeIndex) const;
-    void onNodeInserteAfter(const NodeIndex& nodeIndex) const;
-    void onNodeMoveBefore(const NodeIndex& sourceNodeIndex, const NodeIndex& targetNodeIndex) const;
-    void onNodeMoveAfter(const NodeIndex& sourceNodeIndex, const NodeIndex& targetNodeIndex) const;
-    void onNodeCloneBefore(const NodeIndex& sourceNodeIndex, const NodeIndex& targetNodeIndex) const;
-    void onNodeCloneAfter(const NodeIndex& sourceNodeIndex, const NodeIndex& targetNodeIndex) const;
+    // Connected observers are called for every change before the notifiers
+    //  are triggered (The model does not take ownership)
+    void addObserver(ObserverInterface *observer) const;
+    void removeObserver(ObserverInterface *observer) const;
 
-    void onNodeRemoveAfter(const NodeIndex& nodeIndex) const;
-    void onNodeRemoveBefore(const NodeIndex& nodeIndex) const;
+    // The option indexes are maintained by the option observers and used by
+    //  'ValueOptions' to find the options of a query without running it
+    bool addOptionsIndex(const LeafQuery *query, const OptionsIndex *index) const;
+    void removeOptionsIndex(const LeafQuery *query) const;
+    const OptionsIndex *optionsIndex(const LeafQuery *query) const;
 
-    void onLeafChangeBefore(const NodeIndex& nodeIndex, const std::string &valueName) const;
-    void onLeafChangeAfter(const NodeIndex& nodeIndex, const std::string &valueName) const;
-    void onVariantLeafChangeAfter(const NodeIndex& nodeIndex) const;
-    void onKeyLeafChangeAfter(const NodeIndex& nodeIndex) const;
+protected:
+    // The 'NodeIndex' passed to the notifiers is only created if a subscriber accepts the event
+    void onNodeInserteBefore(const NodePath& nodePath) const;
+    void onNodeInserteAfter(const NodePath& nodePath) const;
+    void onNodeMoveBefore(const NodePath& sourceNodePath, const NodePath& targetNodePath) const;
+    void onNodeMoveAfter(const NodePath& sourceNodePath, const NodePath& targetNodePath) const;
+    void onNodeCloneBefore(const NodePath& sourceNodePath, const NodePath& targetNodePath) const;
+    void onNodeCloneAfter(const NodePath& sourceNodePath, const NodePath& targetNodePath) const;
+
+    void onNodeRemoveAfter(const NodePath& nodePath) const;
+    void onNodeRemoveBefore(const NodePath& nodePath) const;
+
+    void onLeafChangeBefore(const NodePath& nodePath, const LeafDef &leafDef) const;
+    void onLeafChangeAfter(const NodePath& nodePath, const LeafDef &leafDef) const;
+    void onVariantLeafChangeAfter(const NodePath& nodePath) const;
+    void onKeyLeafChangeAfter(const NodePath& nodePath) const;
+
+    struct BatchChange
+    {
+        enum class Type { NodeInserte, NodeRemove, NodeMove, NodeClone, LeafChange, VariantLeafChange, KeyLeafChange };
+
+        Type type;
+        NodePath nodePath; // Points to the first node of a range
+        NodePath targetNodePath;
+        int count = 1;
+        std::string valueName;
+        int valueNameId = -1;
+    };
+
+    void beforeBatchNodeChange(const NodePath &removePath, const NodePath &insertPath, bool isInserte = false) const;
+    void addBatchNodeChange(BatchChange::Type type, const NodePath &nodePath, const NodePath &targetNodePath = NodePath()) const;
+    void addBatchLeafChange(BatchChange::Type type, const NodePath &nodePath, const LeafDef *leafDef = nullptr) const;
+    void updateBatchLeafChanges(BatchChange::Type type, const NodePath &nodePath, const NodePath &targetNodePath = NodePath()) const;
+    void flushBatchChanges() const;
+    void triggerBatchChange(const BatchChange &change) const;
+
+    // Returns the level where 'path' passes through the list of the node at 'position' or -1
+    static int _listLevel(const NodePath &path, const NodePath &position);
+    // Returns true if 'path' points inside one of the 'count' nodes from 'first'
+    static bool _isInside(const NodePath &path, const NodePath &first, int count);
+    // Returns true if inserting or removing a node at 'position' moves or removes one of the 'count' nodes from 'first'
+    static bool _isAffected(const NodePath &first, int count, const NodePath &position);
+    // Updates 'path' to point to the same node after a node is inserted or removed at 'position'.
+    //  Returns false if the node of 'path' is removed
+    static bool _updatePath(NodePath &path, const NodePath &position, bool removed);
 
     void createObservers();
     void clearObservers();
 
+    void updateNodeDefLookup();
+    void addNodeDefLookup(const NodeDef *def);
+    const NodeDef *findNodeDef(const NodeDef *def, const NodeData &nodeData) const;
+    void clearNodeDefCache() const;
+
 public:
     Callback notifier_currentNodeChanged;
     Callback notifier_rootNodeDataChanged;
@@ -105,6 +240,9 @@ public:
 
     Callback notifier_destroyed;
 
+    // Triggered when the outermost batch ends, before the batched changes are reported
+    Callback notifier_batchEnd;
+
     Callback_NodeIndex notifier_nodeInserteBefore;
     Callback_NodeIndex notifier_nodeInserteAfter;
     Callback_NodeIndexNodeIndex notifier_nodeMoveBefore;
@@ -115,6 +253,11 @@ public:
     Callback_NodeIndex notifier_nodeRemoveBefore;
     Callback_NodeIndex notifier_nodeRemoveAfter;
 
+    // Only triggered when a batch ends. The 'NodeIndex' points to the first node
+    //  of the range and the int is the number of nodes
+    Callback_NodeIndexInt notifier_nodesInserteAfter;
+    Callback_NodeIndexInt notifier_nodesRemoveAfter;
+
     Callback_NodeIndexString notifier_leafChangeBefore;
     Callback_NodeIndexString notifier_leafChangeAfter;
     Callback_NodeIndex notifier_variantLeafChangeAfter;
@@ -124,12 +267,32 @@ protected:
     Node m_rootNode;
     mutable Node m_currentNode;
     mutable NodeIndexUPtr m_currentNodeIndex;
+    mutable NodePath m_currentNodePath;
 
     std::vector<ObserverInterfaceUPtr> m_observerList;
+    mutable std::vector<ObserverInterface*> m_connectedObserverList;
+    mutable std::unordered_map<const LeafQuery*, const OptionsIndex*> m_optionsIndexMap;
 
     // Used only to keep the definition alive (Smart Pointer)
     NodeDefSPtr m_def;
 
+    // The NodeDefs with a tag name in the order they are searched
+    std::unordered_map<std::string, std::vector<const NodeDef*>> m_nodeDefLookupMap;
+
+    bool m_nodeDefCacheEnabled = false;
+    mutable std::unordered_map<void*, const NodeDef*> m_nodeDefCache;
+    mutable std::mutex m_nodeDefCacheMutex;
+
+    mutable int m_batchDepth = 0;
+    mutable std::vector<BatchChange> m_batchChangeList;
+    // The leaf changes are kept pointing to their node while nodes are changed
+    mutable std::vector<BatchChange> m_batchLeafChangeList;
+    mutable std::unordered_map<NodePath, std::vector<size_t>, NodePath::Hash> m_batchLeafMap;
+    // Set when the node change being made is inside a node inserted earlier in the batch
+    mutable bool m_batchAbsorb = false;
+
+    ReadWriteLock m_lock;
+
 #ifdef XML_BACKEND
     NodeData m_rootNodeXML;
     std::string m_xmlDocFilePath;
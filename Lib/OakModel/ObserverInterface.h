@@ -19,11 +19,15 @@
 #pragma once
 
 #include <memory>
+#include <string>
+
+#include "CallbackFunctions.h"
 
 
 namespace Oak::Model {
 
 class OakModel;
+class NodePath;
 
 // =============================================================================
 // Class definition
@@ -37,8 +41,32 @@ public:
     virtual void connect() = 0;
     virtual void disconnect() = 0;
 
+    // Connected observers are called directly by the model for every change,
+    //  also while a batch is open, so they can keep the model consistent
+    virtual void onNodeInserteBefore(const NodePath &nodePath) { (void)nodePath; }
+    virtual void onNodeInserteAfter(const NodePath &nodePath) { (void)nodePath; }
+    virtual void onNodeMoveBefore(const NodePath &sourceNodePath, const NodePath &targetNodePath) { (void)sourceNodePath; (void)targetNodePath; }
+    virtual void onNodeMoveAfter(const NodePath &sourceNodePath, const NodePath &targetNodePath) { (void)sourceNodePath; (void)targetNodePath; }
+    virtual void onNodeCloneBefore(const NodePath &sourceNodePath, const NodePath &targetNodePath) { (void)sourceNodePath; (void)targetNodePath; }
+    virtual void onNodeCloneAfter(const NodePath &sourceNodePath, const NodePath &targetNodePath) { (void)sourceNodePath; (void)targetNodePath; }
+    virtual void onNodeRemoveBefore(const NodePath &nodePath) { (void)nodePath; }
+    virtual void onNodeRemoveAfter(const NodePath &nodePath) { (void)nodePath; }
+    virtual void onLeafChangeBefore(const NodePath &nodePath, const std::string &valueName) { (void)nodePath; (void)valueName; }
+    virtual void onLeafChangeAfter(const NodePath &nodePath, const std::string &valueName) { (void)nodePath; (void)valueName; }
+
+    // Called when the root node data of the model is replaced
+    virtual void onRootNodeChanged() {}
+
+    // Called when the outermost batch of the model begins and ends
+    virtual void onBatchBegin() {}
+    virtual void onBatchEnd() {}
+
+    // Only the leaf changes accepted by the filter are passed to the observer
+    const CallbackFilter &leafChangeFilter() const { return m_leafChangeFilter; }
+
 protected:
     OakModel * m_model;
+    CallbackFilter m_leafChangeFilter;
 };
 
 
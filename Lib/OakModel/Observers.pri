@@ -1,7 +1,11 @@
 SOURCES += \
     $$PWD/ObserverInterface.cpp \
-    $$PWD/OptionsObserver.cpp
+    $$PWD/OptionsIndex.cpp \
+    $$PWD/OptionsObserver.cpp \
+    $$PWD/UndoJournal.cpp
 
 HEADERS += \
     $$PWD/ObserverInterface.h \
-    $$PWD/OptionsObserver.h
+    $$PWD/OptionsIndex.h \
+    $$PWD/OptionsObserver.h \
+    $$PWD/UndoJournal.h
@@ -0,0 +1,303 @@
+/*
+ * OakModelView (http://oakmodelview.com/)
+ * Author: Mikkel Nøhr Løvgreen (mikkel@oakmodelview.com)
+ * ------------------------------------------------------------------------
+ * Licensed to Vilaversoftware IVS who licenses this file to you under the
+ * Apache License, Version 2.0 (the "License"); you may not use this file
+ * except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "OptionsIndex.h"
+
+#include "LeafQuery.h"
+#include "NodeQueryChildren.h"
+#include "NodeQueryParent.h"
+
+#include "../ServiceFunctions/Assert.h"
+
+#include <algorithm>
+
+
+namespace Oak::Model {
+
+// =============================================================================
+// (public)
+OptionsIndex::OptionsIndex(const LeafQuery &query)
+    : m_leaf(query.leafHandle())
+{
+    if (!query.hasNodeQuery() || m_leaf.isNull()) { return; }
+
+    // Only parent steps followed by child steps are supported
+    const NodeQuery *q = &query.nodeQuery();
+    while (q != nullptr && dynamic_cast<const NodeQueryParent *>(q) != nullptr) {
+        m_parentCount++;
+        q = q->childQuery();
+    }
+    while (q != nullptr) {
+        const NodeQueryChildren *nodeQueryChildren = dynamic_cast<const NodeQueryChildren *>(q);
+        if (nodeQueryChildren == nullptr) {
+            m_childNameList.clear();
+            return;
+        }
+        m_childNameList.push_back(nodeQueryChildren->nodeName());
+        q = q->childQuery();
+    }
+    m_valid = !m_childNameList.empty();
+}
+
+// =============================================================================
+// (public)
+bool OptionsIndex::getValues(const Node &refNode, std::vector<UnionValue> &values) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Entry *e = entry(refNode);
+    if (e == nullptr) { return false; }
+
+    values = e->sortedList;
+    return true;
+}
+
+// =============================================================================
+// (public)
+bool OptionsIndex::contains(const Node &refNode, const UnionRef &value) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Entry *e = entry(refNode);
+    if (e == nullptr || e->sortedList.empty()) { return false; }
+
+    UnionValue uValue(value);
+    if (uValue.type() == e->sortedList.front().type()) {
+        return e->countMap.find(uValue) != e->countMap.end();
+    }
+    // Values of another type are compared one by one
+    return std::find(e->sortedList.begin(), e->sortedList.end(), value) != e->sortedList.end();
+}
+
+// =============================================================================
+// (public)
+void OptionsIndex::onNodeInserted(const Node &node)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_valid || m_entryMap.empty() || node.isNull()) { return; }
+
+    forEachScope(node, [this, &node](Entry &e, size_t step) {
+        std::vector<UnionValue> values;
+        collectValues(node, step, values);
+        for (const UnionValue &value: values)
+        {
+            addValue(e, value);
+        }
+    });
+}
+
+// =============================================================================
+// (public)
+void OptionsIndex::onNodeRemove(const Node &node)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_valid || m_entryMap.empty() || node.isNull()) { return; }
+
+    std::vector<void*> invalidList;
+    forEachScope(node, [this, &node, &invalidList](Entry &e, size_t step) {
+        std::vector<UnionValue> values;
+        collectValues(node, step, values);
+        for (const UnionValue &value: values)
+        {
+            if (!removeValue(e, value)) {
+                // The entry is out of sync and is build again when it is used
+                invalidList.push_back(e.scope.nodeData().internalPtr());
+                return;
+            }
+        }
+    });
+
+    // Scopes in the removed subtree are no longer valid
+    for (const auto &pair: m_entryMap)
+    {
+        Node scope = pair.second.scope;
+        while (!scope.isNull()) {
+            if (scope.nodeData() == node.nodeData()) {
+                invalidList.push_back(pair.first);
+                break;
+            }
+            scope = scope.parent();
+        }
+    }
+
+    for (void *ptr: invalidList)
+    {
+        m_entryMap.erase(ptr);
+    }
+}
+
+// =============================================================================
+// (public)
+void OptionsIndex::onLeafChangeBefore(const Node &sourceNode)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_changeNodePtr = sourceNode.nodeData().internalPtr();
+    m_hasValueBeforeChange = sourceValue(sourceNode, m_valueBeforeChange);
+}
+
+// =============================================================================
+// (public)
+void OptionsIndex::onLeafChangeAfter(const Node &sourceNode)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_changeNodePtr != sourceNode.nodeData().internalPtr()) {
+        // The value before the change is unknown
+        m_entryMap.clear();
+        return;
+    }
+    m_changeNodePtr = nullptr;
+    if (!m_valid || m_entryMap.empty()) { return; }
+
+    UnionValue newValue;
+    bool hasNewValue = sourceValue(sourceNode, newValue);
+    if (hasNewValue == m_hasValueBeforeChange && (!hasNewValue || newValue == m_valueBeforeChange)) { return; }
+
+    std::vector<void*> invalidList;
+    forEachScope(sourceNode, [&](Entry &e, size_t step) {
+        if (step != m_childNameList.size()) { return; }
+        if (m_hasValueBeforeChange && !removeValue(e, m_valueBeforeChange)) {
+            invalidList.push_back(e.scope.nodeData().internalPtr());
+            return;
+        }
+        if (hasNewValue) {
+            addValue(e, newValue);
+        }
+    });
+
+    for (void *ptr: invalidList)
+    {
+        m_entryMap.erase(ptr);
+    }
+}
+
+// =============================================================================
+// (public)
+void OptionsIndex::clear()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_entryMap.clear();
+    m_changeNodePtr = nullptr;
+}
+
+// =============================================================================
+// (protected)
+Node OptionsIndex::scopeNode(const Node &refNode) const
+{
+    Node scope = refNode;
+    for (int i = 0; i < m_parentCount && !scope.isNull(); i++)
+    {
+        scope = scope.parent();
+    }
+    return scope;
+}
+
+// =============================================================================
+// (protected)
+OptionsIndex::Entry *OptionsIndex::entry(const Node &refNode) const
+{
+    if (!m_valid) { return nullptr; }
+
+    Node scope = scopeNode(refNode);
+    if (scope.isNull()) { return nullptr; }
+
+    Entry *e = findEntry(scope);
+    if (e) { return e; }
+
+    // Build the entry the first time the scope is used
+    Entry &newEntry = m_entryMap[scope.nodeData().internalPtr()];
+    newEntry.scope = scope;
+
+    std::vector<UnionValue> values;
+    collectValues(scope, 0, values);
+    for (const UnionValue &value: values)
+    {
+        if (++newEntry.countMap[value] == 1) {
+            newEntry.sortedList.push_back(value);
+        }
+    }
+    std::sort(newEntry.sortedList.begin(), newEntry.sortedList.end());
+    return &newEntry;
+}
+
+// =============================================================================
+// (protected)
+OptionsIndex::Entry *OptionsIndex::findEntry(const Node &scope) const
+{
+    auto it = m_entryMap.find(scope.nodeData().internalPtr());
+    if (it == m_entryMap.end()) { return nullptr; }
+    return &it->second;
+}
+
+// =============================================================================
+// (protected)
+void OptionsIndex::collectValues(const Node &node, size_t step, std::vector<UnionValue> &values) const
+{
+    if (step == m_childNameList.size()) {
+        UnionValue value;
+        if (sourceValue(node, value)) {
+            values.push_back(std::move(value));
+        }
+        return;
+    }
+
+    const std::string &name = m_childNameList[step];
+    Node child = node.firstChild(name);
+    while (!child.isNull()) {
+        collectValues(child, step + 1, values);
+        child = node.nextChild(name, child);
+    }
+}
+
+// =============================================================================
+// (protected)
+bool OptionsIndex::sourceValue(const Node &node, UnionValue &value) const
+{
+    if (node.isNull()) { return false; }
+    int leafIndex = m_leaf.index(node.def());
+    if (leafIndex == -1) { return false; }
+    value = node.leafAt(leafIndex).value();
+    return true;
+}
+
+// =============================================================================
+// (protected)
+void OptionsIndex::addValue(Entry &entry, const UnionValue &value) const
+{
+    if (++entry.countMap[value] == 1) {
+        auto it = std::lower_bound(entry.sortedList.begin(), entry.sortedList.end(), value);
+        entry.sortedList.insert(it, value);
+    }
+}
+
+// =============================================================================
+// (protected)
+bool OptionsIndex::removeValue(Entry &entry, const UnionValue &value) const
+{
+    auto it = entry.countMap.find(value);
+    if (it == entry.countMap.end()) { return false; }
+
+    if (--it->second == 0) {
+        entry.countMap.erase(it);
+        auto sIt = std::lower_bound(entry.sortedList.begin(), entry.sortedList.end(), value);
+        if (sIt == entry.sortedList.end() || *sIt != value) {
+            sIt = std::find(entry.sortedList.begin(), entry.sortedList.end(), value);
+        }
+        if (sIt == entry.sortedList.end()) { return false; }
+        entry.sortedList.erase(sIt);
+    }
+    return true;
+}
+
+} // namespace Oak::Model
@@ -0,0 +1,121 @@
+/*
+ * OakModelView (http://oakmodelview.com/)
+ * Author: Mikkel Nøhr Løvgreen (mikkel@oakmodelview.com)
+ * ------------------------------------------------------------------------
+ * Licensed to Vilaversoftware IVS who licenses this file to you under the
+ * Apache License, Version 2.0 (the "License"); you may not use this file
+ * except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Node.h"
+#include "LeafHandle.h"
+#include "UnionValue.h"
+
+
+namespace Oak::Model {
+
+class LeafQuery;
+
+// =============================================================================
+// Class definition
+// =============================================================================
+// Keeps the values found by an option query for each scope node, so the
+//  option list does not have to be collected again on every call. The scope
+//  is the node the query reaches through its parent steps and the values are
+//  found through the child steps that follow. Queries of any other form are
+//  not supported (See isValid()).
+// An entry is build the first time a scope is looked up and is kept up to date
+//  by the model changes passed to it (See OptionsObserver).
+class OptionsIndex
+{
+public:
+    OptionsIndex(const LeafQuery &query);
+
+    bool isValid() const { return m_valid; }
+
+    // Sets 'values' to the unique values found by the query from 'refNode' in sorted order
+    bool getValues(const Node &refNode, std::vector<UnionValue> &values) const;
+    bool contains(const Node &refNode, const UnionRef &value) const;
+
+    void onNodeInserted(const Node &node);
+    void onNodeRemove(const Node &node);
+    void onLeafChangeBefore(const Node &sourceNode);
+    void onLeafChangeAfter(const Node &sourceNode);
+
+    void clear();
+
+protected:
+    struct Entry
+    {
+        Node scope;
+        std::unordered_map<UnionValue, int, UnionValue::Hash> countMap;
+        std::vector<UnionValue> sortedList;
+    };
+
+    Node scopeNode(const Node &refNode) const;
+    Entry *entry(const Node &refNode) const;
+    Entry *findEntry(const Node &scope) const;
+
+    void collectValues(const Node &node, size_t step, std::vector<UnionValue> &values) const;
+    bool sourceValue(const Node &node, UnionValue &value) const;
+
+    void addValue(Entry &entry, const UnionValue &value) const;
+    bool removeValue(Entry &entry, const UnionValue &value) const;
+
+    // Calls 'function' for every indexed scope above 'node' together with the
+    //  number of child steps from the scope to 'node'
+    template<typename F>
+    void forEachScope(const Node &node, F function);
+
+protected:
+    bool m_valid = false;
+    int m_parentCount = 0;
+    std::vector<std::string> m_childNameList;
+    LeafHandle m_leaf;
+
+    // The entries are keyed by the internal pointer of the scope node
+    mutable std::unordered_map<void*, Entry> m_entryMap;
+    mutable std::mutex m_mutex;
+
+    void *m_changeNodePtr = nullptr;
+    bool m_hasValueBeforeChange = false;
+    UnionValue m_valueBeforeChange;
+};
+
+// =============================================================================
+// (protected)
+template<typename F>
+void OptionsIndex::forEachScope(const Node &node, F function)
+{
+    for (size_t step = 1; step <= m_childNameList.size(); step++)
+    {
+        // 'node' must be reached from the scope by the first child steps
+        Node scope = node;
+        size_t i = step;
+        while (i > 0 && !scope.isNull() && scope.def()->name() == m_childNameList[i-1]) {
+            scope = scope.parent();
+            i--;
+        }
+        if (i > 0 || scope.isNull()) { continue; }
+
+        Entry *e = findEntry(scope);
+        if (e) { function(*e, step); }
+    }
+}
+
+} // namespace Oak::Model
@@ -21,7 +21,7 @@
 #include "OakModel.h"
 #include "NodeDef.h"
 #include "LeafQuery.h"
-#include "NodeIndex.h"
+#include "NodePath.h"
 #include "QueryBuilder.h"
 
 #include "../ServiceFunctions/Trace.h"
@@ -31,115 +31,121 @@ namespace Oak::Model {
 
 // =============================================================================
 // (public)
-OptionsObserver::OptionsObserver(OakModel *model, const NodeDef *optionsNodeDef, const LeafDef *optionsLeafDef)
+OptionsObserver::OptionsObserver(OakModel *model, const NodeDef *optionsNodeDef, const LeafDef *optionsLeafDef, bool excluded)
     : ObserverInterface(model),
       m_optionsNodeDef { optionsNodeDef},
-      m_optionsLeafDef { optionsLeafDef}
+      m_optionsLeafDef { optionsLeafDef},
+      m_query { excluded ? optionsLeafDef->options().queryExcluded() : optionsLeafDef->options().query() },
+      m_optionsIndex { *m_query }
 {
     ASSERT(m_optionsNodeDef);
     ASSERT(m_optionsLeafDef);
-    ASSERT(m_optionsLeafDef->options().hasQuery());
+    ASSERT(m_query);
 
-    const LeafQuery *query = m_optionsLeafDef->options().query();
-    m_sourceNodeDef = query->nodeQuery().nodeDef(m_optionsNodeDef);
+    m_sourceNodeDef = m_query->nodeQuery().nodeDef(m_optionsNodeDef);
     ASSERT(m_sourceNodeDef != nullptr);
-    m_sourceValueName = query->valueName();
-
-    // Create an inverse query that points from the option values to the leaf where there can be chosen
-    m_inverseQuery = QueryBuilder::createInverse(query->nodeQuery(), m_optionsNodeDef)->leafSPtr(m_optionsLeafDef->name());
-
+    m_sourceLeaf.setName(m_query->valueName());
+    m_leafChangeFilter = CallbackFilter::create(m_sourceNodeDef, m_query->valueName());
 
+    if (!excluded) {
+        // Create an inverse query that points from the option values to the leaf where there can be chosen
+        m_inverseQuery = QueryBuilder::createInverse(m_query->nodeQuery(), m_optionsNodeDef)->leafSPtr(m_optionsLeafDef->name());
+    }
 }
 
 // =============================================================================
 // (public)
 void OptionsObserver::connect()
 {
-    m_model->notifier_nodeInserteAfter.add(this, &OptionsObserver::onNodeInserteAfter);
-    m_model->notifier_nodeMoveBefore.add(this, &OptionsObserver::onNodeMoveBefore);
-    m_model->notifier_nodeMoveAfter.add(this, &OptionsObserver::onNodeMoveAfter);
-    m_model->notifier_nodeCloneAfter.add(this, &OptionsObserver::onNodeCloneAfter);
-
-    m_model->notifier_nodeRemoveBefore.add(this, &OptionsObserver::onNodeRemoveBefore);
-
-    m_model->notifier_leafChangeBefore.add(this, &OptionsObserver::onLeafChangeBefore);
-    m_model->notifier_leafChangeAfter.add(this, &OptionsObserver::onLeafChangeAfter);
+    m_model->addObserver(this);
+    if (m_optionsIndex.isValid()) {
+        m_indexConnected = m_model->addOptionsIndex(m_query, &m_optionsIndex);
+    }
 }
 
 // =============================================================================
 // (public)
 void OptionsObserver::disconnect()
 {
-    m_model->notifier_nodeInserteAfter.remove(this);
-    m_model->notifier_nodeMoveBefore.remove(this);
-    m_model->notifier_nodeMoveAfter.remove(this);
-    m_model->notifier_nodeCloneAfter.remove(this);
-
-    m_model->notifier_nodeRemoveBefore.remove(this);
-
-    m_model->notifier_leafChangeBefore.remove(this);
-    m_model->notifier_leafChangeAfter.remove(this);
+    m_model->removeObserver(this);
+    if (m_indexConnected) {
+        m_model->removeOptionsIndex(m_query);
+        m_indexConnected = false;
+    }
 }
 
 // =============================================================================
-// (protected)
-void OptionsObserver::onNodeInserteAfter(const NodeIndex &nodeIndex)
+// (public)
+void OptionsObserver::onNodeInserteAfter(const NodePath &nodePath)
 {
-
+    if (!m_indexConnected) { return; }
+    m_optionsIndex.onNodeInserted(nodePath.node(m_model->rootNode()));
 }
 
 // =============================================================================
-// (protected)
-void OptionsObserver::onNodeMoveAfter(const NodeIndex &sourceNodeIndex, const NodeIndex &targetNodeIndex)
+// (public)
+void OptionsObserver::onNodeMoveBefore(const NodePath &sourceNodePath, const NodePath &targetNodePath)
 {
-
+    UNUSED(targetNodePath);
+    if (!m_indexConnected) { return; }
+    m_optionsIndex.onNodeRemove(sourceNodePath.node(m_model->rootNode()));
 }
 
 // =============================================================================
-// (protected)
-void OptionsObserver::onNodeMoveBefore(const NodeIndex &sourceNodeIndex, const NodeIndex &targetNodeIndex)
+// (public)
+void OptionsObserver::onNodeMoveAfter(const NodePath &sourceNodePath, const NodePath &targetNodePath)
 {
-
+    UNUSED(sourceNodePath);
+    if (!m_indexConnected) { return; }
+    m_optionsIndex.onNodeInserted(targetNodePath.node(m_model->rootNode()));
 }
 
 // =============================================================================
-// (protected)
-void OptionsObserver::onNodeCloneAfter(const NodeIndex &sourceNodeIndex, const NodeIndex &targetNodeIndex)
+// (public)
+void OptionsObserver::onNodeCloneAfter(const NodePath &sourceNodePath, const NodePath &targetNodePath)
 {
-
+    UNUSED(sourceNodePath);
+    if (!m_indexConnected) { return; }
+    m_optionsIndex.onNodeInserted(targetNodePath.node(m_model->rootNode()));
 }
 
 // =============================================================================
-// (protected)
-void OptionsObserver::onNodeRemoveBefore(const NodeIndex &nodeIndex)
+// (public)
+void OptionsObserver::onNodeRemoveBefore(const NodePath &nodePath)
 {
-
+    if (!m_indexConnected) { return; }
+    m_optionsIndex.onNodeRemove(nodePath.node(m_model->rootNode()));
 }
 
 // =============================================================================
-// (protected)
-void OptionsObserver::onLeafChangeBefore(const NodeIndex &nodeIndex, const std::string &valueName)
+// (public)
+void OptionsObserver::onLeafChangeBefore(const NodePath &nodePath, const std::string &valueName)
 {
-    // If not valid return as fast as possible
-    if (m_sourceValueName != valueName) { return; }
-    if (m_sourceNodeDef->name() != nodeIndex.lastNodeIndex().name()) { return; }
+    UNUSED(valueName);
+    Node sourceNode = nodePath.node(m_model->rootNode());
+    if (m_indexConnected) {
+        m_optionsIndex.onLeafChangeBefore(sourceNode);
+    }
 
-    Node sourceNode = nodeIndex.node(m_model->rootNode());
+    // The filter lets changes to leaves of the root node through
+    if (nodePath.depth() == 0 || !m_inverseQuery) { return; }
 
-    m_valueBeforeChange = sourceNode.leaf(valueName).value();
+    m_valueBeforeChange = sourceNode.leaf(m_sourceLeaf).value();
 }
 
 // =============================================================================
-// (protected)
-void OptionsObserver::onLeafChangeAfter(const NodeIndex &nodeIndex, const std::string &valueName)
+// (public)
+void OptionsObserver::onLeafChangeAfter(const NodePath &nodePath, const std::string &valueName)
 {
-    // If not valid return as fast as possible
+    UNUSED(valueName);
+    Node sourceNode = nodePath.node(m_model->rootNode());
+    if (m_indexConnected) {
+        m_optionsIndex.onLeafChangeAfter(sourceNode);
+    }
+
     if (m_valueBeforeChange.isNull()) { return; }
-    if (m_sourceValueName != valueName) { return; }
-    if (m_sourceNodeDef->name() != nodeIndex.lastNodeIndex().name()) { return; }
 
-    Node sourceNode = nodeIndex.node(m_model->rootNode());
-    UnionValue newValue = sourceNode.leaf(valueName).value();
+    UnionValue newValue = sourceNode.leaf(m_sourceLeaf).value();
 
     if (m_valueBeforeChange == newValue) { return; }
 
@@ -159,5 +165,12 @@ void OptionsObserver::onLeafChangeAfter(const NodeIndex &nodeIndex, const std::s
     m_valueBeforeChange = UnionValue();
 }
 
+// =============================================================================
+// (public)
+void OptionsObserver::onRootNodeChanged()
+{
+    m_optionsIndex.clear();
+}
+
 } // namespace Oak::Model
 
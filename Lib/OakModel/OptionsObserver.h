@@ -22,13 +22,14 @@
 
 #include "ObserverInterface.h"
 #include "UnionValue.h"
+#include "LeafHandle.h"
+#include "OptionsIndex.h"
 
 
 namespace Oak::Model {
 
 class NodeDef;
 class LeafDef;
-class NodeIndex;
 
 class LeafQuery;
 typedef std::shared_ptr<LeafQuery> LeafQuerySPtr;
@@ -39,29 +40,37 @@ typedef std::shared_ptr<LeafQuery> LeafQuerySPtr;
 class OptionsObserver : public ObserverInterface
 {
 public:
-    OptionsObserver(OakModel * model, const NodeDef *optionsNodeDef, const LeafDef *optionsLeafDef);
+    // Observes the excluded options query if 'excluded' is true. Only the
+    //  option index is updated for it as the excluded values are not renamed
+    OptionsObserver(OakModel * model, const NodeDef *optionsNodeDef, const LeafDef *optionsLeafDef, bool excluded = false);
 
     virtual void connect() override;
     virtual void disconnect() override;
 
-protected:
-    void onNodeInserteAfter(const NodeIndex& nodeIndex);
-    void onNodeMoveAfter(const NodeIndex& sourceNodeIndex, const NodeIndex& targetNodeIndex);
-    void onNodeMoveBefore(const NodeIndex& sourceNodeIndex, const NodeIndex& targetNodeIndex);
-    void onNodeCloneAfter(const NodeIndex& sourceNodeIndex, const NodeIndex& targetNodeIndex);
-
-    void onNodeRemoveBefore(const NodeIndex& nodeIndex);
+    const LeafQuery *query() const { return m_query; }
+    const OptionsIndex &optionsIndex() const { return m_optionsIndex; }
 
-    void onLeafChangeBefore(const NodeIndex& nodeIndex, const std::string &valueName);
-    void onLeafChangeAfter(const NodeIndex& nodeIndex, const std::string &valueName);
+    virtual void onNodeInserteAfter(const NodePath &nodePath) override;
+    virtual void onNodeMoveBefore(const NodePath &sourceNodePath, const NodePath &targetNodePath) override;
+    virtual void onNodeMoveAfter(const NodePath &sourceNodePath, const NodePath &targetNodePath) override;
+    virtual void onNodeCloneAfter(const NodePath &sourceNodePath, const NodePath &targetNodePath) override;
+    virtual void onNodeRemoveBefore(const NodePath &nodePath) override;
+    virtual void onLeafChangeBefore(const NodePath &nodePath, const std::string &valueName) override;
+    virtual void onLeafChangeAfter(const NodePath &nodePath, const std::string &valueName) override;
+    virtual void onRootNodeChanged() override;
 
 protected:
     const NodeDef *m_optionsNodeDef;
     const LeafDef *m_optionsLeafDef;
+    const LeafQuery *m_query;
     LeafQuerySPtr m_inverseQuery;
 
+    // Only maintained if it is the index the model uses for the query
+    OptionsIndex m_optionsIndex;
+    bool m_indexConnected = false;
+
     const NodeDef *m_sourceNodeDef;
-    std::string m_sourceValueName;
+    LeafHandle m_sourceLeaf;
 
     UnionValue m_valueBeforeChange;
 };
@@ -1,17 +1,21 @@
 SOURCES += \
     $$PWD/TableQuery.cpp \
+    $$PWD/TableSnapshot.cpp \
     $$PWD/QueryBuilder.cpp \
     $$PWD/LeafQuery.cpp \
     $$PWD/NodeQuery.cpp \
     $$PWD/NodeQueryChildren.cpp \
     $$PWD/NodeQuerySiblings.cpp \
-    $$PWD/NodeQueryParent.cpp
+    $$PWD/NodeQueryParent.cpp \
+    $$PWD/ThreadPool.cpp
 
 HEADERS += \
     $$PWD/TableQuery.h \
+    $$PWD/TableSnapshot.h \
     $$PWD/QueryBuilder.h \
     $$PWD/LeafQuery.h \
     $$PWD/NodeQuery.h \
     $$PWD/NodeQueryChildren.h \
     $$PWD/NodeQuerySiblings.h \
-    $$PWD/NodeQueryParent.h
+    $$PWD/NodeQueryParent.h \
+    $$PWD/ThreadPool.h
@@ -176,6 +176,8 @@ LeafQuerySPtr QueryBuilder::createLeaf(const std::string &leafName)
 // (public)
 NodeQueryUPtr QueryBuilder::duplicate(const NodeQueryUPtr &c)
 {
+    if (!c) { return NodeQueryUPtr(); }
+
     {
         const NodeQueryChildren * nodeQuery = dynamic_cast<const NodeQueryChildren * >(c.get());
         if (nodeQuery) {
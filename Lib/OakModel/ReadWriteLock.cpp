@@ -0,0 +1,139 @@
+/*
+ * OakModelView (http://oakmodelview.com/)
+ * Author: Mikkel Nøhr Løvgreen (mikkel@oakmodelview.com)
+ * ------------------------------------------------------------------------
+ * Licensed to Vilaversoftware IVS who licenses this file to you under the
+ * Apache License, Version 2.0 (the "License"); you may not use this file
+ * except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ReadWriteLock.h"
+
+#include <vector>
+
+#include "../ServiceFunctions/Assert.h"
+
+
+namespace Oak::Model {
+
+// =============================================================================
+// (public)
+ReadWriteLock::ReadWriteLock()
+    : m_readerCount(0),
+      m_writing(false),
+      m_writerThread(std::thread::id())
+{
+}
+
+// =============================================================================
+// (public)
+void ReadWriteLock::lockRead() const
+{
+    ThreadRead &read = threadRead();
+    if (read.depth++ > 0) { return; }
+
+    // The writing thread reads its own changes
+    read.counted = !isWriting();
+    if (!read.counted) { return; }
+
+    while (true) {
+        m_readerCount++;
+        if (!m_writing) { return; }
+
+        // A writer is active or waiting for the readers to finish
+        if (--m_readerCount == 0) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_condition.notify_all();
+        }
+        waitForWriter();
+    }
+}
+
+// =============================================================================
+// (public)
+void ReadWriteLock::unlockRead() const
+{
+    ThreadRead &read = threadRead();
+    ASSERT(read.depth > 0);
+    if (--read.depth > 0 || !read.counted) { return; }
+
+    if (--m_readerCount == 0 && m_writing) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_condition.notify_all();
+    }
+}
+
+// =============================================================================
+// (public)
+void ReadWriteLock::lockWrite() const
+{
+    if (isWriting()) {
+        m_writeDepth++;
+        return;
+    }
+    ASSERT(threadRead().depth == 0);
+
+    m_writeMutex.lock();
+    m_writing = true;
+    m_writerThread = std::this_thread::get_id();
+    m_writeDepth = 1;
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_condition.wait(lock, [this] { return m_readerCount == 0; });
+}
+
+// =============================================================================
+// (public)
+void ReadWriteLock::unlockWrite() const
+{
+    ASSERT(isWriting());
+    if (--m_writeDepth > 0) { return; }
+
+    m_writerThread = std::thread::id();
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_writing = false;
+    }
+    m_condition.notify_all();
+    m_writeMutex.unlock();
+}
+
+// =============================================================================
+// (protected)
+ReadWriteLock::ThreadRead &ReadWriteLock::threadRead() const
+{
+    // A thread holds read locks on few models at a time so a short list is searched
+    thread_local std::vector<ThreadRead> s_threadReadList;
+    for (ThreadRead &read: s_threadReadList)
+    {
+        if (read.lock == this) { return read; }
+    }
+    for (ThreadRead &read: s_threadReadList)
+    {
+        if (read.depth == 0) {
+            read.lock = this;
+            return read;
+        }
+    }
+    s_threadReadList.push_back({ this, 0, false });
+    return s_threadReadList.back();
+}
+
+// =============================================================================
+// (protected)
+void ReadWriteLock::waitForWriter() const
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_condition.wait(lock, [this] { return !m_writing; });
+}
+
+} // namespace Oak::Model
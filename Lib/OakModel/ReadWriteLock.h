@@ -0,0 +1,78 @@
+/*
+ * OakModelView (http://oakmodelview.com/)
+ * Author: Mikkel Nøhr Løvgreen (mikkel@oakmodelview.com)
+ * ------------------------------------------------------------------------
+ * Licensed to Vilaversoftware IVS who licenses this file to you under the
+ * Apache License, Version 2.0 (the "License"); you may not use this file
+ * except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+
+namespace Oak::Model {
+
+// =============================================================================
+// Class definition
+// =============================================================================
+// Allows many readers or one writer. A read lock that is not contended costs
+//  one atomic increment and readers only wait while a writer is active or
+//  waiting. Read locks can be nested and the thread that holds the write lock
+//  can read without waiting. A thread that holds a read lock must not take the
+//  write lock, as it would wait for itself.
+class ReadWriteLock
+{
+public:
+    ReadWriteLock();
+
+    ReadWriteLock(const ReadWriteLock &copy) = delete;
+    ReadWriteLock& operator=(const ReadWriteLock &copy) = delete;
+
+    void lockRead() const;
+    void unlockRead() const;
+
+    void lockWrite() const;
+    void unlockWrite() const;
+
+    // Returns true if any thread holds a read lock
+    bool isReading() const { return m_readerCount > 0; }
+    // Returns true if the calling thread holds the write lock
+    bool isWriting() const { return m_writerThread == std::this_thread::get_id(); }
+
+protected:
+    struct ThreadRead
+    {
+        const ReadWriteLock *lock;
+        int depth;
+        bool counted;
+    };
+
+    ThreadRead &threadRead() const;
+    void waitForWriter() const;
+
+protected:
+    mutable std::atomic<int> m_readerCount;
+    mutable std::atomic<bool> m_writing;
+    mutable std::atomic<std::thread::id> m_writerThread;
+    mutable int m_writeDepth = 0;
+
+    mutable std::mutex m_writeMutex;
+    mutable std::mutex m_mutex;
+    mutable std::condition_variable m_condition;
+};
+
+} // namespace Oak::Model
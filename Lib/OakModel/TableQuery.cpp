@@ -17,8 +17,10 @@
  */
 
 #include "TableQuery.h"
+#include "OakModel.h"
 
 #include "../ServiceFunctions/Assert.h"
+#include "../ServiceFunctions/Instrumentation.h"
 
 
 namespace Oak::Model {
@@ -68,6 +70,22 @@ int TableQuery::count(const Node &node) const
     return m_nodeQuery->count(node);
 }
 
+// =============================================================================
+// (public)
+Leaf TableQuery::leaf(const Node &rowNode, int column) const
+{
+    if (rowNode.isNull() || column < 0 || column >= columnCount()) { return Leaf::emptyLeaf(); }
+
+    const LeafQuery &leafQuery = *m_leafList[static_cast<vSize>(column)];
+    if (leafQuery.hasNodeQuery()) {
+        auto it = leafQuery.iterator(rowNode);
+        return it->first(rowNode) ? it->leaf() : Leaf::emptyLeaf();
+    }
+
+    int leafIndex = leafQuery.leafHandle().index(rowNode.def());
+    return leafIndex == -1 ? Leaf::emptyLeaf() : rowNode.leafAt(leafIndex);
+}
+
 // =============================================================================
 // (public)
 NodeQuery &TableQuery::nodeQuery()
@@ -82,6 +100,160 @@ const NodeQuery &TableQuery::nodeQuery() const
     return *m_nodeQuery.get();
 }
 
+// =============================================================================
+// (public)
+TableSnapshot TableQuery::materialize(const Node &node) const
+{
+    OAK_SCOPED_TIMER("TableQuery::materialize");
+    ASSERT(m_nodeQuery);
+
+    TableSnapshot snapshot;
+    std::vector<LeafQuery::IteratorUPtr> leafIteratorList;
+    for (const LeafQuerySPtr &leafQuery: m_leafList)
+    {
+        snapshot.addColumn(leafQuery->valueName());
+        // Columns with leafs on other nodes than the row node needs their own iterator
+        if (leafQuery->hasNodeQuery()) {
+            leafIteratorList.push_back(leafQuery->iterator(node));
+        } else {
+            leafIteratorList.push_back(LeafQuery::IteratorUPtr());
+        }
+    }
+
+    const int columnCount = static_cast<int>(m_leafList.size());
+    auto it = m_nodeQuery->iterator(node);
+    while (it->next()) {
+        const Node &rowNode = it->node();
+        for (int column = 0; column < columnCount; column++)
+        {
+            const vSize c = static_cast<vSize>(column);
+            const Node *leafNode = &rowNode;
+            if (leafIteratorList[c]) {
+                leafNode = leafIteratorList[c]->first(rowNode) ? &leafIteratorList[c]->node() : nullptr;
+            }
+
+            const LeafDef *leafDef = nullptr;
+            if (leafNode) {
+                int index = m_leafList[c]->leafHandle().index(leafNode->def());
+                if (index != -1) {
+                    leafDef = &leafNode->def()->value(index);
+                }
+            }
+            snapshot.addValue(column, leafDef, leafDef ? leafNode->nodeData() : rowNode.nodeData());
+        }
+        snapshot.addRow();
+    }
+    snapshot.finish();
+
+    return snapshot;
+}
+
+// =============================================================================
+// (public)
+TableSnapshot TableQuery::materializeParallel(const Node &node, ThreadPool &pool) const
+{
+    OAK_SCOPED_TIMER("TableQuery::materializeParallel");
+    ASSERT(m_nodeQuery);
+
+    // The leaf and node data of every cell are found while the rows are traversed.
+    //  The values are read when the column types are known, as the type of a
+    //  column is given by the first leaf found in it
+    struct Cell
+    {
+        const LeafDef *leafDef;
+        NodeData nodeData;
+    };
+
+    struct Range
+    {
+        std::vector<LeafQuerySPtr> leafQueryList;
+        std::vector<LeafHandle> leafList;
+        std::vector<Cell> cellList;
+        int rowCount = 0;
+        TableSnapshot part;
+    };
+
+    OakModel::ReadLock readLock(node.model());
+
+    const vSize columnCount = m_leafList.size();
+    std::vector<Range> rangeList;
+    m_nodeQuery->forEachRangeParallel(node, [&rangeList](int rangeCount) {
+        rangeList.resize(static_cast<vSize>(rangeCount));
+    }, [&](int rangeIndex, const Node &rowNode) {
+        Range &range = rangeList[static_cast<vSize>(rangeIndex)];
+        if (range.leafList.empty()) {
+            // Queries keep state while they are traversed so every range runs its own copy
+            for (const LeafQuerySPtr &leafQuery: m_leafList)
+            {
+                range.leafQueryList.push_back(leafQuery->hasNodeQuery() ? leafQuery->duplicate() : LeafQuerySPtr());
+                range.leafList.push_back(leafQuery->leafHandle());
+            }
+        }
+
+        for (vSize c = 0; c < columnCount; c++) {
+            Node leafNode = rowNode;
+            if (range.leafQueryList[c]) {
+                LeafQuery::IteratorUPtr it = range.leafQueryList[c]->iterator(rowNode);
+                leafNode = it->first(rowNode) ? it->node() : Node();
+            }
+
+            const LeafDef *leafDef = nullptr;
+            if (!leafNode.isNull()) {
+                int index = range.leafList[c].index(leafNode.def());
+                if (index != -1) {
+                    leafDef = &leafNode.def()->value(index);
+                }
+            }
+            range.cellList.push_back({ leafDef, leafDef ? leafNode.nodeData() : rowNode.nodeData() });
+        }
+        range.rowCount++;
+    }, pool);
+
+    std::vector<UnionType> typeList(columnCount, UnionType::Undefined);
+    for (const Range &range: rangeList)
+    {
+        for (vSize i = 0; i < range.cellList.size(); i++) {
+            const Cell &cell = range.cellList[i];
+            if (cell.leafDef && typeList[i % columnCount] == UnionType::Undefined) {
+                typeList[i % columnCount] = cell.leafDef->valueType();
+            }
+        }
+    }
+
+    std::vector<ThreadPool::Task> taskList;
+    for (Range &range: rangeList)
+    {
+        taskList.push_back([&]() {
+            for (vSize c = 0; c < columnCount; c++) {
+                range.part.addColumn(m_leafList[c]->valueName());
+                range.part.setColumnType(static_cast<int>(c), typeList[c]);
+            }
+            const Cell *cell = range.cellList.data();
+            for (int row = 0; row < range.rowCount; row++) {
+                for (vSize c = 0; c < columnCount; c++) {
+                    range.part.addValue(static_cast<int>(c), cell->leafDef, cell->nodeData);
+                    cell++;
+                }
+                range.part.addRow();
+            }
+        });
+    }
+    pool.run(taskList);
+
+    TableSnapshot snapshot;
+    for (vSize c = 0; c < columnCount; c++) {
+        snapshot.addColumn(m_leafList[c]->valueName());
+        snapshot.setColumnType(static_cast<int>(c), typeList[c]);
+    }
+    for (const Range &range: rangeList)
+    {
+        snapshot.append(range.part);
+    }
+    snapshot.finish();
+
+    return snapshot;
+}
+
 // =============================================================================
 // (public)
 TableQuery::IteratorUPtr TableQuery::iterator(const Node &refNode) const
@@ -123,7 +295,13 @@ TableQuery::Iterator::Iterator(const TableQuery &tableQuery, const Node *refNode
     size_t count = static_cast<size_t>(m_tableQuery->columnCount());
     for (size_t i = 0; i < count; i++)
     {
-        m_leafIteratorList.push_back(new LeafQuery::Iterator(*m_tableQuery->m_leafList[i].get()));
+        const LeafQuery &leafQuery = *m_tableQuery->m_leafList[i].get();
+        // Leafs of the row node are looked up directly in leaf()
+        if (leafQuery.hasNodeQuery()) {
+            m_leafIteratorList.push_back(new LeafQuery::Iterator(leafQuery));
+        } else {
+            m_leafIteratorList.push_back(nullptr);
+        }
     }
 }
 
@@ -137,12 +315,11 @@ TableQuery::Iterator::~Iterator()
     }
     m_leafIteratorList.clear();
     m_tableQuery = nullptr;
-    NodeQuery::Iterator::~Iterator();
 }
 
 // =============================================================================
 // (public)
-const Leaf &TableQuery::Iterator::leaf(int index) const
+Leaf TableQuery::Iterator::leaf(int index) const
 {
     if (!isValid() ||
         index >= static_cast<int>(m_leafIteratorList.size())) {
@@ -151,6 +328,10 @@ const Leaf &TableQuery::Iterator::leaf(int index) const
 
     auto eIt = m_leafIteratorList[static_cast<size_t>(index)];
     Node i = node();
+    if (!eIt) {
+        int leafIndex = m_tableQuery->m_leafList[static_cast<size_t>(index)]->leafHandle().index(i.def());
+        return leafIndex == -1 ? Leaf::emptyLeaf() : i.leafAt(leafIndex);
+    }
     if (eIt->first(i)) {
         return eIt->leaf();
     }
@@ -161,7 +342,7 @@ const Leaf &TableQuery::Iterator::leaf(int index) const
 // (public)
 void TableQuery::Iterator::getValue(int index, UnionValue value) const
 {
-    const Leaf &e = leaf(index);
+    Leaf e = leaf(index);
     if (e.isNull()) { return; }
     e.getValue(value);
 }
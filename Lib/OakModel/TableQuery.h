@@ -19,6 +19,7 @@
 #pragma once
 
 #include "LeafQuery.h"
+#include "TableSnapshot.h"
 
 
 namespace Oak::Model {
@@ -37,15 +38,25 @@ public:
     TableQuery(NodeQueryUPtr nodeQuery);
 
     void setNodeQuery(NodeQueryUPtr nodeQuery);
+    bool hasNodeQuery() const { return static_cast<bool>(m_nodeQuery); }
 
     int columnCount() const;
     void addValueQuery(LeafQuerySPtr valueQuery);
 
     int count(const Node &node) const;
 
+    // Returns the leaf of the column found from a node of the node query
+    Leaf leaf(const Node &rowNode, int column) const;
+
     NodeQuery &nodeQuery();
     const NodeQuery &nodeQuery() const;
 
+    // Reads all the rows in one traversal into typed contiguous columns
+    TableSnapshot materialize(const Node &node) const;
+    // Returns the same snapshot as materialize() but the rows are read on the
+    //  threads of 'pool' (See NodeQuery::forEachParallel())
+    TableSnapshot materializeParallel(const Node &node, ThreadPool &pool = ThreadPool::global()) const;
+
 protected:
     NodeQueryUPtr m_nodeQuery;
     std::vector<LeafQuerySPtr> m_leafList; // Should be a valueRef (to be leafRef)
@@ -59,7 +70,7 @@ public:
 
         virtual ~Iterator() override;
 
-        const Leaf &leaf(int index) const;
+        Leaf leaf(int index) const;
         void getValue(int index, UnionValue value) const;
 
         template<typename T>
@@ -83,7 +94,7 @@ public:
 template<typename T>
 T TableQuery::Iterator::value(int index)
 {
-    const Leaf &e = leaf(index);
+    Leaf e = leaf(index);
     if (e.isNull()) { T(); }
     return e.value<T>();
 }
@@ -0,0 +1,250 @@
+/*
+ * OakModelView (http://oakmodelview.com/)
+ * Author: Mikkel Nøhr Løvgreen (mikkel@oakmodelview.com)
+ * ------------------------------------------------------------------------
+ * Licensed to Vilaversoftware IVS who licenses this file to you under the
+ * Apache License, Version 2.0 (the "License"); you may not use this file
+ * except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "TableSnapshot.h"
+
+#include "LeafDef.h"
+
+#include "../ServiceFunctions/Assert.h"
+
+
+namespace Oak::Model {
+
+// =============================================================================
+// (public)
+bool TableSnapshot::Column::isNull(int row) const
+{
+    ASSERT(row >= 0);
+    vSize word = static_cast<vSize>(row) / 64;
+    if (word >= m_validBits.size()) { return true; }
+    return (m_validBits[word] & (uint64_t(1) << (row % 64))) == 0;
+}
+
+// =============================================================================
+// (protected)
+void TableSnapshot::Column::setType(UnionType type, size_t rowCount)
+{
+    m_type = type;
+    switch (m_type) {
+    case UnionType::Undefined:
+        break;
+    case UnionType::Bool:
+        m_boolValues.resize(rowCount, 0);
+        break;
+    case UnionType::Integer:
+        m_intValues.resize(rowCount, 0);
+        break;
+    case UnionType::Double:
+        m_doubleValues.resize(rowCount, 0.0);
+        break;
+    case UnionType::DateTime:
+        m_dateTimeValues.resize(rowCount);
+        break;
+    default:
+        m_type = UnionType::String;
+        m_stringIds.resize(rowCount, -1);
+        break;
+    }
+}
+
+// =============================================================================
+// (public)
+const TableSnapshot::Column &TableSnapshot::column(int index) const
+{
+    ASSERT(index >= 0 && index < columnCount());
+    return m_columnList[static_cast<vSize>(index)];
+}
+
+// =============================================================================
+// (public)
+const std::string &TableSnapshot::string(int id) const
+{
+    static const std::string emptyString;
+    if (id < 0 || id >= static_cast<int>(m_stringDictionary.size())) { return emptyString; }
+    return m_stringDictionary[static_cast<vSize>(id)];
+}
+
+// =============================================================================
+// (protected)
+void TableSnapshot::addColumn(const std::string &name)
+{
+    ASSERT(m_rowCount == 0);
+    Column column;
+    column.m_name = name;
+    m_columnList.push_back(std::move(column));
+}
+
+// =============================================================================
+// (protected)
+void TableSnapshot::addValue(int column, const LeafDef *leafDef, const NodeData &nodeData)
+{
+    Column &c = m_columnList[static_cast<vSize>(column)];
+    const vSize row = static_cast<vSize>(m_rowCount);
+
+    if (row % 64 == 0) {
+        c.m_validBits.push_back(0);
+    }
+
+    // The column type is given by the first 'LeafDef' found in the column
+    if (c.m_type == UnionType::Undefined && leafDef != nullptr) {
+        c.setType(leafDef->valueType(), row);
+    }
+
+    bool valid = false;
+    switch (c.m_type) {
+    case UnionType::Undefined:
+        break;
+    case UnionType::Bool: {
+        bool value = false;
+        valid = leafDef && leafDef->getValue(nodeData, UnionRef(value));
+        c.m_boolValues.push_back(value ? 1 : 0);
+        break;
+    }
+    case UnionType::Integer: {
+        int value = 0;
+        valid = leafDef && leafDef->getValue(nodeData, UnionRef(value));
+        c.m_intValues.push_back(value);
+        break;
+    }
+    case UnionType::Double: {
+        double value = 0.0;
+        valid = leafDef && leafDef->getValue(nodeData, UnionRef(value));
+        c.m_doubleValues.push_back(value);
+        break;
+    }
+    case UnionType::DateTime: {
+        c.m_dateTimeValues.emplace_back();
+        valid = leafDef && leafDef->getValue(nodeData, UnionRef(c.m_dateTimeValues.back()));
+        break;
+    }
+    default:
+        valid = leafDef && leafDef->getValue(nodeData, UnionRef(m_tempString));
+        c.m_stringIds.push_back(valid ? internString(m_tempString) : -1);
+        break;
+    }
+
+    if (valid) {
+        c.m_validBits.back() |= uint64_t(1) << (row % 64);
+    } else {
+        c.m_nullCount++;
+    }
+}
+
+// =============================================================================
+// (protected)
+void TableSnapshot::addRow()
+{
+    m_rowCount++;
+}
+
+// =============================================================================
+// (protected)
+void TableSnapshot::finish()
+{
+    std::unordered_map<std::string, int>().swap(m_stringMap);
+    std::string().swap(m_tempString);
+}
+
+// =============================================================================
+// (protected)
+void TableSnapshot::setColumnType(int column, UnionType type)
+{
+    ASSERT(m_rowCount == 0);
+    m_columnList[static_cast<vSize>(column)].setType(type, 0);
+}
+
+// =============================================================================
+// (protected)
+void TableSnapshot::append(const TableSnapshot &part)
+{
+    ASSERT(part.columnCount() == columnCount());
+
+    const vSize rowOffset = static_cast<vSize>(m_rowCount);
+    const vSize rowCount = rowOffset + static_cast<vSize>(part.m_rowCount);
+
+    // The dictionary of the part is in the order the strings are first found,
+    //  so interning it in order gives the same ids as reading the rows here
+    std::vector<int> stringIdList;
+    stringIdList.reserve(part.m_stringDictionary.size());
+    for (const std::string &str: part.m_stringDictionary)
+    {
+        stringIdList.push_back(internString(str));
+    }
+
+    for (vSize i = 0; i < m_columnList.size(); i++) {
+        Column &c = m_columnList[i];
+        const Column &p = part.m_columnList[i];
+        ASSERT(c.m_type == p.m_type || p.m_type == UnionType::Undefined);
+        if (c.m_type == UnionType::Undefined && p.m_type != UnionType::Undefined) {
+            c.setType(p.m_type, rowOffset);
+        }
+
+        switch (c.m_type) {
+        case UnionType::Undefined:
+            break;
+        case UnionType::Bool:
+            c.m_boolValues.insert(c.m_boolValues.end(), p.m_boolValues.begin(), p.m_boolValues.end());
+            break;
+        case UnionType::Integer:
+            c.m_intValues.insert(c.m_intValues.end(), p.m_intValues.begin(), p.m_intValues.end());
+            break;
+        case UnionType::Double:
+            c.m_doubleValues.insert(c.m_doubleValues.end(), p.m_doubleValues.begin(), p.m_doubleValues.end());
+            break;
+        case UnionType::DateTime:
+            c.m_dateTimeValues.insert(c.m_dateTimeValues.end(), p.m_dateTimeValues.begin(), p.m_dateTimeValues.end());
+            break;
+        default:
+            for (int id: p.m_stringIds)
+            {
+                c.m_stringIds.push_back(id == -1 ? -1 : stringIdList[static_cast<vSize>(id)]);
+            }
+            break;
+        }
+        // Columns of a part where no leaf was found has no values
+        if (p.m_type == UnionType::Undefined && c.m_type != UnionType::Undefined) {
+            c.setType(c.m_type, rowCount);
+        }
+
+        c.m_validBits.resize((rowCount + 63) / 64, 0);
+        for (vSize row = 0; row < static_cast<vSize>(part.m_rowCount); row++) {
+            if (p.m_validBits[row / 64] & (uint64_t(1) << (row % 64))) {
+                const vSize r = rowOffset + row;
+                c.m_validBits[r / 64] |= uint64_t(1) << (r % 64);
+            }
+        }
+        c.m_nullCount += p.m_nullCount;
+    }
+
+    m_rowCount = static_cast<int>(rowCount);
+}
+
+// =============================================================================
+// (protected)
+int TableSnapshot::internString(const std::string &str)
+{
+    auto it = m_stringMap.find(str);
+    if (it != m_stringMap.end()) { return it->second; }
+
+    int id = static_cast<int>(m_stringDictionary.size());
+    m_stringDictionary.push_back(str);
+    m_stringMap.emplace(str, id);
+    return id;
+}
+
+} // namespace Oak::Model
@@ -0,0 +1,114 @@
+/*
+ * OakModelView (http://oakmodelview.com/)
+ * Author: Mikkel Nøhr Løvgreen (mikkel@oakmodelview.com)
+ * ------------------------------------------------------------------------
+ * Licensed to Vilaversoftware IVS who licenses this file to you under the
+ * Apache License, Version 2.0 (the "License"); you may not use this file
+ * except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+
+#include "Union.h"
+#include "DateTime.h"
+
+
+namespace Oak::Model {
+
+class LeafDef;
+class NodeData;
+
+// =============================================================================
+// Class definition
+// =============================================================================
+class TableSnapshot
+{
+public:
+    // Values of one column stored in a contiguous vector of the 'LeafDef' value type
+    class Column
+    {
+    public:
+        const std::string &name() const { return m_name; }
+        UnionType type() const { return m_type; }
+
+        bool isNull(int row) const;
+        int nullCount() const { return m_nullCount; }
+
+        // Only the vector matching 'type()' has values; null entries are default values
+        const std::vector<char> &boolValues() const { return m_boolValues; }
+        const std::vector<int> &intValues() const { return m_intValues; }
+        const std::vector<double> &doubleValues() const { return m_doubleValues; }
+        const std::vector<DateTime> &dateTimeValues() const { return m_dateTimeValues; }
+        // Index into 'TableSnapshot::stringDictionary()' or -1 if the value is null
+        const std::vector<int> &stringIds() const { return m_stringIds; }
+
+        // Bit 'row % 64' of word 'row / 64' is set when the value is not null
+        const std::vector<uint64_t> &validBits() const { return m_validBits; }
+
+    protected:
+        std::string m_name;
+        UnionType m_type = UnionType::Undefined;
+        int m_nullCount = 0;
+
+        std::vector<char> m_boolValues;
+        std::vector<int> m_intValues;
+        std::vector<double> m_doubleValues;
+        std::vector<DateTime> m_dateTimeValues;
+        std::vector<int> m_stringIds;
+
+        std::vector<uint64_t> m_validBits;
+
+        void setType(UnionType type, size_t rowCount);
+
+        friend class TableSnapshot;
+    };
+
+public:
+    int rowCount() const { return m_rowCount; }
+    int columnCount() const { return static_cast<int>(m_columnList.size()); }
+
+    const Column &column(int index) const;
+
+    const std::vector<std::string> &stringDictionary() const { return m_stringDictionary; }
+    const std::string &string(int id) const;
+
+protected:
+    void addColumn(const std::string &name);
+    void addValue(int column, const LeafDef *leafDef, const NodeData &nodeData);
+    void addRow();
+    void finish();
+
+    // Used when the rows are read in parts. The column type is set before any
+    //  rows are added and the parts are appended in the order of the rows
+    void setColumnType(int column, UnionType type);
+    void append(const TableSnapshot &part);
+
+    int internString(const std::string &str);
+
+protected:
+    int m_rowCount = 0;
+    std::vector<Column> m_columnList;
+    std::vector<std::string> m_stringDictionary;
+
+    // Only used while the snapshot is built
+    std::unordered_map<std::string, int> m_stringMap;
+    std::string m_tempString;
+
+    friend class TableQuery;
+};
+
+} // namespace Oak::Model
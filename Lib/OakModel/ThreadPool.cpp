@@ -0,0 +1,172 @@
+/*
+ * OakModelView (http://oakmodelview.com/)
+ * Author: Mikkel Nøhr Løvgreen (mikkel@oakmodelview.com)
+ * ------------------------------------------------------------------------
+ * Licensed to Vilaversoftware IVS who licenses this file to you under the
+ * Apache License, Version 2.0 (the "License"); you may not use this file
+ * except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ThreadPool.h"
+
+#include "../ServiceFunctions/Assert.h"
+
+
+namespace Oak::Model {
+
+thread_local bool ThreadPool::s_isRunning = false;
+
+// =============================================================================
+// (public)
+ThreadPool::ThreadPool(int threadCount)
+    : m_queuedCount(0),
+      m_pendingCount(0)
+{
+    if (threadCount < 0) {
+        threadCount = static_cast<int>(std::thread::hardware_concurrency()) - 1;
+    }
+    if (threadCount < 0) { threadCount = 0; }
+
+    for (int i = 0; i <= threadCount; i++) {
+        m_queueList.push_back(std::make_unique<Queue>());
+    }
+    for (size_t i = 0; i < static_cast<size_t>(threadCount); i++) {
+        m_threadList.emplace_back(&ThreadPool::workerLoop, this, i);
+    }
+}
+
+// =============================================================================
+// (public)
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_taskCondition.notify_all();
+    for (std::thread &thread: m_threadList)
+    {
+        thread.join();
+    }
+}
+
+// =============================================================================
+// (public)
+void ThreadPool::run(std::vector<Task> &taskList)
+{
+    if (taskList.empty()) { return; }
+
+    std::unique_lock<std::mutex> runLock(m_runMutex, std::defer_lock);
+    if (m_threadList.empty() || taskList.size() == 1 || s_isRunning || !runLock.try_lock()) {
+        for (Task &task: taskList)
+        {
+            task();
+        }
+        return;
+    }
+
+    // The count is raised before the tasks are queued so it never drops below zero
+    m_pendingCount = static_cast<int>(taskList.size());
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_queuedCount += static_cast<int>(taskList.size());
+    }
+
+    // The tasks are dealt out round robin so neighbouring tasks start on different threads
+    for (size_t i = 0; i < taskList.size(); i++) {
+        Queue &queue = *m_queueList[i % m_queueList.size()];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.taskList.push_back(&taskList[i]);
+    }
+    m_taskCondition.notify_all();
+
+    const size_t queueIndex = m_queueList.size() - 1;
+    while (Task *task = takeTask(queueIndex)) {
+        runTask(task);
+    }
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_doneCondition.wait(lock, [this] { return m_pendingCount == 0; });
+}
+
+// =============================================================================
+// (public static)
+ThreadPool &ThreadPool::global()
+{
+    static ThreadPool pool;
+    return pool;
+}
+
+// =============================================================================
+// (protected)
+ThreadPool::Task *ThreadPool::takeTask(size_t queueIndex)
+{
+    if (m_queuedCount == 0) { return nullptr; }
+
+    // The own queue is used from the back and the other queues from the front
+    {
+        Queue &queue = *m_queueList[queueIndex];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (!queue.taskList.empty()) {
+            Task *task = queue.taskList.back();
+            queue.taskList.pop_back();
+            m_queuedCount--;
+            return task;
+        }
+    }
+
+    for (size_t i = 1; i < m_queueList.size(); i++) {
+        Queue &queue = *m_queueList[(queueIndex + i) % m_queueList.size()];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (!queue.taskList.empty()) {
+            Task *task = queue.taskList.front();
+            queue.taskList.pop_front();
+            m_queuedCount--;
+            return task;
+        }
+    }
+    return nullptr;
+}
+
+// =============================================================================
+// (protected)
+void ThreadPool::runTask(Task *task)
+{
+    ASSERT(task);
+    s_isRunning = true;
+    (*task)();
+    s_isRunning = false;
+
+    if (--m_pendingCount == 0) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_doneCondition.notify_all();
+    }
+}
+
+// =============================================================================
+// (protected)
+void ThreadPool::workerLoop(size_t queueIndex)
+{
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_taskCondition.wait(lock, [this] { return m_stop || m_queuedCount > 0; });
+            if (m_stop) { return; }
+        }
+
+        while (Task *task = takeTask(queueIndex)) {
+            runTask(task);
+        }
+    }
+}
+
+} // namespace Oak::Model
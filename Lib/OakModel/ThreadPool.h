@@ -0,0 +1,87 @@
+/*
+ * OakModelView (http://oakmodelview.com/)
+ * Author: Mikkel Nøhr Løvgreen (mikkel@oakmodelview.com)
+ * ------------------------------------------------------------------------
+ * Licensed to Vilaversoftware IVS who licenses this file to you under the
+ * Apache License, Version 2.0 (the "License"); you may not use this file
+ * except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+namespace Oak::Model {
+
+// =============================================================================
+// Class definition
+// =============================================================================
+// A fixed set of worker threads that run lists of tasks. Every thread has its
+//  own queue of tasks and takes tasks from the queues of the other threads when
+//  its own queue is empty, so uneven tasks are spread over all the threads.
+class ThreadPool
+{
+public:
+    typedef std::function<void()> Task;
+
+    // A thread count of -1 uses one thread less than the hardware supports,
+    //  as the thread that calls run() takes part in running the tasks
+    ThreadPool(int threadCount = -1);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool &copy) = delete;
+    ThreadPool& operator=(const ThreadPool &copy) = delete;
+
+    int threadCount() const { return static_cast<int>(m_threadList.size()); }
+
+    // Runs all the tasks and returns when they are done. Tasks that call run()
+    //  and calls from other threads while tasks are running run the tasks serially
+    void run(std::vector<Task> &taskList);
+
+    // Shared pool used by the parallel queries
+    static ThreadPool &global();
+
+protected:
+    struct Queue
+    {
+        std::mutex mutex;
+        std::deque<Task*> taskList;
+    };
+
+    Task *takeTask(size_t queueIndex);
+    void runTask(Task *task);
+    void workerLoop(size_t queueIndex);
+
+protected:
+    std::vector<std::unique_ptr<Queue>> m_queueList; // The last queue is used by the thread calling run()
+    std::vector<std::thread> m_threadList;
+
+    std::mutex m_runMutex;
+    std::mutex m_mutex;
+    std::condition_variable m_taskCondition;
+    std::condition_variable m_doneCondition;
+    std::atomic<int> m_queuedCount;
+    std::atomic<int> m_pendingCount;
+    bool m_stop = false;
+
+    static thread_local bool s_isRunning;
+};
+
+} // namespace Oak::Model
@@ -0,0 +1,531 @@
+/*
+ * OakModelView (http://oakmodelview.com/)
+ * Author: Mikkel Nøhr Løvgreen (mikkel@oakmodelview.com)
+ * ------------------------------------------------------------------------
+ * Licensed to Vilaversoftware IVS who licenses this file to you under the
+ * Apache License, Version 2.0 (the "License"); you may not use this file
+ * except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "UndoJournal.h"
+
+#include "OakModel.h"
+#include "Leaf.h"
+
+#ifdef XML_BACKEND
+#include "XMLDocument.h"
+#endif // XML_BACKEND
+
+#include "../ServiceFunctions/Trace.h"
+
+
+namespace Oak::Model {
+
+// =============================================================================
+// (public)
+UndoJournal::UndoJournal(OakModel *model)
+    : ObserverInterface(model)
+{
+}
+
+// =============================================================================
+// (public)
+UndoJournal::~UndoJournal()
+{
+    disconnect();
+}
+
+// =============================================================================
+// (public)
+void UndoJournal::connect()
+{
+    if (m_connected || m_model == nullptr) { return; }
+    m_model->addObserver(this);
+    m_model->notifier_rootNodeDataChanged.add(this, &UndoJournal::clear);
+    m_model->notifier_rootNodeDefChanged.add(this, &UndoJournal::clear);
+    m_model->notifier_destroyed.add(this, &UndoJournal::modelDestroyed);
+    m_connected = true;
+}
+
+// =============================================================================
+// (public)
+void UndoJournal::disconnect()
+{
+    if (!m_connected || m_model == nullptr) { return; }
+    m_model->removeObserver(this);
+    m_model->notifier_rootNodeDataChanged.remove(this);
+    m_model->notifier_rootNodeDefChanged.remove(this);
+    m_model->notifier_destroyed.remove(this);
+    m_connected = false;
+    m_pendingList.clear();
+}
+
+// =============================================================================
+// (public)
+bool UndoJournal::undo()
+{
+    if (m_undoList.empty() || m_model == nullptr) { return false; }
+
+    Entry entry = std::move(m_undoList.back());
+    m_undoList.pop_back();
+    m_memoryUsage -= entry.memorySize;
+
+    bool result = true;
+    m_replaying = true;
+    {
+        OakModel::Batch batch(m_model);
+        for (auto it = entry.operationList.rbegin(); it != entry.operationList.rend(); it++)
+        {
+            result = apply(*it, true) && result;
+        }
+    }
+    m_replaying = false;
+    m_startNewEntry = true;
+
+    updateMemoryUsage(entry);
+    m_redoList.push_back(std::move(entry));
+    return result;
+}
+
+// =============================================================================
+// (public)
+bool UndoJournal::redo()
+{
+    if (m_redoList.empty() || m_model == nullptr) { return false; }
+
+    Entry entry = std::move(m_redoList.back());
+    m_redoList.pop_back();
+    m_memoryUsage -= entry.memorySize;
+
+    bool result = true;
+    m_replaying = true;
+    {
+        OakModel::Batch batch(m_model);
+        for (Operation &operation: entry.operationList)
+        {
+            result = apply(operation, false) && result;
+        }
+    }
+    m_replaying = false;
+    m_startNewEntry = true;
+
+    updateMemoryUsage(entry);
+    m_undoList.push_back(std::move(entry));
+    trimToLimit();
+    return result;
+}
+
+// =============================================================================
+// (public)
+void UndoJournal::clear()
+{
+    m_undoList.clear();
+    m_redoList.clear();
+    m_pendingList.clear();
+    m_memoryUsage = 0;
+    m_startNewEntry = true;
+}
+
+// =============================================================================
+// (public)
+void UndoJournal::beginGroup()
+{
+    if (m_groupDepth == 0 && !m_batchOpen) {
+        m_startNewEntry = true;
+    }
+    m_groupDepth++;
+}
+
+// =============================================================================
+// (public)
+void UndoJournal::endGroup()
+{
+    ASSERT(m_groupDepth > 0);
+    if (m_groupDepth > 0) {
+        m_groupDepth--;
+    }
+}
+
+// =============================================================================
+// (public)
+void UndoJournal::setMemoryLimit(size_t bytes)
+{
+    m_memoryLimit = bytes;
+    trimToLimit();
+}
+
+// =============================================================================
+// (public)
+void UndoJournal::onNodeInserteBefore(const NodePath &nodePath)
+{
+    UNUSED(nodePath);
+    beginChange(Operation::Type::NodeInserte);
+}
+
+// =============================================================================
+// (public)
+void UndoJournal::onNodeInserteAfter(const NodePath &nodePath)
+{
+    if (m_replaying || m_pendingList.empty()) { return; }
+    Operation operation = std::move(m_pendingList.back());
+    m_pendingList.pop_back();
+
+    operation.nodePath = nodePath;
+    addOperation(std::move(operation));
+}
+
+// =============================================================================
+// (public)
+void UndoJournal::onNodeMoveBefore(const NodePath &sourceNodePath, const NodePath &targetNodePath)
+{
+    UNUSED(sourceNodePath);
+    UNUSED(targetNodePath);
+    beginChange(Operation::Type::NodeMove);
+}
+
+// =============================================================================
+// (public)
+void UndoJournal::onNodeMoveAfter(const NodePath &sourceNodePath, const NodePath &targetNodePath)
+{
+    if (m_replaying || m_pendingList.empty()) { return; }
+    Operation operation = std::move(m_pendingList.back());
+    m_pendingList.pop_back();
+
+    operation.nodePath = sourceNodePath;
+    operation.targetNodePath = targetNodePath;
+    addOperation(std::move(operation));
+}
+
+// =============================================================================
+// (public)
+void UndoJournal::onNodeCloneBefore(const NodePath &sourceNodePath, const NodePath &targetNodePath)
+{
+    UNUSED(sourceNodePath);
+    UNUSED(targetNodePath);
+    // The clone is undone by removing it like any other inserted node
+    beginChange(Operation::Type::NodeInserte);
+}
+
+// =============================================================================
+// (public)
+void UndoJournal::onNodeCloneAfter(const NodePath &sourceNodePath, const NodePath &targetNodePath)
+{
+    UNUSED(sourceNodePath);
+    onNodeInserteAfter(targetNodePath);
+}
+
+// =============================================================================
+// (public)
+void UndoJournal::onNodeRemoveBefore(const NodePath &nodePath)
+{
+    beginChange(Operation::Type::NodeRemove);
+    if (m_replaying) { return; }
+
+    Operation &operation = m_pendingList.back();
+    operation.nodePath = nodePath;
+    serialize(nodePath.node(m_model->rootNode()), operation.subtree);
+}
+
+// =============================================================================
+// (public)
+void UndoJournal::onNodeRemoveAfter(const NodePath &nodePath)
+{
+    UNUSED(nodePath);
+    if (m_replaying || m_pendingList.empty()) { return; }
+    Operation operation = std::move(m_pendingList.back());
+    m_pendingList.pop_back();
+
+    addOperation(std::move(operation));
+}
+
+// =============================================================================
+// (public)
+void UndoJournal::onLeafChangeBefore(const NodePath &nodePath, const std::string &valueName)
+{
+    beginChange(Operation::Type::LeafChange);
+    if (m_replaying) { return; }
+
+    Operation &operation = m_pendingList.back();
+    operation.nodePath = nodePath;
+    operation.valueName = valueName;
+    Node node = nodePath.node(m_model->rootNode());
+    if (!node.isNull()) {
+        operation.oldValue = node.leaf(valueName).value();
+    }
+}
+
+// =============================================================================
+// (public)
+void UndoJournal::onLeafChangeAfter(const NodePath &nodePath, const std::string &valueName)
+{
+    UNUSED(valueName);
+    if (m_replaying || m_pendingList.empty()) { return; }
+    Operation operation = std::move(m_pendingList.back());
+    m_pendingList.pop_back();
+
+    Node node = nodePath.node(m_model->rootNode());
+    if (!node.isNull()) {
+        operation.newValue = node.leaf(operation.valueName).value();
+    }
+    if (operation.newValue == operation.oldValue) { return; }
+
+    addOperation(std::move(operation));
+}
+
+// =============================================================================
+// (public)
+void UndoJournal::onBatchBegin()
+{
+    if (m_groupDepth == 0) {
+        m_startNewEntry = true;
+    }
+    m_batchOpen = true;
+}
+
+// =============================================================================
+// (public)
+void UndoJournal::onBatchEnd()
+{
+    m_batchOpen = false;
+}
+
+// =============================================================================
+// (protected)
+size_t UndoJournal::Operation::memorySize() const
+{
+    size_t size = sizeof(Operation) + subtree.capacity() + valueName.capacity();
+    if (oldValue.type() == UnionType::String) { size += oldValue.getCString().capacity(); }
+    if (newValue.type() == UnionType::String) { size += newValue.getCString().capacity(); }
+    return size;
+}
+
+// =============================================================================
+// (protected)
+void UndoJournal::beginChange(Operation::Type type)
+{
+    if (m_replaying) { return; }
+
+    // Changes made by observers while another change is reported belongs to the same entry
+    if (m_pendingList.empty() && m_groupDepth == 0 && !m_batchOpen) {
+        m_startNewEntry = true;
+    }
+
+    Operation operation;
+    operation.type = type;
+    m_pendingList.push_back(std::move(operation));
+}
+
+// =============================================================================
+// (protected)
+void UndoJournal::addOperation(Operation &&operation)
+{
+    // A new change makes the undone changes invalid
+    for (const Entry &entry: m_redoList)
+    {
+        m_memoryUsage -= entry.memorySize;
+    }
+    m_redoList.clear();
+
+    if (m_startNewEntry || m_undoList.empty()) {
+        m_undoList.push_back(Entry());
+        m_startNewEntry = false;
+    }
+    Entry &entry = m_undoList.back();
+
+    // Repeated changes of the same leaf only needs the first old value
+    if (operation.type == Operation::Type::LeafChange && !entry.operationList.empty()) {
+        Operation &last = entry.operationList.back();
+        if (last.type == Operation::Type::LeafChange &&
+            last.valueName == operation.valueName &&
+            last.nodePath == operation.nodePath) {
+            last.newValue = std::move(operation.newValue);
+            m_memoryUsage -= entry.memorySize;
+            updateMemoryUsage(entry);
+            return;
+        }
+    }
+
+    m_memoryUsage -= entry.memorySize;
+    entry.operationList.push_back(std::move(operation));
+    updateMemoryUsage(entry);
+    trimToLimit();
+}
+
+// =============================================================================
+// (protected)
+void UndoJournal::updateMemoryUsage(Entry &entry)
+{
+    entry.memorySize = sizeof(Entry);
+    for (const Operation &operation: entry.operationList)
+    {
+        entry.memorySize += operation.memorySize();
+    }
+    m_memoryUsage += entry.memorySize;
+}
+
+// =============================================================================
+// (protected)
+void UndoJournal::trimToLimit()
+{
+    // Redo entries are dropped first since they are the least likely to be used
+    while (m_memoryUsage > m_memoryLimit && !m_redoList.empty()) {
+        m_memoryUsage -= m_redoList.front().memorySize;
+        m_redoList.erase(m_redoList.begin());
+    }
+    while (m_memoryUsage > m_memoryLimit && m_undoList.size() > 1) {
+        m_memoryUsage -= m_undoList.front().memorySize;
+        m_undoList.pop_front();
+    }
+}
+
+// =============================================================================
+// (protected)
+bool UndoJournal::apply(Operation &operation, bool undo)
+{
+    switch (operation.type) {
+    case Operation::Type::NodeInserte:
+        return undo ? removeNode(operation) : insertNode(operation);
+    case Operation::Type::NodeRemove:
+        return undo ? insertNode(operation) : removeNode(operation);
+    case Operation::Type::NodeMove:
+        if (undo) {
+            return moveNode(operation.targetNodePath, operation.nodePath, operation.targetNodePath);
+        } else {
+            return moveNode(operation.nodePath, operation.targetNodePath, operation.nodePath);
+        }
+    case Operation::Type::LeafChange: {
+        Node node = operation.nodePath.node(m_model->rootNode());
+        if (node.isNull()) { return false; }
+        const UnionValue &value = undo ? operation.oldValue : operation.newValue;
+        if (value.isNull()) { return false; }
+        return node.leaf(operation.valueName).setValue(value);
+    }
+    }
+    return false;
+}
+
+// =============================================================================
+// (protected)
+bool UndoJournal::removeNode(Operation &operation)
+{
+    const NodePath &path = operation.nodePath;
+    if (path.depth() <= 0) { return false; }
+
+    Node node = path.node(m_model->rootNode());
+    if (node.isNull()) { return false; }
+
+    // The node is serialized so it can be inserted again
+    serialize(node, operation.subtree);
+
+    Node parentNode = path.nodeParent(m_model->rootNode());
+    return parentNode.removeChild(path.name(path.depth()-1), path.last().index);
+}
+
+// =============================================================================
+// (protected)
+bool UndoJournal::insertNode(const Operation &operation)
+{
+    const NodePath &path = operation.nodePath;
+    if (path.depth() <= 0) { return false; }
+
+    Node parentNode = path.nodeParent(m_model->rootNode());
+    if (parentNode.isNull()) { return false; }
+
+    const std::string &name = path.name(path.depth()-1);
+    int index = path.last().index;
+
+    if (operation.subtree.empty()) {
+        // Nodes inserted and never removed can be created again from the definition
+        return !parentNode.insertChild(name, index).isNull();
+    }
+
+    switch (parentNode.nodeData().type()) {
+#ifdef XML_BACKEND
+    case NodeData::Type::XML: {
+        XML::Document doc;
+        if (!doc.parse(operation.subtree)) { return false; }
+        return !parentNode.insertChildCopy(name, index, NodeData(doc.documentElement())).isNull();
+    }
+#endif // XML_BACKEND
+    default:
+        // _nodeData.type() returns an unhandled type that needs to be implemented
+        ASSERT(false);
+    }
+    return false;
+}
+
+// =============================================================================
+// (protected)
+bool UndoJournal::moveNode(const NodePath &fromPath, const NodePath &toPath, const NodePath &insertedPath)
+{
+    if (fromPath.depth() <= 0 || toPath.depth() <= 0) { return false; }
+
+    Node node = fromPath.node(m_model->rootNode());
+    if (node.isNull()) { return false; }
+
+    // 'toPath' points to where the node was before it was moved to 'insertedPath'
+    NodePath parentPath = toPath;
+    parentPath.removeLast();
+    adjustForInsert(parentPath, insertedPath);
+
+    Node parentNode = parentPath.node(m_model->rootNode());
+    if (parentNode.isNull()) { return false; }
+
+    int index = toPath.last().index;
+    return !parentNode.moveChild(toPath.name(toPath.depth()-1), index, node).isNull();
+}
+
+// =============================================================================
+// (protected)
+void UndoJournal::modelDestroyed()
+{
+    m_model = nullptr;
+    m_connected = false;
+    clear();
+}
+
+// =============================================================================
+// (protected static)
+void UndoJournal::adjustForInsert(NodePath &path, const NodePath &insertedPath)
+{
+    int depth = insertedPath.depth();
+    if (depth <= 0 || path.depth() < depth) { return; }
+    if (path.depthWhereEqual(insertedPath) < depth-1) { return; }
+
+    const NodePath::Entry &entry = path.at(depth-1);
+    if (entry.nameId != insertedPath.last().nameId) { return; }
+    if (entry.index >= insertedPath.last().index) {
+        path.setIndex(depth-1, entry.index + 1);
+    }
+}
+
+// =============================================================================
+// (protected static)
+bool UndoJournal::serialize(const Node &node, std::string &str)
+{
+    str.clear();
+    if (node.isNull()) { return false; }
+
+    switch (node.nodeData().type()) {
+#ifdef XML_BACKEND
+    case NodeData::Type::XML:
+        node.nodeData().xmlNode().save(str, -1);
+        return true;
+#endif // XML_BACKEND
+    default:
+        // _nodeData.type() returns an unhandled type that needs to be implemented
+        ASSERT(false);
+    }
+    return false;
+}
+
+} // namespace Oak::Model
@@ -0,0 +1,141 @@
+/*
+ * OakModelView (http://oakmodelview.com/)
+ * Author: Mikkel Nøhr Løvgreen (mikkel@oakmodelview.com)
+ * ------------------------------------------------------------------------
+ * Licensed to Vilaversoftware IVS who licenses this file to you under the
+ * Apache License, Version 2.0 (the "License"); you may not use this file
+ * except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <deque>
+#include <vector>
+#include <string>
+
+#include "ObserverInterface.h"
+#include "NodePath.h"
+#include "UnionValue.h"
+
+
+namespace Oak::Model {
+
+// =============================================================================
+// Class definition
+// =============================================================================
+// Records the changes made to the model as small inverse operations that can
+//  be undone and redone. Only the path, the old and new leaf value and, for
+//  removed nodes, the serialized subtree is stored, so an entry uses memory in
+//  proportion to the change and not to the document.
+// Leaf values are restored, not the layout of the data. A leaf that was missing
+//  gets its default value written back when a change to it is undone.
+class UndoJournal : public ObserverInterface
+{
+public:
+    UndoJournal(OakModel *model);
+    virtual ~UndoJournal() override;
+
+    virtual void connect() override;
+    virtual void disconnect() override;
+
+    bool canUndo() const { return !m_undoList.empty(); }
+    bool canRedo() const { return !m_redoList.empty(); }
+    bool undo();
+    bool redo();
+    void clear();
+
+    int undoCount() const { return static_cast<int>(m_undoList.size()); }
+    int redoCount() const { return static_cast<int>(m_redoList.size()); }
+
+    // Changes made between beginGroup() and endGroup() are undone as one entry.
+    //  The changes made in one batch of the model are always merged
+    void beginGroup();
+    void endGroup();
+
+    // The oldest entries are discarded when the memory used exceeds the limit
+    //  (The last entry is always kept)
+    size_t memoryLimit() const { return m_memoryLimit; }
+    void setMemoryLimit(size_t bytes);
+    size_t memoryUsage() const { return m_memoryUsage; }
+
+    virtual void onNodeInserteBefore(const NodePath &nodePath) override;
+    virtual void onNodeInserteAfter(const NodePath &nodePath) override;
+    virtual void onNodeMoveBefore(const NodePath &sourceNodePath, const NodePath &targetNodePath) override;
+    virtual void onNodeMoveAfter(const NodePath &sourceNodePath, const NodePath &targetNodePath) override;
+    virtual void onNodeCloneBefore(const NodePath &sourceNodePath, const NodePath &targetNodePath) override;
+    virtual void onNodeCloneAfter(const NodePath &sourceNodePath, const NodePath &targetNodePath) override;
+    virtual void onNodeRemoveBefore(const NodePath &nodePath) override;
+    virtual void onNodeRemoveAfter(const NodePath &nodePath) override;
+    virtual void onLeafChangeBefore(const NodePath &nodePath, const std::string &valueName) override;
+    virtual void onLeafChangeAfter(const NodePath &nodePath, const std::string &valueName) override;
+
+    virtual void onBatchBegin() override;
+    virtual void onBatchEnd() override;
+
+protected:
+    struct Operation
+    {
+        enum class Type { NodeInserte, NodeRemove, NodeMove, LeafChange };
+
+        Type type;
+        NodePath nodePath; // The source path of a move
+        NodePath targetNodePath;
+        std::string subtree; // Set while the node is removed
+        std::string valueName;
+        UnionValue oldValue;
+        UnionValue newValue;
+
+        size_t memorySize() const;
+    };
+
+    struct Entry
+    {
+        std::vector<Operation> operationList;
+        size_t memorySize = 0;
+    };
+
+    void beginChange(Operation::Type type);
+    void addOperation(Operation &&operation);
+    void updateMemoryUsage(Entry &entry);
+    void trimToLimit();
+
+    bool apply(Operation &operation, bool undo);
+    bool removeNode(Operation &operation);
+    bool insertNode(const Operation &operation);
+    bool moveNode(const NodePath &fromPath, const NodePath &toPath, const NodePath &insertedPath);
+
+    void modelDestroyed();
+
+    // Moves 'path' to where it points after a node is inserted at 'insertedPath'
+    static void adjustForInsert(NodePath &path, const NodePath &insertedPath);
+    static bool serialize(const Node &node, std::string &str);
+
+protected:
+    std::deque<Entry> m_undoList;
+    std::vector<Entry> m_redoList;
+
+    // Changes that have been reported 'before' but not 'after' yet
+    std::vector<Operation> m_pendingList;
+
+    size_t m_memoryLimit = 16 * 1024 * 1024;
+    size_t m_memoryUsage = 0;
+
+    int m_groupDepth = 0;
+    bool m_batchOpen = false;
+    bool m_startNewEntry = true;
+    bool m_replaying = false;
+    bool m_connected = false;
+};
+
+typedef std::unique_ptr<UndoJournal> UndoJournalUPtr;
+
+} // namespace Oak::Model
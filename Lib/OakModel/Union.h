@@ -27,7 +27,16 @@
 namespace Oak::Model {
 
 enum class UnionType { Undefined = -1, Char = 0, Bool = 1, Integer = 2, Double = 3, String = 4, DateTime = 5 };
-typedef union UValue { bool b; int i; double d; std::string *s; DateTime *dt; } UValue;
+// Strings and date times are stored inline, so a short string fits in the small string
+//  buffer of std::string and no value needs an allocation of its own. 'UnionValue'
+//  constructs and destroys the member in use
+union UValue
+{
+    UValue() : i(0) {}
+    ~UValue() {}
+
+    bool b; int i; double d; std::string s; DateTime dt;
+};
 typedef union UPtr { const char *c; const bool *b; const int *i; const double *d; const std::string *s; const DateTime *dt; } UPtr;
 
 class UnionRef;
@@ -95,9 +95,9 @@ UnionRef::UnionRef(const UnionValue &v)
     } else if (t == UnionType::Double) {
         r.d = const_cast<double*>(&v.v.d);
     } else if (t == UnionType::String) {
-        r.s = v.v.s;
+        r.s = &v.v.s;
     } else if (t == UnionType::DateTime) {
-        r.dt = v.v.dt;
+        r.dt = &v.v.dt;
     } else {
         ASSERT(false);
     }
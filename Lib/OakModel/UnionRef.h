@@ -23,6 +23,8 @@
 #include "Union.h"
 #include "ConvertFunctions.h"
 
+#include "../ServiceFunctions/Instrumentation.h"
+
 
 namespace Oak::Model {
 
@@ -147,6 +149,7 @@ bool UnionRef::get(T &target, bool allowConversion, Conversion *properties) cons
 {
     if (t == UnionType::Undefined) { return false; }
     if (!allowConversion && t != Union::GetValueType(target)) { return false; }
+    OAK_COUNT_IF(Conversion, t != Union::GetValueType(target));
 
     switch (t) {
         case UnionType::Undefined:
@@ -18,6 +18,11 @@
 
 #include "UnionValue.h"
 
+#include <functional>
+#include <memory>
+#include <new>
+#include <type_traits>
+
 #include "UnionRef.h"
 #include "ConvertFunctions.h"
 
@@ -27,6 +32,9 @@
 
 namespace Oak::Model {
 
+// Containers of values only move them instead of copying when the move can not throw
+static_assert(std::is_nothrow_move_constructible<UnionValue>::value, "UnionValue must be nothrow movable");
+
 // =============================================================================
 // (public)
 UnionValue::UnionValue()
@@ -40,7 +48,7 @@ UnionValue::UnionValue()
 UnionValue::UnionValue(const char *c)
     : t(UnionType::String)
 {
-    v.s = new std::string(c);
+    new (&v.s) std::string(c);
 }
 
 // =============================================================================
@@ -72,7 +80,15 @@ UnionValue::UnionValue(double d)
 UnionValue::UnionValue(const std::string &s)
     : t(UnionType::String)
 {
-    v.s = new std::string(s);
+    new (&v.s) std::string(s);
+}
+
+// =============================================================================
+// (public)
+UnionValue::UnionValue(std::string &&s)
+    : t(UnionType::String)
+{
+    new (&v.s) std::string(std::move(s));
 }
 
 // =============================================================================
@@ -80,7 +96,7 @@ UnionValue::UnionValue(const std::string &s)
 UnionValue::UnionValue(const DateTime &dt)
     : t(UnionType::DateTime)
 {
-    v.dt = new DateTime(dt);
+    new (&v.dt) DateTime(dt);
 }
 
 // =============================================================================
@@ -90,9 +106,9 @@ UnionValue::UnionValue(UnionType type)
 {
     ASSERT(static_cast<int>(type) > 0);
     if (type == UnionType::String) {
-        v.s = new std::string();
+        new (&v.s) std::string();
     } else if (type == UnionType::DateTime) {
-        v.dt = new DateTime(DateTime::defaultDateTime());
+        new (&v.dt) DateTime(DateTime::defaultDateTime());
     } else {
         v.i = 0;
     }
@@ -101,8 +117,9 @@ UnionValue::UnionValue(UnionType type)
 // =============================================================================
 // (public)
 UnionValue::UnionValue(const UnionRef &uRef)
+    : t(UnionType::Undefined)
 {
-    *this = uRef;
+    construct(uRef);
 }
 
 // =============================================================================
@@ -110,80 +127,44 @@ UnionValue::UnionValue(const UnionRef &uRef)
 UnionValue::UnionValue(const UnionValue &copy)
     : t(UnionType::Undefined)
 {
-    *this = copy;
+    construct(UnionRef(copy));
 }
 
 // =============================================================================
 // (public)
-UnionValue::UnionValue(UnionValue &&move)
+UnionValue::UnionValue(UnionValue &&move) noexcept
     : t(UnionType::Undefined)
 {
-    *this = std::move(move);
+    construct(std::move(move));
 }
 
 // =============================================================================
 // (public)
 UnionValue::~UnionValue()
 {
-    if (t == UnionType::String) {
-        delete v.s;
-        v.s = nullptr;
-    } else if (t == UnionType::DateTime) {
-        delete v.dt;
-        v.dt = nullptr;
-    }
+    destroy();
 }
 
 // =============================================================================
 // (public)
 UnionValue &UnionValue::operator=(const UnionRef &value)
 {
+    // Assigning to a value of the same type reuses its storage
     if (t == UnionType::String) {
         if (value.t == UnionType::String) {
-            *v.s = *value.r.s;
+            v.s = *value.r.s;
             return *this;
-        } else {
-            delete v.s;
-        }
-    }
-
-    if (t == UnionType::DateTime) {
-        if (value.t == UnionType::DateTime) {
-            *v.dt = *value.r.dt;
+        } else if (value.t == UnionType::Char) {
+            v.s = value.r.c;
             return *this;
-        } else {
-            delete v.dt;
         }
+    } else if (t == UnionType::DateTime && value.t == UnionType::DateTime) {
+        v.dt = *value.r.dt;
+        return *this;
     }
 
-    t = value.t;
-    switch (value.t) {
-        case UnionType::Undefined:
-            v.i = 0;
-            break;
-        case UnionType::Char:
-            v.s = new std::string(value.r.c);
-            t = UnionType::String;
-            break;
-        case UnionType::Bool:
-            v.b = *value.r.b;
-            break;
-        case UnionType::Integer:
-            v.i = *value.r.i;
-            break;
-        case UnionType::Double:
-            v.d = *value.r.d;
-            break;
-        case UnionType::String:
-            v.s = new std::string(*value.r.s);
-            break;
-        case UnionType::DateTime:
-            v.dt = new DateTime(*value.r.dt);
-            break;
-        default:
-            ASSERT(false);
-    }
-
+    destroy();
+    construct(value);
     return *this;
 }
 
@@ -211,6 +192,35 @@ bool UnionValue::operator!=(const UnionRef &value) const
     return uRef != value;
 }
 
+// =============================================================================
+// (public)
+bool UnionValue::operator==(const UnionValue &value) const
+{
+    // Values of the same type are compared directly. Doubles are compared with a tolerance by 'UnionRef'
+    if (t == value.t) {
+        switch (t) {
+            case UnionType::Bool:
+                return v.b == value.v.b;
+            case UnionType::Integer:
+                return v.i == value.v.i;
+            case UnionType::String:
+                return v.s == value.v.s;
+            case UnionType::DateTime:
+                return v.dt == value.v.dt;
+            default:
+                break;
+        }
+    }
+    return UnionRef(*this) == UnionRef(value);
+}
+
+// =============================================================================
+// (public)
+bool UnionValue::operator!=(const UnionValue &value) const
+{
+    return !(*this == value);
+}
+
 // =============================================================================
 // (public)
 bool UnionValue::operator>=(const UnionRef &value) const
@@ -268,19 +278,18 @@ bool UnionValue::isNull() const
 
 // =============================================================================
 // (public)
-UnionValue &UnionValue::operator=(UnionValue &&move)
+UnionValue &UnionValue::operator=(UnionValue &&move) noexcept
 {
-    if (t == UnionType::String) {
-        delete v.s;
-    } else if (t == UnionType::DateTime) {
-        delete v.dt;
-    }
-    t = move.t;
-    memcpy(&v, &move.v, sizeof(v));
+    if (this == &move) { return *this; }
 
-    move.t = UnionType::Undefined;
-    move.v.s = nullptr;
+    if (t == UnionType::String && move.t == UnionType::String) {
+        v.s = std::move(move.v.s);
+        move.destroy();
+        return *this;
+    }
 
+    destroy();
+    construct(std::move(move));
     return *this;
 }
 
@@ -299,7 +308,7 @@ UnionValue::operator bool() const
         case UnionType::Double:
             return v.d != 0.0;
         case UnionType::String:
-            return !v.s->empty();
+            return !v.s.empty();
         case UnionType::DateTime:
             return true;
         default:
@@ -315,6 +324,25 @@ UnionType UnionValue::type() const
     return t;
 }
 
+// =============================================================================
+// (public)
+size_t UnionValue::hash() const
+{
+    size_t typeHash = std::hash<int>()(static_cast<int>(t));
+    switch (t) {
+        case UnionType::Bool:
+            return typeHash ^ std::hash<bool>()(v.b);
+        case UnionType::Integer:
+            return typeHash ^ std::hash<int>()(v.i);
+        case UnionType::String:
+            return typeHash ^ std::hash<std::string>()(v.s);
+        case UnionType::DateTime:
+            return typeHash ^ std::hash<long long>()(v.dt.mSecsSinceEpoch());
+        default:
+            return typeHash;
+    }
+}
+
 // =============================================================================
 // (public)
 const UnionRef UnionValue::getRef() const
@@ -358,7 +386,7 @@ double UnionValue::getDouble() const
 const std::string& UnionValue::getCString() const
 {
     ASSERT(t == UnionType::String);
-    return *v.s;
+    return v.s;
 }
 
 // =============================================================================
@@ -366,7 +394,7 @@ const std::string& UnionValue::getCString() const
 std::string& UnionValue::getString()
 {
     ASSERT(t == UnionType::String);
-    return *v.s;
+    return v.s;
 }
 
 // =============================================================================
@@ -403,5 +431,84 @@ bool UnionValue::get(UnionValue &target, bool allowConversion, Conversion *prope
     return sourceRef.get(targetRef, allowConversion, properties);
 }
 
+// =============================================================================
+// (protected)
+void UnionValue::construct(const UnionRef &value)
+{
+    ASSERT(t == UnionType::Undefined);
+    t = value.t;
+    switch (value.t) {
+        case UnionType::Undefined:
+            v.i = 0;
+            break;
+        case UnionType::Char:
+            new (&v.s) std::string(value.r.c);
+            t = UnionType::String;
+            break;
+        case UnionType::Bool:
+            v.b = *value.r.b;
+            break;
+        case UnionType::Integer:
+            v.i = *value.r.i;
+            break;
+        case UnionType::Double:
+            v.d = *value.r.d;
+            break;
+        case UnionType::String:
+            new (&v.s) std::string(*value.r.s);
+            break;
+        case UnionType::DateTime:
+            new (&v.dt) DateTime(*value.r.dt);
+            break;
+        default:
+            ASSERT(false);
+    }
+}
+
+// =============================================================================
+// (protected)
+void UnionValue::construct(UnionValue &&move)
+{
+    ASSERT(t == UnionType::Undefined);
+    t = move.t;
+    switch (move.t) {
+        case UnionType::Undefined:
+            v.i = 0;
+            break;
+        case UnionType::Bool:
+            v.b = move.v.b;
+            break;
+        case UnionType::Integer:
+            v.i = move.v.i;
+            break;
+        case UnionType::Double:
+            v.d = move.v.d;
+            break;
+        case UnionType::String:
+            // Takes over the buffer of long strings
+            new (&v.s) std::string(std::move(move.v.s));
+            break;
+        case UnionType::DateTime:
+            new (&v.dt) DateTime(std::move(move.v.dt));
+            break;
+        default:
+            ASSERT(false);
+    }
+    move.destroy();
+}
+
+// =============================================================================
+// (protected)
+void UnionValue::destroy()
+{
+    if (t == UnionType::String) {
+        std::destroy_at(&v.s);
+    } else if (t == UnionType::DateTime) {
+        std::destroy_at(&v.dt);
+    }
+    t = UnionType::Undefined;
+    v.i = 0;
+}
+
 } // namespace Oak::Model
 
@@ -38,19 +38,20 @@ public:
     UnionValue(int i);
     UnionValue(double d);
     UnionValue(const std::string &s);
+    UnionValue(std::string &&s);
     UnionValue(const DateTime &dt);
     UnionValue(UnionType type);
 
     UnionValue(const UnionRef& uRef);
 
     UnionValue(const UnionValue& copy);
-    UnionValue(UnionValue&& move);
+    UnionValue(UnionValue&& move) noexcept;
 
     ~UnionValue();
 
     UnionValue& operator=(const UnionRef& value);
     UnionValue& operator=(const UnionValue& copy);
-    UnionValue& operator=(UnionValue&& move);
+    UnionValue& operator=(UnionValue&& move) noexcept;
 
     template<typename T>
     UnionValue& operator=(T value) { return *this = UnionRef(value); }
@@ -59,6 +60,8 @@ public:
 
     bool operator==(const UnionRef& value) const;
     bool operator!=(const UnionRef& value) const;
+    bool operator==(const UnionValue& value) const;
+    bool operator!=(const UnionValue& value) const;
 
     bool operator>(const UnionRef& value) const;
     bool operator>=(const UnionRef& value) const;
@@ -112,6 +115,22 @@ public:
 
     template<typename T>
     static UnionType GetType(const T &v);
+
+    size_t hash() const;
+
+    // Equal values of the same type get the same hash. Doubles only hash their
+    //  type, as they are compared with a tolerance
+    struct Hash
+    {
+        size_t operator()(const UnionValue &value) const { return value.hash(); }
+    };
+
+protected:
+    // 'construct()' requires that no value is held. 'destroy()' leaves the value undefined
+    void construct(const UnionRef &value);
+    void construct(UnionValue &&move);
+    void destroy();
+
 protected:
     UValue v;
     UnionType t;
@@ -20,6 +20,10 @@
 
 #include "UnionRef.h"
 #include "LeafQuery.h"
+#include "OakModel.h"
+#include "OptionsIndex.h"
+
+#include <unordered_set>
 
 
 namespace Oak::Model {
@@ -50,11 +54,26 @@ bool ValueOptions::isUsed() const
 // (public)
 bool ValueOptions::hasOption(const UnionRef& value, const Node* node, bool allowConversion, ConversionSPtr conversion) const
 {
-    UnionValueList options;
-    // Todo: This function can be optimized
-    if (!getOptions(options, node, allowConversion, conversion)) { return false; }
+    if (!isUsed()) { return false; }
 
-    return std::find(options.begin(), options.end(), value) != options.end();
+    bool found = std::find(m_options.begin(), m_options.end(), value) != m_options.end();
+    if (!found && node && m_query) {
+        found = queryContains(m_query.get(), *node, value);
+    }
+    if (!found) { return false; }
+
+    if (node && m_queryExcluded && queryContains(m_queryExcluded.get(), *node, value)) {
+        return false;
+    }
+
+    UnionValue option;
+    for (const UnionValue& vo: m_excluded)
+    {
+        if (vo.get(option, allowConversion, conversion.get()) && option == value) {
+            return false;
+        }
+    }
+    return true;
 }
 
 // =============================================================================
@@ -70,31 +89,43 @@ bool ValueOptions::getOptions(std::vector<UnionValue> &options, const Node *node
         options[i] = m_options[i];
     }
 
-    std::vector<UnionValue>::const_iterator it;
+    // The values of an option index are unique and sorted
+    bool isSorted = false;
     if (node && m_query) {
-        std::vector<UnionValue> oList = m_query->valueList(*node);
-        for(const UnionValue &option: oList)
-        {
-            it = std::find(options.begin(), options.end(), option);
-            if (it == options.end()) {
-                options.push_back(option);
+        std::vector<UnionValue> oList;
+        bool isIndexed = queryValues(m_query.get(), *node, oList);
+        if (options.empty() && isIndexed) {
+            options = std::move(oList);
+            isSorted = true;
+        } else {
+            std::unordered_set<UnionValue, UnionValue::Hash> optionSet(options.begin(), options.end());
+            for(UnionValue &option: oList)
+            {
+                if (optionSet.insert(option).second) {
+                    options.push_back(std::move(option));
+                }
             }
         }
     }
 
-    if (node && m_queryExcluded) {
-        std::vector<UnionValue> oList = m_queryExcluded->valueList(*node);
-        for(const UnionValue &option: oList)
-        {
-            it = std::find(options.begin(), options.end(), option);
-            if (it != options.end()) {
-                options.erase(it);
-            }
+    if (node && m_queryExcluded && !options.empty()) {
+        const OptionsIndex *index = optionsIndex(m_queryExcluded.get(), *node);
+        if (index) {
+            options.erase(std::remove_if(options.begin(), options.end(), [index, node](const UnionValue &option) {
+                return index->contains(*node, option);
+            }), options.end());
+        } else {
+            std::vector<UnionValue> oList = m_queryExcluded->valueList(*node);
+            std::unordered_set<UnionValue, UnionValue::Hash> excludedSet(oList.begin(), oList.end());
+            options.erase(std::remove_if(options.begin(), options.end(), [&excludedSet](const UnionValue &option) {
+                return excludedSet.count(option) > 0;
+            }), options.end());
         }
     }
 
     // Remove excluded options
     UnionValue option;
+    std::vector<UnionValue>::const_iterator it;
     for (const UnionValue& vo: m_excluded)
     {
         if (vo.get(option, allowConversion, conversion.get())) {
@@ -106,7 +137,9 @@ bool ValueOptions::getOptions(std::vector<UnionValue> &options, const Node *node
 
     }
 
-    std::sort(options.begin(), options.end());
+    if (!isSorted) {
+        std::sort(options.begin(), options.end());
+    }
 
     return true;
 }
@@ -147,6 +180,36 @@ const ValueOptions &ValueOptions::empty()
     return vo;
 }
 
+// =============================================================================
+// (protected)
+const OptionsIndex *ValueOptions::optionsIndex(const LeafQuery *query, const Node &node) const
+{
+    if (node.model() == nullptr) { return nullptr; }
+    return node.model()->optionsIndex(query);
+}
+
+// =============================================================================
+// (protected)
+bool ValueOptions::queryValues(const LeafQuery *query, const Node &node, std::vector<UnionValue> &values) const
+{
+    const OptionsIndex *index = optionsIndex(query, node);
+    if (index && index->getValues(node, values)) { return true; }
+
+    query->getValueList(node, values);
+    return false;
+}
+
+// =============================================================================
+// (protected)
+bool ValueOptions::queryContains(const LeafQuery *query, const Node &node, const UnionRef &value) const
+{
+    const OptionsIndex *index = optionsIndex(query, node);
+    if (index) { return index->contains(node, value); }
+
+    std::vector<UnionValue> oList = query->valueList(node);
+    return std::find(oList.begin(), oList.end(), value) != oList.end();
+}
+
 //// =============================================================================
 //// (public)
 //bool ValueOptions::getOptions(std::vector<VariantCRef>& options) const
@@ -28,6 +28,7 @@ namespace Oak::Model {
 
 class Node;
 class LeafQuery;
+class OptionsIndex;
 typedef std::shared_ptr<LeafQuery> LeafQuerySPtr;
 typedef std::weak_ptr<LeafQuery> LeafQueryWPtr;
 
@@ -60,6 +61,13 @@ public:
 
     static const ValueOptions& empty();
 
+protected:
+    // Uses the option index of the model if the query has one
+    const OptionsIndex *optionsIndex(const LeafQuery *query, const Node &node) const;
+    // Returns true if the values are found in an option index
+    bool queryValues(const LeafQuery *query, const Node &node, std::vector<UnionValue> &values) const;
+    bool queryContains(const LeafQuery *query, const Node &node, const UnionRef &value) const;
+
 protected:
     std::vector<UnionValue> m_options;
     std::vector<UnionValue> m_excluded;
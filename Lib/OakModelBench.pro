@@ -0,0 +1,23 @@
+TEMPLATE = subdirs
+CONFIG += debug_and_release
+
+SUBDIRS += sub_OakXML \
+           sub_OakModel \
+           sub_OakModelBench
+
+sub_OakXML.file           = OakXML/OakXML.pro
+
+sub_OakModel.file         = OakModel/OakModel.pro
+sub_OakModel.depends      = sub_OakXML
+
+sub_OakModelBench.file    = OakModelBench/OakModelBench.pro
+sub_OakModelBench.depends = sub_OakXML sub_OakModel
+
+oak_bench_qt {
+    SUBDIRS += sub_QtOakModel
+
+    sub_QtOakModel.file    = QtOakModel/QtOakModel.pro
+    sub_QtOakModel.depends = sub_OakXML sub_OakModel
+
+    sub_OakModelBench.depends += sub_QtOakModel
+}
@@ -0,0 +1,221 @@
+/*
+ * OakModelView (http://oakmodelview.com/)
+ * Author: Mikkel Nøhr Løvgreen (mikkel@oakmodelview.com)
+ * ------------------------------------------------------------------------
+ * Licensed to Vilaversoftware IVS who licenses this file to you under the
+ * Apache License, Version 2.0 (the "License"); you may not use this file
+ * except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// =============================================================================
+// Class definition
+// =============================================================================
+// Runs each benchmark repeatedly until 'minTime' has passed (at least 'minRuns'
+//  times) and reports the fastest and the mean time of a run. A benchmark is
+//  skipped if its name does not contain the filter given on the command line.
+// Options are given as "--name=value". The runner reads "--filter",
+//  "--min-time" and "--json", the benchmarks read the rest through option().
+//  With "--json=<file path>" the results are also written to the file in the
+//  JSON format of Google Benchmark, so the reports can be compared between builds
+class BenchRunner
+{
+public:
+    BenchRunner(int argc, char *argv[])
+    {
+        if (argc > 0) { m_executable = argv[0]; }
+        for (int i = 1; i < argc; i++) {
+            std::string arg = argv[i];
+            if (arg.compare(0, 2, "--") != 0) { continue; }
+            size_t pos = arg.find('=');
+            if (pos == std::string::npos) {
+                m_optionMap[arg.substr(2)] = "true";
+            } else {
+                m_optionMap[arg.substr(2, pos - 2)] = arg.substr(pos + 1);
+            }
+        }
+        m_filter = option("filter", "");
+        m_minTime = std::stod(option("min-time", "0.5"));
+        m_jsonFilePath = option("json", "");
+    }
+
+    ~BenchRunner()
+    {
+        if (!m_jsonFilePath.empty()) {
+            writeJson(m_jsonFilePath);
+        }
+    }
+
+    std::string option(const std::string &name, const std::string &defaultValue) const
+    {
+        auto it = m_optionMap.find(name);
+        return it == m_optionMap.end() ? defaultValue : it->second;
+    }
+
+    int option(const std::string &name, int defaultValue) const
+    {
+        auto it = m_optionMap.find(name);
+        return it == m_optionMap.end() ? defaultValue : std::stoi(it->second);
+    }
+
+    bool isFiltered(const std::string &name) const
+    {
+        return !m_filter.empty() && name.find(m_filter) == std::string::npos;
+    }
+
+    // Values added to the context are written to the "context" section of the JSON report
+    void addContext(const std::string &name, const std::string &value)
+    {
+        m_contextList.push_back(std::make_pair(name, value));
+    }
+
+    // 'itemCount' is the number of items handled by one run of 'fn'. It is
+    //  reported as the items per second
+    template<typename F>
+    void run(const std::string &name, F fn, long long itemCount = 0)
+    {
+        if (isFiltered(name)) { return; }
+
+        Result result;
+        result.name = name;
+        result.itemCount = itemCount;
+        double totalTime = 0.0;
+        while (result.runs < m_minRuns || totalTime < m_minTime) {
+            auto start = std::chrono::steady_clock::now();
+            fn();
+            std::chrono::duration<double> time = std::chrono::steady_clock::now() - start;
+            totalTime += time.count();
+            if (result.runs == 0 || time.count() < result.bestTime) {
+                result.bestTime = time.count();
+            }
+            result.runs++;
+        }
+        result.meanTime = totalTime / result.runs;
+        m_resultList.push_back(result);
+
+        std::cout << std::left << std::setw(48) << name << std::right << std::fixed << std::setprecision(3)
+                  << std::setw(10) << result.bestTime * 1000.0 << " ms"
+                  << std::setw(10) << result.meanTime * 1000.0 << " ms"
+                  << std::setw(6) << result.runs << std::endl;
+    }
+
+    bool writeJson(const std::string &filePath) const
+    {
+        std::ofstream file(filePath);
+        if (!file) {
+            std::cerr << "Failed to write " << filePath << std::endl;
+            return false;
+        }
+        writeJson(file);
+        return file.good();
+    }
+
+    void writeJson(std::ostream &os) const
+    {
+        char date[32];
+        std::time_t now = std::time(nullptr);
+        std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+
+        os << "{\n";
+        os << "  \"context\": {\n";
+        os << "    \"date\": \"" << date << "\",\n";
+        os << "    \"executable\": \"" << jsonEscape(m_executable) << "\",\n";
+        for (const auto &context: m_contextList) {
+            os << "    \"" << jsonEscape(context.first) << "\": \"" << jsonEscape(context.second) << "\",\n";
+        }
+#ifdef NDEBUG
+        os << "    \"library_build_type\": \"release\"\n";
+#else
+        os << "    \"library_build_type\": \"debug\"\n";
+#endif
+        os << "  },\n";
+        os << "  \"benchmarks\": [";
+        for (size_t i = 0; i < m_resultList.size(); i++) {
+            const Result &result = m_resultList[i];
+            os << (i == 0 ? "\n" : ",\n");
+            os << "    {\n";
+            os << "      \"name\": \"" << jsonEscape(result.name) << "\",\n";
+            os << "      \"run_name\": \"" << jsonEscape(result.name) << "\",\n";
+            os << "      \"run_type\": \"iteration\",\n";
+            os << "      \"iterations\": " << result.runs << ",\n";
+            os << std::setprecision(6) << std::fixed;
+            // The time is measured as wall time so it is also reported as the CPU time
+            os << "      \"real_time\": " << result.meanTime * 1000.0 << ",\n";
+            os << "      \"cpu_time\": " << result.meanTime * 1000.0 << ",\n";
+            os << "      \"best_time\": " << result.bestTime * 1000.0 << ",\n";
+            if (result.itemCount > 0 && result.meanTime > 0.0) {
+                os << "      \"items_per_second\": " << result.itemCount / result.meanTime << ",\n";
+            }
+            os << "      \"time_unit\": \"ms\"\n";
+            os << "    }";
+        }
+        os << "\n  ]\n";
+        os << "}\n";
+    }
+
+protected:
+    static std::string jsonEscape(const std::string &str)
+    {
+        std::stringstream ss;
+        for (char c: str) {
+            switch (c) {
+            case '"': ss << "\\\""; break;
+            case '\\': ss << "\\\\"; break;
+            case '\n': ss << "\\n"; break;
+            case '\t': ss << "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    ss << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c);
+                } else {
+                    ss << c;
+                }
+            }
+        }
+        return ss.str();
+    }
+
+    struct Result
+    {
+        std::string name;
+        int runs = 0;
+        double bestTime = 0.0;
+        double meanTime = 0.0;
+        long long itemCount = 0;
+    };
+
+    std::vector<Result> m_resultList;
+    std::vector<std::pair<std::string, std::string>> m_contextList;
+    std::map<std::string, std::string> m_optionMap;
+    std::string m_executable;
+    std::string m_filter;
+    std::string m_jsonFilePath;
+    double m_minTime = 0.5;
+    int m_minRuns = 3;
+};
+
+// Results are added to a volatile sum so the compiler can not remove the work done to get them
+inline void benchKeep(long long value)
+{
+    static volatile long long sink = 0;
+    sink = sink + value;
+}
@@ -0,0 +1,100 @@
+/*
+ * OakModelView (http://oakmodelview.com/)
+ * Author: Mikkel Nøhr Løvgreen (mikkel@oakmodelview.com)
+ * ------------------------------------------------------------------------
+ * Licensed to Vilaversoftware IVS who licenses this file to you under the
+ * Apache License, Version 2.0 (the "License"); you may not use this file
+ * except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "Bench.h"
+
+#include "DateTime.h"
+
+using namespace Oak::Model;
+
+// =============================================================================
+// Benchmarks
+// =============================================================================
+
+// One date time for every minute, starting at the first of January 2020
+inline std::vector<DateTime> bench_createDateTimeList(int count)
+{
+    std::vector<DateTime> list;
+    list.reserve(static_cast<size_t>(count));
+    DateTime start(2020, 1, 1, 0, 0, 0, DateTime::TimeZone::UTC);
+    for (int i = 0; i < count; i++) {
+        list.emplace_back();
+        list.back().setMSecsSinceEpoch(start.mSecsSinceEpoch() + i * 60000LL);
+    }
+    return list;
+}
+
+void bench_DateTime(BenchRunner &runner)
+{
+    const int count = 100000;
+
+    std::vector<DateTime> dateTimeList = bench_createDateTimeList(count);
+    std::vector<std::string> strList;
+    DateTime::toStringList(dateTimeList, strList, DateTime::TimeZone::UTC);
+
+    for (auto timeZone: { DateTime::TimeZone::UTC, DateTime::TimeZone::Local })
+    {
+        std::string name = timeZone == DateTime::TimeZone::UTC ? "DateTime/utc" : "DateTime/local";
+
+        runner.run(name + "/parse", [&]() {
+            long long sum = 0;
+            for (const std::string &str: strList) {
+                sum += DateTime(str, timeZone).mSecsSinceEpoch();
+            }
+            benchKeep(sum);
+        });
+
+        runner.run(name + "/parseList", [&]() {
+            std::vector<DateTime> list;
+            benchKeep(DateTime::fromStringList(strList, list, timeZone));
+        });
+
+        runner.run(name + "/format", [&]() {
+            long long size = 0;
+            for (const DateTime &dt: dateTimeList) {
+                size += static_cast<long long>(dt.toString(timeZone, "%Y-%m-%d %H:%M:%S").size());
+            }
+            benchKeep(size);
+        });
+
+        runner.run(name + "/formatList", [&]() {
+            std::vector<std::string> list;
+            DateTime::toStringList(dateTimeList, list, timeZone);
+            benchKeep(static_cast<long long>(list.size()));
+        });
+    }
+
+    // Formats the 'std::put_time()' fallback is used for
+    runner.run("DateTime/utc/formatStream", [&]() {
+        long long size = 0;
+        for (const DateTime &dt: dateTimeList) {
+            size += static_cast<long long>(dt.toString(DateTime::TimeZone::UTC, "%d %b %Y %H:%M").size());
+        }
+        benchKeep(size);
+    });
+
+    runner.run("DateTime/utc/parseIso", [&]() {
+        long long sum = 0;
+        for (const DateTime &dt: dateTimeList) {
+            sum += DateTime::fromIsoString(dt.toIsoString()).mSecsSinceEpoch();
+        }
+        benchKeep(sum);
+    });
+}
@@ -0,0 +1,278 @@
+/*
+ * OakModelView (http://oakmodelview.com/)
+ * Author: Mikkel Nøhr Løvgreen (mikkel@oakmodelview.com)
+ * ------------------------------------------------------------------------
+ * Licensed to Vilaversoftware IVS who licenses this file to you under the
+ * Apache License, Version 2.0 (the "License"); you may not use this file
+ * except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "Bench.h"
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+#include "OakModel.h"
+#include "NodeDefBuilder.h"
+#include "ContainerDefBuilder.h"
+#include "LeafDefBuilder.h"
+
+using namespace Oak::Model;
+
+// =============================================================================
+// Class definition
+// =============================================================================
+// The shape of a synthetic document. The root node "model" has 'fanOut' child
+//  nodes named "level1", each of them has 'fanOut' child nodes named "level2"
+//  and so on down to "level<depth>". Every node has 'leafCount' leafs, the
+//  first is the key leaf "id". With more than one variant the second leaf is
+//  the variant leaf "type", and each variant after the first adds one leaf.
+//  The last leaf is always a plain leaf, so at least 3 leafs are used
+struct BenchModelParams
+{
+    int depth = 4;
+    int fanOut = 8;
+    int leafCount = 6;
+    int variantCount = 3;
+
+    BenchModelParams() {}
+    BenchModelParams(const BenchRunner &runner)
+    {
+        depth = std::max(1, runner.option("depth", depth));
+        fanOut = std::max(1, runner.option("fan-out", fanOut));
+        leafCount = std::max(3, runner.option("leafs", leafCount));
+        variantCount = std::max(1, runner.option("variants", variantCount));
+    }
+
+    // Used as the suffix of the benchmark names
+    std::string name() const
+    {
+        std::stringstream ss;
+        ss << "d" << depth << "_f" << fanOut << "_l" << leafCount << "_v" << variantCount;
+        return ss.str();
+    }
+
+    // The number of nodes not counting the root node
+    long long nodeCount() const
+    {
+        long long count = 0;
+        long long levelCount = 1;
+        for (int level = 1; level <= depth; level++) {
+            levelCount *= fanOut;
+            count += levelCount;
+        }
+        return count;
+    }
+
+    std::string levelName(int level) const
+    {
+        return level == 0 ? "model" : "level" + std::to_string(level);
+    }
+
+    std::string variantId(int variant) const
+    {
+        return "v" + std::to_string(variant);
+    }
+};
+
+// =============================================================================
+// (Service functions)
+inline UnionType bench_leafType(int leafIndex)
+{
+    switch (leafIndex % 4) {
+    case 0: return UnionType::String;
+    case 1: return UnionType::Integer;
+    case 2: return UnionType::Double;
+    default: return UnionType::Bool;
+    }
+}
+
+// =============================================================================
+// (Service functions)
+inline NodeDefSPtr bench_createNodeDef(const BenchModelParams &params)
+{
+    NodeDefBuilderSPtr childBuilder;
+    for (int level = params.depth; level >= 0; level--) {
+        std::string name = params.levelName(level);
+        bool hasVariants = level > 0 && params.variantCount > 1;
+
+        NodeDefBuilderSPtr builder;
+        if (hasVariants) {
+            builder = NDB::createVariantRoot(name, params.variantId(0));
+        } else {
+            builder = NDB::create(name);
+        }
+
+        int leafIndex = 0;
+        if (level > 0) {
+            builder->addKeyLeaf(LeafDefBuilder::create(UnionType::Integer, "id"));
+            leafIndex++;
+        }
+        if (hasVariants) {
+            builder->addVariantLeaf(LeafDefBuilder::create(UnionType::String, "type"));
+            leafIndex++;
+        }
+        for (; leafIndex < params.leafCount; leafIndex++) {
+            builder->addLeafDef(LeafDefBuilder::create(bench_leafType(leafIndex), "leaf" + std::to_string(leafIndex)));
+        }
+
+        if (childBuilder) {
+            builder->addContainerDef(ContainerDefBuilder::create(childBuilder));
+        }
+
+        if (hasVariants) {
+            for (int variant = 1; variant < params.variantCount; variant++) {
+                NDB::createVariant(builder, params.variantId(variant))
+                    ->addLeafDef(LeafDefBuilder::create(UnionType::Integer, "extra" + std::to_string(variant)));
+            }
+        }
+        childBuilder = builder;
+    }
+    return childBuilder->get();
+}
+
+// =============================================================================
+// (Service functions)
+inline void bench_setLeafValues(const Node &node, int number)
+{
+    int count = node.leafCount();
+    for (int i = 0; i < count; i++) {
+        Leaf leaf = node.leafAt(i);
+        if (leaf.name() == "id" || leaf.name() == "type") { continue; }
+        switch (leaf.def()->valueType()) {
+        case UnionType::String:
+            leaf.setValue("text " + std::to_string(number * 7 + i));
+            break;
+        case UnionType::Integer:
+            leaf.setValue(number * 3 + i);
+            break;
+        case UnionType::Double:
+            leaf.setValue(number * 0.25 + i);
+            break;
+        case UnionType::Bool:
+            leaf.setValue((number + i) % 2 == 0);
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+// =============================================================================
+// (Service functions)
+inline void bench_fillNode(const Node &node, int level, const BenchModelParams &params, int &number)
+{
+    if (level > params.depth) { return; }
+
+    std::string name = params.levelName(level);
+    for (int i = 0; i < params.fanOut; i++) {
+        int index = i;
+        Node child = node.insertChild(name, index);
+        child.leaf("id").setValue(number);
+        if (params.variantCount > 1) {
+            child.leaf("type").setValue(params.variantId(number % params.variantCount));
+            // The variant of the node changed
+            child = node.childAt(index);
+        }
+        bench_setLeafValues(child, number);
+        number++;
+        bench_fillNode(child, level + 1, params, number);
+    }
+}
+
+// =============================================================================
+// Class definition
+// =============================================================================
+// Builds a model with the NodeDefs and a generated document described by 'params'.
+//  The document is also saved to a temporary file, that is removed again by the destructor
+class BenchModel
+{
+public:
+    BenchModel(const BenchModelParams &params, const std::string &directory = ".")
+        : m_params(params)
+    {
+        m_def = bench_createNodeDef(params);
+        m_model.setRootNodeDef(m_def);
+        m_model.createNewRootDocument(NodeData::Type::XML);
+
+        int number = 0;
+        {
+            OakModel::Batch batch(&m_model);
+            bench_fillNode(m_model.rootNode(), 1, params, number);
+        }
+
+        m_filePath = directory + "/OakModelBench_" + params.name() + ".xml";
+        m_model.saveRootNodeXML(m_filePath);
+
+        std::ifstream file(m_filePath, std::ios::binary);
+        std::stringstream ss;
+        ss << file.rdbuf();
+        m_text = ss.str();
+    }
+
+    ~BenchModel()
+    {
+        std::remove(m_filePath.c_str());
+    }
+
+    BenchModel(const BenchModel &copy) = delete;
+    BenchModel& operator=(const BenchModel &copy) = delete;
+
+    const BenchModelParams &params() const { return m_params; }
+    NodeDefSPtr def() const { return m_def; }
+    OakModel &model() { return m_model; }
+    const Node &rootNode() const { return m_model.rootNode(); }
+
+    // The document saved as indented XML
+    const std::string &filePath() const { return m_filePath; }
+    const std::string &text() const { return m_text; }
+
+    // All the nodes below the root node in document order
+    std::vector<Node> nodeList() const
+    {
+        std::vector<Node> list;
+        list.reserve(static_cast<size_t>(m_params.nodeCount()));
+        addChildNodes(rootNode(), list);
+        return list;
+    }
+
+    // The query string that finds the nodes at 'level'
+    std::string queryString(int level) const
+    {
+        std::string str;
+        for (int i = 1; i <= level; i++) {
+            if (i > 1) { str += ";"; }
+            str += "C{" + m_params.levelName(i) + "}";
+        }
+        return str;
+    }
+
+protected:
+    static void addChildNodes(const Node &node, std::vector<Node> &list)
+    {
+        int count = node.childCount();
+        for (int i = 0; i < count; i++) {
+            Node child = node.childAt(i);
+            list.push_back(child);
+            addChildNodes(child, list);
+        }
+    }
+
+    BenchModelParams m_params;
+    NodeDefSPtr m_def;
+    OakModel m_model;
+    std::string m_filePath;
+    std::string m_text;
+};
@@ -0,0 +1,145 @@
+/*
+ * OakModelView (http://oakmodelview.com/)
+ * Author: Mikkel Nøhr Løvgreen (mikkel@oakmodelview.com)
+ * ------------------------------------------------------------------------
+ * Licensed to Vilaversoftware IVS who licenses this file to you under the
+ * Apache License, Version 2.0 (the "License"); you may not use this file
+ * except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "Bench_Model.h"
+
+#include "NodeIndex.h"
+
+// =============================================================================
+// (Benchmarks)
+inline long long bench_visitChildren(const Node &node)
+{
+    long long count = 0;
+    int childCount = node.childCount();
+    for (int i = 0; i < childCount; i++) {
+        count += 1 + bench_visitChildren(node.childAt(i));
+    }
+    return count;
+}
+
+// =============================================================================
+// (Benchmarks)
+inline void bench_Node(BenchRunner &runner, const BenchModel &bModel)
+{
+    const std::string suffix = "/" + bModel.params().name();
+    const std::vector<Node> nodeList = bModel.nodeList();
+    const long long nodeCount = static_cast<long long>(nodeList.size());
+
+    std::vector<Node> parentList;
+    parentList.reserve(nodeList.size());
+    for (const Node &node: nodeList) {
+        parentList.push_back(node.parent());
+    }
+
+    runner.run("Node::childAt" + suffix, [&]() {
+        benchKeep(bench_visitChildren(bModel.rootNode()));
+    }, nodeCount);
+
+    runner.run("Node::childIndex" + suffix, [&]() {
+        long long sum = 0;
+        for (size_t i = 0; i < nodeList.size(); i++) {
+            sum += parentList[i].childIndex(nodeList[i]);
+        }
+        benchKeep(sum);
+    }, nodeCount);
+
+    runner.run("Node::parent" + suffix, [&]() {
+        long long sum = 0;
+        for (const Node &node: nodeList) {
+            sum += node.parent().isNull() ? 0 : 1;
+        }
+        benchKeep(sum);
+    }, nodeCount);
+
+    runner.run("NodeIndex::create" + suffix, [&]() {
+        long long sum = 0;
+        for (const Node &node: nodeList) {
+            NodeIndexUPtr nodeIndex = NodeIndex::create(node);
+            sum += nodeIndex->depth();
+        }
+        benchKeep(sum);
+    }, nodeCount);
+
+    std::vector<NodeIndexUPtr> nodeIndexList;
+    nodeIndexList.reserve(nodeList.size());
+    for (const Node &node: nodeList) {
+        nodeIndexList.push_back(NodeIndex::create(node));
+    }
+
+    runner.run("NodeIndex::node" + suffix, [&]() {
+        long long sum = 0;
+        for (const NodeIndexUPtr &nodeIndex: nodeIndexList) {
+            sum += nodeIndex->node(bModel.rootNode()).isNull() ? 0 : 1;
+        }
+        benchKeep(sum);
+    }, nodeCount);
+}
+
+// =============================================================================
+// (Benchmarks)
+inline void bench_Leaf(BenchRunner &runner, BenchModel &bModel)
+{
+    const std::string suffix = "/" + bModel.params().name();
+    const std::vector<Node> nodeList = bModel.nodeList();
+    long long leafCount = 0;
+    for (const Node &node: nodeList) {
+        leafCount += node.leafCount();
+    }
+    const long long nodeCount = static_cast<long long>(nodeList.size());
+
+    runner.run("LeafDef::value" + suffix, [&]() {
+        long long sum = 0;
+        for (const Node &node: nodeList) {
+            int count = node.leafCount();
+            for (int i = 0; i < count; i++) {
+                UnionValue value = node.leafAt(i).value();
+                sum += static_cast<int>(value.type());
+            }
+        }
+        benchKeep(sum);
+    }, leafCount);
+
+    runner.run("LeafDef::value(Name)" + suffix, [&]() {
+        long long sum = 0;
+        for (const Node &node: nodeList) {
+            sum += node.leaf("id").value<int>();
+        }
+        benchKeep(sum);
+    }, nodeCount);
+
+    // Sets a value without notifying the model
+    const std::string leafName = "leaf" + std::to_string(bModel.params().leafCount - 1);
+    int number = 0;
+    runner.run("LeafDef::setValue" + suffix, [&]() {
+        for (const Node &node: nodeList) {
+            const LeafDef &leafDef = node.def()->value(leafName);
+            leafDef.setValue(node.nodeData(), UnionRef(number), true);
+        }
+        number++;
+    }, nodeCount);
+
+    // Sets a value the way the views do, which notifies the model observers
+    runner.run("Leaf::setValue" + suffix, [&]() {
+        for (const Node &node: nodeList) {
+            node.leaf(leafName).setValue(number);
+        }
+        number++;
+    }, nodeCount);
+}
@@ -0,0 +1,89 @@
+/*
+ * OakModelView (http://oakmodelview.com/)
+ * Author: Mikkel Nøhr Løvgreen (mikkel@oakmodelview.com)
+ * ------------------------------------------------------------------------
+ * Licensed to Vilaversoftware IVS who licenses this file to you under the
+ * Apache License, Version 2.0 (the "License"); you may not use this file
+ * except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "Bench_Model.h"
+
+#include "QOakModel.h"
+#include "OakTreeViewInternalModel.h"
+
+// =============================================================================
+// (Service functions)
+// Expands every row from the top, which also expands the rows it inserts
+inline int bench_expandAll(OakTreeViewInternalModel &treeViewModel)
+{
+    for (int row = 0; row < treeViewModel.rowCount(QModelIndex()); row++) {
+        QModelIndex index = treeViewModel.index(row, 0, QModelIndex());
+        if (treeViewModel.data(index, OakTreeViewInternalModel::HasChildrenRole).toBool()) {
+            treeViewModel.setData(index, true, OakTreeViewInternalModel::ExpandedRole);
+        }
+    }
+    return treeViewModel.rowCount(QModelIndex());
+}
+
+// =============================================================================
+// (Benchmarks)
+// The flattened rows of the QML tree view are benchmarked on a tree with
+//  111110 nodes (10 children on each of 5 levels)
+inline void bench_OakTreeView(BenchRunner &runner, const BenchModelParams &modelParams)
+{
+    BenchModelParams params = modelParams;
+    params.depth = 5;
+    params.fanOut = 10;
+    const std::string suffix = "/" + params.name();
+    const long long nodeCount = params.nodeCount();
+
+    BenchModel bModel(params, runner.option("tmp-dir", "."));
+
+    QOakModel qModel;
+    qModel.oakModel()->setRootNodeDef(bModel.def());
+    qModel.oakModel()->loadRootNodeXML(bModel.filePath());
+
+    runner.run("OakTreeViewInternalModel::expandAll" + suffix, [&]() {
+        OakTreeViewInternalModel treeViewModel;
+        treeViewModel.setTreeModel(&qModel);
+        benchKeep(bench_expandAll(treeViewModel));
+    }, nodeCount);
+
+    OakTreeViewInternalModel treeViewModel;
+    treeViewModel.setTreeModel(&qModel);
+    bench_expandAll(treeViewModel);
+    const int rowCount = treeViewModel.rowCount(QModelIndex());
+
+    // Scrolling through the list looks up the tree model index of every row
+    runner.run("OakTreeViewInternalModel::data(ModelIndex)" + suffix, [&]() {
+        long long sum = 0;
+        for (int row = 0; row < rowCount; row++) {
+            QModelIndex index = treeViewModel.index(row, 0, QModelIndex());
+            sum += treeViewModel.data(index, OakTreeViewInternalModel::ModelIndexRole).toModelIndex().row();
+        }
+        benchKeep(sum);
+    }, rowCount);
+
+    // Collapses and expands the first node of the last level again
+    runner.run("OakTreeViewInternalModel::collapse/expand" + suffix, [&]() {
+        for (int i = 0; i < 1000; i++) {
+            int row = rowCount - params.fanOut - 1;
+            QModelIndex index = treeViewModel.index(row, 0, QModelIndex());
+            treeViewModel.setData(index, false, OakTreeViewInternalModel::ExpandedRole);
+            treeViewModel.setData(index, true, OakTreeViewInternalModel::ExpandedRole);
+        }
+        benchKeep(treeViewModel.rowCount(QModelIndex()));
+    }, 2000);
+}
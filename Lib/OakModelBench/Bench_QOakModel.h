@@ -0,0 +1,81 @@
+/*
+ * OakModelView (http://oakmodelview.com/)
+ * Author: Mikkel Nøhr Løvgreen (mikkel@oakmodelview.com)
+ * ------------------------------------------------------------------------
+ * Licensed to Vilaversoftware IVS who licenses this file to you under the
+ * Apache License, Version 2.0 (the "License"); you may not use this file
+ * except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "Bench_Model.h"
+
+#include <functional>
+
+#include "QOakModel.h"
+
+// =============================================================================
+// (Benchmarks)
+inline long long bench_visitModelIndex(const QOakModel &qModel, const QModelIndex &parent)
+{
+    long long count = 0;
+    int rowCount = qModel.rowCount(parent);
+    for (int row = 0; row < rowCount; row++) {
+        QModelIndex index = qModel.index(row, 0, parent);
+        count += 1 + bench_visitModelIndex(qModel, index);
+    }
+    return count;
+}
+
+// =============================================================================
+// (Benchmarks)
+inline void bench_QOakModel(BenchRunner &runner, const BenchModel &bModel)
+{
+    const std::string suffix = "/" + bModel.params().name();
+    const long long nodeCount = bModel.params().nodeCount();
+
+    QOakModel qModel;
+    qModel.oakModel()->setRootNodeDef(bModel.def());
+    qModel.oakModel()->loadRootNodeXML(bModel.filePath());
+
+    runner.run("QOakModel::index" + suffix, [&]() {
+        benchKeep(bench_visitModelIndex(qModel, QModelIndex()));
+    }, nodeCount);
+
+    QModelIndexList indexList;
+    std::function<void(const QModelIndex&)> addIndexes = [&](const QModelIndex &parent) {
+        int rowCount = qModel.rowCount(parent);
+        for (int row = 0; row < rowCount; row++) {
+            QModelIndex index = qModel.index(row, 0, parent);
+            indexList.append(index);
+            addIndexes(index);
+        }
+    };
+    addIndexes(QModelIndex());
+
+    runner.run("QOakModel::data(Display)" + suffix, [&]() {
+        long long sum = 0;
+        for (const QModelIndex &index: indexList) {
+            sum += qModel.data(index, Qt::DisplayRole).toString().size();
+        }
+        benchKeep(sum);
+    }, nodeCount);
+
+    runner.run("QOakModel::data(KeyValue)" + suffix, [&]() {
+        long long sum = 0;
+        for (const QModelIndex &index: indexList) {
+            sum += qModel.data(index, QOakModel::KeyValue).toString().size();
+        }
+        benchKeep(sum);
+    }, nodeCount);
+}
@@ -0,0 +1,79 @@
+/*
+ * OakModelView (http://oakmodelview.com/)
+ * Author: Mikkel Nøhr Løvgreen (mikkel@oakmodelview.com)
+ * ------------------------------------------------------------------------
+ * Licensed to Vilaversoftware IVS who licenses this file to you under the
+ * Apache License, Version 2.0 (the "License"); you may not use this file
+ * except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "Bench_Model.h"
+
+#include "QueryBuilder.h"
+#include "TableQuery.h"
+
+// =============================================================================
+// (Benchmarks)
+inline void bench_Query(BenchRunner &runner, const BenchModel &bModel)
+{
+    const std::string suffix = "/" + bModel.params().name();
+    const int depth = bModel.params().depth;
+    const std::string queryString = bModel.queryString(depth);
+
+    runner.run("QueryBuilder::createNodeQuery" + suffix, [&]() {
+        long long sum = 0;
+        for (int i = 0; i < 1000; i++) {
+            NodeQueryUPtr query = QueryBuilder::createNodeQuery(queryString);
+            sum += query ? 1 : 0;
+        }
+        benchKeep(sum);
+    }, 1000);
+
+    NodeQueryUPtr nodeQuery = QueryBuilder::createNodeQuery(queryString);
+    const long long rowCount = nodeQuery->count(bModel.rootNode());
+
+    runner.run("NodeQuery::Iterator" + suffix, [&]() {
+        long long sum = 0;
+        auto it = nodeQuery->iterator(bModel.rootNode());
+        while (it->next()) {
+            sum += it->node().isNull() ? 0 : 1;
+        }
+        benchKeep(sum);
+    }, rowCount);
+
+    // The columns are the key leaf, a leaf of the parent and the last leaf
+    TableQuery tableQuery(QueryBuilder::createNodeQuery(queryString));
+    tableQuery.addValueQuery(QueryBuilder::createLeaf("id"));
+    if (depth > 1) {
+        tableQuery.addValueQuery(QueryBuilder::createParent()->leafSPtr("id"));
+    }
+    tableQuery.addValueQuery(QueryBuilder::createLeaf("leaf" + std::to_string(bModel.params().leafCount - 1)));
+    const int columnCount = tableQuery.columnCount();
+
+    runner.run("TableQuery::Iterator" + suffix, [&]() {
+        long long sum = 0;
+        auto it = tableQuery.iterator(bModel.rootNode());
+        while (it->next()) {
+            for (int column = 0; column < columnCount; column++) {
+                sum += static_cast<int>(it->leaf(column).value().type());
+            }
+        }
+        benchKeep(sum);
+    }, rowCount);
+
+    runner.run("TableQuery::materialize" + suffix, [&]() {
+        TableSnapshot snapshot = tableQuery.materialize(bModel.rootNode());
+        benchKeep(snapshot.rowCount());
+    }, rowCount);
+}
@@ -0,0 +1,175 @@
+/*
+ * OakModelView (http://oakmodelview.com/)
+ * Author: Mikkel Nøhr Løvgreen (mikkel@oakmodelview.com)
+ * ------------------------------------------------------------------------
+ * Licensed to Vilaversoftware IVS who licenses this file to you under the
+ * Apache License, Version 2.0 (the "License"); you may not use this file
+ * except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "Bench.h"
+
+#include "UnionValue.h"
+#include "UnionRef.h"
+
+using namespace Oak::Model;
+
+// =============================================================================
+// Class definition
+// =============================================================================
+// The storage layout 'UnionValue' had before strings and date times were held
+//  inline. It is kept here as the baseline of the benchmark
+class LegacyUnionValue
+{
+public:
+    LegacyUnionValue() : t(UnionType::Undefined) { v.i = 0; }
+    LegacyUnionValue(int i) : t(UnionType::Integer) { v.i = i; }
+    LegacyUnionValue(const std::string &s) : t(UnionType::String) { v.s = new std::string(s); }
+    LegacyUnionValue(const DateTime &dt) : t(UnionType::DateTime) { v.dt = new DateTime(dt); }
+
+    LegacyUnionValue(const LegacyUnionValue &copy) : t(copy.t)
+    {
+        if (t == UnionType::String) {
+            v.s = new std::string(*copy.v.s);
+        } else if (t == UnionType::DateTime) {
+            v.dt = new DateTime(*copy.v.dt);
+        } else {
+            v = copy.v;
+        }
+    }
+
+    LegacyUnionValue(LegacyUnionValue &&move) noexcept : t(move.t)
+    {
+        v = move.v;
+        move.t = UnionType::Undefined;
+    }
+
+    ~LegacyUnionValue()
+    {
+        if (t == UnionType::String) {
+            delete v.s;
+        } else if (t == UnionType::DateTime) {
+            delete v.dt;
+        }
+    }
+
+    LegacyUnionValue &operator=(const LegacyUnionValue &copy) = delete;
+
+    // Compared through 'UnionRef' like 'UnionValue' is
+    bool operator==(const LegacyUnionValue &value) const
+    {
+        return getRef() == value.getRef();
+    }
+
+    UnionRef getRef() const
+    {
+        switch (t) {
+        case UnionType::Integer:
+            return UnionRef(v.i);
+        case UnionType::String:
+            return UnionRef(*v.s);
+        case UnionType::DateTime:
+            return UnionRef(*v.dt);
+        default:
+            return UnionRef();
+        }
+    }
+
+protected:
+    union { bool b; int i; double d; std::string *s; DateTime *dt; } v;
+    UnionType t;
+};
+
+// =============================================================================
+// Benchmarks
+// =============================================================================
+
+// Every fourth value is an integer, a short string, a long string and a date time
+template<typename ValueType>
+std::vector<ValueType> bench_createValueList(int count)
+{
+    std::string shortStr = "item";
+    std::string longStr = "a string that is too long to fit in the small string buffer";
+    DateTime dateTime(2020, 6, 15, 12, 30);
+
+    std::vector<ValueType> list;
+    list.reserve(static_cast<size_t>(count));
+    for (int i = 0; i < count; i++) {
+        switch (i % 4) {
+        case 0:
+            list.emplace_back(i);
+            break;
+        case 1:
+            list.emplace_back(shortStr);
+            break;
+        case 2:
+            list.emplace_back(longStr);
+            break;
+        default:
+            list.emplace_back(dateTime);
+        }
+    }
+    return list;
+}
+
+template<typename ValueType>
+void bench_UnionValueLayout(BenchRunner &runner, const std::string &name)
+{
+    const int count = 1000000;
+
+    runner.run(name + "/create", [&]() {
+        auto list = bench_createValueList<ValueType>(count);
+        benchKeep(static_cast<long long>(list.size()));
+    });
+
+    auto sourceList = bench_createValueList<ValueType>(count);
+
+    runner.run(name + "/copy", [&]() {
+        std::vector<ValueType> list(sourceList);
+        benchKeep(static_cast<long long>(list.size()));
+    });
+
+    // The values are moved back and forth between two lists so only the moves are timed
+    std::vector<ValueType> moveList(sourceList);
+    std::vector<ValueType> movedList;
+    movedList.reserve(moveList.size());
+
+    runner.run(name + "/move", [&]() {
+        movedList.clear();
+        for (auto &value: moveList) {
+            movedList.push_back(std::move(value));
+        }
+        moveList.swap(movedList);
+        benchKeep(static_cast<long long>(moveList.size()));
+    });
+
+    auto compareList = bench_createValueList<ValueType>(count);
+
+    runner.run(name + "/compare", [&]() {
+        long long equalCount = 0;
+        for (size_t i = 0; i < sourceList.size(); i++) {
+            if (sourceList[i] == compareList[i]) { equalCount++; }
+        }
+        benchKeep(equalCount);
+    });
+}
+
+void bench_UnionValue(BenchRunner &runner)
+{
+    std::cout << "Size of LegacyUnionValue: " << sizeof(LegacyUnionValue) << std::endl;
+    std::cout << "Size of UnionValue:       " << sizeof(UnionValue) << std::endl;
+
+    bench_UnionValueLayout<LegacyUnionValue>(runner, "UnionValue/legacy");
+    bench_UnionValueLayout<UnionValue>(runner, "UnionValue/inline");
+}
@@ -0,0 +1,70 @@
+/*
+ * OakModelView (http://oakmodelview.com/)
+ * Author: Mikkel Nøhr Løvgreen (mikkel@oakmodelview.com)
+ * ------------------------------------------------------------------------
+ * Licensed to Vilaversoftware IVS who licenses this file to you under the
+ * Apache License, Version 2.0 (the "License"); you may not use this file
+ * except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "Bench_Model.h"
+
+#include "XMLDocument.h"
+
+// =============================================================================
+// (Benchmarks)
+inline void bench_XMLDocument(BenchRunner &runner, const BenchModel &bModel)
+{
+    const std::string suffix = "/" + bModel.params().name();
+    const long long nodeCount = bModel.params().nodeCount();
+
+    runner.run("XML::Document::parse" + suffix, [&]() {
+        Oak::XML::Document doc;
+        doc.parse(bModel.text());
+        benchKeep(doc.isNull() ? 0 : 1);
+    }, nodeCount);
+
+    runner.run("XML::Document::load" + suffix, [&]() {
+        Oak::XML::Document doc;
+        doc.load(bModel.filePath());
+        benchKeep(doc.isNull() ? 0 : 1);
+    }, nodeCount);
+
+    runner.run("XML::Document::load(Mapped)" + suffix, [&]() {
+        Oak::XML::Document doc;
+        doc.load(bModel.filePath(), Oak::XML::Document::LoadMode::Mapped);
+        benchKeep(doc.isNull() ? 0 : 1);
+    }, nodeCount);
+
+    Oak::XML::Document doc;
+    doc.parse(bModel.text());
+
+    runner.run("XML::Document::save(Indented)" + suffix, [&]() {
+        std::string str;
+        doc.save(str, 2);
+        benchKeep(static_cast<long long>(str.size()));
+    }, nodeCount);
+
+    runner.run("XML::Document::save(Compact)" + suffix, [&]() {
+        std::string str;
+        doc.save(str, -1);
+        benchKeep(static_cast<long long>(str.size()));
+    }, nodeCount);
+
+    const std::string filePath = bModel.filePath() + ".save";
+    runner.run("XML::Document::save(File)" + suffix, [&]() {
+        benchKeep(doc.save(filePath) ? 1 : 0);
+    }, nodeCount);
+    std::remove(filePath.c_str());
+}
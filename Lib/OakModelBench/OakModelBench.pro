@@ -0,0 +1,51 @@
+CONFIG += \
+    console \
+    release
+
+INCLUDEPATH +=  \
+    .. \
+    ../OakXML \
+    ../OakModel
+
+include(../OakModel/Configure.pri)
+
+SOURCES += \
+    main.cpp
+
+HEADERS += \
+    Bench.h \
+    Bench_DateTime.h \
+    Bench_Model.h \
+    Bench_Node.h \
+    Bench_Query.h \
+    Bench_UnionValue.h \
+    Bench_XMLDocument.h
+
+# The QOakModel benchmarks are built with "qmake CONFIG+=oak_bench_qt"
+oak_bench_qt {
+    QT += qml quick
+    DEFINES += OAK_BENCH_QT
+    INCLUDEPATH += \
+        ../QtOakModel \
+        ../QMLOakTreeViewPlugin
+    HEADERS += \
+        Bench_QOakModel.h \
+        Bench_OakTreeView.h \
+        ../QMLOakTreeViewPlugin/OakTreeViewInternalModel.h \
+        ../QMLOakTreeViewPlugin/OakTreeViewNodeData.h \
+        ../QMLOakTreeViewPlugin/FenwickTree.h
+    SOURCES += \
+        ../QMLOakTreeViewPlugin/OakTreeViewInternalModel.cpp \
+        ../QMLOakTreeViewPlugin/OakTreeViewNodeData.cpp
+    win32:POST_TARGETDEPS += ../QtOakModel.lib
+    win32:LIBS += ../QtOakModel.lib
+}
+
+TARGET = OakModelBench
+win32:POST_TARGETDEPS += \
+    ../OakXML.lib \
+    ../OakModel.lib
+win32:LIBS += \
+    ../OakXML.lib \
+    ../OakModel.lib
+OBJECTS_DIR = ./release
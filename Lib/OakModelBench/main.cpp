@@ -0,0 +1,83 @@
+/*
+ * OakModelView (http://oakmodelview.com/)
+ * Author: Mikkel Nøhr Løvgreen (mikkel@oakmodelview.com)
+ * ------------------------------------------------------------------------
+ * Licensed to Vilaversoftware IVS who licenses this file to you under the
+ * Apache License, Version 2.0 (the "License"); you may not use this file
+ * except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Bench.h"
+#include "Bench_UnionValue.h"
+#include "Bench_DateTime.h"
+#include "Bench_Model.h"
+#include "Bench_XMLDocument.h"
+#include "Bench_Node.h"
+#include "Bench_Query.h"
+#ifdef OAK_BENCH_QT
+#include "Bench_QOakModel.h"
+#include "Bench_OakTreeView.h"
+#endif // OAK_BENCH_QT
+
+#include "../ServiceFunctions/Instrumentation.h"
+
+#include <fstream>
+
+// Options:
+//  --filter=<text>       Runs only the benchmarks with names that contain the text
+//  --min-time=<seconds>  The minimum time each benchmark is run
+//  --json=<file path>    Writes the results to the file as JSON
+//  --depth=<n> --fan-out=<n> --leafs=<n> --variants=<n>
+//                        The shape of the generated document (See BenchModelParams)
+//  --tmp-dir=<path>      Where the generated document is saved
+//  --stats=<file path>   Writes the instrumentation counters and timer totals as JSON
+//  --trace=<file path>   Writes the instrumentation timer events as a Chrome trace
+//                        (The library must be built with OAK_INSTRUMENTATION)
+int main(int argc, char *argv[])
+{
+    BenchRunner runner(argc, argv);
+
+    bench_UnionValue(runner);
+    bench_DateTime(runner);
+
+    BenchModelParams params(runner);
+    runner.addContext("model", params.name());
+    runner.addContext("model_nodes", std::to_string(params.nodeCount()));
+
+    BenchModel bModel(params, runner.option("tmp-dir", "."));
+    // Only the benchmarks are counted, not the generation of the document
+    Oak::Instrumentation::reset();
+
+    bench_XMLDocument(runner, bModel);
+    bench_Node(runner, bModel);
+    bench_Query(runner, bModel);
+#ifdef OAK_BENCH_QT
+    bench_QOakModel(runner, bModel);
+    bench_OakTreeView(runner, params);
+#endif // OAK_BENCH_QT
+
+    // Changes the leaf values of the generated document
+    bench_Leaf(runner, bModel);
+
+    std::string statsFilePath = runner.option("stats", "");
+    if (!statsFilePath.empty()) {
+        std::ofstream file(statsFilePath);
+        Oak::Instrumentation::writeStatsJson(file);
+    }
+    std::string traceFilePath = runner.option("trace", "");
+    if (!traceFilePath.empty()) {
+        std::ofstream file(traceFilePath);
+        Oak::Instrumentation::writeChromeTrace(file);
+    }
+
+    return 0;
+}
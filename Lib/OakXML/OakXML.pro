@@ -8,10 +8,12 @@ unix::QMAKE_CXXFLAGS += -std=gnu++0x
 SOURCES += \
     pugixml/pugixml.cpp \
     XMLElement.cpp \
+    XMLNameId.cpp \
     XMLValueRef.cpp \
     XMLRefFactory.cpp \
     XMLServiceFunctions.cpp \
     XMLDocument.cpp \
+    XMLWriter.cpp \
     XMLListRef.cpp \
     XMLRef.cpp \
     XMLChildRef.cpp \
@@ -23,10 +25,12 @@ HEADERS += \
     pugixml/pugiconfig.hpp \
     pugixml/pugixml.hpp \
     XMLElement.h \
+    XMLNameId.h \
     XMLValueRef.h \
     XMLRefFactory.h \
     XMLServiceFunctions.h \
     XMLDocument.h \
+    XMLWriter.h \
     XMLListRef.h \
     XMLRef.h \
     XMLChildRef.h \
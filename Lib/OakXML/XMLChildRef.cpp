@@ -63,7 +63,7 @@ ChildRef &ChildRef::operator=(const ChildRef& copy)
 // (public)
 ChildRef &ChildRef::operator=(ChildRef&& move)
 {
-    m_tagName = std::move(move.m_tagName);
+    m_tagName = move.m_tagName;
     m_index = move.m_index;
     return *this;
 }
@@ -97,11 +97,11 @@ Element ChildRef::getTarget(Element source, bool create) const
     }
 
     // Creats the reference element if it is missing
-    if (create && refElement.isNull() && !m_tagName.empty()) {
+    if (create && refElement.isNull() && !m_tagName.isEmpty()) {
         index--; // Last element was not found
         refElement = source.lastChild(m_tagName);
         while (index < m_index) {
-            refElement = source.insertAfter(m_tagName, refElement);
+            refElement = source.insertAfter(m_tagName.str(), refElement);
             index++;
         }
     }
@@ -21,6 +21,7 @@
 #ifdef XML_BACKEND
 
 #include "XMLRef.h"
+#include "XMLNameId.h"
 
 namespace Oak::XML {
 
@@ -53,11 +54,12 @@ public:
     int index() const { return m_index; }
     void setIndex(int index) { m_index = index; }
 
-    const std::string& tagName() const { return m_tagName; }
-    void setTagName(std::string tagName) { m_tagName = tagName; }
+    const std::string& tagName() const { return m_tagName.str(); }
+    const NameId& tagNameId() const { return m_tagName; }
+    void setTagName(std::string tagName) { m_tagName = NameId(tagName); }
 
-    virtual const std::string& firstTagName() const override { return m_tagName; }
-    virtual const std::string& lastTagName() const override { return m_tagName; }
+    virtual const std::string& firstTagName() const override { return m_tagName.str(); }
+    virtual const std::string& lastTagName() const override { return m_tagName.str(); }
 
     template<class... _Types> inline
     static ChildRefUPtr MakeUPtr(_Types&&... _Args)
@@ -66,7 +68,7 @@ public:
     }
 
 protected:
-    std::string m_tagName;
+    NameId m_tagName;
     int m_index;
 };
 
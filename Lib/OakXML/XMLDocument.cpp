@@ -23,14 +23,127 @@
 #include "XMLServiceFunctions.h"
 
 #include "../ServiceFunctions/Assert.h"
+#include "../ServiceFunctions/Instrumentation.h"
+
+#include <cstdio>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 namespace Oak::XML {
 
+// =============================================================================
+// Class definition
+// =============================================================================
+// The pugixml document and the file mapping its strings point into when it
+//  was parsed in place. It is shared by copies of Document the same way as the
+//  pugixml document, so the mapping lives as long as the nodes that use it.
+class Document::Data : public pugi::xml_document
+{
+public:
+    Data() {}
+    ~Data()
+    {
+        reset();
+        unmap();
+    }
+
+    bool map(const std::string &filePath);
+    void unmap();
+
+    bool isMapped() const { return m_mappedData != nullptr; }
+    const std::string &mappedFilePath() const { return m_mappedFilePath; }
+    void *mappedData() const { return m_mappedData; }
+    size_t mappedSize() const { return m_mappedSize; }
+
+protected:
+    void *m_mappedData = nullptr;
+    size_t m_mappedSize = 0;
+    std::string m_mappedFilePath;
+};
+
+// =============================================================================
+//
+bool Document::Data::map(const std::string &filePath)
+{
+    ASSERT(!isMapped());
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) { return false; }
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0) {
+        CloseHandle(file);
+        return false;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+    CloseHandle(file);
+    if (mapping == nullptr) { return false; }
+
+    // The view keeps the mapping open
+    void *data = MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0);
+    CloseHandle(mapping);
+    if (data == nullptr) { return false; }
+
+    m_mappedSize = static_cast<size_t>(fileSize.QuadPart);
+#else
+    int fd = open(filePath.c_str(), O_RDONLY);
+    if (fd < 0) { return false; }
+
+    struct stat fileStat;
+    if (fstat(fd, &fileStat) != 0 || fileStat.st_size == 0) {
+        close(fd);
+        return false;
+    }
+
+    // Private mapping: The in place parser writes to the pages without changing the file
+    void *data = mmap(nullptr, static_cast<size_t>(fileStat.st_size), PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) { return false; }
+
+    madvise(data, static_cast<size_t>(fileStat.st_size), MADV_SEQUENTIAL);
+    m_mappedSize = static_cast<size_t>(fileStat.st_size);
+#endif
+
+    m_mappedData = data;
+    m_mappedFilePath = filePath;
+    return true;
+}
+
+// =============================================================================
+//
+void Document::Data::unmap()
+{
+    if (!isMapped()) { return; }
+
+#ifdef _WIN32
+    UnmapViewOfFile(m_mappedData);
+#else
+    munmap(m_mappedData, m_mappedSize);
+#endif
+
+    m_mappedData = nullptr;
+    m_mappedSize = 0;
+    m_mappedFilePath.clear();
+}
+
 // =============================================================================
 //
 Document::Document()
-    : m_document(new pugi::xml_document())
+    : m_document(new Data())
 {
+    Element(*m_document).touch();
 }
 
 // =============================================================================
@@ -81,6 +194,7 @@ bool Document::isNull() const
 //
 Element Document::appendChild(const std::string &tagName)
 {
+    Element(*m_document).touch();
     return Element(m_document->append_child(tagName.c_str()));
 }
 
@@ -89,22 +203,62 @@ Element Document::appendChild(const std::string &tagName)
 void Document::clear()
 {
     m_document->reset();
+    m_document->unmap();
+    // The document is recreated by reset(), so it needs a generation that was not used before
+    Element(*m_document).touch();
 }
 
 // =============================================================================
 //
 bool Document::save(std::string filePath) const
 {
-    return m_document->save_file(filePath.c_str(), "  ", pugi::format_indent | pugi::format_save_file_text);
+    OAK_SCOPED_TIMER("XML::Document::save(file)");
+    if (!m_document->isMapped() || filePath != m_document->mappedFilePath()) {
+        return m_document->save_file(filePath.c_str(), "  ", pugi::format_indent | pugi::format_save_file_text);
+    }
+
+    // Truncating the mapped file would remove the pages the document still reads from.
+    //  Write a new file and replace the old one, the mapping keeps the old content.
+    std::string tempFilePath = filePath + ".tmp";
+    if (!m_document->save_file(tempFilePath.c_str(), "  ", pugi::format_indent | pugi::format_save_file_text)) {
+        return false;
+    }
+#ifdef _WIN32
+    if (!MoveFileExA(tempFilePath.c_str(), filePath.c_str(), MOVEFILE_REPLACE_EXISTING)) {
+#else
+    if (std::rename(tempFilePath.c_str(), filePath.c_str()) != 0) {
+#endif
+        std::remove(tempFilePath.c_str());
+        return false;
+    }
+    return true;
 }
 
 // =============================================================================
 //
 void Document::save(std::string &str, int indent) const
 {
-    // TODO
-    UNUSED(str);
-    UNUSED(indent);
+    OAK_SCOPED_TIMER("XML::Document::save(string)");
+    str.clear();
+    StringWriter writer(str);
+    if (indent < 0) {
+        m_document->save(writer, "", pugi::format_raw);
+    } else {
+        m_document->save(writer, std::string(static_cast<size_t>(indent), ' ').c_str(), pugi::format_indent);
+    }
+}
+
+// =============================================================================
+//
+bool Document::save(Writer &writer, SaveFormat format) const
+{
+    OAK_SCOPED_TIMER("XML::Document::save(writer)");
+    if (format == SaveFormat::Compact) {
+        m_document->save(writer, "", pugi::format_raw);
+    } else {
+        m_document->save(writer, "  ", pugi::format_indent);
+    }
+    return !writer.failed();
 }
 
 // =============================================================================
@@ -112,20 +266,76 @@ void Document::save(std::string &str, int indent) const
 void Document::clone(const Document &copy)
 {
     m_document->reset(*copy.m_document.get());
+    if (m_document != copy.m_document) {
+        m_document->unmap();
+    }
+    Element(*m_document).touch();
 }
 
 // =============================================================================
 //
-bool Document::load(std::string filePath)
+bool Document::load(std::string filePath, LoadMode mode)
 {
-    return m_document->load_file(filePath.c_str(), pugi::parse_full).status == pugi::status_ok;
+    if (mode == LoadMode::Mapped) {
+        return loadMapped(filePath);
+    }
+
+    OAK_SCOPED_TIMER("XML::Document::load");
+    bool result = m_document->load_file(filePath.c_str(), ParseFull).status == pugi::status_ok;
+    m_document->unmap();
+    Element(*m_document).touch();
+    return result;
 }
 
 // =============================================================================
 //
 bool Document::load(std::istream stream)
 {
-    return m_document->load(stream).status == pugi::status_ok;
+    OAK_SCOPED_TIMER("XML::Document::load(stream)");
+    bool result = m_document->load(stream).status == pugi::status_ok;
+    m_document->unmap();
+    Element(*m_document).touch();
+    return result;
+}
+
+// =============================================================================
+//
+bool Document::loadMapped(const std::string &filePath, unsigned int parseOptions)
+{
+    OAK_SCOPED_TIMER("XML::Document::loadMapped");
+    m_document->reset();
+    m_document->unmap();
+    Element(*m_document).touch();
+
+    if (!m_document->map(filePath)) { return false; }
+
+    // Files that need encoding conversion are copied by pugixml and the mapping is not used
+    if (m_document->load_buffer_inplace(m_document->mappedData(), m_document->mappedSize(), parseOptions, pugi::encoding_auto).status != pugi::status_ok) {
+        m_document->reset();
+        m_document->unmap();
+        Element(*m_document).touch();
+        return false;
+    }
+    Element(*m_document).touch();
+    return true;
+}
+
+// =============================================================================
+//
+bool Document::isMapped() const
+{
+    return m_document->isMapped();
+}
+
+// =============================================================================
+//
+bool Document::parse(const std::string &text)
+{
+    OAK_SCOPED_TIMER("XML::Document::parse");
+    bool result = m_document->load_buffer(text.data(), text.size(), ParseFull).status == pugi::status_ok;
+    m_document->unmap();
+    Element(*m_document).touch();
+    return result;
 }
 
 // =============================================================================
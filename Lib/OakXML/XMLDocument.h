@@ -21,6 +21,7 @@
 #ifdef XML_BACKEND
 
 #include "XMLElement.h"
+#include "XMLWriter.h"
 
 #include <memory>
 
@@ -32,6 +33,16 @@ namespace Oak::XML {
 class Document
 {
 public:
+    // Keeps everything in the file, including comments, PIs and DOCTYPE
+    static const unsigned int ParseFull = pugi::parse_full;
+    // Keeps only what the model uses. Values are parsed the same way as ParseFull
+    static const unsigned int ParseModel = pugi::parse_default;
+
+    // Copy reads the file into a buffer owned by the document.
+    // Mapped maps the file copy-on-write and parses it in place with ParseModel,
+    //  so only the pages modified by the parser are copied into memory.
+    enum class LoadMode { Copy, Mapped };
+
     Document();
     Document(const Document &copy);
 
@@ -44,7 +55,10 @@ public:
     bool isNull() const;
 
     bool save(std::string filePath) const;
+    // A negative indent saves the document in the compact format
     void save(std::string &str, int indent) const;
+    // Streams the document to 'writer'. Call writer.finish() when done writing
+    bool save(Writer &writer, SaveFormat format = SaveFormat::Indented) const;
 
     Element appendChild(const std::string &tagName);
 
@@ -52,12 +66,19 @@ public:
 
     void clone(const Document &copy);
 
-    bool load(std::string filePath);
+    bool load(std::string filePath, LoadMode mode = LoadMode::Copy);
     bool load(std::istream stream);
+    // The mapping is kept until the document is cleared or loaded again.
+    //  Comments and PIs are not saved again when parsed with ParseModel
+    bool loadMapped(const std::string &filePath, unsigned int parseOptions = ParseModel);
+    bool isMapped() const;
+    // Parses the XML in 'text' instead of reading a file
+    bool parse(const std::string &text);
     Element documentElement();
 
 private:
-    std::shared_ptr<pugi::xml_document> m_document;
+    class Data;
+    std::shared_ptr<Data> m_document;
 };
 
 } // namespace Oak::XML
@@ -23,10 +23,14 @@
 #include "XMLServiceFunctions.h"
 
 #include <regex>
+#include <cstring>
 #include "../ServiceFunctions/Assert.h"
+#include "../ServiceFunctions/Instrumentation.h"
 
 namespace Oak::XML {
 
+std::atomic<unsigned long long> Element::s_generation(0);
+
 // =============================================================================
 //
 Element::Element()
@@ -62,6 +66,13 @@ int Element::compareTagName(const std::string &tName) const
     return tName.compare(m_element.name());
 }
 
+// =============================================================================
+//
+bool Element::hasTagName(const NameId &tagName) const
+{
+    return tagName.isEqual(m_element.name());
+}
+
 // =============================================================================
 //
 bool Element::isNull() const
@@ -88,6 +99,7 @@ pugi::xml_node Element::internalObject() const
 // Replaces this element with a copy of the argument element
 bool Element::cloneElement(const Element &element)
 {
+    touch();
     pugi::impl::recursive_copy_skip(m_element, element.m_element, m_element);
     return !m_element.empty();
 }
@@ -96,6 +108,7 @@ bool Element::cloneElement(const Element &element)
 //
 Element Element::prependChild(const std::string &tagName)
 {
+    touch();
     return Element(m_element.prepend_child(tagName.c_str()));
 }
 
@@ -103,6 +116,7 @@ Element Element::prependChild(const std::string &tagName)
 //
 Element Element::appendChild(const std::string &tagName)
 {
+    touch();
     return Element(m_element.append_child(tagName.c_str()));
 }
 
@@ -110,6 +124,7 @@ Element Element::appendChild(const std::string &tagName)
 //
 Element Element::insertBefore(const std::string &tagName, const Element &refChild)
 {
+    touch();
     if (refChild.isNull()) {
         return Element(m_element.prepend_child(tagName.c_str()));
     } else {
@@ -121,6 +136,7 @@ Element Element::insertBefore(const std::string &tagName, const Element &refChil
 //
 Element Element::insertAfter(const std::string &tagName, const Element &refChild)
 {
+    touch();
     if (refChild.isNull()) {
         return Element(m_element.append_child(tagName.c_str()));
     } else {
@@ -129,37 +145,44 @@ Element Element::insertAfter(const std::string &tagName, const Element &refChild
 }
 
 // =============================================================================
-//
+// The target is relinked so the element and its subtree are not copied
 Element Element::moveBefore(const Element &target, const Element &refChild)
 {
-    if (!refChild.isNull() && refChild.previousSibling() == target) {
+    if (target == refChild || (!refChild.isNull() && refChild.previousSibling() == target)) {
         // Target is already before refChild
         return target;
     }
-    Element element = insertBefore(target.tagName(), refChild);
-    element.cloneElement(target);
-    target.parentElement().removeChild(target);
-    return element;
+    touch();
+    target.touch();
+    if (refChild.isNull()) {
+        return Element(m_element.prepend_move(target.m_element));
+    } else {
+        return Element(m_element.insert_move_before(target.m_element, refChild.m_element));
+    }
 }
 
 // =============================================================================
-//
+// The target is relinked so the element and its subtree are not copied
 Element Element::moveAfter(const Element &target, const Element &refChild)
 {
-    if (!refChild.isNull() && refChild.nextSibling() == target) {
-        // Target is already before refChild
+    if (target == refChild || (!refChild.isNull() && refChild.nextSibling() == target)) {
+        // Target is already after refChild
         return target;
     }
-    Element element = insertAfter(target.tagName(), refChild);
-    element.cloneElement(target);
-    target.parentElement().removeChild(target);
-    return element;
+    touch();
+    target.touch();
+    if (refChild.isNull()) {
+        return Element(m_element.append_move(target.m_element));
+    } else {
+        return Element(m_element.insert_move_after(target.m_element, refChild.m_element));
+    }
 }
 
 // =============================================================================
 //
 bool Element::removeChild(const Element &child)
 {
+    touch();
     return m_element.remove_child(child.m_element);
 }
 
@@ -167,6 +190,7 @@ bool Element::removeChild(const Element &child)
 //
 void Element::clear()
 {
+    touch();
     m_element.parent().remove_child(m_element);
 }
 
@@ -174,12 +198,42 @@ void Element::clear()
 //
 void Element::save(std::string &str, int indent) const
 {
-    UNUSED(str);
-    UNUSED(indent);
-    //TODO
+    str.clear();
+    StringWriter writer(str);
+    if (indent < 0) {
+        m_element.print(writer, "", pugi::format_raw);
+    } else {
+        m_element.print(writer, std::string(static_cast<size_t>(indent), ' ').c_str(), pugi::format_indent);
+    }
+}
+
+// =============================================================================
+//
+bool Element::save(Writer &writer, SaveFormat format) const
+{
+    if (format == SaveFormat::Compact) {
+        m_element.print(writer, "", pugi::format_raw);
+    } else {
+        m_element.print(writer, "  ", pugi::format_indent);
+    }
+    return !writer.failed();
 }
 
 // Element navigation
+// =============================================================================
+//
+Element Element::firstChild() const
+{
+    pugi::xml_node node = m_element.first_child();
+    while (!node.empty()) {
+        if (node.type() == pugi::node_element) {
+            return Element(node);
+        }
+        node = node.next_sibling();
+    }
+    return Element();
+}
+
 // =============================================================================
 //
 Element Element::firstChild(const std::string &tagName) const
@@ -196,6 +250,34 @@ Element Element::firstChild(const std::string &tagName) const
     return Element();
 }
 
+// =============================================================================
+//
+Element Element::firstChild(const NameId &tagName) const
+{
+    pugi::xml_node node = m_element.first_child();
+    while (!node.empty()) {
+        if (node.type() == pugi::node_element && tagName.matches(node.name())) {
+            return Element(node);
+        }
+        node = node.next_sibling();
+    }
+    return Element();
+}
+
+// =============================================================================
+//
+Element Element::lastChild() const
+{
+    pugi::xml_node node = m_element.last_child();
+    while (!node.empty()) {
+        if (node.type() == pugi::node_element) {
+            return Element(node);
+        }
+        node = node.previous_sibling();
+    }
+    return Element();
+}
+
 // =============================================================================
 //
 Element Element::lastChild(const std::string &tagName) const
@@ -212,12 +294,42 @@ Element Element::lastChild(const std::string &tagName) const
     return Element();
 }
 
+// =============================================================================
+//
+Element Element::lastChild(const NameId &tagName) const
+{
+    pugi::xml_node node = m_element.last_child();
+    while (!node.empty()) {
+        if (node.type() == pugi::node_element && tagName.matches(node.name())) {
+            return Element(node);
+        }
+        node = node.previous_sibling();
+    }
+    return Element();
+}
+
+// =============================================================================
+//
+Element Element::nextSibling() const
+{
+    pugi::xml_node node = m_element.next_sibling();
+    while (!node.empty()) {
+        OAK_COUNT(SiblingScanStep);
+        if (node.type() == pugi::node_element) {
+            return Element(node);
+        }
+        node = node.next_sibling();
+    }
+    return Element();
+}
+
 // =============================================================================
 //
 Element Element::nextSibling(const std::string &tagName) const
 {
     pugi::xml_node node = m_element.next_sibling();
     while (!node.empty()) {
+        OAK_COUNT(SiblingScanStep);
         if (node.type() == pugi::node_element) {
             if (tagName.empty() || tagName.compare(node.name()) == 0) {
                 return Element(node);
@@ -228,12 +340,43 @@ Element Element::nextSibling(const std::string &tagName) const
     return Element();
 }
 
+// =============================================================================
+//
+Element Element::nextSibling(const NameId &tagName) const
+{
+    pugi::xml_node node = m_element.next_sibling();
+    while (!node.empty()) {
+        OAK_COUNT(SiblingScanStep);
+        if (node.type() == pugi::node_element && tagName.matches(node.name())) {
+            return Element(node);
+        }
+        node = node.next_sibling();
+    }
+    return Element();
+}
+
+// =============================================================================
+//
+Element Element::previousSibling() const
+{
+    pugi::xml_node node = m_element.previous_sibling();
+    while (!node.empty()) {
+        OAK_COUNT(SiblingScanStep);
+        if (node.type() == pugi::node_element) {
+            return Element(node);
+        }
+        node = node.previous_sibling();
+    }
+    return Element();
+}
+
 // =============================================================================
 //
 Element Element::previousSibling(const std::string &tagName) const
 {
     pugi::xml_node node = m_element.previous_sibling();
     while (!node.empty()) {
+        OAK_COUNT(SiblingScanStep);
         if (node.type() == pugi::node_element) {
             if (tagName.empty() || tagName.compare(node.name()) == 0) {
                 return Element(node);
@@ -244,6 +387,21 @@ Element Element::previousSibling(const std::string &tagName) const
     return Element();
 }
 
+// =============================================================================
+//
+Element Element::previousSibling(const NameId &tagName) const
+{
+    pugi::xml_node node = m_element.previous_sibling();
+    while (!node.empty()) {
+        OAK_COUNT(SiblingScanStep);
+        if (node.type() == pugi::node_element && tagName.matches(node.name())) {
+            return Element(node);
+        }
+        node = node.previous_sibling();
+    }
+    return Element();
+}
+
 // =============================================================================
 //
 Element Element::parentElement() const
@@ -267,6 +425,13 @@ bool Element::hasAttribute(const std::string &name) const
     return false;
 }
 
+// =============================================================================
+//
+bool Element::hasAttribute(const NameId &name) const
+{
+    return !findAttribute(name).empty();
+}
+
 // =============================================================================
 //
 std::string Element::attribute(const std::string &name) const
@@ -299,6 +464,42 @@ bool Element::getAttribute(const std::string &name, std::string &value) const
     return false;
 }
 
+// =============================================================================
+//
+bool Element::getAttribute(const NameId &name, std::string &value) const
+{
+    pugi::xml_attribute attribute = findAttribute(name);
+    if (attribute.empty()) {
+        value.clear();
+        return false;
+    }
+    value = attribute.value();
+    return true;
+}
+
+// =============================================================================
+//
+const char *Element::attributeCString(const std::string &name) const
+{
+    auto it = m_element.attributes_begin();
+    auto itEnd = m_element.attributes_end();
+    while (it != itEnd) {
+        if (name.compare(it->name()) == 0) {
+            return it->value();
+        }
+        it++;
+    }
+    return nullptr;
+}
+
+// =============================================================================
+//
+const char *Element::attributeCString(const NameId &name) const
+{
+    pugi::xml_attribute attribute = findAttribute(name);
+    return attribute.empty() ? nullptr : attribute.value();
+}
+
 // =============================================================================
 //
 std::map<std::string,std::string> Element::attributeMap()const
@@ -317,20 +518,28 @@ std::map<std::string,std::string> Element::attributeMap()const
 //
 bool Element::setAttribute(const std::string &name, const std::string &value)
 {
+    return setAttribute(name, value.c_str());
+}
+
+// =============================================================================
+//
+bool Element::setAttribute(const std::string &name, const char *value)
+{
+    ASSERT(value);
     auto it = m_element.attributes_begin();
     auto itEnd = m_element.attributes_end();
     while (it != itEnd) {
         if (name.compare(it->name()) == 0) {
-            if (value.compare(it->value()) == 0) {
+            if (std::strcmp(value, it->value()) == 0) {
                 // Strings are equal
                 return false;
             }
-            it->set_value(value.c_str());
+            it->set_value(value);
             return true;
         }
         it++;
     }
-    m_element.append_attribute(name.c_str()).set_value(value.c_str());
+    m_element.append_attribute(name.c_str()).set_value(value);
     return true;
 }
 
@@ -349,6 +558,14 @@ int Element::compareAttribute(const std::string &name, const std::string &value)
     return -2;
 }
 
+// =============================================================================
+//
+int Element::compareAttribute(const NameId &name, const std::string &value)
+{
+    pugi::xml_attribute attribute = findAttribute(name);
+    return attribute.empty() ? -2 : value.compare(attribute.value());
+}
+
 // =============================================================================
 //
 bool Element::removeAttribute(const std::string &name)
@@ -379,11 +596,26 @@ bool Element::getText(std::string &str) const
     return true;
 }
 
+// =============================================================================
+//
+const char *Element::textCString() const
+{
+    return m_element.text().get();
+}
+
 // =============================================================================
 //
 bool Element::setText(const std::string &text)
 {
-    if (text.empty()) {
+    return setText(text.c_str());
+}
+
+// =============================================================================
+//
+bool Element::setText(const char *text)
+{
+    ASSERT(text);
+    if (*text == '\0') {
         if (m_element.text().empty()) {
             // Both strings is empty
             return false;
@@ -393,12 +625,12 @@ bool Element::setText(const std::string &text)
             return true;
         }
     } else {
-        if (text.compare(m_element.text().get()) == 0) {
+        if (std::strcmp(text, m_element.text().get()) == 0) {
             // Strings are equal
             return false;
         } else {
             // Set the new text string
-            m_element.text().set(text.c_str());
+            m_element.text().set(text);
             return true;
         }
     }
@@ -471,6 +703,43 @@ bool Element::validateAttributeText(const std::string &text)
     return true;
 }
 
+// =============================================================================
+//
+unsigned long long Element::generation() const
+{
+    if (m_element.empty()) { return 0; }
+    return pugi::impl::get_document(m_element.internal_object()).generation;
+}
+
+// =============================================================================
+//
+bool Element::isSameDocument(const Element &element) const
+{
+    if (m_element.empty() || element.m_element.empty()) { return false; }
+    return &pugi::impl::get_document(m_element.internal_object()) == &pugi::impl::get_document(element.m_element.internal_object());
+}
+
+// =============================================================================
+// Gives the document of the element a new generation
+void Element::touch() const
+{
+    if (m_element.empty()) { return; }
+    pugi::impl::get_document(m_element.internal_object()).generation = ++s_generation;
+}
+
+// =============================================================================
+//
+pugi::xml_attribute Element::findAttribute(const NameId &name) const
+{
+    if (name.isEmpty()) { return pugi::xml_attribute(); }
+    for (pugi::xml_attribute attribute = m_element.first_attribute(); attribute; attribute = attribute.next_attribute()) {
+        if (name.isEqual(attribute.name())) {
+            return attribute;
+        }
+    }
+    return pugi::xml_attribute();
+}
+
 } // namespace Oak::XML
 
 #endif // XML_BACKEND
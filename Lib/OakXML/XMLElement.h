@@ -23,12 +23,15 @@
 // This class is ment to be an definition to a xml parser
 // It is created in the hopes that the TDMLib will be independent of a specific xml parser
 
+#include <atomic>
 #include <map>
 #include <string>
 #include <vector>
 typedef std::basic_ostream<char, std::char_traits<char> > stdTextStream;
 
 #include "pugixml/pugixml.hpp"
+#include "XMLWriter.h"
+#include "XMLNameId.h"
 
 #ifndef UNUSED
 #define UNUSED(x) (void)x;
@@ -52,6 +55,7 @@ public:
 
     std::string tagName() const;
     int compareTagName(const std::string &tName) const;
+    bool hasTagName(const NameId &tagName) const;
 
     bool isNull() const;
     bool empty() const;
@@ -64,35 +68,58 @@ public:
     Element appendChild(const std::string &tagName);
     Element insertBefore(const std::string &tagName, const Element &refChild);
     Element insertAfter(const std::string &tagName, const Element &refChild);
+    // Moves 'target' by relinking it, so the element keeps its identity. Returns
+    //  a null element if 'target' is this element or one of its parents
     Element moveBefore(const Element &target, const Element &refChild);
     Element moveAfter(const Element &target, const Element &refChild);
     bool removeChild(const Element &child);
     void clear();
+    // A negative indent saves the element in the compact format
     void save(std::string &str, int indent) const;
+    // Streams the element and its descendants to 'writer'
+    bool save(Writer &writer, SaveFormat format = SaveFormat::Indented) const;
 
     // Element navigation
-    Element firstChild(const std::string &tagName = std::string()) const;
-    Element lastChild(const std::string &tagName = std::string()) const;
-
-    Element nextSibling(const std::string &tagName = std::string()) const;
-    Element previousSibling(const std::string &tagName = std::string()) const;
+    Element firstChild() const;
+    Element firstChild(const std::string &tagName) const;
+    Element firstChild(const NameId &tagName) const;
+    Element lastChild() const;
+    Element lastChild(const std::string &tagName) const;
+    Element lastChild(const NameId &tagName) const;
+
+    Element nextSibling() const;
+    Element nextSibling(const std::string &tagName) const;
+    Element nextSibling(const NameId &tagName) const;
+    Element previousSibling() const;
+    Element previousSibling(const std::string &tagName) const;
+    Element previousSibling(const NameId &tagName) const;
 
     Element parentElement() const;
 
     // Attribute
     bool hasAttribute(const std::string &name) const;
+    bool hasAttribute(const NameId &name) const;
     std::string attribute(const std::string &name) const;
     bool getAttribute(const std::string &name, std::string &value) const;
+    bool getAttribute(const NameId &name, std::string &value) const;
+    // Returns the attribute value stored in the document or nullptr if the attribute is not found
+    const char *attributeCString(const std::string &name) const;
+    const char *attributeCString(const NameId &name) const;
     std::map<std::string,std::string> attributeMap()const;
     bool setAttribute(const std::string &name, const std::string &value);
+    bool setAttribute(const std::string &name, const char *value);
     int compareAttribute(const std::string& name, const std::string& value);
+    int compareAttribute(const NameId& name, const std::string& value);
     bool removeAttribute(const std::string &name);
 
     // Element text
     bool hasText() const;
     std::string text() const;
     bool getText(std::string &str) const;
+    // Returns the text stored in the document or an empty string if there is no text
+    const char *textCString() const;
     bool setText(const std::string &text);
+    bool setText(const char *text);
     int compareText(const std::string& value);
     bool removeText();
 
@@ -106,10 +133,24 @@ public:
     static bool validateTagText(const std::string& text);
     static bool validateAttributeText(const std::string& text);
 
+    // The generation of the document changes every time elements are added to or removed
+    // from it. Caches of element handles are valid as long as it is unchanged.
+    // Generations are unique across documents, a null element has generation 0
+    unsigned long long generation() const;
+
+    // Elements can only be moved between parents of the same document
+    bool isSameDocument(const Element &element) const;
+
 private:
+    pugi::xml_attribute findAttribute(const NameId &name) const;
+    void touch() const;
+
     pugi::xml_node m_element;
 
-//    friend class ParserDocument;
+    // The last generation given to a document
+    static std::atomic<unsigned long long> s_generation;
+
+    friend class Document;
 };
 
 } // namespace Oak::XML
@@ -24,11 +24,13 @@
 
 namespace Oak::XML {
 
+thread_local int ListRef::s_sharedReadDepth = 0;
+
 // =============================================================================
 // (public)
 ListRef::ListRef(const std::string &elementTagName)
     : m_listBaseRef(Ref::MakeUPtr()),
-      m_tagName(elementTagName),
+      m_tagName(NameId(elementTagName)),
       m_subRef(ChildRefGroup::MakeUPtr())
 {
 }
@@ -37,10 +39,10 @@ ListRef::ListRef(const std::string &elementTagName)
 // (public)
 ListRef::ListRef(RefUPtr listBaseRef, const std::string &elementTagName, ChildRefGroupUPtr elementSubRef)
     : m_listBaseRef(std::move(listBaseRef)),
-      m_tagName(elementTagName),
+      m_tagName(NameId(elementTagName)),
       m_subRef(std::move(elementSubRef))
 {
-    ASSERT(!m_tagName.empty());
+    ASSERT(!m_tagName.isEmpty());
 }
 
 // =============================================================================
@@ -71,6 +73,8 @@ ListRef& ListRef::operator=(const ListRef &copy)
     m_listBaseRef = copy.m_listBaseRef->copy();
     m_tagName = copy.m_tagName;
     m_subRef = copy.m_subRef->copyChildGroup();
+    m_indexEnabled = copy.m_indexEnabled;
+    m_indexMap.clear();
     return *this;
 }
 
@@ -79,8 +83,10 @@ ListRef& ListRef::operator=(const ListRef &copy)
 ListRef& ListRef::operator=(ListRef &&move)
 {
     m_listBaseRef = std::move(move.m_listBaseRef);
-    m_tagName = std::move(move.m_tagName);
+    m_tagName = move.m_tagName;
     m_subRef = std::move(move.m_subRef);
+    m_indexEnabled = move.m_indexEnabled;
+    m_indexMap = std::move(move.m_indexMap);
     return *this;
 }
 
@@ -101,6 +107,10 @@ int ListRef::count(Element refBase) const
 
     if (listBase.isNull()) { return 0; }
 
+    std::unique_lock<std::mutex> indexLock(m_indexMutex, std::defer_lock);
+    SiblingIndex *siblings = (useSiblingIndex() && indexLock.try_lock()) ? siblingIndex(listBase) : nullptr;
+    if (siblings) { return static_cast<int>(siblings->elements.size()); }
+
     int nb = 0;
     Element element = listBase.firstChild(m_tagName);
     while (!element.isNull()) {
@@ -120,6 +130,16 @@ int ListRef::indexOf(Element refBase, Element refElement) const
 
     if (listBase.isNull()) { return -1; }
 
+    std::unique_lock<std::mutex> indexLock(m_indexMutex, std::defer_lock);
+    SiblingIndex *siblings = (useSiblingIndex() && indexLock.try_lock()) ? siblingIndex(listBase) : nullptr;
+    if (siblings) {
+        int position = siblingPosition(siblings, m_subRef->getSource(refElement));
+        if (position >= 0 && m_subRef->getTarget(siblings->elements[static_cast<vSize>(position)]) == refElement) {
+            return position;
+        }
+        return -1;
+    }
+
     int index = 0;
     Element element = listBase.firstChild(m_tagName);
     while (!element.isNull()) {
@@ -143,6 +163,15 @@ Element ListRef::at(Element refBase, int index) const
 
     if (listBase.isNull()) { return Element(); }
 
+    std::unique_lock<std::mutex> indexLock(m_indexMutex, std::defer_lock);
+    SiblingIndex *siblings = (useSiblingIndex() && indexLock.try_lock()) ? siblingIndex(listBase) : nullptr;
+    if (siblings) {
+        // A negative index returns the first element like the sibling iteration below
+        vSize position = static_cast<vSize>((index > 0) ? index : 0);
+        if (position >= siblings->elements.size()) { return Element(); }
+        return m_subRef->getTarget(siblings->elements[position], true);
+    }
+
     int nb = 0;
     Element element = listBase.firstChild(m_tagName);
     while (!element.isNull() && nb < index) {
@@ -163,6 +192,16 @@ std::vector<Element> ListRef::list(Element refBase) const
     if (listBase.isNull()) { return std::vector<Element>(); }
 
     std::vector<Element> eList;
+    std::unique_lock<std::mutex> indexLock(m_indexMutex, std::defer_lock);
+    SiblingIndex *siblings = (useSiblingIndex() && indexLock.try_lock()) ? siblingIndex(listBase) : nullptr;
+    if (siblings) {
+        eList.reserve(siblings->elements.size());
+        for (const Element &element: siblings->elements) {
+            eList.push_back(m_subRef->getTarget(element, true));
+        }
+        return eList;
+    }
+
     Element element = listBase.firstChild(m_tagName);
     while (!element.isNull()) {
         eList.push_back(m_subRef->getTarget(element, true));
@@ -229,11 +268,20 @@ Element ListRef::insert(Element refBase, int index) const
 
     if (listBase.isNull()) { return Element(); }
 
-    int nb = 1;
-    Element refElement = listBase.firstChild(m_tagName);
-    while (!refElement.isNull() && nb < index) {
-        nb++;
-        refElement = refElement.nextSibling(m_tagName);
+    Element refElement;
+    SiblingIndex *siblings = siblingIndex(listBase);
+    if (siblings) {
+        vSize position = static_cast<vSize>((index > 1) ? index - 1 : 0);
+        if (position < siblings->elements.size()) {
+            refElement = siblings->elements[position];
+        }
+    } else {
+        int nb = 1;
+        refElement = listBase.firstChild(m_tagName);
+        while (!refElement.isNull() && nb < index) {
+            nb++;
+            refElement = refElement.nextSibling(m_tagName);
+        }
     }
 
     if (refElement.isNull()) {
@@ -242,19 +290,21 @@ Element ListRef::insert(Element refBase, int index) const
             return Element();
         }
         // No elements already exists so the new element is appended
-        refElement = listBase.appendChild(m_tagName);
+        refElement = listBase.appendChild(m_tagName.str());
     } else {
         if (index == 0) {
             // The new element has to be inserted before existing elements
             // so insert before has to be used
-            refElement = listBase.insertBefore(m_tagName, refElement);
+            refElement = listBase.insertBefore(m_tagName.str(), refElement);
         } else {
             // The new element is inserted after the
-            refElement = listBase.insertAfter(m_tagName, refElement);
+            refElement = listBase.insertAfter(m_tagName.str(), refElement);
         }
     }
 
-    return m_subRef->getTarget(refElement, true);
+    Element target = m_subRef->getTarget(refElement, true);
+    siblingInserted(listBase, siblings, refElement);
+    return target;
 }
 
 // =============================================================================
@@ -267,20 +317,24 @@ Element ListRef::insertBefore(Element refBase, Element refElement) const
 
     if (listBase.isNull()) { return Element(); }
 
+    SiblingIndex *siblings = siblingIndex(listBase);
+
     Element element;
     if (listBase == refElement.parentElement()) {
-        element = listBase.insertBefore(m_tagName, refElement);
+        element = listBase.insertBefore(m_tagName.str(), refElement);
     } else {
         refElement = m_subRef->getSource(refElement);
 
         if (refElement.isNull()) { return Element(); }
 
         if (listBase == refElement.parentElement()) {
-            element = listBase.insertBefore(m_tagName, refElement);
+            element = listBase.insertBefore(m_tagName.str(), refElement);
         } else { return Element(); }
     }
 
-    return m_subRef->getTarget(element, true);
+    Element target = m_subRef->getTarget(element, true);
+    siblingInserted(listBase, siblings, element);
+    return target;
 }
 
 // =============================================================================
@@ -293,20 +347,24 @@ Element ListRef::insertAfter(Element refBase, Element refElement) const
 
     if (listBase.isNull()) { return Element(); }
 
+    SiblingIndex *siblings = siblingIndex(listBase);
+
     Element element;
     if (listBase == refElement.parentElement()) {
-        element = listBase.insertAfter(m_tagName, refElement);
+        element = listBase.insertAfter(m_tagName.str(), refElement);
     } else {
         refElement = m_subRef->getSource(refElement);
 
         if (refElement.isNull()) { return Element(); }
 
         if (listBase == refElement.parentElement()) {
-            element = listBase.insertAfter(m_tagName, refElement);
+            element = listBase.insertAfter(m_tagName.str(), refElement);
         } else { return Element(); }
     }
 
-    return m_subRef->getTarget(element, true);
+    Element target = m_subRef->getTarget(element, true);
+    siblingInserted(listBase, siblings, element);
+    return target;
 }
 
 // =============================================================================
@@ -315,7 +373,10 @@ Element ListRef::clone(Element refBase, int index, Element cloneElement) const
 {
     Element newElement = insert(refBase, index);
     if (!newElement.isNull()) {
+        // Cloning only changes the content of the new element, so the sibling index is still valid
+        unsigned long long generation = newElement.generation();
         newElement.cloneElement(cloneElement);
+        siblingsKept(newElement, generation);
     }
     return newElement;
 }
@@ -326,7 +387,10 @@ Element ListRef::cloneBefore(Element refBase, Element refElement, Element cloneE
 {
     Element newElement = insertBefore(refBase, refElement);
     if (!newElement.isNull()) {
+        // Cloning only changes the content of the new element, so the sibling index is still valid
+        unsigned long long generation = newElement.generation();
         newElement.cloneElement(cloneElement);
+        siblingsKept(newElement, generation);
     }
     return newElement;
 }
@@ -337,7 +401,10 @@ Element ListRef::cloneAfter(Element refBase, Element refElement, Element cloneEl
 {
     Element newElement = insertAfter(refBase, refElement);
     if (!newElement.isNull()) {
+        // Cloning only changes the content of the new element, so the sibling index is still valid
+        unsigned long long generation = newElement.generation();
         newElement.cloneElement(cloneElement);
+        siblingsKept(newElement, generation);
     }
     return newElement;
 }
@@ -354,9 +421,13 @@ Element ListRef::move(Element refBase, int index, Element moveElement) const
 
     Element tempElement = insert(refBase, index);
     if (!tempElement.isNull()) {
+        unsigned long long generation = tempElement.generation();
         Element parent = tempElement.parentElement();
+        // The element is relinked after the placeholder, so it keeps its identity
         Element newElement = parent.moveAfter(moveElement, tempElement);
         parent.removeChild(tempElement);
+        if (newElement.isNull()) { return Element(); }
+        siblingMoved(m_listBaseRef->getTarget(refBase), moveIndex, tempElement, newElement, generation);
         return newElement;
     }
     return Element();
@@ -366,11 +437,17 @@ Element ListRef::move(Element refBase, int index, Element moveElement) const
 // (public)
 Element ListRef::moveBefore(Element refBase, Element refElement, Element moveElement) const
 {
+    int moveIndex = (m_indexEnabled) ? indexOf(refBase, moveElement) : -1;
+
     Element tempElement = insertBefore(refBase, refElement);
     if (!tempElement.isNull()) {
+        unsigned long long generation = tempElement.generation();
         Element parent = tempElement.parentElement();
+        // The element is relinked after the placeholder, so it keeps its identity
         Element newElement = parent.moveAfter(moveElement, tempElement);
         parent.removeChild(tempElement);
+        if (newElement.isNull()) { return Element(); }
+        siblingMoved(m_listBaseRef->getTarget(refBase), moveIndex, tempElement, newElement, generation);
         return newElement;
     }
     return Element();
@@ -380,11 +457,17 @@ Element ListRef::moveBefore(Element refBase, Element refElement, Element moveEle
 // (public)
 Element ListRef::moveAfter(Element refBase, Element refElement, Element moveElement) const
 {
+    int moveIndex = (m_indexEnabled) ? indexOf(refBase, moveElement) : -1;
+
     Element tempElement = insertAfter(refBase, refElement);
     if (!tempElement.isNull()) {
+        unsigned long long generation = tempElement.generation();
         Element parent = tempElement.parentElement();
+        // The element is relinked after the placeholder, so it keeps its identity
         Element newElement = parent.moveAfter(moveElement, tempElement);
         parent.removeChild(tempElement);
+        if (newElement.isNull()) { return Element(); }
+        siblingMoved(m_listBaseRef->getTarget(refBase), moveIndex, tempElement, newElement, generation);
         return newElement;
     }
     return Element();
@@ -400,19 +483,21 @@ bool ListRef::remove(Element refBase, Element refElement) const
 
     if (listBase.isNull()) { return false; }
 
-    if (listBase == refElement.parentElement()) {
-        return listBase.removeChild(refElement);
-    } else {
+    if (listBase != refElement.parentElement()) {
         refElement = m_subRef->getSource(refElement);
 
         if (refElement.isNull()) { return false; }
 
-        if (listBase == refElement.parentElement()) {
-            return listBase.removeChild(refElement);
-        }
+        if (listBase != refElement.parentElement()) { return false; }
     }
 
-    return false;
+    SiblingIndex *siblings = siblingIndex(listBase);
+    int position = (siblings) ? siblingPosition(siblings, refElement) : -1;
+
+    if (!listBase.removeChild(refElement)) { return false; }
+
+    siblingRemoved(listBase, siblings, position);
+    return true;
 }
 
 // =============================================================================
@@ -425,6 +510,15 @@ bool ListRef::remove(Element refBase, int index) const
 
     if (listBase.isNull()) { return false; }
 
+    SiblingIndex *siblings = siblingIndex(listBase);
+    if (siblings) {
+        int position = (index > 0) ? index : 0;
+        if (position >= static_cast<int>(siblings->elements.size())) { return false; }
+        if (!listBase.removeChild(siblings->elements[static_cast<vSize>(position)])) { return false; }
+        siblingRemoved(listBase, siblings, position);
+        return true;
+    }
+
     int nb = 0;
     Element refElement = listBase.firstChild(m_tagName);
     while (!refElement.isNull() && nb < index) {
@@ -446,7 +540,7 @@ Element ListRef::invertedAt(Element refElement) const
     refElement = m_subRef->getSource(refElement);
 
     if (refElement.isNull()) { return Element(); }
-    if (refElement.compareTagName(m_tagName) != 0) { return Element(); }
+    if (!refElement.hasTagName(m_tagName)) { return Element(); }
 
     return m_listBaseRef->getSource(refElement.parentElement());
 }
@@ -463,7 +557,7 @@ void ListRef::setListBaseRef(RefUPtr value)
 void ListRef::setTagName(const std::string &value)
 {
     ASSERT(!value.empty());
-    m_tagName = value;
+    m_tagName = NameId(value);
 }
 
 // =============================================================================
@@ -471,6 +565,179 @@ void ListRef::setTagName(const std::string &value)
 void ListRef::setSubRef(ChildRefGroupUPtr value)
 {
     m_subRef = std::move(value);
+    m_indexMap.clear();
+}
+
+// =============================================================================
+// (public)
+void ListRef::setIndexEnabled(bool value)
+{
+    m_indexEnabled = value;
+    m_indexMap.clear();
+}
+
+// =============================================================================
+// (protected)
+// Returns the sibling index of the list base element or nullptr if the index is disabled
+ListRef::SiblingIndex *ListRef::siblingIndex(Element listBase) const
+{
+    if (!m_indexEnabled || listBase.isNull() || s_sharedReadDepth > 0) { return nullptr; }
+
+    pugi::xml_node_struct *key = listBase.internalObject().internal_object();
+    pugi::xml_node_struct *document = listBase.internalObject().root().internal_object();
+    unsigned long long generation = listBase.generation();
+    auto it = m_indexMap.find(key);
+    if (it != m_indexMap.end()) {
+        if (it->second.generation == generation) { return &it->second; }
+
+        // Elements have been added to or removed from the document since the sibling
+        //  indexes were build. The indexes of other documents are still valid
+        for (it = m_indexMap.begin(); it != m_indexMap.end();) {
+            if (it->second.document == document) {
+                it = m_indexMap.erase(it);
+            } else {
+                it++;
+            }
+        }
+    }
+
+    SiblingIndex &siblings = m_indexMap[key];
+    siblings.document = document;
+    siblings.generation = generation;
+    Element element = listBase.firstChild(m_tagName);
+    while (!element.isNull()) {
+        siblings.elements.push_back(element);
+        element = element.nextSibling(m_tagName);
+    }
+    return &siblings;
+}
+
+// =============================================================================
+// (protected)
+int ListRef::siblingPosition(SiblingIndex *siblings, Element element) const
+{
+    if (!siblings->positionsValid) {
+        siblings->positions.clear();
+        siblings->positions.reserve(siblings->elements.size());
+        int position = 0;
+        for (const Element &sibling: siblings->elements) {
+            siblings->positions[sibling.internalObject().internal_object()] = position++;
+        }
+        siblings->positionsValid = true;
+    }
+
+    auto it = siblings->positions.find(element.internalObject().internal_object());
+    return (it == siblings->positions.end()) ? -1 : it->second;
+}
+
+// =============================================================================
+// (protected)
+// Adds a new element to the sibling index after it is inserted into the list base
+void ListRef::siblingInserted(Element listBase, SiblingIndex *siblings, Element element) const
+{
+    if (siblings == nullptr || element.isNull()) { return; }
+
+    unsigned long long generation = siblings->generation;
+    int position = 0;
+    Element previous = element.previousSibling(m_tagName);
+    if (!previous.isNull()) {
+        position = siblingPosition(siblings, previous);
+        if (position < 0) {
+            m_indexMap.erase(listBase.internalObject().internal_object());
+            return;
+        }
+        position++;
+    }
+
+    if (position == static_cast<int>(siblings->elements.size())) {
+        siblings->elements.push_back(element);
+        if (siblings->positionsValid) {
+            siblings->positions[element.internalObject().internal_object()] = position;
+        }
+    } else {
+        siblings->elements.insert(siblings->elements.begin() + position, element);
+        siblings->positionsValid = false;
+    }
+
+    // Other list bases are not changed by inserting an element
+    siblingsKept(listBase, generation);
+}
+
+// =============================================================================
+// (protected)
+// Removes the element at 'position' from the sibling index after it is removed from the list base
+void ListRef::siblingRemoved(Element listBase, SiblingIndex *siblings, int position) const
+{
+    // The sibling indexes are discarded if the removed element is unknown
+    if (siblings == nullptr || position < 0) { return; }
+
+    siblings->elements.erase(siblings->elements.begin() + position);
+    siblings->positionsValid = false;
+
+    keepSiblingIndex(listBase);
+}
+
+// =============================================================================
+// (protected)
+// The moved element is copied into the list right after the temporary element, which
+// is then removed. The new element therefore takes the position of the temporary element
+void ListRef::siblingMoved(Element listBase, int oldPosition, Element tempElement, Element newElement, unsigned long long generation) const
+{
+    if (listBase.isNull()) { return; }
+
+    // Only an index that was valid before the move can be updated
+    auto it = m_indexMap.find(listBase.internalObject().internal_object());
+    if (it == m_indexMap.end() || it->second.generation != generation) { return; }
+
+    SiblingIndex *siblings = &it->second;
+    int tempPosition = siblingPosition(siblings, m_subRef->getSource(tempElement));
+    if (tempPosition < 0) { return; }
+
+    siblings->elements[static_cast<vSize>(tempPosition)] = m_subRef->getSource(newElement);
+    if (oldPosition >= 0) {
+        if (oldPosition >= tempPosition) { oldPosition++; }
+        siblings->elements.erase(siblings->elements.begin() + oldPosition);
+    }
+    siblings->positionsValid = false;
+
+    keepSiblingIndex(listBase);
+}
+
+// =============================================================================
+// (protected)
+// The sibling indexes of the document of 'element' that were valid at 'generation'
+//  are still valid after a change that did not add or remove list elements
+void ListRef::siblingsKept(Element element, unsigned long long generation) const
+{
+    if (!m_indexEnabled || element.isNull()) { return; }
+
+    pugi::xml_node_struct *document = element.internalObject().root().internal_object();
+    unsigned long long newGeneration = element.generation();
+    for (auto &it: m_indexMap) {
+        if (it.second.document == document && it.second.generation == generation) {
+            it.second.generation = newGeneration;
+        }
+    }
+}
+
+// =============================================================================
+// (protected)
+// List bases inside a removed element are deleted with it, so only the sibling
+// index of 'listBase' is kept in its document after elements are removed
+void ListRef::keepSiblingIndex(Element listBase) const
+{
+    pugi::xml_node_struct *key = listBase.internalObject().internal_object();
+    pugi::xml_node_struct *document = listBase.internalObject().root().internal_object();
+    for (auto it = m_indexMap.begin(); it != m_indexMap.end();) {
+        if (it->first == key) {
+            it->second.generation = listBase.generation();
+            it++;
+        } else if (it->second.document == document) {
+            it = m_indexMap.erase(it);
+        } else {
+            it++;
+        }
+    }
 }
 
 } // namespace Oak::XML
@@ -22,8 +22,11 @@
 
 #include <vector>
 #include <memory>
+#include <mutex>
+#include <unordered_map>
 
 #include "XMLChildRefGroup.h"
+#include "XMLNameId.h"
 
 namespace Oak::XML {
 
@@ -77,26 +80,75 @@ public:
     virtual Element invertedAt(Element refElement) const;
 
     const Ref& listBaseRef() const { return *m_listBaseRef.get(); }
-    const std::string& tagName() const { return m_tagName; }
+    const std::string& tagName() const { return m_tagName.str(); }
+    const NameId& tagNameId() const { return m_tagName; }
     const ChildRefGroup& subRef() const { return *m_subRef.get(); }
 
     void setListBaseRef(RefUPtr value);
     void setTagName(const std::string& value);
     void setSubRef(ChildRefGroupUPtr value);
 
+    // The sibling index caches the list elements of each list base element, so count(), at()
+    // and indexOf() does not have to iterate the siblings. It is updated when elements are
+    // inserted, cloned, moved or removed through the list reference and discarded when
+    // the document of the list base is changed by others (see Element::generation())
+    bool indexEnabled() const { return m_indexEnabled; }
+    void setIndexEnabled(bool value);
+
+    // Reading threads take turns using the sibling index; a reader that finds it in use
+    //  iterates the siblings instead of waiting. Changing the list must not happen while
+    //  others read it. A thread that splits up a large read with other threads does it
+    //  while a SharedRead exists, which makes it bypass the sibling indexes entirely
+    class SharedRead
+    {
+    public:
+        SharedRead() { s_sharedReadDepth++; }
+        ~SharedRead() { s_sharedReadDepth--; }
+
+        SharedRead(const SharedRead &copy) = delete;
+        SharedRead& operator=(const SharedRead &copy) = delete;
+    };
+
     template<class... _Types> inline
     static ListRefUPtr MakeUPtr(_Types&&... _Args)
     {
         return (ListRefUPtr(new ListRef(_STD forward<_Types>(_Args)...)));
     }
 
+protected:
+    struct SiblingIndex
+    {
+        std::vector<Element> elements;
+        std::unordered_map<pugi::xml_node_struct*, int> positions;
+        bool positionsValid = false;
+        // The document of the list base and its generation when the index was valid
+        pugi::xml_node_struct *document = nullptr;
+        unsigned long long generation = 0;
+    };
+
+    // Lists without a sibling index, and shared reads, never touch the index mutex
+    bool useSiblingIndex() const { return m_indexEnabled && s_sharedReadDepth == 0; }
+    SiblingIndex *siblingIndex(Element listBase) const;
+    int siblingPosition(SiblingIndex *siblings, Element element) const;
+    void siblingInserted(Element listBase, SiblingIndex *siblings, Element element) const;
+    void siblingRemoved(Element listBase, SiblingIndex *siblings, int position) const;
+    void siblingMoved(Element listBase, int oldPosition, Element tempElement, Element newElement, unsigned long long generation) const;
+    void siblingsKept(Element element, unsigned long long generation) const;
+    void keepSiblingIndex(Element listBase) const;
+
 protected:
     // The number of elements in a element reference list is the number of elements
     // with element tag name in in the list base ref element.
     // The ref element in each element can be a sub ref of the element
     RefUPtr m_listBaseRef;
-    std::string m_tagName;
+    NameId m_tagName;
     ChildRefGroupUPtr m_subRef;
+
+    bool m_indexEnabled = false;
+    mutable std::unordered_map<pugi::xml_node_struct*, SiblingIndex> m_indexMap;
+    mutable std::mutex m_indexMutex;
+
+    static thread_local int s_sharedReadDepth;
 };
 
 } // namespace Oak::XML
@@ -0,0 +1,80 @@
+/*
+ * OakModelView (http://oakmodelview.com/)
+ * Author: Mikkel Nøhr Løvgreen (mikkel@oakmodelview.com)
+ * ------------------------------------------------------------------------
+ * Licensed to Vilaversoftware IVS who licenses this file to you under the
+ * Apache License, Version 2.0 (the "License"); you may not use this file
+ * except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifdef XML_BACKEND
+
+#include "XMLNameId.h"
+
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <unordered_map>
+
+namespace Oak::XML {
+
+// =============================================================================
+//
+NameId::NameId()
+    : m_entry(emptyEntry())
+{
+}
+
+// =============================================================================
+//
+NameId::NameId(const std::string &name)
+    : m_entry(intern(name.c_str(), name.size()))
+{
+}
+
+// =============================================================================
+//
+NameId::NameId(const char *name)
+    : m_entry(intern(name ? name : "", name ? std::strlen(name) : 0))
+{
+}
+
+// =============================================================================
+//
+const NameId::Entry *NameId::emptyEntry()
+{
+    static const Entry s_emptyEntry { std::string(), 0 };
+    return &s_emptyEntry;
+}
+
+// =============================================================================
+//
+const NameId::Entry *NameId::intern(const char *name, size_t length)
+{
+    if (length == 0) { return emptyEntry(); }
+
+    static std::unordered_map<std::string_view, std::unique_ptr<Entry>> s_entryMap;
+    static std::mutex s_mutex;
+
+    std::lock_guard<std::mutex> lock(s_mutex);
+    auto it = s_entryMap.find(std::string_view(name, length));
+    if (it != s_entryMap.end()) { return it->second.get(); }
+
+    std::unique_ptr<Entry> entry(new Entry { std::string(name, length), length });
+    const Entry *entryPtr = entry.get();
+    s_entryMap.emplace(std::string_view(entryPtr->name), std::move(entry));
+    return entryPtr;
+}
+
+} // namespace Oak::XML
+
+#endif // XML_BACKEND
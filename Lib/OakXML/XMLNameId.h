@@ -0,0 +1,83 @@
+/*
+ * OakModelView (http://oakmodelview.com/)
+ * Author: Mikkel Nøhr Løvgreen (mikkel@oakmodelview.com)
+ * ------------------------------------------------------------------------
+ * Licensed to Vilaversoftware IVS who licenses this file to you under the
+ * Apache License, Version 2.0 (the "License"); you may not use this file
+ * except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#ifdef XML_BACKEND
+
+#include <cstring>
+#include <string>
+
+namespace Oak::XML {
+
+// =============================================================================
+// Class definition
+// =============================================================================
+// An interned tag or attribute name. Names are interned once when a definition
+//  is built. Two ids are compared by pointer and an id is compared to a name in
+//  the document by its first character and known length, so no strings are
+//  created when elements are searched. The empty id matches any name.
+class NameId
+{
+public:
+    NameId();
+    explicit NameId(const std::string &name);
+    explicit NameId(const char *name);
+
+    bool operator==(const NameId &nameId) const { return m_entry == nameId.m_entry; }
+    bool operator!=(const NameId &nameId) const { return m_entry != nameId.m_entry; }
+
+    bool isEmpty() const { return m_entry->length == 0; }
+
+    const std::string &str() const { return m_entry->name; }
+    const char *c_str() const { return m_entry->name.c_str(); }
+    size_t length() const { return m_entry->length; }
+
+    // Returns true if 'name' is equal to the interned name. The length of
+    //  'name' is not known, so the first character is compared before the
+    //  rest and the terminator are compared in one pass
+    bool isEqual(const char *name) const
+    {
+        const char *str = m_entry->name.c_str();
+        return *name == *str &&
+               (m_entry->length == 0 || std::strncmp(name + 1, str + 1, m_entry->length) == 0);
+    }
+
+    // Returns true if the id is empty or 'name' is equal to the interned name
+    bool matches(const char *name) const
+    {
+        return m_entry->length == 0 || isEqual(name);
+    }
+
+protected:
+    struct Entry
+    {
+        std::string name;
+        size_t length;
+    };
+
+    // The entry of the empty id is not interned, so default ids are created without locking
+    static const Entry *emptyEntry();
+    static const Entry *intern(const char *name, size_t length);
+
+    const Entry *m_entry;
+};
+
+} // namespace Oak::XML
+
+#endif // XML_BACKEND
@@ -25,7 +25,7 @@ namespace Oak::XML {
 // =============================================================================
 // (public)
 ValueRef::ValueRef(std::string attName, RefUPtr elRef)
-    : m_attributeName(attName)
+    : m_attributeName(NameId(attName))
 {
     if (elRef) {
         m_elementRef = std::move(elRef);
@@ -62,7 +62,7 @@ ValueRef& ValueRef::operator=(const ValueRef &copy)
 ValueRef& ValueRef::operator=(ValueRef &&move)
 {
     m_elementRef = std::move(move.m_elementRef);
-    m_attributeName = std::move(move.m_attributeName);
+    m_attributeName = move.m_attributeName;
     return *this;
 }
 
@@ -80,7 +80,7 @@ bool ValueRef::hasValue(Element baseElement)
     baseElement = m_elementRef->getTarget(baseElement);
     if (baseElement.isNull()) { return false; }
 
-    if (m_attributeName.empty()) {
+    if (m_attributeName.isEmpty()) {
         return baseElement.hasText();
     } else {
         return baseElement.hasAttribute(m_attributeName);
@@ -94,7 +94,7 @@ int ValueRef::compareValue(Element baseElement, const std::string& value) const
     baseElement = m_elementRef->getTarget(baseElement);
     if (baseElement.isNull()) { return -2; }
 
-    if (m_attributeName.empty()) {
+    if (m_attributeName.isEmpty()) {
         return baseElement.compareText(value);
     } else {
         return baseElement.compareAttribute(m_attributeName, value);
@@ -111,7 +111,7 @@ void ValueRef::getValue(Element baseElement, std::string &value) const
         return;
     }
 
-    if (m_attributeName.empty()) {
+    if (m_attributeName.isEmpty()) {
         baseElement.getText(value);
     } else {
         baseElement.getAttribute(m_attributeName, value);
@@ -122,17 +122,39 @@ void ValueRef::getValue(Element baseElement, std::string &value) const
 // (public)
 bool ValueRef::setValue(Element baseElement, const std::string& value) const
 {
-    if (value.empty()) {
+    return setValue(baseElement, value.c_str());
+}
+
+// =============================================================================
+// (public)
+const char *ValueRef::valueCString(Element baseElement) const
+{
+    baseElement = m_elementRef->getTarget(baseElement);
+    if (baseElement.isNull()) { return nullptr; }
+
+    if (m_attributeName.isEmpty()) {
+        const char *text = baseElement.textCString();
+        return (*text == '\0') ? nullptr : text;
+    } else {
+        return baseElement.attributeCString(m_attributeName);
+    }
+}
+
+// =============================================================================
+// (public)
+bool ValueRef::setValue(Element baseElement, const char *value) const
+{
+    if (value == nullptr || *value == '\0') {
         return clearValue(baseElement);
     }
 
     baseElement = m_elementRef->getTarget(baseElement, true);
     if (baseElement.isNull()) { return false; }
 
-    if (m_attributeName.empty()) {
+    if (m_attributeName.isEmpty()) {
         return baseElement.setText(value);
     } else {
-        return baseElement.setAttribute(m_attributeName, value);
+        return baseElement.setAttribute(m_attributeName.str(), value);
     }
 }
 
@@ -144,10 +166,10 @@ bool ValueRef::clearValue(Element baseElement) const
 
     bool result = false;
     if (!refElement.isNull()) {
-        if (m_attributeName.empty()) {
+        if (m_attributeName.isEmpty()) {
             result = refElement.removeText();
         } else {
-            result = refElement.removeAttribute(m_attributeName);
+            result = refElement.removeAttribute(m_attributeName.str());
         }
     }
     m_elementRef->clearTarget(baseElement);
@@ -158,7 +180,7 @@ bool ValueRef::clearValue(Element baseElement) const
 // (public)
 void ValueRef::setAttributeName(std::string attName)
 {
-    m_attributeName = attName;
+    m_attributeName = NameId(attName);
 }
 
 // =============================================================================
@@ -21,6 +21,7 @@
 #ifdef XML_BACKEND
 
 #include "XMLRef.h"
+#include "XMLNameId.h"
 #include <memory>
 
 namespace Oak::XML {
@@ -49,9 +50,13 @@ public:
     void getValue(Element baseElement, std::string& value) const;
     bool setValue(Element baseElement, const std::string& value) const;
 
+    // Returns the value stored in the document without copying it or nullptr if there is no value
+    const char *valueCString(Element baseElement) const;
+    bool setValue(Element baseElement, const char *value) const;
+
     bool clearValue(Element baseElement) const;
 
-    const std::string& attributeName() const { return m_attributeName; }
+    const std::string& attributeName() const { return m_attributeName.str(); }
     void setAttributeName(std::string attName);
 
     Ref* elementRef() const { return m_elementRef.get(); }
@@ -73,7 +78,7 @@ protected:
      * \brief Name of the attribute that contains the value.
      * If empty the value is stored as element text.
     */
-    std::string m_attributeName;
+    NameId m_attributeName;
 };
 
 } // namespace Oak::XML
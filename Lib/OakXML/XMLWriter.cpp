@@ -0,0 +1,228 @@
+/*
+ * OakModelView (http://oakmodelview.com/)
+ * Author: Mikkel Nøhr Løvgreen (mikkel@oakmodelview.com)
+ * ------------------------------------------------------------------------
+ * Licensed to Vilaversoftware IVS who licenses this file to you under the
+ * Apache License, Version 2.0 (the "License"); you may not use this file
+ * except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifdef XML_BACKEND
+
+#include "XMLWriter.h"
+
+#include "../ServiceFunctions/Assert.h"
+
+#include <cerrno>
+#include <cstdio>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace Oak::XML {
+
+// =============================================================================
+//
+StringWriter::StringWriter(std::string &str)
+    : m_str(str)
+{
+}
+
+// =============================================================================
+//
+void StringWriter::write(const void *data, size_t size)
+{
+    m_str.append(static_cast<const char*>(data), size);
+}
+
+// =============================================================================
+//
+FileDescriptorWriter::FileDescriptorWriter(int fd)
+    : m_fd(fd)
+{
+}
+
+// =============================================================================
+//
+void FileDescriptorWriter::write(const void *data, size_t size)
+{
+    if (m_failed) { return; }
+
+    const char *ptr = static_cast<const char*>(data);
+    while (size > 0) {
+#ifdef _WIN32
+        int count = _write(m_fd, ptr, static_cast<unsigned int>(size));
+#else
+        ssize_t count = ::write(m_fd, ptr, size);
+#endif
+        if (count < 0) {
+            if (errno == EINTR) { continue; }
+            m_failed = true;
+            return;
+        }
+        ptr += count;
+        size -= static_cast<size_t>(count);
+    }
+}
+
+// =============================================================================
+//
+FileWriter::FileWriter(const std::string &filePath)
+    : m_filePath(filePath),
+      m_tempFilePath(filePath + ".tmp")
+{
+    m_file = fopen(m_tempFilePath.c_str(), "wb");
+    m_failed = m_file == nullptr;
+}
+
+// =============================================================================
+//
+FileWriter::~FileWriter()
+{
+    if (m_file) {
+        fclose(m_file);
+        std::remove(m_tempFilePath.c_str());
+    }
+}
+
+// =============================================================================
+//
+void FileWriter::write(const void *data, size_t size)
+{
+    if (m_failed) { return; }
+    if (fwrite(data, 1, size, m_file) != size) {
+        m_failed = true;
+    }
+}
+
+// =============================================================================
+//
+bool FileWriter::finish()
+{
+    if (!m_file) { return !m_failed; }
+
+    if (fclose(m_file) != 0) {
+        m_failed = true;
+    }
+    m_file = nullptr;
+
+    // A mapped document keeps reading the old content after the file is replaced
+    if (!m_failed) {
+#ifdef _WIN32
+        if (!MoveFileExA(m_tempFilePath.c_str(), m_filePath.c_str(), MOVEFILE_REPLACE_EXISTING)) {
+#else
+        if (std::rename(m_tempFilePath.c_str(), m_filePath.c_str()) != 0) {
+#endif
+            m_failed = true;
+        }
+    }
+    if (m_failed) {
+        std::remove(m_tempFilePath.c_str());
+    }
+    return !m_failed;
+}
+
+#ifdef OAK_ZLIB
+
+// =============================================================================
+//
+GZipWriter::GZipWriter(Writer &sink, int level)
+    : m_sink(sink),
+      m_buffer(64 * 1024)
+{
+    m_stream.zalloc = Z_NULL;
+    m_stream.zfree = Z_NULL;
+    m_stream.opaque = Z_NULL;
+    // 15 + 16 selects the largest window and writes a gzip header instead of a zlib header
+    if (deflateInit2(&m_stream, level, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+        m_failed = true;
+        m_finished = true;
+    }
+}
+
+// =============================================================================
+//
+GZipWriter::~GZipWriter()
+{
+    if (!m_finished) {
+        deflateEnd(&m_stream);
+    }
+}
+
+// =============================================================================
+//
+void GZipWriter::write(const void *data, size_t size)
+{
+    if (m_failed || m_finished) { return; }
+
+    // zlib does not change the input, the cast is needed by older versions of zlib
+    m_stream.next_in = static_cast<Bytef*>(const_cast<void*>(data));
+    while (size > 0) {
+        uInt chunkSize = size > 0x40000000 ? 0x40000000 : static_cast<uInt>(size);
+        m_stream.avail_in = chunkSize;
+        if (!deflateData(Z_NO_FLUSH)) { return; }
+        size -= chunkSize;
+    }
+}
+
+// =============================================================================
+//
+bool GZipWriter::finish()
+{
+    if (!m_finished) {
+        m_stream.next_in = Z_NULL;
+        m_stream.avail_in = 0;
+        deflateData(Z_FINISH);
+        deflateEnd(&m_stream);
+        m_finished = true;
+    }
+    bool sinkResult = m_sink.finish();
+    return !m_failed && sinkResult;
+}
+
+// =============================================================================
+//
+bool GZipWriter::deflateData(int flush)
+{
+    int result;
+    do {
+        m_stream.next_out = m_buffer.data();
+        m_stream.avail_out = static_cast<uInt>(m_buffer.size());
+        result = deflate(&m_stream, flush);
+        if (result == Z_STREAM_ERROR) {
+            m_failed = true;
+            return false;
+        }
+        size_t count = m_buffer.size() - m_stream.avail_out;
+        if (count > 0) {
+            m_sink.write(m_buffer.data(), count);
+            if (m_sink.failed()) {
+                m_failed = true;
+                return false;
+            }
+        }
+    } while (m_stream.avail_out == 0 || (flush == Z_FINISH && result != Z_STREAM_END));
+    return true;
+}
+
+#endif // OAK_ZLIB
+
+} // namespace Oak::XML
+
+#endif // XML_BACKEND
@@ -0,0 +1,141 @@
+/*
+ * OakModelView (http://oakmodelview.com/)
+ * Author: Mikkel Nøhr Løvgreen (mikkel@oakmodelview.com)
+ * ------------------------------------------------------------------------
+ * Licensed to Vilaversoftware IVS who licenses this file to you under the
+ * Apache License, Version 2.0 (the "License"); you may not use this file
+ * except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#ifdef XML_BACKEND
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "pugixml/pugixml.hpp"
+
+#ifdef OAK_ZLIB
+#include <zlib.h>
+#endif // OAK_ZLIB
+
+namespace Oak::XML {
+
+// Indented is the format used when saving to files
+// Compact writes no indentation or line breaks
+enum class SaveFormat { Indented, Compact };
+
+// =============================================================================
+// Class definition
+// =============================================================================
+// Sink for the streaming save of a document or an element.
+//  pugixml calls write() with small chunks, so the serialized data is never
+//  kept in memory as a whole unless the sink does it.
+class Writer : public pugi::xml_writer
+{
+public:
+    Writer() {}
+    virtual ~Writer() {}
+
+    // Flushes the data that is buffered by the writer.
+    //  Returns false if any of the writes failed
+    virtual bool finish() { return !m_failed; }
+
+    bool failed() const { return m_failed; }
+
+protected:
+    bool m_failed = false;
+};
+
+// =============================================================================
+// Class definition
+// =============================================================================
+class StringWriter : public Writer
+{
+public:
+    StringWriter(std::string &str);
+
+    virtual void write(const void* data, size_t size) override;
+
+protected:
+    std::string &m_str;
+};
+
+// =============================================================================
+// Class definition
+// =============================================================================
+// Writes to an open file descriptor. The file descriptor is not closed
+class FileDescriptorWriter : public Writer
+{
+public:
+    FileDescriptorWriter(int fd);
+
+    virtual void write(const void* data, size_t size) override;
+
+protected:
+    int m_fd;
+};
+
+// =============================================================================
+// Class definition
+// =============================================================================
+// Writes to a temporary file next to 'filePath' that replaces the file in finish().
+//  The file is never truncated, so it can be the file a mapped document reads from.
+//  The temporary file is removed if the save fails or finish() is not called
+class FileWriter : public Writer
+{
+public:
+    FileWriter(const std::string &filePath);
+    virtual ~FileWriter() override;
+
+    bool isOpen() const { return m_file != nullptr; }
+
+    virtual void write(const void* data, size_t size) override;
+    virtual bool finish() override;
+
+protected:
+    std::string m_filePath;
+    std::string m_tempFilePath;
+    FILE *m_file;
+};
+
+#ifdef OAK_ZLIB
+// =============================================================================
+// Class definition
+// =============================================================================
+// Compresses the data with gzip before it is passed on to 'sink'
+class GZipWriter : public Writer
+{
+public:
+    GZipWriter(Writer &sink, int level = Z_DEFAULT_COMPRESSION);
+    virtual ~GZipWriter() override;
+
+    virtual void write(const void* data, size_t size) override;
+    // Writes the gzip trailer and finishes the sink
+    virtual bool finish() override;
+
+protected:
+    bool deflateData(int flush);
+
+protected:
+    Writer &m_sink;
+    z_stream m_stream;
+    std::vector<unsigned char> m_buffer;
+    bool m_finished = false;
+};
+#endif // OAK_ZLIB
+
+} // namespace Oak::XML
+
+#endif // XML_BACKEND
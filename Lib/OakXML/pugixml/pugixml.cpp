@@ -529,13 +529,19 @@ PUGI__NS_BEGIN
 
 	struct xml_document_struct: public xml_node_struct, public xml_allocator
 	{
-		xml_document_struct(xml_memory_page* page): xml_node_struct(page, node_document), xml_allocator(page), buffer(0), extra_buffers(0)
+		xml_document_struct(xml_memory_page* page): xml_node_struct(page, node_document), xml_allocator(page), buffer(0), extra_buffers(0), nodes_moved(false), generation(0)
 		{
 		}
 
 		const char_t* buffer;
 
 		xml_extra_buffer* extra_buffers;
+
+		// Set when nodes are moved, as the buffer order no longer is the document order
+		bool nodes_moved;
+
+		// Changed by Oak::XML::Element when nodes are added to or removed from the document
+		unsigned long long generation;
 	};
 
 	inline xml_allocator& get_allocator(const xml_node_struct* node)
@@ -3356,6 +3362,120 @@ PUGI__NS_BEGIN
 		return true;
 	}
 
+	inline xml_document_struct& get_document(const xml_node_struct* node)
+	{
+		return static_cast<xml_document_struct&>(get_allocator(node));
+	}
+
+	inline bool allow_move(const xml_node& parent, const xml_node& child)
+	{
+		// check that child can be a child of parent
+		if (!allow_insert_child(parent.type(), child.type())) return false;
+
+		// check that node is not moved between documents
+		if (parent.root() != child.root()) return false;
+
+		// check that new parent is not in the child subtree
+		xml_node cur = parent;
+
+		while (cur)
+		{
+			if (cur == child) return false;
+
+			cur = cur.parent();
+		}
+
+		return true;
+	}
+
+	inline void unlink_node(xml_node_struct* node)
+	{
+		xml_node_struct* parent = node->parent;
+
+		if (node->next_sibling) node->next_sibling->prev_sibling_c = node->prev_sibling_c;
+		else parent->first_child->prev_sibling_c = node->prev_sibling_c;
+
+		if (node->prev_sibling_c->next_sibling) node->prev_sibling_c->next_sibling = node->next_sibling;
+		else parent->first_child = node->next_sibling;
+
+		node->parent = 0;
+		node->prev_sibling_c = 0;
+		node->next_sibling = 0;
+	}
+
+	inline void link_node_before(xml_node_struct* child, xml_node_struct* node)
+	{
+		xml_node_struct* parent = node->parent;
+
+		child->parent = parent;
+
+		if (node->prev_sibling_c->next_sibling)
+			node->prev_sibling_c->next_sibling = child;
+		else
+			parent->first_child = child;
+
+		child->prev_sibling_c = node->prev_sibling_c;
+		child->next_sibling = node;
+		node->prev_sibling_c = child;
+	}
+
+	inline void link_node_after(xml_node_struct* child, xml_node_struct* node)
+	{
+		xml_node_struct* parent = node->parent;
+
+		child->parent = parent;
+
+		if (node->next_sibling)
+			node->next_sibling->prev_sibling_c = child;
+		else
+			parent->first_child->prev_sibling_c = child;
+
+		child->next_sibling = node->next_sibling;
+		child->prev_sibling_c = node;
+		node->next_sibling = child;
+	}
+
+	inline void link_node_first(xml_node_struct* child, xml_node_struct* parent)
+	{
+		child->parent = parent;
+
+		xml_node_struct* head = parent->first_child;
+
+		if (head)
+		{
+			child->prev_sibling_c = head->prev_sibling_c;
+			head->prev_sibling_c = child;
+		}
+		else
+			child->prev_sibling_c = child;
+
+		child->next_sibling = head;
+		parent->first_child = child;
+	}
+
+	inline void link_node_last(xml_node_struct* child, xml_node_struct* parent)
+	{
+		child->parent = parent;
+
+		xml_node_struct* head = parent->first_child;
+
+		if (head)
+		{
+			xml_node_struct* tail = head->prev_sibling_c;
+
+			tail->next_sibling = child;
+			child->prev_sibling_c = tail;
+			head->prev_sibling_c = child;
+		}
+		else
+		{
+			parent->first_child = child;
+			child->prev_sibling_c = child;
+		}
+
+		child->next_sibling = 0;
+	}
+
 	PUGI__FN void recursive_copy_skip(xml_node& dest, const xml_node& source, const xml_node& skip)
 	{
 		assert(dest.type() == source.type());
@@ -4779,6 +4899,58 @@ namespace pugi
 		return result;
 	}
 
+	PUGI__FN xml_node xml_node::append_move(const xml_node& moved)
+	{
+		if (!_root || !moved._root || !impl::allow_move(*this, moved)) return xml_node();
+
+		impl::get_document(_root).nodes_moved = true;
+
+		impl::unlink_node(moved._root);
+		impl::link_node_last(moved._root, _root);
+
+		return moved;
+	}
+
+	PUGI__FN xml_node xml_node::prepend_move(const xml_node& moved)
+	{
+		if (!_root || !moved._root || !impl::allow_move(*this, moved)) return xml_node();
+
+		impl::get_document(_root).nodes_moved = true;
+
+		impl::unlink_node(moved._root);
+		impl::link_node_first(moved._root, _root);
+
+		return moved;
+	}
+
+	PUGI__FN xml_node xml_node::insert_move_after(const xml_node& moved, const xml_node& node)
+	{
+		if (!_root || !moved._root || !impl::allow_move(*this, moved)) return xml_node();
+		if (!node._root || node._root->parent != _root) return xml_node();
+		if (moved._root == node._root) return xml_node();
+
+		impl::get_document(_root).nodes_moved = true;
+
+		impl::unlink_node(moved._root);
+		impl::link_node_after(moved._root, node._root);
+
+		return moved;
+	}
+
+	PUGI__FN xml_node xml_node::insert_move_before(const xml_node& moved, const xml_node& node)
+	{
+		if (!_root || !moved._root || !impl::allow_move(*this, moved)) return xml_node();
+		if (!node._root || node._root->parent != _root) return xml_node();
+		if (moved._root == node._root) return xml_node();
+
+		impl::get_document(_root).nodes_moved = true;
+
+		impl::unlink_node(moved._root);
+		impl::link_node_before(moved._root, node._root);
+
+		return moved;
+	}
+
 	PUGI__FN bool xml_node::remove_attribute(const char_t* name_)
 	{
 		return remove_attribute(attribute(name_));
@@ -6548,6 +6720,7 @@ PUGI__NS_BEGIN
 
 		if (node)
 		{
+			if (get_document(node).nodes_moved) return 0;
 			if (node->name && (node->header & xml_memory_page_name_allocated_mask) == 0) return node->name;
 			if (node->value && (node->header & xml_memory_page_value_allocated_mask) == 0) return node->value;
 			return 0;
@@ -6557,6 +6730,8 @@ PUGI__NS_BEGIN
 
 		if (attr)
 		{
+			xml_node_struct* parent = xnode.parent().internal_object();
+			if (parent && get_document(parent).nodes_moved) return 0;
 			if ((attr->header & xml_memory_page_name_allocated_mask) == 0) return attr->name;
 			if ((attr->header & xml_memory_page_value_allocated_mask) == 0) return attr->value;
 			return 0;
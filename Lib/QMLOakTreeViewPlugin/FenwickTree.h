@@ -0,0 +1,121 @@
+/*
+ * OakModelView (http://oakmodelview.com/)
+ * Author: Mikkel Nøhr Løvgreen (mikkel@oakmodelview.com)
+ * ------------------------------------------------------------------------
+ * Licensed to Vilaversoftware IVS who licenses this file to you under the
+ * Apache License, Version 2.0 (the "License"); you may not use this file
+ * except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <vector>
+
+#include "Assert.h"
+
+// =============================================================================
+// Class definition
+// =============================================================================
+// Holds a list of positive values and finds the sum of the values before an
+//  index and the index of a sum in O(log n) time. Changing a value is also
+//  O(log n) while inserting and removing values rebuilds the tree in O(n) time
+class FenwickTree
+{
+public:
+    FenwickTree() {}
+
+    int count() const { return static_cast<int>(m_values.size()); }
+    int total() const { return m_total; }
+    int value(int index) const { return m_values[static_cast<size_t>(index)]; }
+
+    // Sets all the values to 'value'
+    void reset(int count, int value)
+    {
+        m_values.assign(static_cast<size_t>(count), value);
+        build();
+    }
+
+    void add(int index, int change)
+    {
+        ASSERT(index >= 0 && index < count());
+        m_values[static_cast<size_t>(index)] += change;
+        m_total += change;
+        for (size_t i = static_cast<size_t>(index) + 1; i <= m_values.size(); i += i & (~i + 1)) {
+            m_tree[i] += change;
+        }
+    }
+
+    // Returns the sum of the values before 'index'
+    int prefixSum(int index) const
+    {
+        ASSERT(index >= 0 && index <= count());
+        int sum = 0;
+        for (size_t i = static_cast<size_t>(index); i > 0; i -= i & (~i + 1)) {
+            sum += m_tree[i];
+        }
+        return sum;
+    }
+
+    // Returns the index where prefixSum(index) <= sum < prefixSum(index + 1)
+    //  and sets 'prefix' to prefixSum(index)
+    int find(int sum, int &prefix) const
+    {
+        ASSERT(sum >= 0 && sum < m_total);
+        size_t index = 0;
+        prefix = 0;
+        for (size_t step = m_highestBit; step > 0; step >>= 1) {
+            size_t next = index + step;
+            if (next <= m_values.size() && prefix + m_tree[next] <= sum) {
+                index = next;
+                prefix += m_tree[index];
+            }
+        }
+        return static_cast<int>(index);
+    }
+
+    void insert(int index, int count, int value)
+    {
+        ASSERT(index >= 0 && index <= this->count());
+        m_values.insert(m_values.begin() + index, static_cast<size_t>(count), value);
+        build();
+    }
+
+    void remove(int index, int count)
+    {
+        ASSERT(index >= 0 && index + count <= this->count());
+        m_values.erase(m_values.begin() + index, m_values.begin() + index + count);
+        build();
+    }
+
+protected:
+    void build()
+    {
+        m_tree.assign(m_values.size() + 1, 0);
+        m_total = 0;
+        for (size_t i = 1; i <= m_values.size(); i++) {
+            m_tree[i] += m_values[i - 1];
+            m_total += m_values[i - 1];
+            size_t parent = i + (i & (~i + 1));
+            if (parent <= m_values.size()) {
+                m_tree[parent] += m_tree[i];
+            }
+        }
+        m_highestBit = 1;
+        while (m_highestBit * 2 <= m_values.size()) { m_highestBit *= 2; }
+    }
+
+protected:
+    std::vector<int> m_values;
+    std::vector<int> m_tree;
+    int m_total = 0;
+    size_t m_highestBit = 1;
+};
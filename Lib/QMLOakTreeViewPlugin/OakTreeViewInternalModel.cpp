@@ -305,10 +305,15 @@ void OakTreeViewInternalModel::resetInternateNodeData()
 
 // =============================================================================
 // (protected)
-void OakTreeViewInternalModel::updateTreeModelIndexes()
+// Only the indexes below the node data where rows are inserted or removed can change
+void OakTreeViewInternalModel::updateTreeModelIndexes(OakTreeViewNodeData *nodeData)
 {
     // TODO: Make sure the rootModelIndex can not get out of skope too?
-    m_rootNodeData->updateTreeModelIndexes(m_rootModelIndex);
+    if (nodeData == m_rootNodeData) {
+        m_rootNodeData->updateTreeModelIndexes(m_rootModelIndex);
+    } else {
+        nodeData->updateTreeModelIndexes(nodeData->treeModelIndex());
+    }
 }
 
 // =============================================================================
@@ -354,7 +359,8 @@ void OakTreeViewInternalModel::onRowsAboutToBeInserted(const QModelIndex &parent
 {
     if (!isValid()) { return; }
     OakTreeViewNodeData *nodeData = findNodeData(parent);
-    if (!nodeData) { return; }
+    // The rows of collapsed nodes are not in the list
+    if (!nodeData || !nodeData->isVisible()) { return; }
     int globalRow = nodeData->localToGlobalRow(start);
 
     beginInsertRows(QModelIndex(), globalRow, globalRow + end - start);
@@ -366,7 +372,8 @@ void OakTreeViewInternalModel::onRowsAboutToBeRemoved(const QModelIndex &parent,
 {
     if (!isValid()) { return; }
     OakTreeViewNodeData *nodeData = findNodeData(parent);
-    if (!nodeData) { return; }
+    // The rows of collapsed nodes are not in the list
+    if (!nodeData || !nodeData->isVisible()) { return; }
 
     int gFirst, gLast;
     std::tie(gFirst, gLast) = nodeData->localToGlobalRows(first, last);
@@ -385,23 +392,22 @@ void OakTreeViewInternalModel::onRowsInserted(const QModelIndex &parent, int fir
         // Check if hasChildren changed for parent
         if (m_treeModel->rowCount(parent) == last - first + 1) {
             nodeData = findNodeData(parent.parent());
-            if (nodeData) {
+            if (nodeData && nodeData->isVisible()) {
                 QModelIndex i = index(nodeData->localToGlobalRow(parent.row()), 0, QModelIndex());
                 dataChanged(i, i, QVector<int>() << HasChildrenRole);
             }
         }
         return;
     }
-    int globalRow = nodeData->localToGlobalRow(first);
-
-    int insertCount = last - first + 1;
+    bool visible = nodeData->isVisible();
 
-    nodeData->updateLocalRowData(globalRow, insertCount);
-    nodeData->updateGlobalRowCount(globalRow, insertCount);
-    updateTreeModelIndexes();
+    nodeData->insertRows(first, last);
+    updateTreeModelIndexes(nodeData);
 
-    endInsertRows();
-    updateCurrentGlobalRow(m_currentGlobalRow);
+    if (visible) {
+        endInsertRows();
+        updateCurrentGlobalRow(m_currentGlobalRow);
+    }
 }
 
 // =============================================================================
@@ -413,7 +419,7 @@ void OakTreeViewInternalModel::onRowsRemoved(const QModelIndex &parent, int firs
     // Check if hasChildren changed for parent
     if (!m_treeModel->hasChildren(parent)) {
         OakTreeViewNodeData *pNodeData = findNodeData(parent.parent());
-        if (pNodeData) {
+        if (pNodeData && pNodeData->isVisible()) {
             QModelIndex i = index(pNodeData->localToGlobalRow(parent.row()), 0, QModelIndex());
             dataChanged(i, i, QVector<int>() << HasChildrenRole);
         }
@@ -421,12 +427,15 @@ void OakTreeViewInternalModel::onRowsRemoved(const QModelIndex &parent, int firs
 
     OakTreeViewNodeData *nodeData = findNodeData(parent);
     if (!nodeData) { return; }
+    bool visible = nodeData->isVisible();
 
-    int gFirst, gLast;
-    std::tie(gFirst, gLast) = nodeData->localToGlobalRows(first, last);
+    int gFirst = -1, gLast = -1;
+    if (visible) {
+        std::tie(gFirst, gLast) = nodeData->localToGlobalRows(first, last);
+    }
 
     int nextCurrentRow = m_currentGlobalRow;
-    if (nextCurrentRow >= gFirst && nextCurrentRow <= gLast) {
+    if (visible && nextCurrentRow >= gFirst && nextCurrentRow <= gLast) {
         // Current row is being deleted
         if (nodeData->rowCountDirect() > last + 1) {
             // Select next sibling
@@ -440,18 +449,18 @@ void OakTreeViewInternalModel::onRowsRemoved(const QModelIndex &parent, int firs
         }
     }
 
-    nodeData->removeChildNodeData(first, last);
-    nodeData->updateLocalRowData(gFirst, -(last - first + 1));
-    nodeData->updateGlobalRowCount(gFirst, -(gLast - gFirst + 1));
-    updateTreeModelIndexes();
+    nodeData->removeRows(first, last);
+    updateTreeModelIndexes(nodeData);
 
-    endRemoveRows();
-    updateCurrentGlobalRow(nextCurrentRow);
+    if (visible) {
+        endRemoveRows();
+        updateCurrentGlobalRow(nextCurrentRow);
+    }
 
     if (!m_treeModel->hasChildren(parent)) {
         OakTreeViewNodeData *pNodeData = findNodeData(parent.parent());
         if (pNodeData) {
-            pNodeData->removeChildNodeData(nodeData->localRowInParent(), nodeData->localRowInParent());
+            pNodeData->removeChildNodeData(nodeData->localRowInParent());
         }
     }
 }
@@ -466,7 +475,7 @@ void OakTreeViewInternalModel::onTreeModelDataChanged(const QModelIndex &topLeft
         return;
     }
     OakTreeViewNodeData *nodeData = findNodeData(parent);
-    if (!nodeData) { return; }
+    if (!nodeData || !nodeData->isVisible()) { return; }
 
     int gFirstRow, gLastRow;
     std::tie(gFirstRow, gLastRow) = nodeData->localToGlobalRows(topLeft.row(), bottomRight.row());
@@ -97,7 +97,7 @@ protected:
     void modelDisconnect();
 
     void resetInternateNodeData();
-    void updateTreeModelIndexes();
+    void updateTreeModelIndexes(OakTreeViewNodeData *nodeData);
 
     OakTreeViewNodeData * findNodeData(const QModelIndex &treeModelIndex) const;
 
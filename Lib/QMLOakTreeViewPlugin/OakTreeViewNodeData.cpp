@@ -35,15 +35,15 @@ OakTreeViewNodeData::OakTreeViewNodeData(OakTreeViewInternalModel *model)
 
     m_depth = 0;
 
-    m_firstRow = 0;
-    m_rowCountDirect = m_model->treeModel()->rowCount(m_treeModelIndex);
     // No nodes are expanded at initilization
-    m_rowCount = m_rowCountDirect;
+    int rowCount = m_model->treeModel()->rowCount(m_treeModelIndex);
+    m_childNodes.assign(static_cast<size_t>(rowCount), nullptr);
+    m_rowTree.reset(rowCount, 1);
 }
 
 // =============================================================================
 // (public)
-OakTreeViewNodeData::OakTreeViewNodeData(int firstRow, const QModelIndex &modelIndex, OakTreeViewNodeData *parent)
+OakTreeViewNodeData::OakTreeViewNodeData(const QModelIndex &modelIndex, OakTreeViewNodeData *parent)
 {
     ASSERT(parent);
     m_parent = parent;
@@ -54,10 +54,10 @@ OakTreeViewNodeData::OakTreeViewNodeData(int firstRow, const QModelIndex &modelI
 
     m_depth = m_parent->m_depth + 1;
 
-    m_firstRow = firstRow;
-    m_rowCountDirect = m_model->treeModel()->rowCount(m_treeModelIndex);
     // No nodes are expanded at initilization
-    m_rowCount = m_rowCountDirect;
+    int rowCount = m_model->treeModel()->rowCount(m_treeModelIndex);
+    m_childNodes.assign(static_cast<size_t>(rowCount), nullptr);
+    m_rowTree.reset(rowCount, 1);
 }
 
 // =============================================================================
@@ -80,10 +80,14 @@ bool OakTreeViewNodeData::expanded() const
 
 // =============================================================================
 // (public)
-bool OakTreeViewNodeData::setExpanded(bool value)
+// Returns true if the node and all its parents are expanded
+bool OakTreeViewNodeData::isVisible() const
 {
-    if (m_expanded == value) { return false; }
-    m_expanded = value;
+    const OakTreeViewNodeData *node = this;
+    while (node) {
+        if (!node->m_expanded) { return false; }
+        node = node->m_parent;
+    }
     return true;
 }
 
@@ -96,30 +100,37 @@ int OakTreeViewNodeData::depth() const
 
 // =============================================================================
 // (public)
+// Returns the global row of the first child
 int OakTreeViewNodeData::firstRow() const
 {
-    return m_firstRow;
+    int row = 0;
+    const OakTreeViewNodeData *node = this;
+    while (node->m_parent) {
+        row += node->m_parent->m_rowTree.prefixSum(node->m_localRowInParent) + 1;
+        node = node->m_parent;
+    }
+    return row;
 }
 
 // =============================================================================
 // (public)
 int OakTreeViewNodeData::lastRow() const
 {
-    return m_firstRow + m_rowCount - 1;
+    return firstRow() + rowCount() - 1;
 }
 
 // =============================================================================
 // (public)
 int OakTreeViewNodeData::rowCountDirect() const
 {
-    return m_rowCountDirect;
+    return m_rowTree.count();
 }
 
 // =============================================================================
 // (public)
 int OakTreeViewNodeData::rowCount() const
 {
-    return m_rowCount;
+    return m_rowTree.total();
 }
 
 // =============================================================================
@@ -138,57 +149,55 @@ const QModelIndex &OakTreeViewNodeData::treeModelIndex() const
 
 // =============================================================================
 // (public)
-void OakTreeViewNodeData::updateFirstRow(int change)
+void OakTreeViewNodeData::insertRows(int first, int last)
 {
-    m_firstRow += change;
-    for (OakTreeViewNodeData *cNode: m_childNodes)
+    ASSERT(first >= 0 && first <= last && first <= rowCountDirect());
+    int count = last - first + 1;
+
+    m_childNodes.insert(m_childNodes.begin() + first, static_cast<size_t>(count), nullptr);
+    m_rowTree.insert(first, count, 1);
+    for (size_t i = static_cast<size_t>(last) + 1; i < m_childNodes.size(); i++)
     {
-        cNode->updateFirstRow(change);
+        if (m_childNodes[i]) { m_childNodes[i]->m_localRowInParent += count; }
     }
+    updateParentRowCount(count);
 }
 
 // =============================================================================
 // (public)
-void OakTreeViewNodeData::updateGlobalRowCount(int globalRow, int change)
+void OakTreeViewNodeData::removeRows(int first, int last)
 {
-    for (OakTreeViewNodeData *cNode: m_childNodes)
+    ASSERT(first >= 0 && first <= last && last < rowCountDirect());
+    int count = last - first + 1;
+    int change = m_rowTree.prefixSum(last + 1) - m_rowTree.prefixSum(first);
+
+    for (int i = first; i <= last; i++)
     {
-        if (cNode->firstRow() > globalRow) {
-            cNode->updateFirstRow(change);
-        }
-    }
-    m_rowCount += change;
-    if (m_parent) {
-        m_parent->updateGlobalRowCount(globalRow, change);
+        delete m_childNodes[static_cast<size_t>(i)];
     }
-}
-
-// =============================================================================
-// (public)
-void OakTreeViewNodeData::updateLocalRowData(int globalRow, int change)
-{
-    m_rowCountDirect += change;
-    for (OakTreeViewNodeData *cNode: m_childNodes)
+    m_childNodes.erase(m_childNodes.begin() + first, m_childNodes.begin() + last + 1);
+    m_rowTree.remove(first, count);
+    for (size_t i = static_cast<size_t>(first); i < m_childNodes.size(); i++)
     {
-        if (cNode->firstRow() > globalRow + 1) {
-            cNode->m_localRowInParent += change;;
-        }
+        if (m_childNodes[i]) { m_childNodes[i]->m_localRowInParent -= count; }
     }
+    updateParentRowCount(-change);
 }
 
 // =============================================================================
 // (public)
-void OakTreeViewNodeData::removeChildNodeData(int first, int last)
+void OakTreeViewNodeData::removeChildNodeData(int row)
 {
-    for (int i = 0; i < m_childNodes.size(); i++)
-    {
-        OakTreeViewNodeData *childNode = m_childNodes[i];
-        if (childNode->localRowInParent() >= first &&
-            childNode->localRowInParent() <= last) {
-            m_childNodes.removeAt(i);
-            i--;
-            delete childNode;
-        }
+    if (row < 0 || row >= rowCountDirect()) { return; }
+    OakTreeViewNodeData *childNode = m_childNodes[static_cast<size_t>(row)];
+    if (!childNode) { return; }
+
+    int change = 1 - m_rowTree.value(row);
+    m_childNodes[static_cast<size_t>(row)] = nullptr;
+    delete childNode;
+    if (change != 0) {
+        m_rowTree.add(row, change);
+        updateParentRowCount(change);
     }
 }
 
@@ -196,98 +205,57 @@ void OakTreeViewNodeData::removeChildNodeData(int first, int last)
 // (public)
 bool OakTreeViewNodeData::containsRow(int globalRow) const
 {
-    return globalRow >= m_firstRow && globalRow < (m_firstRow + m_rowCount);
+    int first = firstRow();
+    return globalRow >= first && globalRow < (first + rowCount());
 }
 
 // =============================================================================
 // (public)
 bool OakTreeViewNodeData::expanded(int globalRow) const
 {
-    int row = globalRow - m_firstRow;
-    ASSERT(row >= 0);
-    ASSERT(row < m_rowCount);
-    for(OakTreeViewNodeData *cNode: m_childNodes) {
-        if (cNode->treeModelIndex().row() == row) {
-            return cNode->expanded();
-        }
-
-        // Ignore collapesed nodes
-        if (!cNode->expanded()) { continue; }
-
-        if (globalRow < cNode->firstRow()) {
-            // Passed the globalRow (global row is a direct child of this node)
-            break;
-        }
-        if (globalRow <= cNode->lastRow()) {
-            ASSERT(false);
-            return expanded(globalRow);
-        }
-        row -= cNode->rowCount();
-    }
-    ASSERT(row < m_rowCountDirect);
-    return false;
+    int row = localRow(globalRow);
+    const OakTreeViewNodeData *cNode = m_childNodes[static_cast<size_t>(row)];
+    return cNode && cNode->expanded();
 }
 
 // =============================================================================
 // (public)
 bool OakTreeViewNodeData::setExpanded(const QModelIndex &treeModelIndex, int globalRow, bool value)
 {
-    int row = globalRow - m_firstRow;
-    ASSERT(row >= 0);
-    ASSERT(row < m_rowCount);
-    for(OakTreeViewNodeData *cNode: m_childNodes) {
-        if (cNode->treeModelIndex() == treeModelIndex) {
-            // Data Node already exist (state changed)
-            if (cNode->expanded() == value) { return false; }
-            if (value) {
-                m_model->beginInsertRows(QModelIndex(), globalRow+1, globalRow + cNode->rowCount());
-                ASSERT(cNode->setExpanded(value));
-                updateGlobalRowCount(globalRow+1, cNode->rowCount());
-                m_model->endInsertRows();
-                //TRACE("Row count after expanding node: %i\n", m_model->rowCount(QModelIndex()));
-            } else {
-                m_model->beginRemoveRows(QModelIndex(), globalRow+1, globalRow + cNode->rowCount());
-                ASSERT(cNode->setExpanded(value));
-                updateGlobalRowCount(globalRow+1, -cNode->rowCount());
-                m_model->endRemoveRows();
-                //TRACE("Row count after collapsing node: %i\n", m_model->rowCount(QModelIndex()));
-            }
-            return true;
-        }
-
-        // Ignore collapesed nodes
-        if (!cNode->expanded()) { continue; }
-
-        if (globalRow < cNode->firstRow()) {
-            // Passed the globalRow (global row is a direct child of this node)
-            break;
-        }
-        if (globalRow <= cNode->lastRow()) {
-            ASSERT(false);
-            return setExpanded(treeModelIndex, globalRow, value);
-        }
-        row -= cNode->rowCount();
-    }
-    ASSERT(row < m_rowCountDirect); //
-    ASSERT(value);
-    ASSERT(m_model->treeModel()->hasChildren(treeModelIndex));
-
-    // Create a new TreeViewNodeData for the first time expanded node
-    OakTreeViewNodeData *cNode = new OakTreeViewNodeData(globalRow+1, treeModelIndex, this);
-    auto it = m_childNodes.begin();
-    while (it != m_childNodes.end()) {
-        if ((*it)->firstRow() > cNode->firstRow()) {
-            break;
-        }
-        it++;
+    int row = localRow(globalRow);
+    ASSERT(treeModelIndex.row() == row);
+
+    OakTreeViewNodeData *cNode = m_childNodes[static_cast<size_t>(row)];
+    if (cNode) {
+        // Data Node already exist (state changed)
+        if (cNode->expanded() == value) { return false; }
+    } else {
+        if (!value) { return false; }
+        ASSERT(m_model->treeModel()->hasChildren(treeModelIndex));
+
+        // Create a new TreeViewNodeData for the first time expanded node
+        cNode = new OakTreeViewNodeData(treeModelIndex, this);
+        cNode->m_expanded = false;
+        m_childNodes[static_cast<size_t>(row)] = cNode;
     }
 
-    m_model->beginInsertRows(QModelIndex(), globalRow+1, globalRow + cNode->rowCount());
-    m_childNodes.insert(it, cNode);
-    updateGlobalRowCount(globalRow+1, cNode->rowCount());
-    m_model->endInsertRows();
-    //TRACE("Row count after expanding(2) node: %i\n", m_model->rowCount(QModelIndex()));
-
+    int count = cNode->rowCount();
+    int change = value ? count : -count;
+    if (count == 0) {
+        cNode->m_expanded = value;
+    } else if (value) {
+        m_model->beginInsertRows(QModelIndex(), globalRow + 1, globalRow + count);
+        cNode->m_expanded = value;
+        m_rowTree.add(row, change);
+        updateParentRowCount(change);
+        m_model->endInsertRows();
+    } else {
+        m_model->beginRemoveRows(QModelIndex(), globalRow + 1, globalRow + count);
+        cNode->m_expanded = value;
+        m_rowTree.add(row, change);
+        updateParentRowCount(change);
+        m_model->endRemoveRows();
+    }
     return true;
 }
 
@@ -295,105 +263,41 @@ bool OakTreeViewNodeData::setExpanded(const QModelIndex &treeModelIndex, int glo
 // (public)
 QModelIndex OakTreeViewNodeData::treeModelIndex(int globalRow, int column) const
 {
-    int row = globalRow - m_firstRow;
-    ASSERT(row >= 0);
-    ASSERT(row < m_rowCount);
-    for(OakTreeViewNodeData *cNode: m_childNodes) {
-        // Ignore collapesed nodes
-        if (!cNode->expanded()) { continue; }
-
-        if (globalRow < cNode->firstRow()) {
-            // Passed the globalRow (global row is a direct child of this node)
-            break;
-        }
-        if (globalRow <= cNode->lastRow()) {
-            ASSERT(false);
-            return treeModelIndex(globalRow, column);
-        }
-        row -= cNode->rowCount();
-    }
-    ASSERT(row < m_rowCountDirect);
-    return m_model->treeModel()->index(row, column, m_treeModelIndex);
+    return m_model->treeModel()->index(localRow(globalRow), column, m_treeModelIndex);
 }
 
 // =============================================================================
 // (public)
 const OakTreeViewNodeData *OakTreeViewNodeData::parentNodeData(int globalRow) const
 {
-    int row = globalRow - m_firstRow;
-    ASSERT(row >= 0);
-    ASSERT(row < m_rowCount);
-    for(OakTreeViewNodeData *cNode: m_childNodes) {
-        // Ignore collapesed nodes
-        if (!cNode->expanded()) { continue; }
-
-        if (globalRow < cNode->firstRow()) {
-            // Passed the globalRow (global row is a direct child of this node)
-            break;
-        }
-        if (globalRow <= cNode->lastRow()) {
-            return parentNodeData(globalRow);
-        }
-        row -= cNode->rowCount();
-    }
-    ASSERT(row < m_rowCountDirect);
-    return this;
+    int row;
+    return findParentNodeData(globalRow - firstRow(), row);
 }
 
 // =============================================================================
 // (public)
 OakTreeViewNodeData *OakTreeViewNodeData::parentNodeData(int globalRow)
 {
-    int row = globalRow - m_firstRow;
-    ASSERT(row >= 0);
-    ASSERT(row < m_rowCount);
-    for(OakTreeViewNodeData *cNode: m_childNodes) {
-        // Ignore collapesed nodes
-        if (!cNode->expanded()) { continue; }
-
-        if (globalRow < cNode->firstRow()) {
-            // Passed the globalRow (global row is a direct child of this node)
-            break;
-        }
-        if (globalRow <= cNode->lastRow()) {
-            return cNode->parentNodeData(globalRow);
-        }
-        row -= cNode->rowCount();
-    }
-    ASSERT(row < m_rowCountDirect);
-    return this;
+    int row;
+    return const_cast<OakTreeViewNodeData*>(findParentNodeData(globalRow - firstRow(), row));
 }
 
 // =============================================================================
 // (public)
 OakTreeViewNodeData *OakTreeViewNodeData::childNodeData(const QModelIndex &index)
 {
-    for(OakTreeViewNodeData *cNode: m_childNodes) {
-        if (cNode->treeModelIndex() == index) {
-            return cNode;
-        }
-    }
-    return nullptr;
+    int row = index.row();
+    if (row < 0 || row >= rowCountDirect()) { return nullptr; }
+    return m_childNodes[static_cast<size_t>(row)];
 }
 
 // =============================================================================
 // (public)
 int OakTreeViewNodeData::localToGlobalRow(int row) const
 {
-    int globalRow = m_firstRow + row;
     ASSERT(row >= 0);
-    ASSERT(row < m_rowCount+1);
-    for(OakTreeViewNodeData *cNode: m_childNodes) {
-        // Ignore collapesed nodes
-        if (!cNode->expanded()) { continue; }
-
-        if (cNode->firstRow() <= globalRow) {
-            globalRow += cNode->rowCount();
-        } else {
-            break;
-        }
-    }
-    return globalRow;
+    ASSERT(row <= rowCountDirect());
+    return firstRow() + m_rowTree.prefixSum(row);
 }
 
 // =============================================================================
@@ -401,24 +305,10 @@ int OakTreeViewNodeData::localToGlobalRow(int row) const
 std::tuple<int,int> OakTreeViewNodeData::localToGlobalRows(int first, int last)
 {
     ASSERT(last >= first);
-    int gFirst = m_firstRow + first;
-    int gLast = m_firstRow + last;
     ASSERT(first >= 0);
-    ASSERT(first < m_rowCount+1);
-    for(OakTreeViewNodeData *cNode: m_childNodes) {
-        // Ignore collapesed nodes
-        if (!cNode->expanded()) { continue; }
-
-        if (cNode->localRowInParent() < first) {
-            gFirst += cNode->rowCount();
-        }
-        if (cNode->localRowInParent() <= last) {
-            gLast += cNode->rowCount();
-        } else {
-            break;
-        }
-    }
-    return std::make_tuple(gFirst, gLast);
+    ASSERT(last < rowCountDirect());
+    int globalRow = firstRow();
+    return std::make_tuple(globalRow + m_rowTree.prefixSum(first), globalRow + m_rowTree.prefixSum(last + 1) - 1);
 }
 
 // =============================================================================
@@ -431,11 +321,52 @@ void OakTreeViewNodeData::updateTreeModelIndexes(const QModelIndex &newTreeModel
     m_treeModelIndex = newTreeModelIndex;
     //TRACE("Node key value: %s\n", m_treeModelIndex.data(QOakModel::KeyValue).toString().toStdString().c_str());
     for(OakTreeViewNodeData *cNode: m_childNodes) {
+        if (!cNode) { continue; }
         QModelIndex i = m_model->treeModel()->index(cNode->localRowInParent(), 0, newTreeModelIndex);
-        if (!i.isValid()) {
-            i = m_model->treeModel()->index(cNode->localRowInParent(), 0, newTreeModelIndex);
-            return;
-        }
+        if (!i.isValid()) { return; }
         cNode->updateTreeModelIndexes(i);
     }
 }
+
+// =============================================================================
+// (protected)
+// Returns the node data that has the row as a direct child and sets 'row' to
+//  its local row. 'rowOffset' is the global row minus firstRow()
+const OakTreeViewNodeData *OakTreeViewNodeData::findParentNodeData(int rowOffset, int &row) const
+{
+    const OakTreeViewNodeData *node = this;
+    while (true) {
+        int prefix;
+        row = node->m_rowTree.find(rowOffset, prefix);
+        if (rowOffset == prefix) { return node; }
+
+        // The row is a child of an expanded child
+        node = node->m_childNodes[static_cast<size_t>(row)];
+        ASSERT(node && node->m_expanded);
+        rowOffset -= prefix + 1;
+    }
+}
+
+// =============================================================================
+// (protected)
+// Returns the local row of a global row that is a direct child
+int OakTreeViewNodeData::localRow(int globalRow) const
+{
+    int row;
+    const OakTreeViewNodeData *node = findParentNodeData(globalRow - firstRow(), row);
+    ASSERT(node == this);
+    Q_UNUSED(node)
+    return row;
+}
+
+// =============================================================================
+// (protected)
+// Adds the change in row count to the parents the rows are visible in
+void OakTreeViewNodeData::updateParentRowCount(int change)
+{
+    const OakTreeViewNodeData *node = this;
+    while (node->m_parent && node->m_expanded) {
+        node->m_parent->m_rowTree.add(node->m_localRowInParent, change);
+        node = node->m_parent;
+    }
+}
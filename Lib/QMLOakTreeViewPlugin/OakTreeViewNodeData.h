@@ -21,20 +21,26 @@
 #include <vector>
 #include <QModelIndex>
 
+#include "FenwickTree.h"
+
 class OakTreeViewInternalModel;
 
 // =============================================================================
 // Class definition
 // =============================================================================
+// Node data is created for the nodes that have been expanded. The rows of the
+//  children are not stored as global rows. Instead a Fenwick tree holds the
+//  number of rows each child takes up (1 plus the rows of its children if it
+//  is expanded), so global rows are found and changed in O(depth * log n) time
 class OakTreeViewNodeData
 {
 public:
     OakTreeViewNodeData(OakTreeViewInternalModel *model);
-    OakTreeViewNodeData(int firstRow, const QModelIndex &modelIndex, OakTreeViewNodeData *parent = nullptr);
+    OakTreeViewNodeData(const QModelIndex &modelIndex, OakTreeViewNodeData *parent);
     ~OakTreeViewNodeData();
 
     bool expanded() const;
-    bool setExpanded(bool value);
+    bool isVisible() const;
     int depth() const;
     int firstRow() const;
     int lastRow() const;
@@ -43,11 +49,9 @@ public:
     int localRowInParent() const;
     const QModelIndex &treeModelIndex() const;
 
-    void updateFirstRow(int change);
-    void updateGlobalRowCount(int globalRow, int change);
-    void updateLocalRowData(int globalRow, int change);
-
-    void removeChildNodeData(int first, int last);
+    void insertRows(int first, int last);
+    void removeRows(int first, int last);
+    void removeChildNodeData(int row);
 
     bool containsRow(int globalRow) const;
 
@@ -66,17 +70,20 @@ public:
 
     void updateTreeModelIndexes(const QModelIndex &newTreeModelIndex);
 
+protected:
+    const OakTreeViewNodeData *findParentNodeData(int rowOffset, int &row) const;
+    int localRow(int globalRow) const;
+    void updateParentRowCount(int change);
+
 protected:
     OakTreeViewNodeData *m_parent = nullptr;
     OakTreeViewInternalModel * m_model;
-    QList<OakTreeViewNodeData*> m_childNodes;
+    // The node data of the children by local row (nullptr if never expanded)
+    std::vector<OakTreeViewNodeData*> m_childNodes;
+    FenwickTree m_rowTree;
     bool m_expanded = true;
     int m_depth;
-    int m_firstRow;
-    int m_rowCountDirect;
-    int m_rowCount;
 
     int m_localRowInParent;
     QModelIndex m_treeModelIndex;
 };
-
@@ -13,6 +13,7 @@ DESTDIR += ../Plugins/Oak/TreeView
 HEADERS += \
     OakTreeViewInternalModel.h \
     OakTreeViewNodeData.h \
+    FenwickTree.h \
     oaktreeviewplugin.h \
     Assert.h \
     Trace.h
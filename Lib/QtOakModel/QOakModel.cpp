@@ -42,6 +42,7 @@ QOakModel::QOakModel(QObject *parent)
     m_model.notifier_nodeMoveAfter.add(this, &QOakModel::onNodeMoveAfter);
     m_model.notifier_nodeCloneBefore.add(this, &QOakModel::onNodeCloneBefore);
     m_model.notifier_nodeCloneAfter.add(this, &QOakModel::onNodeCloneAfter);
+    m_model.notifier_batchEnd.add(this, &QOakModel::onBatchEnd);
     updateEnabledActions();
 }
 
@@ -187,6 +188,7 @@ void QOakModel::onRootNodeDataChanged()
 // (public)
 void QOakModel::onVariantLeafChanged(const Oak::Model::NodeIndex& nIndex)
 {
+    if (m_layoutChanging) { return; }
     Oak::Model::Node node = nIndex.node(m_model.rootNode());
     if (node.isNull()) { return; }
     QModelIndex index = createModelIndex(node);
@@ -197,6 +199,7 @@ void QOakModel::onVariantLeafChanged(const Oak::Model::NodeIndex& nIndex)
 // (public)
 void QOakModel::onKeyLeafChanged(const Oak::Model::NodeIndex& nIndex)
 {
+    if (m_layoutChanging) { return; }
     Oak::Model::Node node = nIndex.node(m_model.rootNode());
     if (node.isNull()) { return; }
     QModelIndex index = createModelIndex(node);
@@ -208,6 +211,10 @@ void QOakModel::onKeyLeafChanged(const Oak::Model::NodeIndex& nIndex)
 void QOakModel::onNodeInserteBefore(const Oak::Model::NodeIndex &nIndex)
 {
     //TRACE("onNodeInserteBefore(%s)\n",nIndex.toString().c_str());
+    if (m_model.isBatching()) {
+        beginBatchLayoutChange();
+        return;
+    }
     Oak::Model::Node pNode = nIndex.nodeParent(m_model.rootNode());
     if (pNode.isNull()) { return; }
     QModelIndex pIndex = createModelIndex(pNode);
@@ -221,6 +228,7 @@ void QOakModel::onNodeInserteAfter(const Oak::Model::NodeIndex &nIndex)
 {
     Q_UNUSED(nIndex)
     //TRACE("onNodeInserteAfter(%s)\n",nIndex.toString().c_str());
+    if (m_layoutChanging) { return; }
     endInsertRows();
 }
 
@@ -229,6 +237,19 @@ void QOakModel::onNodeInserteAfter(const Oak::Model::NodeIndex &nIndex)
 void QOakModel::onNodeRemoveBefore(const Oak::Model::NodeIndex &nIndex)
 {
     //TRACE("onNodeRemoveBefore(%s)\n",nIndex.toString().c_str());
+    if (m_model.isBatching()) {
+        beginBatchLayoutChange();
+
+        // Persistent indexes of the removed nodes are invalidated when the batch ends
+        Oak::Model::Node removedNode = nIndex.node(m_model.rootNode());
+        for (Oak::Model::Node &node: m_layoutNodeList)
+        {
+            Oak::Model::Node ancestor = node;
+            while (!ancestor.isNull() && ancestor != removedNode) { ancestor = ancestor.parent(); }
+            if (!ancestor.isNull()) { node = Oak::Model::Node(); }
+        }
+        return;
+    }
     Oak::Model::Node pNode = nIndex.nodeParent(m_model.rootNode());
     if (pNode.isNull()) { return; }
     QModelIndex pIndex = createModelIndex(pNode);
@@ -241,6 +262,7 @@ void QOakModel::onNodeRemoveBefore(const Oak::Model::NodeIndex &nIndex)
 void QOakModel::onNodeRemoveAfter(const Oak::Model::NodeIndex &nIndex)
 {
     Q_UNUSED(nIndex)
+    if (m_layoutChanging) { return; }
     endRemoveRows();
 }
 
@@ -248,7 +270,9 @@ void QOakModel::onNodeRemoveAfter(const Oak::Model::NodeIndex &nIndex)
 // (public)
 void QOakModel::onNodeMoveBefore(const Oak::Model::NodeIndex &sourceNodeIndex, const Oak::Model::NodeIndex &targetNodeIndex)
 {
-
+    Q_UNUSED(sourceNodeIndex)
+    Q_UNUSED(targetNodeIndex)
+    if (m_model.isBatching()) { beginBatchLayoutChange(); }
 }
 
 // =============================================================================
@@ -262,7 +286,9 @@ void QOakModel::onNodeMoveAfter(const Oak::Model::NodeIndex &sourceNodeIndex, co
 // (public)
 void QOakModel::onNodeCloneBefore(const Oak::Model::NodeIndex &sourceNodeIndex, const Oak::Model::NodeIndex &targetNodeIndex)
 {
-
+    Q_UNUSED(sourceNodeIndex)
+    Q_UNUSED(targetNodeIndex)
+    if (m_model.isBatching()) { beginBatchLayoutChange(); }
 }
 
 // =============================================================================
@@ -272,6 +298,55 @@ void QOakModel::onNodeCloneAfter(const Oak::Model::NodeIndex &sourceNodeIndex, c
 
 }
 
+// =============================================================================
+// (public)
+// The rows can not be inserted and removed one at a time in a batch, because the
+//  changes are reported after they are made. The nodes of the persistent indexes
+//  are looked up before the first change, and the indexes are moved to where the
+//  nodes are when the batch ends
+void QOakModel::beginBatchLayoutChange()
+{
+    if (m_layoutChanging) { return; }
+    m_layoutChanging = true;
+
+    emit layoutAboutToBeChanged();
+
+    m_layoutIndexList = persistentIndexList();
+    m_layoutNodeList.clear();
+    m_layoutNodeList.reserve(static_cast<size_t>(m_layoutIndexList.size()));
+    for (const QModelIndex &index: m_layoutIndexList)
+    {
+        m_layoutNodeList.push_back(toNode(index));
+    }
+}
+
+// =============================================================================
+// (public)
+void QOakModel::onBatchEnd()
+{
+    if (!m_layoutChanging) { return; }
+
+    QModelIndexList newIndexList;
+    newIndexList.reserve(m_layoutIndexList.size());
+    for (int i = 0; i < m_layoutIndexList.size(); i++)
+    {
+        const Oak::Model::Node &node = m_layoutNodeList[static_cast<size_t>(i)];
+        Oak::Model::Node pNode = node.isNull() ? Oak::Model::Node() : node.parent();
+        if (pNode.isNull()) {
+            newIndexList.append(QModelIndex());
+        } else {
+            newIndexList.append(createModelIndex(pNode.childIndex(node), m_layoutIndexList.at(i).column(), pNode));
+        }
+    }
+    changePersistentIndexList(m_layoutIndexList, newIndexList);
+
+    m_layoutIndexList.clear();
+    m_layoutNodeList.clear();
+    m_layoutChanging = false;
+
+    emit layoutChanged();
+}
+
 // =============================================================================
 // (public)
 QModelIndex QOakModel::index(int row, int column, const QModelIndex &parent) const
@@ -83,6 +83,9 @@ protected:
     void onNodeCloneBefore(const Oak::Model::NodeIndex& sourceNodeIndex, const Oak::Model::NodeIndex& targetNodeIndex);
     void onNodeCloneAfter(const Oak::Model::NodeIndex& sourceNodeIndex, const Oak::Model::NodeIndex& targetNodeIndex);
 
+    void beginBatchLayoutChange();
+    void onBatchEnd();
+
 signals:
     void dataLoaded();
     void builderChanged();
@@ -92,6 +95,11 @@ protected:
     QOakModelBuilderData* m_builder;
     QString m_name;
 
+    // Changes made in a batch are reported as one layout change when the batch ends
+    bool m_layoutChanging = false;
+    QModelIndexList m_layoutIndexList;
+    std::vector<Oak::Model::Node> m_layoutNodeList;
+
     // QAbstractItemModel interface
 public:
     virtual QModelIndex index(int row, int column, const QModelIndex& parent) const override;
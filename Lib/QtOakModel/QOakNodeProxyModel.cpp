@@ -100,7 +100,7 @@ QVariant QOakNodeProxyModel::data(const QModelIndex &index, int role) const
 
     if (!index.isValid()) { return QVariant(); }
 
-    const Oak::Model::Leaf &leaf = toLeaf(index);
+    Oak::Model::Leaf leaf = toLeaf(index);
     if (leaf.isNull()) { return QVariant(); }
 
     switch (role) {
@@ -173,7 +173,7 @@ bool QOakNodeProxyModel::setData(const QModelIndex &index, const QVariant &value
     if (!index.isValid()) { return false; }
     if (role != Qt::EditRole) { return false; }
 
-    const Oak::Model::Leaf &leaf = toLeaf(index);
+    Oak::Model::Leaf leaf = toLeaf(index);
     if (leaf.isNull()) { return false; }
 
     if (leaf.setValue(toUnionValue(value))) {
@@ -241,7 +241,7 @@ QHash<int, QByteArray> QOakNodeProxyModel::roleNames() const
 
 // =============================================================================
 // (public)
-const Oak::Model::Leaf &QOakNodeProxyModel::toLeaf(const QModelIndex& index) const
+Oak::Model::Leaf QOakNodeProxyModel::toLeaf(const QModelIndex& index) const
 {
     ASSERT(index.internalPointer() == m_node.parent().nodeData().internalPtr());
     ASSERT(index.row() < m_node.leafCount());
@@ -253,8 +253,10 @@ const Oak::Model::Leaf &QOakNodeProxyModel::toLeaf(const QModelIndex& index) con
 // (protected)
 void QOakNodeProxyModel::sourceModelConnect()
 {
-    sourceOakModel()->notifier_leafChangeAfter.add(this, &QOakNodeProxyModel::onLeafValueChanged);
-    sourceOakModel()->notifier_variantLeafChangeAfter.add(this, &QOakNodeProxyModel::onVariantLeafChanged);
+    // Only the changes of nodes with the same name as the source node are passed on
+    Oak::Model::CallbackFilter filter = Oak::Model::CallbackFilter::create(m_node.def());
+    sourceOakModel()->notifier_leafChangeAfter.add(this, &QOakNodeProxyModel::onLeafValueChanged, filter);
+    sourceOakModel()->notifier_variantLeafChangeAfter.add(this, &QOakNodeProxyModel::onVariantLeafChanged, filter);
 }
 
 // =============================================================================
@@ -269,7 +271,10 @@ void QOakNodeProxyModel::sourceModelDisconnect()
 // (protected)
 void QOakNodeProxyModel::sourceItemChanged()
 {
-
+    // The filter of the notifiers depends on the source node
+    if (sourceOakModel() == nullptr || m_node.isNull()) { return; }
+    sourceModelDisconnect();
+    sourceModelConnect();
 }
 
 // =============================================================================
@@ -279,7 +284,7 @@ void QOakNodeProxyModel::onLeafValueChanged(const Oak::Model::NodeIndex& nIndex,
     // Do nothing if the change related to an other node
     if (!m_nodeIndexUPtr || !m_nodeIndexUPtr->equal(nIndex)) { return; }
 
-    const Oak::Model::Leaf &leaf = m_node.leaf(str);
+    Oak::Model::Leaf leaf = m_node.leaf(str);
     if (leaf.isNull()) { return; }
 
     int leafIndex = m_node.leafIndex(leaf);
@@ -60,7 +60,7 @@ public:
 
     virtual QHash<int, QByteArray> roleNames() const override;
 
-    const Oak::Model::Leaf& toLeaf(const QModelIndex &index) const;
+    Oak::Model::Leaf toLeaf(const QModelIndex &index) const;
 
 protected:
     virtual void sourceModelConnect() override;
@@ -285,6 +285,16 @@ void ListView::onNodeCloneAfter(const Model::NodeIndex &sourceNodeIndex, const M
 // =============================================================================
 // (protected)
 void ListView::onNodeRemoveBefore(const Model::NodeIndex &nodeIndex)
+{
+    // The paths of a batch point into a model the view has not caught up with yet
+    if (m_model->isBatching()) { return; }
+
+    removeViewNode(nodeIndex);
+}
+
+// =============================================================================
+// (protected)
+void ListView::removeViewNode(const Model::NodeIndex &nodeIndex)
 {
     // Return if change is outside root node
     if (!nodeIndex.contains(*m_rootNodeIndex.get())) { return; }
@@ -300,7 +310,7 @@ void ListView::onNodeRemoveBefore(const Model::NodeIndex &nodeIndex)
 void ListView::onVariantLeafChangeAfter(const Model::NodeIndex &nodeIndex)
 {
     // Child nodes can change when the variant definition change
-    onNodeRemoveBefore(nodeIndex);
+    removeViewNode(nodeIndex);
     onNodeInserteAfter(nodeIndex);
 
     currentNodeChanged();
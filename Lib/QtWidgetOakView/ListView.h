@@ -64,6 +64,7 @@ protected:
     void onNodeMoveBefore(const Model::NodeIndex &sourceNodeIndex, const Model::NodeIndex &targetNodeIndex);
     void onNodeCloneAfter(const Model::NodeIndex &sourceNodeIndex, const Model::NodeIndex &targetNodeIndex);
     void onNodeRemoveBefore(const Model::NodeIndex &nodeIndex);
+    void removeViewNode(const Model::NodeIndex &nodeIndex);
     void onVariantLeafChangeAfter(const Model::NodeIndex &nodeIndex);
     void onKeyLeafChangeAfter(const Model::NodeIndex &nodeIndex);
 
@@ -32,6 +32,50 @@
 
 namespace Oak::View::QtWidgets {
 
+// =============================================================================
+// Class definition
+// =============================================================================
+class OakView::LazyItem : public QTreeWidgetItem
+{
+public:
+    LazyItem(QTreeWidgetItem *parent = nullptr)
+        : QTreeWidgetItem(parent, UserType) {}
+
+    virtual QVariant data(int column, int role) const override
+    {
+        if (role != Qt::DisplayRole && role != Qt::EditRole) {
+            return QTreeWidgetItem::data(column, role);
+        }
+        if (!m_labelsValid) {
+            // The display name depends on the variant and the key can change at any time,
+            // so both are read from the node the first time the item is displayed
+            m_labels.clear();
+            OakView *view = static_cast<OakView*>(treeWidget());
+            Model::Node node = view ? view->nodeFromWidget(const_cast<LazyItem*>(this)) : Model::Node();
+            if (!node.isNull()) {
+                m_labels.append(QString::fromStdString(node.def()->displayName()));
+                if (node.def()->hasKey()) {
+                    m_labels.append(QString::fromStdString(node.keyLeaf().toString()));
+                }
+            }
+            m_labelsValid = true;
+        }
+        return (column < m_labels.size()) ? m_labels.at(column) : QVariant();
+    }
+
+    void invalidateLabels()
+    {
+        m_labelsValid = false;
+        emitDataChanged();
+    }
+
+    bool populated = false;
+
+protected:
+    mutable QStringList m_labels;
+    mutable bool m_labelsValid = false;
+};
+
 // =============================================================================
 // (public)
 OakView::OakView(QWidget* parent)
@@ -44,6 +88,8 @@ OakView::OakView(QWidget* parent)
     setDragDropMode(QAbstractItemView::DragDrop);
 
     connect(this, SIGNAL(currentItemChanged(QTreeWidgetItem*,QTreeWidgetItem*)), this, SLOT(onCurrentQNodeChanged(QTreeWidgetItem*,QTreeWidgetItem*)));
+    connect(this, SIGNAL(itemExpanded(QTreeWidgetItem*)), this, SLOT(onItemExpanded(QTreeWidgetItem*)));
+    connect(this, SIGNAL(itemCollapsed(QTreeWidgetItem*)), this, SLOT(onItemCollapsed(QTreeWidgetItem*)));
 }
 
 // =============================================================================
@@ -71,6 +117,8 @@ void OakView::setOakModel(Model::OakModel* model)
         m_model->notifier_nodeMoveAfter.remove(this);
         m_model->notifier_nodeCloneAfter.remove(this);
         m_model->notifier_nodeRemoveBefore.remove(this);
+        m_model->notifier_nodesInserteAfter.remove(this);
+        m_model->notifier_nodesRemoveAfter.remove(this);
 
         m_model->notifier_variantLeafChangeAfter.remove(this);
         m_model->notifier_keyLeafChangeAfter.remove(this);
@@ -94,6 +142,8 @@ void OakView::setOakModel(Model::OakModel* model)
         m_model->notifier_nodeMoveAfter.add(this, &OakView::onNodeMoveAfter);
         m_model->notifier_nodeCloneAfter.add(this, &OakView::onNodeCloneAfter);
         m_model->notifier_nodeRemoveBefore.add(this, &OakView::onNodeRemoveBefore);
+        m_model->notifier_nodesInserteAfter.add(this, &OakView::onNodesInserteAfter);
+        m_model->notifier_nodesRemoveAfter.add(this, &OakView::onNodesRemoveAfter);
 
         m_model->notifier_variantLeafChangeAfter.add(this, &OakView::onVariantLeafChangeAfter);
         m_model->notifier_keyLeafChangeAfter.add(this, &OakView::onKeyLeafChangeAfter);
@@ -102,6 +152,24 @@ void OakView::setOakModel(Model::OakModel* model)
     }
 }
 
+// =============================================================================
+// (public)
+void OakView::setLazyPopulation(bool lazy)
+{
+    if (m_lazy == lazy) { return; }
+    m_lazy = lazy;
+    if (m_model && !m_model->isNull()) {
+        updateTreeStructure();
+    }
+}
+
+// =============================================================================
+// (public)
+bool OakView::lazyPopulation() const
+{
+    return m_lazy;
+}
+
 // =============================================================================
 // (public)
 void OakView::currentNodeChanged()
@@ -120,7 +188,9 @@ void OakView::setCurrentNode(const Model::NodeIndex& nodeIndex)
         return;
     }
 
-    QTreeWidgetItem * newQItem = widgetFromIndex(nodeIndex);
+    // Populates the path to the node if it is not materialized yet
+    QTreeWidgetItem * newQItem = widgetFromIndex(nodeIndex, false, true);
+    if (newQItem == nullptr) { return; }
 
     // Check if the selection changed
     if (selectedItems().count() == 1 &&
@@ -400,6 +470,13 @@ QTreeWidgetItem * OakView::getTreeNodes(const Model::Node &node, QTreeWidgetItem
 {
     if (node.isNull()) { return nullptr; }
 
+    if (m_lazy) {
+        // Only the item is created. The children are added by populateItem() when it is expanded
+        LazyItem * elementNode = new LazyItem(parentNode);
+        elementNode->setChildIndicatorPolicy(node.firstChild().isNull() ? QTreeWidgetItem::DontShowIndicator : QTreeWidgetItem::ShowIndicator);
+        return elementNode;
+    }
+
     std::vector<std::string> values;
     values.push_back(node.def()->displayName());
     if (node.def()->hasKey()) { values.push_back(node.keyLeaf().toString()); }
@@ -416,11 +493,63 @@ QTreeWidgetItem * OakView::getTreeNodes(const Model::Node &node, QTreeWidgetItem
     return elementNode;
 }
 
+// =============================================================================
+// (protected)
+void OakView::populateItem(QTreeWidgetItem *item)
+{
+    if (item == nullptr || isPopulated(item)) { return; }
+
+    Model::Node node = nodeFromWidget(item);
+    Model::Node childNode = node.firstChild();
+    while (!childNode.isNull()) {
+        getTreeNodes(childNode, item);
+        childNode = node.nextChild(childNode);
+    }
+    static_cast<LazyItem*>(item)->populated = true;
+    item->setChildIndicatorPolicy(QTreeWidgetItem::DontShowIndicatorWhenChildless);
+}
+
+// =============================================================================
+// (protected)
+void OakView::evictItem(QTreeWidgetItem *item)
+{
+    if (item == nullptr || item->type() != QTreeWidgetItem::UserType) { return; }
+
+    LazyItem * lazyItem = static_cast<LazyItem*>(item);
+    if (!lazyItem->populated) { return; }
+
+    // The current item is kept so the selection of the model is not changed by collapsing a node
+    for (QTreeWidgetItem * cItem = currentItem(); cItem; cItem = cItem->parent()) {
+        if (cItem->parent() == item) { return; }
+    }
+
+    bool hasChildren = item->childCount() > 0;
+    blockSignals(true);
+    qDeleteAll(item->takeChildren());
+    blockSignals(false);
+    lazyItem->populated = false;
+    item->setChildIndicatorPolicy(hasChildren ? QTreeWidgetItem::ShowIndicator : QTreeWidgetItem::DontShowIndicator);
+}
+
+// =============================================================================
+// (protected)
+bool OakView::isPopulated(QTreeWidgetItem *item) const
+{
+    // Items created outside lazy mode always have all their children
+    if (item->type() != QTreeWidgetItem::UserType) { return true; }
+    return static_cast<LazyItem*>(item)->populated;
+}
+
 // =============================================================================
 // (protected)
 void OakView::onNodeInserteAfter(const Model::NodeIndex &nodeIndex)
 {
     QTreeWidgetItem* parentWidget = widgetFromIndex(nodeIndex, true);
+    if (parentWidget == nullptr) { return; }
+    if (!isPopulated(parentWidget)) {
+        parentWidget->setChildIndicatorPolicy(QTreeWidgetItem::ShowIndicator);
+        return;
+    }
     int insertIndex = nodeIndex.lastNodeIndex().index();
     parentWidget->insertChild(insertIndex, getTreeNodes(nodeIndex.node(m_model->rootNode())));
 }
@@ -435,8 +564,35 @@ void OakView::onNodeMoveAfter(const Model::NodeIndex &sourceNodeIndex, const Mod
     int sourceIndex = sourceNodeIndex.lastNodeIndex().index();
     int targetIndex = targetNodeIndex.lastNodeIndex().index();
 
+    bool sourceMaterialized = sourceParentWidget && isPopulated(sourceParentWidget);
+    bool targetMaterialized = targetParentWidget && isPopulated(targetParentWidget);
+
     blockSignals(true);
-    targetParentWidget->insertChild(targetIndex, sourceParentWidget->takeChild(sourceIndex));
+    if (sourceMaterialized && targetMaterialized) {
+        targetParentWidget->insertChild(targetIndex, sourceParentWidget->takeChild(sourceIndex));
+    } else if (sourceMaterialized) {
+        QTreeWidgetItem* currentWidget = currentItem();
+        QTreeWidgetItem* moveWidget = sourceParentWidget->takeChild(sourceIndex);
+        bool hasCurrent = false;
+        for (QTreeWidgetItem * cItem = currentWidget; cItem; cItem = cItem->parent()) {
+            if (cItem == moveWidget) { hasCurrent = true; break; }
+        }
+        // The current item is kept, so the target is materialized and the item replaces the one created for it
+        if (hasCurrent) { targetParentWidget = widgetFromIndex(targetNodeIndex, true, true); }
+        if (hasCurrent && targetParentWidget) {
+            targetMaterialized = true;
+            delete targetParentWidget->takeChild(targetIndex);
+            targetParentWidget->insertChild(targetIndex, moveWidget);
+            QTreeWidget::setCurrentItem(currentWidget);
+        } else {
+            delete moveWidget;
+        }
+    } else if (targetMaterialized) {
+        targetParentWidget->insertChild(targetIndex, getTreeNodes(targetNodeIndex.node(m_model->rootNode())));
+    }
+    if (targetParentWidget && !targetMaterialized) {
+        targetParentWidget->setChildIndicatorPolicy(QTreeWidgetItem::ShowIndicator);
+    }
     blockSignals(false);
 }
 
@@ -444,13 +600,23 @@ void OakView::onNodeMoveAfter(const Model::NodeIndex &sourceNodeIndex, const Mod
 // (protected)
 void OakView::onNodeCloneAfter(const Model::NodeIndex &sourceNodeIndex, const Model::NodeIndex &targetNodeIndex)
 {
-    QTreeWidgetItem* sourceWidget = widgetFromIndex(sourceNodeIndex);
     QTreeWidgetItem* targetParentWidget = widgetFromIndex(targetNodeIndex, true);
+    if (targetParentWidget == nullptr) { return; }
+    if (!isPopulated(targetParentWidget)) {
+        targetParentWidget->setChildIndicatorPolicy(QTreeWidgetItem::ShowIndicator);
+        return;
+    }
 
     int targetIndex = targetNodeIndex.lastNodeIndex().index();
 
     blockSignals(true);
-    targetParentWidget->insertChild(targetIndex, sourceWidget->clone());
+    if (m_lazy) {
+        // The source item can be unmaterialized, so the clone is created from the model
+        targetParentWidget->insertChild(targetIndex, getTreeNodes(targetNodeIndex.node(m_model->rootNode())));
+    } else {
+        QTreeWidgetItem* sourceWidget = widgetFromIndex(sourceNodeIndex);
+        targetParentWidget->insertChild(targetIndex, sourceWidget->clone());
+    }
     blockSignals(false);
 }
 
@@ -458,19 +624,63 @@ void OakView::onNodeCloneAfter(const Model::NodeIndex &sourceNodeIndex, const Mo
 // (protected)
 void OakView::onNodeRemoveBefore(const Model::NodeIndex &nodeIndex)
 {
+    // Removed nodes are reported after the batch ends
+    if (m_model->isBatching()) { return; }
+
     QTreeWidgetItem* removeWidget = widgetFromIndex(nodeIndex);
+    if (removeWidget == nullptr) { return; }
 
     blockSignals(true);
     removeWidget->parent()->removeChild(removeWidget);
     blockSignals(false);
 }
 
+// =============================================================================
+// (protected)
+void OakView::onNodesInserteAfter(const Model::NodeIndex &nodeIndex, int count)
+{
+    QTreeWidgetItem* parentWidget = widgetFromIndex(nodeIndex, true);
+    if (parentWidget == nullptr) { return; }
+    if (!isPopulated(parentWidget)) {
+        parentWidget->setChildIndicatorPolicy(QTreeWidgetItem::ShowIndicator);
+        return;
+    }
+    Model::Node parentNode = nodeIndex.nodeParent(m_model->rootNode());
+    const std::string &name = nodeIndex.lastNodeIndex().name();
+    int insertIndex = nodeIndex.lastNodeIndex().index();
+
+    blockSignals(true);
+    for (int i = insertIndex; i < insertIndex + count; i++)
+    {
+        parentWidget->insertChild(i, getTreeNodes(parentNode.childAt(name, i)));
+    }
+    blockSignals(false);
+}
+
+// =============================================================================
+// (protected)
+void OakView::onNodesRemoveAfter(const Model::NodeIndex &nodeIndex, int count)
+{
+    // The nodes are already removed so only the parent widget can be found from the index
+    QTreeWidgetItem* parentWidget = widgetFromIndex(nodeIndex, true);
+    if (parentWidget == nullptr || !isPopulated(parentWidget)) { return; }
+    int removeIndex = nodeIndex.lastNodeIndex().index();
+
+    blockSignals(true);
+    for (int i = 0; i < count; i++)
+    {
+        delete parentWidget->takeChild(removeIndex);
+    }
+    blockSignals(false);
+}
+
 // =============================================================================
 // (protected)
 void OakView::onVariantLeafChangeAfter(const Model::NodeIndex &nodeIndex)
 {
     // Child nodes can change when the variant definition change
     QTreeWidgetItem* qNode = widgetFromIndex(nodeIndex);
+    if (qNode == nullptr) { return; }
     QTreeWidgetItem* qParentNode = qNode->parent();
     int index = qParentNode->indexOfChild(qNode);
     blockSignals(true);
@@ -484,20 +694,32 @@ void OakView::onVariantLeafChangeAfter(const Model::NodeIndex &nodeIndex)
 void OakView::onKeyLeafChangeAfter(const Model::NodeIndex &nodeIndex)
 {
     QTreeWidgetItem* qNode = widgetFromIndex(nodeIndex);
+    if (qNode == nullptr) { return; }
+    if (qNode->type() == QTreeWidgetItem::UserType) {
+        static_cast<LazyItem*>(qNode)->invalidateLabels();
+        return;
+    }
     Model::Node node = nodeIndex.node(m_model->rootNode());
     qNode->setText(1, QString::fromStdString(node.keyLeaf().toString()));
 }
 
 // =============================================================================
 // (protected)
-QTreeWidgetItem *OakView::widgetFromIndex(const Model::NodeIndex &nodeIndex, bool parentWidget)
+QTreeWidgetItem *OakView::widgetFromIndex(const Model::NodeIndex &nodeIndex, bool parentWidget, bool populate)
 {
     QTreeWidgetItem * currentWidget = this->topLevelItem(0);
+    if (currentWidget == nullptr) { return nullptr; }
     Model::NodeIndexUPtr unnamedIndex = m_model->convertNodeIndexToUnnamed(nodeIndex);
     const Model::NodeIndex *currentIndex = unnamedIndex.get();
     while (!currentIndex->isNull()) {
         if (parentWidget && !currentIndex->hasChildNodeIndex()) { break; } // Return the next to last widget
+        if (!isPopulated(currentWidget)) {
+            // The node is inside a subtree that has not been materialized
+            if (!populate) { return nullptr; }
+            populateItem(currentWidget);
+        }
         currentWidget = currentWidget->child(currentIndex->index());
+        if (currentWidget == nullptr) { return nullptr; }
         currentIndex = &currentIndex->childNodeIndex();
     }
     return currentWidget;
@@ -526,6 +748,16 @@ Model::NodeIndexUPtr OakView::indexFromWidget(QTreeWidgetItem *nodeWidget)
     return Model::NodeIndexUPtr(currentIndex);
 }
 
+// =============================================================================
+// (protected)
+Model::Node OakView::nodeFromWidget(QTreeWidgetItem *nodeWidget)
+{
+    if (nodeWidget == nullptr || m_model == nullptr || m_model->isNull()) { return Model::Node(); }
+    Model::NodeIndexUPtr nodeIndex = indexFromWidget(nodeWidget);
+    if (!nodeIndex) { return m_model->rootNode(); } // The top level widget
+    return nodeIndex->node(m_model->rootNode());
+}
+
 // =============================================================================
 // (protected slots)
 void OakView::onCurrentQNodeChanged(QTreeWidgetItem *current, QTreeWidgetItem *previous)
@@ -540,5 +772,21 @@ void OakView::onCurrentQNodeChanged(QTreeWidgetItem *current, QTreeWidgetItem *p
 
 }
 
+// =============================================================================
+// (protected slots)
+void OakView::onItemExpanded(QTreeWidgetItem *item)
+{
+    if (!m_lazy) { return; }
+    populateItem(item);
+}
+
+// =============================================================================
+// (protected slots)
+void OakView::onItemCollapsed(QTreeWidgetItem *item)
+{
+    if (!m_lazy) { return; }
+    evictItem(item);
+}
+
 } // namespace Oak::View::QtWidgets
 
@@ -40,6 +40,12 @@ public:
 
     void setOakModel(Model::OakModel* model);
 
+    // When lazy population is enabled, tree items are only created for the children of
+    // expanded nodes, collapsed subtrees are evicted and the labels are read from the
+    // model the first time an item is displayed.
+    void setLazyPopulation(bool lazy);
+    bool lazyPopulation() const;
+
     void currentNodeChanged();
 
     void setCurrentNode(const Model::NodeIndex &nodeIndex);
@@ -54,29 +60,40 @@ protected:
     virtual void startDrag(Qt::DropActions supportedActions) override;
 
 protected:
+    class LazyItem;
+
     void modelDestroyed();
     void clearTreeStructure();
     void updateTreeStructure();
 
     QTreeWidgetItem * getTreeNodes(const Model::Node &node, QTreeWidgetItem *parentNode = nullptr);
+    void populateItem(QTreeWidgetItem *item);
+    void evictItem(QTreeWidgetItem *item);
+    bool isPopulated(QTreeWidgetItem *item) const;
 
     void onNodeInserteAfter(const Model::NodeIndex& nodeIndex);
     void onNodeMoveAfter(const Model::NodeIndex& sourceNodeIndex, const Model::NodeIndex& targetNodeIndex);
     void onNodeCloneAfter(const Model::NodeIndex& sourceNodeIndex, const Model::NodeIndex& targetNodeIndex);
     void onNodeRemoveBefore(const Model::NodeIndex& nodeIndex);
+    void onNodesInserteAfter(const Model::NodeIndex& nodeIndex, int count);
+    void onNodesRemoveAfter(const Model::NodeIndex& nodeIndex, int count);
 
     void onVariantLeafChangeAfter(const Model::NodeIndex& nodeIndex);
     void onKeyLeafChangeAfter(const Model::NodeIndex& nodeIndex);
 
-    QTreeWidgetItem * widgetFromIndex(const Model::NodeIndex &nodeIndex, bool parentWidget = false);
+    QTreeWidgetItem * widgetFromIndex(const Model::NodeIndex &nodeIndex, bool parentWidget = false, bool populate = false);
     Model::NodeIndexUPtr indexFromWidget(QTreeWidgetItem *nodeWidget);
+    Model::Node nodeFromWidget(QTreeWidgetItem *nodeWidget);
 
 protected slots:
     void createTreeStructure();
     void onCurrentQNodeChanged(QTreeWidgetItem* current, QTreeWidgetItem* previous);
+    void onItemExpanded(QTreeWidgetItem* item);
+    void onItemCollapsed(QTreeWidgetItem* item);
 
 protected:
     Model::OakModel* m_model = nullptr;
+    bool m_lazy = false;
 
     // Drag & drop
     QStringList m_acceptedDropNames;
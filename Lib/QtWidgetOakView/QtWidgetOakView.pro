@@ -22,6 +22,7 @@ SOURCES += \
     OakView.cpp \
     ListView.cpp \
     TableView.cpp \
+    TableModel.cpp \
     ActionToolBar.cpp \
     ListViewNode.cpp
 
@@ -36,6 +37,7 @@ HEADERS += \
     OakView.h \
     ListView.h \
     TableView.h \
+    TableModel.h \
     ActionToolBar.h \
     ListViewNode.h
 
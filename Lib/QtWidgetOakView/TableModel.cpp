@@ -0,0 +1,410 @@
+/*
+ * OakModelView (http://oakmodelview.com/)
+ * Author: Mikkel Nøhr Løvgreen (mikkel@oakmodelview.com)
+ * ------------------------------------------------------------------------
+ * Licensed to Vilaversoftware IVS who licenses this file to you under the
+ * Apache License, Version 2.0 (the "License"); you may not use this file
+ * except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "TableModel.h"
+
+#include "NodeQuery.h"
+
+#include "../ServiceFunctions/Assert.h"
+
+#include <algorithm>
+
+
+namespace Oak::View::QtWidgets {
+
+// =============================================================================
+// (public)
+TableModel::TableModel(QObject *parent)
+    : QAbstractTableModel(parent)
+{
+
+}
+
+// =============================================================================
+// (public)
+TableModel::~TableModel()
+{
+    setOakModel(nullptr);
+}
+
+// =============================================================================
+// (public)
+void TableModel::setTableQuery(const Model::TableQuery *tableQuery)
+{
+    m_tableQuery = tableQuery;
+    reset();
+}
+
+// =============================================================================
+// (public)
+void TableModel::setOakModel(Model::OakModel *model)
+{
+    if (m_model == model) { return; }
+
+    if (m_model) {
+        // Disconnect the old model
+        m_model->notifier_rootNodeDefChanged.remove(this);
+        m_model->notifier_rootNodeDataChanged.remove(this);
+
+        m_model->notifier_nodeInserteAfter.remove(this);
+        m_model->notifier_nodeMoveAfter.remove(this);
+        m_model->notifier_nodeCloneAfter.remove(this);
+        m_model->notifier_nodeRemoveBefore.remove(this);
+        m_model->notifier_nodesInserteAfter.remove(this);
+        m_model->notifier_nodesRemoveAfter.remove(this);
+
+        m_model->notifier_leafChangeAfter.remove(this);
+        m_model->notifier_variantLeafChangeAfter.remove(this);
+    }
+
+    // Change the model
+    m_model = model;
+
+    if (m_model) {
+        // Connect the new model
+        m_model->notifier_rootNodeDefChanged.add(this, &TableModel::reset);
+        m_model->notifier_rootNodeDataChanged.add(this, &TableModel::reset);
+
+        m_model->notifier_nodeInserteAfter.add(this, &TableModel::onNodeInserteAfter);
+        m_model->notifier_nodeMoveAfter.add(this, &TableModel::onNodeMoveAfter);
+        m_model->notifier_nodeCloneAfter.add(this, &TableModel::onNodeCloneAfter);
+        m_model->notifier_nodeRemoveBefore.add(this, &TableModel::onNodeRemoveBefore);
+        m_model->notifier_nodesInserteAfter.add(this, &TableModel::onNodesChangedAfter);
+        m_model->notifier_nodesRemoveAfter.add(this, &TableModel::onNodesChangedAfter);
+
+        m_model->notifier_leafChangeAfter.add(this, &TableModel::onLeafChangeAfter);
+        m_model->notifier_variantLeafChangeAfter.add(this, &TableModel::onVariantLeafChangeAfter);
+    }
+
+    reset();
+}
+
+// =============================================================================
+// (public)
+Model::Node TableModel::rowNode(int row) const
+{
+    if (row < 0 || row >= rowCount()) { return Model::Node(); }
+    return m_rowNodes[static_cast<size_t>(row)];
+}
+
+// =============================================================================
+// (public)
+void TableModel::reset()
+{
+    beginResetModel();
+    m_rootNode = m_model ? m_model->rootNode() : Model::Node();
+    m_rowNodes.clear();
+    m_rowMap.clear();
+    readRowNodes(m_rowNodes);
+    updateHeader();
+    endResetModel();
+}
+
+// =============================================================================
+// (public)
+int TableModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid()) { return 0; }
+    return static_cast<int>(m_rowNodes.size());
+}
+
+// =============================================================================
+// (public)
+int TableModel::columnCount(const QModelIndex &parent) const
+{
+    if (parent.isValid() || m_tableQuery == nullptr) { return 0; }
+    return m_tableQuery->columnCount();
+}
+
+// =============================================================================
+// (public)
+QVariant TableModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid()) { return QVariant(); }
+    if (role != Qt::DisplayRole && role != Qt::EditRole) { return QVariant(); }
+
+    Model::Leaf leaf = m_tableQuery->leaf(rowNode(index.row()), index.column());
+    if (leaf.isNull()) { return QVariant(); }
+    return QString::fromStdString(leaf.value<std::string>());
+}
+
+// =============================================================================
+// (public)
+bool TableModel::setData(const QModelIndex &index, const QVariant &value, int role)
+{
+    if (!index.isValid() || role != Qt::EditRole) { return false; }
+
+    Model::Leaf leaf = m_tableQuery->leaf(rowNode(index.row()), index.column());
+    if (leaf.isNull()) { return false; }
+
+    // The view is updated when the model notifies about the change
+    return leaf.setValue(value.toString().toStdString());
+}
+
+// =============================================================================
+// (public)
+QVariant TableModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation == Qt::Horizontal && role == Qt::DisplayRole &&
+        section >= 0 && section < m_headerList.count()) {
+        return m_headerList.at(section);
+    }
+    return QAbstractTableModel::headerData(section, orientation, role);
+}
+
+// =============================================================================
+// (public)
+Qt::ItemFlags TableModel::flags(const QModelIndex &index) const
+{
+    if (!index.isValid()) { return Qt::NoItemFlags; }
+
+    Qt::ItemFlags flags = QAbstractTableModel::flags(index);
+    if (!m_tableQuery->leaf(rowNode(index.row()), index.column()).isNull()) {
+        flags |= Qt::ItemIsEditable;
+    }
+    return flags;
+}
+
+// =============================================================================
+// (protected)
+void TableModel::readRowNodes(std::vector<Model::Node> &rowNodes) const
+{
+    if (m_tableQuery == nullptr || !m_tableQuery->hasNodeQuery() || m_rootNode.isNull()) { return; }
+
+    auto it = m_tableQuery->nodeQuery().iterator(m_rootNode);
+    while (it->next()) {
+        rowNodes.push_back(it->node());
+    }
+}
+
+// =============================================================================
+// (protected)
+// Compares the row nodes with the ones found by the query now and reports
+//  the rows in between the equal beginning and end as removed and inserted
+//  (Or as moved if one row has moved)
+void TableModel::updateRows()
+{
+    std::vector<Model::Node> rowNodes;
+    rowNodes.reserve(m_rowNodes.size() + 1);
+    readRowNodes(rowNodes);
+
+    const int oldCount = static_cast<int>(m_rowNodes.size());
+    const int newCount = static_cast<int>(rowNodes.size());
+
+    int first = 0;
+    while (first < oldCount && first < newCount &&
+           m_rowNodes[static_cast<size_t>(first)] == rowNodes[static_cast<size_t>(first)]) {
+        first++;
+    }
+    int oldLast = oldCount - 1;
+    int newLast = newCount - 1;
+    while (oldLast >= first && newLast >= first &&
+           m_rowNodes[static_cast<size_t>(oldLast)] == rowNodes[static_cast<size_t>(newLast)]) {
+        oldLast--;
+        newLast--;
+    }
+
+    if (oldLast < first && newLast < first) { return; }
+    m_rowMap.clear();
+
+    auto oldBegin = m_rowNodes.begin() + first;
+    auto oldEnd = m_rowNodes.begin() + oldLast + 1;
+    auto newBegin = rowNodes.begin() + first;
+    auto newEnd = rowNodes.begin() + newLast + 1;
+
+    if (oldLast == newLast && oldLast > first) {
+        if (*oldBegin == *(newEnd - 1) && std::equal(oldBegin + 1, oldEnd, newBegin)) {
+            // The first row has moved to the end
+            beginMoveRows(QModelIndex(), first, first, QModelIndex(), oldLast + 1);
+            m_rowNodes.swap(rowNodes);
+            endMoveRows();
+            updateHeader(true);
+            return;
+        }
+        if (*(oldEnd - 1) == *newBegin && std::equal(oldBegin, oldEnd - 1, newBegin + 1)) {
+            // The last row has moved to the beginning
+            beginMoveRows(QModelIndex(), oldLast, oldLast, QModelIndex(), first);
+            m_rowNodes.swap(rowNodes);
+            endMoveRows();
+            updateHeader(true);
+            return;
+        }
+    }
+
+    if (oldLast >= first) {
+        beginRemoveRows(QModelIndex(), first, oldLast);
+        m_rowNodes.erase(oldBegin, oldEnd);
+        endRemoveRows();
+    }
+    if (newLast >= first) {
+        beginInsertRows(QModelIndex(), first, newLast);
+        m_rowNodes.insert(m_rowNodes.begin() + first, newBegin, newEnd);
+        endInsertRows();
+    }
+    updateHeader(true);
+}
+
+// =============================================================================
+// (protected)
+// The header names are the display names of the leafs of the first row
+void TableModel::updateHeader(bool notify)
+{
+    QStringList headerList;
+    if (!m_rowNodes.empty()) {
+        for (int column = 0; column < columnCount(); column++)
+        {
+            Model::Leaf leaf = m_tableQuery->leaf(m_rowNodes.front(), column);
+            headerList.append(leaf.isNull() ? QString() : QString::fromStdString(leaf.displayName()));
+        }
+    }
+    if (headerList == m_headerList) { return; }
+
+    m_headerList = headerList;
+    if (notify && columnCount() > 0) {
+        emit headerDataChanged(Qt::Horizontal, 0, columnCount() - 1);
+    }
+}
+
+// =============================================================================
+// (protected)
+// Returns the row of the node or of the closest parent that is a row node
+int TableModel::findRow(const Model::Node &node) const
+{
+    if (m_rowMap.empty()) {
+        m_rowMap.reserve(m_rowNodes.size());
+        for (size_t i = 0; i < m_rowNodes.size(); i++)
+        {
+            m_rowMap[m_rowNodes[i].nodeData().internalPtr()] = static_cast<int>(i);
+        }
+    }
+
+    Model::Node n = node;
+    while (!n.isNull()) {
+        auto it = m_rowMap.find(n.nodeData().internalPtr());
+        if (it != m_rowMap.end()) { return it->second; }
+        if (n == m_rootNode) { break; }
+        n = n.parent();
+    }
+    return -1;
+}
+
+// =============================================================================
+// (protected)
+// Returns true if 'node' is 'parentNode' or a node below it
+bool TableModel::isInside(const Model::Node &node, const Model::Node &parentNode) const
+{
+    Model::Node n = node;
+    while (!n.isNull()) {
+        if (n.nodeData() == parentNode.nodeData()) { return true; }
+        if (n == m_rootNode) { return false; }
+        n = n.parent();
+    }
+    return false;
+}
+
+// =============================================================================
+// (protected)
+void TableModel::onNodeInserteAfter(const Model::NodeIndex &nodeIndex)
+{
+    Q_UNUSED(nodeIndex)
+    updateRows();
+}
+
+// =============================================================================
+// (protected)
+void TableModel::onNodeMoveAfter(const Model::NodeIndex &sourceNodeIndex, const Model::NodeIndex &targetNodeIndex)
+{
+    Q_UNUSED(sourceNodeIndex)
+    Q_UNUSED(targetNodeIndex)
+    updateRows();
+}
+
+// =============================================================================
+// (protected)
+void TableModel::onNodeCloneAfter(const Model::NodeIndex &sourceNodeIndex, const Model::NodeIndex &targetNodeIndex)
+{
+    Q_UNUSED(sourceNodeIndex)
+    Q_UNUSED(targetNodeIndex)
+    updateRows();
+}
+
+// =============================================================================
+// (protected)
+// The rows of the removed node and the nodes below it are found while the
+//  nodes still exist, so they are never compared after they are removed.
+//  This is also done while batching, so the diff in onNodesChangedAfter()
+//  only sees nodes that exist
+void TableModel::onNodeRemoveBefore(const Model::NodeIndex &nodeIndex)
+{
+    if (m_rowNodes.empty()) { return; }
+
+    Model::Node removeNode = nodeIndex.node(m_rootNode);
+    if (removeNode.isNull()) { return; }
+
+    // Each run of rows is removed from the end, so the rows before it keep their index
+    int row = rowCount() - 1;
+    while (row >= 0) {
+        int last = row;
+        while (row >= 0 && isInside(m_rowNodes[static_cast<size_t>(row)], removeNode)) { row--; }
+        if (row < last) {
+            m_rowMap.clear();
+            beginRemoveRows(QModelIndex(), row + 1, last);
+            m_rowNodes.erase(m_rowNodes.begin() + row + 1, m_rowNodes.begin() + last + 1);
+            endRemoveRows();
+        }
+        row--;
+    }
+    updateHeader(true);
+}
+
+// =============================================================================
+// (protected)
+void TableModel::onNodesChangedAfter(const Model::NodeIndex &nodeIndex, int count)
+{
+    Q_UNUSED(nodeIndex)
+    Q_UNUSED(count)
+    updateRows();
+}
+
+// =============================================================================
+// (protected)
+void TableModel::onLeafChangeAfter(const Model::NodeIndex &nodeIndex, const std::string &valueName)
+{
+    Q_UNUSED(valueName)
+    if (m_rowNodes.empty() || columnCount() == 0) { return; }
+
+    int row = findRow(nodeIndex.node(m_rootNode));
+    if (row == -1) {
+        // The leaf is not on or below a row node but it can still be found
+        //  by the leaf queries. Only the visible cells are read again
+        emit dataChanged(index(0, 0), index(rowCount() - 1, columnCount() - 1));
+    } else {
+        emit dataChanged(index(row, 0), index(row, columnCount() - 1));
+    }
+}
+
+// =============================================================================
+// (protected)
+// The node definition of the node changes, which can change if it is found by the query
+void TableModel::onVariantLeafChangeAfter(const Model::NodeIndex &nodeIndex)
+{
+    Q_UNUSED(nodeIndex)
+    updateRows();
+}
+
+} // namespace Oak::View::QtWidgets
@@ -0,0 +1,94 @@
+/*
+ * OakModelView (http://oakmodelview.com/)
+ * Author: Mikkel Nøhr Løvgreen (mikkel@oakmodelview.com)
+ * ------------------------------------------------------------------------
+ * Licensed to Vilaversoftware IVS who licenses this file to you under the
+ * Apache License, Version 2.0 (the "License"); you may not use this file
+ * except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <QAbstractTableModel>
+
+#include <unordered_map>
+
+#include "OakModel.h"
+#include "TableQuery.h"
+
+
+namespace Oak::View::QtWidgets {
+
+// =============================================================================
+// Class definition
+// =============================================================================
+// Rows are the nodes found by the node query of the table query and columns
+//  are its leaf queries. Only the row nodes are kept, the cell values are
+//  read when the view asks for them, which is only done for visible cells.
+//  Changes to the model are compared with the kept row nodes, so views only
+//  get the rows that are inserted, removed, moved or changed. The rows of a
+//  removed node are taken out before it is removed, so the kept row nodes
+//  never refer to removed data
+class TableModel : public QAbstractTableModel
+{
+    Q_OBJECT
+public:
+    TableModel(QObject *parent = nullptr);
+    virtual ~TableModel() override;
+
+    // The table query is owned by the caller
+    void setTableQuery(const Model::TableQuery *tableQuery);
+    void setOakModel(Model::OakModel* model);
+
+    const Model::Node &rootNode() const { return m_rootNode; }
+    Model::Node rowNode(int row) const;
+
+    // Reads the row nodes and header names again
+    void reset();
+
+    virtual int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    virtual int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+
+    virtual QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    virtual bool setData(const QModelIndex &index, const QVariant &value, int role = Qt::EditRole) override;
+    virtual QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+    virtual Qt::ItemFlags flags(const QModelIndex &index) const override;
+
+protected:
+    void readRowNodes(std::vector<Model::Node> &rowNodes) const;
+    void updateRows();
+    void updateHeader(bool notify = false);
+    int findRow(const Model::Node &node) const;
+    bool isInside(const Model::Node &node, const Model::Node &parentNode) const;
+
+    void onNodeInserteAfter(const Model::NodeIndex &nodeIndex);
+    void onNodeMoveAfter(const Model::NodeIndex &sourceNodeIndex, const Model::NodeIndex &targetNodeIndex);
+    void onNodeCloneAfter(const Model::NodeIndex &sourceNodeIndex, const Model::NodeIndex &targetNodeIndex);
+    void onNodeRemoveBefore(const Model::NodeIndex &nodeIndex);
+    void onNodesChangedAfter(const Model::NodeIndex &nodeIndex, int count);
+    void onLeafChangeAfter(const Model::NodeIndex &nodeIndex, const std::string &valueName);
+    void onVariantLeafChangeAfter(const Model::NodeIndex &nodeIndex);
+
+protected:
+    Model::OakModel * m_model = nullptr;
+    const Model::TableQuery * m_tableQuery = nullptr;
+    Model::Node m_rootNode;
+
+    std::vector<Model::Node> m_rowNodes;
+    QStringList m_headerList;
+
+    // The row of each row node by its internal pointer. Build when it is
+    //  first needed after the rows are changed
+    mutable std::unordered_map<void *, int> m_rowMap;
+};
+
+} // namespace Oak::View::QtWidgets
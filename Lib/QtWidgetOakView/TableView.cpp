@@ -35,8 +35,13 @@ TableView::TableView(QWidget *parent)
 {
     setMouseTracking(true);
 
-    m_tableWidget = new QTableWidget();
-    m_tableWidget->setStyleSheet(
+    m_tableModel = new TableModel(this);
+    m_tableModel->setTableQuery(&m_tableQuery);
+
+    m_tableView = new QTableView();
+    m_tableView->setModel(m_tableModel);
+    m_tableView->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+    m_tableView->setStyleSheet(
         "QHeaderView::section {"
         "    background-color: #dddddd;"
         "    padding: 4px;"
@@ -111,19 +116,19 @@ TableView::TableView(QWidget *parent)
 
     QHBoxLayout * layout = new QHBoxLayout();
     layout->setMargin(0);
-    layout->addWidget(m_tableWidget);
+    layout->addWidget(m_tableView);
     layout->addWidget(m_toolBar);
     setLayout(layout);
 
-    connect(m_tableWidget, SIGNAL(nodeSelectionChanged()), this, SLOT(onSelectionChanged()));
-    connect(m_tableWidget, SIGNAL(nodeChanged(QTableWidgetItem *)), this, SLOT(onNodeChanged(QTableWidgetItem*)));
+    connect(m_tableView->selectionModel(), SIGNAL(selectionChanged(QItemSelection, QItemSelection)), this, SLOT(onSelectionChanged()));
+    connect(m_tableModel, SIGNAL(modelReset()), this, SLOT(onModelReset()));
 }
 
 // =============================================================================
 // (public)
 TableView::~TableView()
 {
-
+    m_tableModel->setOakModel(nullptr);
 }
 
 // =============================================================================
@@ -132,7 +137,6 @@ void TableView::setBaseRef(Model::NodeQueryUPtr baseRef)
 {
     m_tableQuery.setNodeQuery(std::move(baseRef));
     updateTable();
-
 }
 
 // =============================================================================
@@ -147,43 +151,7 @@ void TableView::addValueRef(Model::LeafQuerySPtr valueRef)
 // (public)
 void TableView::updateTable()
 {
-    m_tableWidget->clearContents();
-    disableAllActions();
-
-    if (m_model == nullptr) { return; }
-    if (m_model->rootNode().isNull()) { return; }
-
-    m_rootNode = m_model->rootNode();
-
-    int rowCount = m_tableQuery.count(m_rootNode);
-    int columnCount = m_tableQuery.columnCount();
-
-    m_tableWidget->blockSignals(true);
-    m_tableWidget->setRowCount(rowCount);
-    m_tableWidget->setColumnCount(columnCount);
-    int row = 0;
-
-    auto it = m_tableQuery.iterator(m_rootNode);
-    while (it->next()) {
-        // Add Table Header
-        if (row == 0) {
-            for (int column = 0; column < columnCount; column++)
-            {
-                m_tableWidget->setHorizontalHeaderItem(column, new QTableWidgetItem(QString::fromStdString(it->leaf(column).displayName())));
-            }
-            m_tableWidget->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
-        }
-        // Add table values
-        for (int column = 0; column < columnCount; column++)
-        {
-            std::string value = it->value<std::string>(column);
-            QTableWidgetItem *node = new QTableWidgetItem(QString::fromStdString(value));
-            m_tableWidget->setItem(row, column, node);
-        }
-        row++;
-    }
-    m_tableWidget->blockSignals(false);
-    updateAllActions();
+    m_tableModel->reset();
 }
 
 // =============================================================================
@@ -192,38 +160,9 @@ void TableView::setOakModel(Model::OakModel *model)
 {
     if (m_model == model) { return; }
 
-    if (m_model) {
-        // Disconnect the old model
-//        m_model->notifier_currentNodeChanged.remove(this);
-        m_model->notifier_rootNodeDefChanged.remove(this);
-        m_model->notifier_rootNodeDataChanged.remove(this);
-//        m_model->notifier_destroyed.remove(this);
-
-        m_model->notifier_nodeInserteAfter.remove(this);
-        m_model->notifier_nodeMoveAfter.remove(this);
-        m_model->notifier_nodeCloneAfter.remove(this);
-        m_model->notifier_nodeRemoveAfter.remove(this);
-
-        m_model->notifier_leafChangeAfter.remove(this);
-    }
-
     // Change the model
     m_model = model;
-
-    if (m_model) {
-        // connect the new mobel
-//        m_model->notifier_currentNodeChanged.add(this, &TableView::currentNodeChanged);
-        m_model->notifier_rootNodeDefChanged.add(this, &TableView::updateTable);
-        m_model->notifier_rootNodeDataChanged.add(this, &TableView::updateTable);
-//        m_model->notifier_destroyed.add(this, &ListView::modelDestroyed);
-
-        m_model->notifier_nodeInserteAfter.add(this, &TableView::onNodeInserteAfter);
-        m_model->notifier_nodeMoveAfter.add(this, &TableView::onNodeMoveAfter);
-        m_model->notifier_nodeCloneAfter.add(this, &TableView::onNodeCloneAfter);
-        m_model->notifier_nodeRemoveBefore.add(this, &TableView::onNodeRemoveBefore);
-
-        m_model->notifier_leafChangeAfter.add(this, &TableView::onEntryChangeAfter);
-    }
+    m_tableModel->setOakModel(m_model);
 }
 
 // =============================================================================
@@ -233,12 +172,22 @@ void TableView::onSelectionChanged()
     updateAllActions();
 }
 
+// =============================================================================
+// (protected slots)
+void TableView::onModelReset()
+{
+    if (m_tableModel->rootNode().isNull()) {
+        disableAllActions();
+    } else {
+        updateAllActions();
+    }
+}
+
 // =============================================================================
 // (protected slots)
 void TableView::onActionAdd()
 {
-    m_tableQuery.nodeQuery().insertNode(m_rootNode, -1);
-    updateTable();
+    m_tableQuery.nodeQuery().insertNode(m_tableModel->rootNode(), -1);
 }
 
 // =============================================================================
@@ -247,8 +196,7 @@ void TableView::onActionDelete()
 {
     QList<int> rows = selectedRows();
     if (rows.empty()) { return; }
-    m_tableQuery.nodeQuery().removeNode(m_rootNode, rows.first());
-    updateTable();
+    m_tableQuery.nodeQuery().removeNode(m_tableModel->rootNode(), rows.first());
 }
 
 // =============================================================================
@@ -286,64 +234,6 @@ void TableView::onActionPaste()
 
 }
 
-// =============================================================================
-// (protected slots)
-void TableView::onNodeChanged(QTableWidgetItem *node)
-{
-    int row = 0;
-    auto it = m_tableQuery.iterator(m_rootNode);
-    while (it->next()) {
-        if (row == node->row()) {
-            auto leaf = it->leaf(node->column());
-            if (!leaf.setValue(node->text().toStdString())) {
-                m_tableWidget->blockSignals(true);
-                node->setText(QString::fromStdString(leaf.value<std::string>(node->column())));
-                m_tableWidget->blockSignals(false);
-            }
-            return;
-        }
-        row++;
-    }
-}
-
-// =============================================================================
-// (protected)
-void TableView::onNodeInserteAfter(const Model::NodeIndex &nodeIndex)
-{
-    Q_UNUSED(nodeIndex)
-}
-
-// =============================================================================
-// (protected)
-void TableView::onNodeMoveAfter(const Model::NodeIndex &sourceNodeIndex, const Model::NodeIndex &targetNodeIndex)
-{
-    Q_UNUSED(sourceNodeIndex)
-    Q_UNUSED(targetNodeIndex)
-}
-
-// =============================================================================
-// (protected)
-void TableView::onNodeCloneAfter(const Model::NodeIndex &sourceNodeIndex, const Model::NodeIndex &targetNodeIndex)
-{
-    Q_UNUSED(sourceNodeIndex)
-    Q_UNUSED(targetNodeIndex)
-}
-
-// =============================================================================
-// (protected)
-void TableView::onNodeRemoveBefore(const Model::NodeIndex &nodeIndex)
-{
-    Q_UNUSED(nodeIndex)
-}
-
-// =============================================================================
-// (protected)
-void TableView::onEntryChangeAfter(const Model::NodeIndex &nodeIndex, const std::string &valueName)
-{
-    Q_UNUSED(nodeIndex)
-    Q_UNUSED(valueName)
-}
-
 // =============================================================================
 // (protected)
 bool TableView::event(QEvent *event)
@@ -385,9 +275,9 @@ void TableView::updateAllActions()
         m_actionCut->setEnabled(false);
         m_actionCopy->setEnabled(false);
     } else {
-        m_actionDelete->setEnabled(m_tableQuery.nodeQuery().canRemoveNode(m_rootNode, rows.first()));
+        m_actionDelete->setEnabled(m_tableQuery.nodeQuery().canRemoveNode(m_tableModel->rootNode(), rows.first()));
         m_actionUp->setDisabled(rows.contains(0));
-        m_actionDown->setDisabled(rows.contains(m_tableWidget->rowCount()-1));
+        m_actionDown->setDisabled(rows.contains(m_tableModel->rowCount()-1));
         m_actionCut->setEnabled(true);
         m_actionCopy->setEnabled(true);
     }
@@ -400,11 +290,11 @@ void TableView::updateAllActions()
 QList<int> TableView::selectedRows() const
 {
     QList<int> list;
-    QList<QTableWidgetItem*> selectedItems = m_tableWidget->selectedItems();
-    for (QTableWidgetItem *node: selectedItems)
+    const QModelIndexList selectedIndexes = m_tableView->selectionModel()->selectedIndexes();
+    for (const QModelIndex &index: selectedIndexes)
     {
-        if (!list.contains(node->row())) {
-            list.push_back(node->row());
+        if (!list.contains(index.row())) {
+            list.push_back(index.row());
         }
     }
     return list;
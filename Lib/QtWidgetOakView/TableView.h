@@ -18,11 +18,12 @@
 
 #pragma once
 
-#include <QTableWidget>
+#include <QTableView>
 #include <QToolBar>
 
 #include "OakModel.h"
 #include "TableQuery.h"
+#include "TableModel.h"
 
 
 namespace Oak::View::QtWidgets {
@@ -40,12 +41,14 @@ public:
     void setBaseRef(Model::NodeQueryUPtr baseRef);
     void addValueRef(Model::LeafQuerySPtr valueRef);
 
+    // Reads all the rows again (Changes made to the model are found without it)
     void updateTable();
 
     void setOakModel(Model::OakModel* model);
 
 protected slots:
     void onSelectionChanged();
+    void onModelReset();
 
     void onActionAdd();
     void onActionDelete();
@@ -55,15 +58,7 @@ protected slots:
     void onActionCopy();
     void onActionPaste();
 
-    void onNodeChanged(QTableWidgetItem *node);
-
 protected:
-    void onNodeInserteAfter(const Model::NodeIndex &nodeIndex);
-    void onNodeMoveAfter(const Model::NodeIndex &sourceNodeIndex, const Model::NodeIndex &targetNodeIndex);
-    void onNodeCloneAfter(const Model::NodeIndex &sourceNodeIndex, const Model::NodeIndex &targetNodeIndex);
-    void onNodeRemoveBefore(const Model::NodeIndex& tNodeIndex);
-    void onEntryChangeAfter(const Model::NodeIndex &nodeIndex, const std::string &valueName);
-
     virtual bool event(QEvent *event) override;
 
     void disableAllActions();
@@ -73,11 +68,11 @@ protected:
 
 protected:
     Model::OakModel * m_model = nullptr;
-    Model::Node m_rootNode;
 
     Model::TableQuery m_tableQuery;
 
-    QTableWidget *m_tableWidget;
+    TableModel *m_tableModel;
+    QTableView *m_tableView;
     QToolBar *m_toolBar;
 
     QAction * m_actionAdd;
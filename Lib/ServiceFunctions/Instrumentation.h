@@ -0,0 +1,343 @@
+/*
+ * OakModelView (http://oakmodelview.com/)
+ * Author: Mikkel Nøhr Løvgreen (mikkel@oakmodelview.com)
+ * ------------------------------------------------------------------------
+ * Licensed to Vilaversoftware IVS who licenses this file to you under the
+ * Apache License, Version 2.0 (the "License"); you may not use this file
+ * except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Counters and scoped timers for the hot paths of the model.
+// The hooks are only compiled in when OAK_INSTRUMENTATION is defined (See
+//  Configure.pri), otherwise OAK_COUNT(), OAK_COUNT_IF() and OAK_SCOPED_TIMER()
+//  expand to nothing. The functions that read, reset and export the results
+//  are always available and report zeros when the hooks are compiled out.
+//
+// Counters are shared atomics. Each thread that runs a scoped timer gets a
+//  ring buffer that keeps its last 'eventCapacity' timer events, the totals
+//  of each timer are kept for all the events.
+
+namespace Oak::Instrumentation {
+
+enum class Counter
+{
+    SiblingScanStep = 0,    // XML::Element::nextSibling() and previousSibling()
+    FindNodeDef,            // OakModel::findNodeDef()
+    NodeIndexAllocation,    // NodeIndex objects created
+    Conversion,             // UnionRef::get() into another type
+    Notification,           // Callback::trigger()
+    Count
+};
+
+inline const char *counterName(Counter counter)
+{
+    static const char *nameList[] = {
+        "siblingScanSteps",
+        "findNodeDefCalls",
+        "nodeIndexAllocations",
+        "conversions",
+        "notifications"
+    };
+    return nameList[static_cast<int>(counter)];
+}
+
+// One cache line for each counter, so threads counting different things do not share it
+struct alignas(64) CounterSlot
+{
+    std::atomic<unsigned long long> value{0};
+};
+
+inline CounterSlot s_counterList[static_cast<int>(Counter::Count)];
+
+inline void count(Counter counter, unsigned long long n = 1)
+{
+    s_counterList[static_cast<int>(counter)].value.fetch_add(n, std::memory_order_relaxed);
+}
+
+inline unsigned long long counterValue(Counter counter)
+{
+    return s_counterList[static_cast<int>(counter)].value.load(std::memory_order_relaxed);
+}
+
+// Nanoseconds since the first call
+inline long long now()
+{
+    static const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+// =============================================================================
+// Class definition
+// =============================================================================
+struct TimerEvent
+{
+    const char *name;
+    long long start;    // ns
+    long long duration; // ns
+};
+
+struct TimerStats
+{
+    unsigned long long count = 0;
+    long long total = 0; // ns
+    long long max = 0;   // ns
+};
+
+// =============================================================================
+// Class definition
+// =============================================================================
+class ThreadBuffer
+{
+public:
+    static const size_t eventCapacity = 4096;
+
+    ThreadBuffer(int threadId)
+        : m_threadId(threadId)
+    {
+    }
+
+    int threadId() const { return m_threadId; }
+
+    void add(const char *name, long long start, long long duration)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        TimerEvent event{name, start, duration};
+        if (m_eventList.size() < eventCapacity) {
+            m_eventList.push_back(event);
+        } else {
+            m_eventList[m_nextEvent] = event;
+        }
+        m_nextEvent = (m_nextEvent + 1) % eventCapacity;
+
+        TimerStats &stats = m_statsMap[name];
+        stats.count++;
+        stats.total += duration;
+        if (duration > stats.max) { stats.max = duration; }
+    }
+
+    // Returns the events in the buffer, the oldest first
+    std::vector<TimerEvent> eventList() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_eventList.size() < eventCapacity) { return m_eventList; }
+        std::vector<TimerEvent> list(m_eventList.begin() + static_cast<std::ptrdiff_t>(m_nextEvent), m_eventList.end());
+        list.insert(list.end(), m_eventList.begin(), m_eventList.begin() + static_cast<std::ptrdiff_t>(m_nextEvent));
+        return list;
+    }
+
+    void addStats(std::unordered_map<std::string, TimerStats> &statsMap) const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (const auto &item: m_statsMap) {
+            TimerStats &stats = statsMap[item.first];
+            stats.count += item.second.count;
+            stats.total += item.second.total;
+            if (item.second.max > stats.max) { stats.max = item.second.max; }
+        }
+    }
+
+    void clear()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_eventList.clear();
+        m_nextEvent = 0;
+        m_statsMap.clear();
+    }
+
+protected:
+    mutable std::mutex m_mutex;
+    int m_threadId;
+    std::vector<TimerEvent> m_eventList;
+    size_t m_nextEvent = 0;
+    // The names are string literals so the pointer identifies the timer
+    std::unordered_map<const char *, TimerStats> m_statsMap;
+};
+
+// =============================================================================
+// Class definition
+// =============================================================================
+// Keeps the buffers of all the threads that have run a timer. A buffer lives
+//  on after its thread has ended, so its events can still be exported
+class ThreadBufferRegistry
+{
+public:
+    static ThreadBufferRegistry &instance()
+    {
+        static ThreadBufferRegistry registry;
+        return registry;
+    }
+
+    ThreadBuffer *create()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_bufferList.push_back(std::make_shared<ThreadBuffer>(static_cast<int>(m_bufferList.size()) + 1));
+        return m_bufferList.back().get();
+    }
+
+    std::vector<std::shared_ptr<ThreadBuffer>> bufferList() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_bufferList;
+    }
+
+protected:
+    mutable std::mutex m_mutex;
+    std::vector<std::shared_ptr<ThreadBuffer>> m_bufferList;
+};
+
+inline ThreadBuffer &threadBuffer()
+{
+    thread_local ThreadBuffer *buffer = ThreadBufferRegistry::instance().create();
+    return *buffer;
+}
+
+// =============================================================================
+// Class definition
+// =============================================================================
+// Records the time from construction to destruction in the buffer of the
+//  thread. 'name' must be a string literal
+class ScopedTimer
+{
+public:
+    ScopedTimer(const char *name)
+        : m_name(name),
+          m_start(now())
+    {
+    }
+
+    ~ScopedTimer()
+    {
+        threadBuffer().add(m_name, m_start, now() - m_start);
+    }
+
+    ScopedTimer(const ScopedTimer &copy) = delete;
+    ScopedTimer& operator=(const ScopedTimer &copy) = delete;
+
+protected:
+    const char *m_name;
+    long long m_start;
+};
+
+// =============================================================================
+// (Service functions)
+inline std::unordered_map<std::string, TimerStats> timerStats()
+{
+    std::unordered_map<std::string, TimerStats> statsMap;
+    for (const auto &buffer: ThreadBufferRegistry::instance().bufferList()) {
+        buffer->addStats(statsMap);
+    }
+    return statsMap;
+}
+
+// =============================================================================
+// (Service functions)
+inline void reset()
+{
+    for (CounterSlot &slot: s_counterList) {
+        slot.value.store(0, std::memory_order_relaxed);
+    }
+    for (const auto &buffer: ThreadBufferRegistry::instance().bufferList()) {
+        buffer->clear();
+    }
+}
+
+// =============================================================================
+// (Service functions)
+inline std::string jsonString(const std::string &str)
+{
+    std::string result = "\"";
+    for (char c: str) {
+        if (c == '"' || c == '\\') { result += '\\'; }
+        result += c;
+    }
+    result += '"';
+    return result;
+}
+
+// =============================================================================
+// (Service functions)
+// Writes the counters and the totals of each timer as JSON. Times are in microseconds
+inline void writeStatsJson(std::ostream &os)
+{
+    os << "{\n  \"counters\": {";
+    for (int i = 0; i < static_cast<int>(Counter::Count); i++) {
+        Counter counter = static_cast<Counter>(i);
+        os << (i == 0 ? "\n" : ",\n") << "    " << jsonString(counterName(counter)) << ": " << counterValue(counter);
+    }
+    os << "\n  },\n  \"timers\": {";
+    bool first = true;
+    os << std::fixed << std::setprecision(3);
+    for (const auto &item: timerStats()) {
+        const TimerStats &stats = item.second;
+        os << (first ? "\n" : ",\n") << "    " << jsonString(item.first) << ": {"
+           << "\"count\": " << stats.count
+           << ", \"total_us\": " << stats.total / 1000.0
+           << ", \"mean_us\": " << (stats.count > 0 ? stats.total / 1000.0 / static_cast<double>(stats.count) : 0.0)
+           << ", \"max_us\": " << stats.max / 1000.0 << "}";
+        first = false;
+    }
+    os << "\n  }\n}\n";
+}
+
+// =============================================================================
+// (Service functions)
+// Writes the timer events in the buffers in the Chrome trace event format, that
+//  can be opened in chrome://tracing or Perfetto. The counters are added as one
+//  counter event at the time of the export
+inline void writeChromeTrace(std::ostream &os)
+{
+    os << "{\n  \"displayTimeUnit\": \"ms\",\n  \"traceEvents\": [";
+    os << std::fixed << std::setprecision(3);
+    bool first = true;
+    for (const auto &buffer: ThreadBufferRegistry::instance().bufferList()) {
+        for (const TimerEvent &event: buffer->eventList()) {
+            os << (first ? "\n" : ",\n") << "    {\"name\": " << jsonString(event.name)
+               << ", \"cat\": \"oak\", \"ph\": \"X\", \"pid\": 1, \"tid\": " << buffer->threadId()
+               << ", \"ts\": " << event.start / 1000.0
+               << ", \"dur\": " << event.duration / 1000.0 << "}";
+            first = false;
+        }
+    }
+    os << (first ? "\n" : ",\n") << "    {\"name\": \"counters\", \"ph\": \"C\", \"pid\": 1, \"tid\": 0, \"ts\": " << now() / 1000.0 << ", \"args\": {";
+    for (int i = 0; i < static_cast<int>(Counter::Count); i++) {
+        Counter counter = static_cast<Counter>(i);
+        os << (i == 0 ? "" : ", ") << jsonString(counterName(counter)) << ": " << counterValue(counter);
+    }
+    os << "}}\n  ]\n}\n";
+}
+
+} // namespace Oak::Instrumentation
+
+#define OAK_INSTRUMENTATION_CONCAT_(a, b) a##b
+#define OAK_INSTRUMENTATION_CONCAT(a, b) OAK_INSTRUMENTATION_CONCAT_(a, b)
+
+#ifdef OAK_INSTRUMENTATION
+#define OAK_COUNT(counter) Oak::Instrumentation::count(Oak::Instrumentation::Counter::counter)
+#define OAK_COUNT_IF(counter, condition) do { if (condition) { OAK_COUNT(counter); } } while (false)
+#define OAK_SCOPED_TIMER(name) Oak::Instrumentation::ScopedTimer OAK_INSTRUMENTATION_CONCAT(oakScopedTimer, __LINE__)(name)
+#else
+#define OAK_COUNT(counter) ((void)0)
+#define OAK_COUNT_IF(counter, condition) ((void)0)
+#define OAK_SCOPED_TIMER(name) ((void)0)
+#endif
@@ -24,7 +24,14 @@ HEADERS += \
     Test_NodeDefinition.h \
     Test_ValueDefinition.h \
     Test_ItemQuery.h \
-    Test_Union.h
+    Test_Node.h \
+    Test_Batch.h \
+    Test_OptionsIndex.h \
+    Test_UndoJournal.h \
+    Test_Parallel.h \
+    Test_Union.h \
+    Test_DateTime.h \
+    Test_FenwickTree.h
 
 win32:QMAKE_CXXFLAGS_EXCEPTIONS_ON = /EHa
 win32:QMAKE_CXXFLAGS_STL_ON = /EHa
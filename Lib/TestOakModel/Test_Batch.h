@@ -0,0 +1,195 @@
+/*
+ * OakModelView (http://oakmodelview.com/)
+ * Author: Mikkel Nøhr Løvgreen (mikkel@oakmodelview.com)
+ * ------------------------------------------------------------------------
+ * Licensed to Vilaversoftware IVS who licenses this file to you under the
+ * Apache License, Version 2.0 (the "License"); you may not use this file
+ * except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <boost/test/included/unit_test.hpp>
+using boost::unit_test_framework::test_suite;
+
+#ifdef XML_BACKEND
+
+#include "OakModel.h"
+#include "NodeDefBuilder.h"
+#include "ContainerDefBuilder.h"
+#include "LeafDefBuilder.h"
+#include "Leaf.h"
+
+using namespace Oak::Model;
+
+// Keeps a copy of the item ids that is only updated from the reported changes
+struct BatchReplica
+{
+    OakModel *model = nullptr;
+    std::vector<int> idList;
+    std::vector<int> changedIdList;
+
+    int idAt(const NodeIndex &nodeIndex, int offset = 0) const
+    {
+        Node node = nodeIndex.nodeParent(model->rootNode()).childAt("item", nodeIndex.lastNodeIndex().index() + offset);
+        return node.isNull() ? -1 : node.leaf("id").value<int>();
+    }
+
+    void onNodesInserteAfter(const NodeIndex &nodeIndex, int count)
+    {
+        int index = nodeIndex.lastNodeIndex().index();
+        for (int i = 0; i < count; i++)
+        {
+            idList.insert(idList.begin() + index + i, idAt(nodeIndex, i));
+        }
+    }
+
+    void onNodesRemoveAfter(const NodeIndex &nodeIndex, int count)
+    {
+        auto it = idList.begin() + nodeIndex.lastNodeIndex().index();
+        idList.erase(it, it + count);
+    }
+
+    void onNodeMoveAfter(const NodeIndex &sourceNodeIndex, const NodeIndex &targetNodeIndex)
+    {
+        idList.erase(idList.begin() + sourceNodeIndex.lastNodeIndex().index());
+        idList.insert(idList.begin() + targetNodeIndex.lastNodeIndex().index(), idAt(targetNodeIndex));
+    }
+
+    void onLeafChangeAfter(const NodeIndex &nodeIndex, const std::string &valueName)
+    {
+        BOOST_CHECK(valueName == "id");
+        int id = idAt(nodeIndex);
+        idList[static_cast<size_t>(nodeIndex.lastNodeIndex().index())] = id;
+        changedIdList.push_back(id);
+    }
+};
+
+OakModel *createBatchModel()
+{
+    auto item = NodeDefBuilder::create("item")
+        ->addLeafDef(LeafDefBuilder::create(UnionType::Integer, "id"));
+    auto root = NodeDefBuilder::create("model")
+        ->addContainerDef(ContainerDefBuilder::create(item));
+
+    OakModel *model = new OakModel();
+    model->setRootNodeDef(root->get());
+    model->createNewRootDocument(NodeData::Type::XML);
+    return model;
+}
+
+Node insertBatchItem(const OakModel *model, int index, int id)
+{
+    Node node = model->rootNode().insertChild("item", index);
+    node.leaf("id").setValue(id);
+    return node;
+}
+
+std::vector<int> batchItemIds(const OakModel *model)
+{
+    std::vector<int> idList;
+    Node rootNode = model->rootNode();
+    for (int i = 0; i < rootNode.childCount("item"); i++)
+    {
+        idList.push_back(rootNode.childAt("item", i).leaf("id").value<int>());
+    }
+    return idList;
+}
+
+void connectBatchReplica(OakModel *model, BatchReplica &replica)
+{
+    replica.model = model;
+    replica.idList = batchItemIds(model);
+    model->notifier_nodesInserteAfter.add(&replica, &BatchReplica::onNodesInserteAfter);
+    model->notifier_nodesRemoveAfter.add(&replica, &BatchReplica::onNodesRemoveAfter);
+    model->notifier_nodeMoveAfter.add(&replica, &BatchReplica::onNodeMoveAfter);
+    model->notifier_leafChangeAfter.add(&replica, &BatchReplica::onLeafChangeAfter);
+}
+
+void test_batchLeafChangeBeforeInserte()
+{
+    std::unique_ptr<OakModel> model(createBatchModel());
+    for (int id = 1; id <= 3; id++) { insertBatchItem(model.get(), id - 1, id); }
+
+    BatchReplica replica;
+    connectBatchReplica(model.get(), replica);
+    {
+        OakModel::Batch batch(model.get());
+        model->rootNode().childAt("item", 1).leaf("id").setValue(20);
+        insertBatchItem(model.get(), 0, 100);
+    }
+
+    // The leaf change is reported on the node that was changed
+    BOOST_CHECK(replica.changedIdList == std::vector<int>({20}));
+    BOOST_CHECK(replica.idList == batchItemIds(model.get()));
+    BOOST_CHECK(replica.idList == std::vector<int>({100, 1, 20, 3}));
+}
+
+void test_batchInserteBeforeRemove()
+{
+    std::unique_ptr<OakModel> model(createBatchModel());
+    for (int id = 1; id <= 3; id++) { insertBatchItem(model.get(), id - 1, id); }
+
+    BatchReplica replica;
+    connectBatchReplica(model.get(), replica);
+    {
+        OakModel::Batch batch(model.get());
+        insertBatchItem(model.get(), 3, 200);
+        BOOST_CHECK(model->rootNode().removeChild("item", 0));
+    }
+
+    // The inserted node is reported as the node with id 200
+    BOOST_CHECK(replica.idList == batchItemIds(model.get()));
+    BOOST_CHECK(replica.idList == std::vector<int>({2, 3, 200}));
+}
+
+void test_batchChangeSequence()
+{
+    std::unique_ptr<OakModel> model(createBatchModel());
+    for (int id = 1; id <= 10; id++) { insertBatchItem(model.get(), id - 1, id); }
+
+    BatchReplica replica;
+    connectBatchReplica(model.get(), replica);
+    {
+        OakModel::Batch batch(model.get());
+        Node rootNode = model->rootNode();
+        rootNode.childAt("item", 8).leaf("id").setValue(90);
+        for (int i = 0; i < 3; i++) { insertBatchItem(model.get(), 2 + i, 20 + i); }
+        rootNode.childAt("item", 4).leaf("id").setValue(40);
+        int index = 0;
+        rootNode.moveChild("item", index, rootNode.childAt("item", 9));
+        rootNode.childAt("item", 0).leaf("id").setValue(80);
+        BOOST_CHECK(rootNode.removeChild("item", 6));
+        BOOST_CHECK(rootNode.removeChild("item", 6));
+        insertBatchItem(model.get(), 1, 30);
+        index = 11;
+        rootNode.moveChild("item", index, rootNode.childAt("item", 1));
+        rootNode.childAt("item", 5).leaf("id").setValue(50);
+        rootNode.childAt("item", 5).leaf("id").setValue(51);
+        BOOST_CHECK(rootNode.removeChild("item", 0));
+    }
+
+    BOOST_CHECK(replica.idList == batchItemIds(model.get()));
+}
+
+test_suite* Test_Batch()
+{
+    test_suite* test = BOOST_TEST_SUITE( "Batch" );
+
+    test->add(BOOST_TEST_CASE(&test_batchLeafChangeBeforeInserte));
+    test->add(BOOST_TEST_CASE(&test_batchInserteBeforeRemove));
+    test->add(BOOST_TEST_CASE(&test_batchChangeSequence));
+
+    return test;
+}
+
+#endif // XML_BACKEND
@@ -0,0 +1,213 @@
+/*
+ * OakModelView (http://oakmodelview.com/)
+ * Author: Mikkel Nøhr Løvgreen (mikkel@oakmodelview.com)
+ * ------------------------------------------------------------------------
+ * Licensed to Vilaversoftware IVS who licenses this file to you under the
+ * Apache License, Version 2.0 (the "License"); you may not use this file
+ * except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <boost/test/included/unit_test.hpp>
+using boost::unit_test_framework::test_suite;
+
+#include <cstdlib>
+#include <ctime>
+
+#include "DateTime.h"
+
+using namespace Oak::Model;
+
+// Sets the local time zone to central European time while it is in scope
+struct DateTimeTestZone
+{
+    DateTimeTestZone()
+    {
+#ifndef _WIN32
+        const char *tz = std::getenv("TZ");
+        hasOldZone = tz != nullptr;
+        if (hasOldZone) { oldZone = tz; }
+        setenv("TZ", "CET-1CEST,M3.5.0,M10.5.0/3", 1);
+        tzset();
+#endif
+    }
+
+    ~DateTimeTestZone()
+    {
+#ifndef _WIN32
+        if (hasOldZone) {
+            setenv("TZ", oldZone.c_str(), 1);
+        } else {
+            unsetenv("TZ");
+        }
+        tzset();
+#endif
+    }
+
+    // The daylight saving time tests need the zone to be set
+    bool isSet() const
+    {
+        return DateTime("2020-07-01 12:00:00", DateTime::TimeZone::Local).toString(DateTime::TimeZone::UTC) == "2020-07-01 10:00:00" &&
+               DateTime("2020-01-01 12:00:00", DateTime::TimeZone::Local).toString(DateTime::TimeZone::UTC) == "2020-01-01 11:00:00";
+    }
+
+    bool hasOldZone = false;
+    std::string oldZone;
+};
+
+void test_dateTimeParseFormat()
+{
+    DateTime dt("2020-02-29 13:45:10", DateTime::TimeZone::UTC);
+    BOOST_REQUIRE(!dt.isNull());
+    BOOST_CHECK(dt.toString(DateTime::TimeZone::UTC) == "2020-02-29 13:45:10");
+    BOOST_CHECK(dt.year(DateTime::TimeZone::UTC) == 2020);
+    BOOST_CHECK(dt.month(DateTime::TimeZone::UTC) == 2);
+    BOOST_CHECK(dt.day(DateTime::TimeZone::UTC) == 29);
+    BOOST_CHECK(dt.hour(DateTime::TimeZone::UTC) == 13);
+    BOOST_CHECK(dt.minute() == 45);
+    BOOST_CHECK(dt.secound() == 10);
+    BOOST_CHECK(dt.mSecsSinceEpoch() == 1582983910000LL);
+
+    BOOST_CHECK(dt.toString(DateTime::TimeZone::UTC, "%d/%m/%Y %H:%M:%S") == "29/02/2020 13:45:10");
+    BOOST_CHECK(DateTime("29/02/2020 13:45:10", DateTime::TimeZone::UTC, "%d/%m/%Y %H:%M:%S") == dt);
+    BOOST_CHECK(DateTime(2020, 2, 29, 13, 45, 10, DateTime::TimeZone::UTC) == dt);
+
+    // Invalid dates and extra characters are not accepted
+    BOOST_CHECK(DateTime("2019-02-29 00:00:00", DateTime::TimeZone::UTC).isNull());
+    BOOST_CHECK(DateTime("2020-2-1 00:00:00", DateTime::TimeZone::UTC).isNull());
+    BOOST_CHECK(DateTime("2020-02-01 00:00:00x", DateTime::TimeZone::UTC).isNull());
+    BOOST_CHECK(DateTime("2020-02-01 24:00:00", DateTime::TimeZone::UTC).isNull());
+    BOOST_CHECK(DateTime(2020, 13, 1, 0, 0, 0, DateTime::TimeZone::UTC).isNull());
+}
+
+void test_dateTimeIso()
+{
+    DateTime dt(2020, 2, 29, 13, 45, 10, DateTime::TimeZone::UTC);
+
+    BOOST_CHECK(dt.toIsoString() == "2020-02-29T13:45:10Z");
+    BOOST_CHECK(DateTime::fromIsoString("2020-02-29T13:45:10Z") == dt);
+    BOOST_CHECK(DateTime::fromIsoString("2020-02-29 13:45:10Z") == dt);
+    BOOST_CHECK(DateTime::fromIsoString("2020-02-29T14:45:10+01:00") == dt);
+    BOOST_CHECK(DateTime::fromIsoString("2020-02-29T12:45:10-0100") == dt);
+    BOOST_CHECK(DateTime::fromIsoString("2020-02-29T19:15:10+05:30") == dt);
+    BOOST_CHECK(DateTime::fromIsoString("2020-02-29T13:45:10") == dt);
+    BOOST_CHECK(DateTime::fromIsoString("2020-02-29").toIsoString() == "2020-02-29T00:00:00Z");
+
+    // Milliseconds
+    DateTime msDt = DateTime::fromIsoString("2020-02-29T13:45:10.250Z");
+    BOOST_CHECK(msDt.mSecsSinceEpoch() == 1582983910250LL);
+    BOOST_CHECK(msDt.toIsoString() == "2020-02-29T13:45:10.250Z");
+    BOOST_CHECK(DateTime::fromIsoString("2020-02-29T13:45:10,5Z").mSecsSinceEpoch() == 1582983910500LL);
+    BOOST_CHECK(DateTime::fromIsoString("2020-02-29T13:45:10.0019Z").toIsoString() == "2020-02-29T13:45:10.001Z");
+
+    BOOST_CHECK(DateTime::fromIsoString("2020-02-29T").isNull());
+    BOOST_CHECK(DateTime::fromIsoString("2020-02-30").isNull());
+    BOOST_CHECK(DateTime::fromIsoString("2020-02-29T13:45:10.Z").isNull());
+    BOOST_CHECK(DateTime::fromIsoString("2020-02-29T13:45:10+24:00").isNull());
+
+    BOOST_CHECK(DateTime().toIsoString().empty());
+}
+
+void test_dateTimeBefore1970()
+{
+    DateTime dt(1900, 3, 1, 0, 0, 0, DateTime::TimeZone::UTC);
+    BOOST_REQUIRE(!dt.isNull());
+    BOOST_CHECK(dt.toString(DateTime::TimeZone::UTC) == "1900-03-01 00:00:00");
+    BOOST_CHECK(dt.toIsoString() == "1900-03-01T00:00:00Z");
+    BOOST_CHECK(dt.mSecsSinceEpoch() == -2203891200000LL);
+
+    DateTime msDt = DateTime::fromIsoString("1969-12-31T23:59:58.500Z");
+    BOOST_CHECK(msDt.mSecsSinceEpoch() == -1500);
+    BOOST_CHECK(msDt.toIsoString() == "1969-12-31T23:59:58.500Z");
+
+    std::vector<std::string> strList = { "1800-01-01 00:00:00", "1950-06-15 12:30:45" };
+    std::vector<DateTime> dateTimeList;
+    BOOST_CHECK(DateTime::fromStringList(strList, dateTimeList, DateTime::TimeZone::UTC) == 0);
+    std::vector<std::string> outList;
+    DateTime::toStringList(dateTimeList, outList, DateTime::TimeZone::UTC);
+    BOOST_CHECK(outList == strList);
+
+    // Dates the clock can not hold become null instead of wrapping around
+    BOOST_CHECK(DateTime(1600, 2, 29, 23, 59, 59, DateTime::TimeZone::UTC).isNull());
+    BOOST_CHECK(DateTime("1600-02-29 23:59:59", DateTime::TimeZone::UTC).isNull());
+    BOOST_CHECK(DateTime::fromIsoString("1600-02-29T23:59:59Z").isNull());
+    BOOST_CHECK(DateTime(9999, 12, 31, 0, 0, 0, DateTime::TimeZone::UTC).isNull());
+    strList = { "1600-02-29 23:59:59", "2000-01-01 00:00:00" };
+    BOOST_CHECK(DateTime::fromStringList(strList, dateTimeList, DateTime::TimeZone::UTC) == 1);
+    BOOST_CHECK(dateTimeList[0].isNull());
+    BOOST_CHECK(dateTimeList[1] == DateTime::defaultDateTime());
+}
+
+void test_dateTimeListDaylightSaving()
+{
+    DateTimeTestZone zone;
+    if (!zone.isSet()) {
+        BOOST_TEST_MESSAGE("The local time zone could not be set, daylight saving time is not tested");
+        return;
+    }
+
+    // 02:30 does not exist when the clocks are moved forward
+    BOOST_CHECK(DateTime("2020-03-29 02:30:00", DateTime::TimeZone::Local).isNull());
+
+    std::vector<std::string> strList = { "2020-03-29 01:59:59", "2020-03-29 02:30:00", "2020-03-29 03:00:00",
+                                         "bad", "2020-10-25 01:00:00", "2020-07-01 12:00:00" };
+    std::vector<DateTime> dateTimeList;
+    BOOST_CHECK(DateTime::fromStringList(strList, dateTimeList, DateTime::TimeZone::Local) == 2);
+    BOOST_REQUIRE(dateTimeList.size() == strList.size());
+    BOOST_CHECK(dateTimeList[1].isNull());
+    BOOST_CHECK(dateTimeList[3].isNull());
+    BOOST_CHECK(dateTimeList[0].toString(DateTime::TimeZone::UTC) == "2020-03-29 00:59:59");
+    BOOST_CHECK(dateTimeList[2].toString(DateTime::TimeZone::UTC) == "2020-03-29 01:00:00");
+    for (size_t i: { 0, 2, 4, 5 })
+    {
+        BOOST_CHECK(dateTimeList[i] == DateTime(strList[i], DateTime::TimeZone::Local));
+    }
+
+    std::vector<std::string> outList;
+    DateTime::toStringList(dateTimeList, outList, DateTime::TimeZone::Local);
+    BOOST_CHECK(outList[1].empty());
+    BOOST_CHECK(outList[3].empty());
+    for (size_t i: { 0, 2, 4, 5 })
+    {
+        BOOST_CHECK(outList[i] == strList[i]);
+    }
+
+    // Every minute around the change must be converted like single values are
+    dateTimeList.clear();
+    for (long long seconds = 1585443600 - 7200; seconds < 1585443600 + 7200; seconds += 61)
+    {
+        DateTime dt;
+        dt.setMSecsSinceEpoch(seconds * 1000);
+        dateTimeList.push_back(dt);
+    }
+    DateTime::toStringList(dateTimeList, outList, DateTime::TimeZone::Local);
+    for (size_t i = 0; i < dateTimeList.size(); i++)
+    {
+        BOOST_CHECK(outList[i] == dateTimeList[i].toString(DateTime::TimeZone::Local));
+    }
+    std::vector<DateTime> backList;
+    BOOST_CHECK(DateTime::fromStringList(outList, backList, DateTime::TimeZone::Local) == 0);
+    BOOST_CHECK(backList == dateTimeList);
+}
+
+test_suite* Test_DateTime()
+{
+    test_suite* test = BOOST_TEST_SUITE( "DateTime" );
+
+    test->add(BOOST_TEST_CASE(&test_dateTimeParseFormat));
+    test->add(BOOST_TEST_CASE(&test_dateTimeIso));
+    test->add(BOOST_TEST_CASE(&test_dateTimeBefore1970));
+    test->add(BOOST_TEST_CASE(&test_dateTimeListDaylightSaving));
+
+    return test;
+}
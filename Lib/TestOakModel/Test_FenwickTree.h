@@ -0,0 +1,140 @@
+/*
+ * OakModelView (http://oakmodelview.com/)
+ * Author: Mikkel Nøhr Løvgreen (mikkel@oakmodelview.com)
+ * ------------------------------------------------------------------------
+ * Licensed to Vilaversoftware IVS who licenses this file to you under the
+ * Apache License, Version 2.0 (the "License"); you may not use this file
+ * except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <boost/test/included/unit_test.hpp>
+using boost::unit_test_framework::test_suite;
+
+#include <vector>
+
+#include "QMLOakTreeViewPlugin/FenwickTree.h"
+
+// Compares every prefix sum and every sum lookup of the tree with the values in 'valueList'
+bool fenwickTreeEqual(const FenwickTree &tree, const std::vector<int> &valueList)
+{
+    if (tree.count() != static_cast<int>(valueList.size())) { return false; }
+
+    int sum = 0;
+    for (int i = 0; i < tree.count(); i++)
+    {
+        if (tree.value(i) != valueList[static_cast<size_t>(i)]) { return false; }
+        if (tree.prefixSum(i) != sum) { return false; }
+        sum += valueList[static_cast<size_t>(i)];
+    }
+    if (tree.prefixSum(tree.count()) != sum || tree.total() != sum) { return false; }
+
+    int index = 0;
+    int prefix = 0;
+    for (int s = 0; s < sum; s++)
+    {
+        // Values of zero are skipped
+        while (s >= prefix + valueList[static_cast<size_t>(index)]) {
+            prefix += valueList[static_cast<size_t>(index)];
+            index++;
+        }
+        int foundPrefix = -1;
+        if (tree.find(s, foundPrefix) != index || foundPrefix != prefix) { return false; }
+    }
+    return true;
+}
+
+void test_fenwickTreeEmpty()
+{
+    FenwickTree tree;
+    BOOST_CHECK(tree.count() == 0);
+    BOOST_CHECK(tree.total() == 0);
+    BOOST_CHECK(tree.prefixSum(0) == 0);
+
+    tree.reset(0, 5);
+    BOOST_CHECK(fenwickTreeEqual(tree, {}));
+
+    tree.insert(0, 2, 3);
+    BOOST_CHECK(fenwickTreeEqual(tree, {3, 3}));
+    tree.remove(0, 2);
+    BOOST_CHECK(fenwickTreeEqual(tree, {}));
+}
+
+void test_fenwickTreeSingle()
+{
+    FenwickTree tree;
+    tree.reset(1, 4);
+    BOOST_CHECK(fenwickTreeEqual(tree, {4}));
+
+    int prefix = -1;
+    BOOST_CHECK(tree.find(0, prefix) == 0 && prefix == 0);
+    BOOST_CHECK(tree.find(3, prefix) == 0 && prefix == 0);
+
+    tree.add(0, 2);
+    BOOST_CHECK(fenwickTreeEqual(tree, {6}));
+    tree.remove(0, 1);
+    BOOST_CHECK(fenwickTreeEqual(tree, {}));
+    tree.insert(0, 1, 1);
+    BOOST_CHECK(fenwickTreeEqual(tree, {1}));
+}
+
+void test_fenwickTreeChanges()
+{
+    FenwickTree tree;
+    std::vector<int> valueList(13, 2);
+    tree.reset(13, 2);
+    BOOST_CHECK(fenwickTreeEqual(tree, valueList));
+
+    // Sizes around powers of two change the highest bit used by find()
+    for (int i = 0; i < 13; i++)
+    {
+        tree.add(i, i % 4);
+        valueList[static_cast<size_t>(i)] += i % 4;
+    }
+    BOOST_CHECK(fenwickTreeEqual(tree, valueList));
+
+    tree.insert(13, 3, 5);
+    valueList.insert(valueList.end(), 3, 5);
+    BOOST_CHECK(fenwickTreeEqual(tree, valueList));
+
+    tree.insert(0, 1, 7);
+    valueList.insert(valueList.begin(), 7);
+    BOOST_CHECK(fenwickTreeEqual(tree, valueList));
+
+    tree.insert(8, 2, 0);
+    valueList.insert(valueList.begin() + 8, 2, 0);
+    BOOST_CHECK(fenwickTreeEqual(tree, valueList));
+
+    tree.remove(3, 6);
+    valueList.erase(valueList.begin() + 3, valueList.begin() + 9);
+    BOOST_CHECK(fenwickTreeEqual(tree, valueList));
+
+    tree.add(2, -valueList[2]);
+    valueList[2] = 0;
+    BOOST_CHECK(fenwickTreeEqual(tree, valueList));
+
+    tree.remove(0, tree.count() - 1);
+    valueList.erase(valueList.begin(), valueList.end() - 1);
+    BOOST_CHECK(fenwickTreeEqual(tree, valueList));
+}
+
+test_suite* Test_FenwickTree()
+{
+    test_suite* test = BOOST_TEST_SUITE( "FenwickTree" );
+
+    test->add(BOOST_TEST_CASE(&test_fenwickTreeEmpty));
+    test->add(BOOST_TEST_CASE(&test_fenwickTreeSingle));
+    test->add(BOOST_TEST_CASE(&test_fenwickTreeChanges));
+
+    return test;
+}
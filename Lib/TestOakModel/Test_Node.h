@@ -0,0 +1,117 @@
+/*
+ * OakModelView (http://oakmodelview.com/)
+ * Author: Mikkel Nøhr Løvgreen (mikkel@oakmodelview.com)
+ * ------------------------------------------------------------------------
+ * Licensed to Vilaversoftware IVS who licenses this file to you under the
+ * Apache License, Version 2.0 (the "License"); you may not use this file
+ * except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <boost/test/included/unit_test.hpp>
+using boost::unit_test_framework::test_suite;
+
+#ifdef XML_BACKEND
+
+#include "OakModel.h"
+#include "NodeDefBuilder.h"
+#include "ContainerDefBuilder.h"
+#include "LeafDefBuilder.h"
+#include "Leaf.h"
+
+using namespace Oak::Model;
+
+NodeDefSPtr createMoveNodeDef()
+{
+    auto item = NodeDefBuilder::create("item")
+        ->addLeafDef(LeafDefBuilder::create(UnionType::String, "id"));
+    return NodeDefBuilder::create("model")
+        ->addContainerDef(ContainerDefBuilder::create(item))->get();
+}
+
+void insertMoveItems(const Node &rootNode, const std::vector<std::string> &idList)
+{
+    for (const std::string &id: idList)
+    {
+        int index = rootNode.childCount("item");
+        rootNode.insertChild("item", index).leaf("id").setValue(id);
+    }
+}
+
+std::string moveItemOrder(const Node &rootNode)
+{
+    std::string order;
+    for (int i = 0; i < rootNode.childCount("item"); i++)
+    {
+        order += rootNode.childAt("item", i).leaf("id").value<std::string>();
+    }
+    return order;
+}
+
+void test_moveChild()
+{
+    OakModel model;
+    model.setRootNodeDef(createMoveNodeDef());
+    model.createNewRootDocument(NodeData::Type::XML);
+    Node rootNode = model.rootNode();
+    insertMoveItems(rootNode, {"a", "b", "c"});
+
+    Node moveNode = rootNode.childAt("item", 0);
+    int index = 2;
+    BOOST_CHECK(rootNode.canMoveChild("item", index, moveNode));
+    Node node = rootNode.moveChild("item", index, moveNode);
+    BOOST_CHECK(node == moveNode);
+    BOOST_CHECK(moveItemOrder(rootNode) == "bca");
+}
+
+void test_moveChildBetweenDocuments()
+{
+    NodeDefSPtr nodeDef = createMoveNodeDef();
+    OakModel model1;
+    model1.setRootNodeDef(nodeDef);
+    model1.createNewRootDocument(NodeData::Type::XML);
+    OakModel model2;
+    model2.setRootNodeDef(nodeDef);
+    model2.createNewRootDocument(NodeData::Type::XML);
+
+    Node rootNode1 = model1.rootNode();
+    Node rootNode2 = model2.rootNode();
+    insertMoveItems(rootNode1, {"a", "b"});
+    insertMoveItems(rootNode2, {"c"});
+
+    // Nodes can not be relinked into another document
+    Node moveNode = rootNode2.childAt("item", 0);
+    int index = 1;
+    BOOST_CHECK(!rootNode1.canMoveChild("item", index, moveNode));
+    index = 1;
+    BOOST_CHECK(!rootNode1.canMoveChild(index, moveNode));
+    index = 1;
+    BOOST_CHECK(rootNode1.moveChild("item", index, moveNode).isNull());
+    index = 1;
+    BOOST_CHECK(rootNode1.moveChild(index, moveNode).isNull());
+
+    BOOST_CHECK(moveItemOrder(rootNode1) == "ab");
+    BOOST_CHECK(moveItemOrder(rootNode2) == "c");
+}
+
+test_suite* Test_Node()
+{
+    test_suite* test = BOOST_TEST_SUITE( "Node" );
+
+    test->add(BOOST_TEST_CASE(&test_moveChild));
+    test->add(BOOST_TEST_CASE(&test_moveChildBetweenDocuments));
+
+    return test;
+}
+
+#endif // XML_BACKEND
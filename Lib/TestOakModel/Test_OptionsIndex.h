@@ -0,0 +1,216 @@
+/*
+ * OakModelView (http://oakmodelview.com/)
+ * Author: Mikkel Nøhr Løvgreen (mikkel@oakmodelview.com)
+ * ------------------------------------------------------------------------
+ * Licensed to Vilaversoftware IVS who licenses this file to you under the
+ * Apache License, Version 2.0 (the "License"); you may not use this file
+ * except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <boost/test/included/unit_test.hpp>
+using boost::unit_test_framework::test_suite;
+
+#ifdef XML_BACKEND
+
+#include <algorithm>
+
+#include "OakModel.h"
+#include "NodeDefBuilder.h"
+#include "ContainerDefBuilder.h"
+#include "LeafDefBuilder.h"
+#include "QueryBuilder.h"
+#include "LeafQuery.h"
+#include "OptionsIndex.h"
+#include "Leaf.h"
+
+using namespace Oak::Model;
+
+// Each group has options and items that can choose one of the options of the group
+OakModel *createOptionsModel()
+{
+    auto option = NodeDefBuilder::create("option")
+        ->addLeafDef(LeafDefBuilder::create(UnionType::Integer, "name"));
+    auto item = NodeDefBuilder::create("item")
+        ->addLeafDef(LeafDefBuilder::create(UnionType::Integer, "choice")
+            ->setOptionsQuery(QueryBuilder::createParent()->children("option")->leafSPtr("name")));
+    auto group = NodeDefBuilder::create("group")
+        ->addContainerDef(ContainerDefBuilder::create(option))
+        ->addContainerDef(ContainerDefBuilder::create(item));
+    auto root = NodeDefBuilder::create("model")
+        ->addContainerDef(ContainerDefBuilder::create(group));
+
+    OakModel *model = new OakModel();
+    model->setRootNodeDef(root->get());
+    model->createNewRootDocument(NodeData::Type::XML);
+    return model;
+}
+
+Node insertOptionsGroup(const OakModel *model, const std::vector<int> &nameList)
+{
+    Node rootNode = model->rootNode();
+    int index = rootNode.childCount("group");
+    Node groupNode = rootNode.insertChild("group", index);
+    index = 0;
+    groupNode.insertChild("item", index);
+    for (int name: nameList)
+    {
+        index = groupNode.childCount("option");
+        groupNode.insertChild("option", index).leaf("name").setValue(name);
+    }
+    return groupNode;
+}
+
+const LeafQuery *optionsQuery(const OakModel *model)
+{
+    return model->rootNode().firstChild("group").firstChild("item").leaf("choice").def()->options().query();
+}
+
+// The unique values found by the query in sorted order
+std::vector<UnionValue> optionsQueryValues(const LeafQuery *query, const Node &itemNode)
+{
+    std::vector<UnionValue> values = query->valueList(itemNode);
+    std::sort(values.begin(), values.end());
+    values.erase(std::unique(values.begin(), values.end()), values.end());
+    return values;
+}
+
+bool optionsIndexEqual(const OptionsIndex *index, const LeafQuery *query, const Node &itemNode)
+{
+    std::vector<UnionValue> values;
+    if (index == nullptr || !index->getValues(itemNode, values)) { return false; }
+    return values == optionsQueryValues(query, itemNode);
+}
+
+// Compares the index of the model with the query for the items of all groups
+bool optionsIndexEqual(const OakModel *model)
+{
+    const LeafQuery *query = optionsQuery(model);
+    const OptionsIndex *index = model->optionsIndex(query);
+    Node rootNode = model->rootNode();
+    for (int i = 0; i < rootNode.childCount("group"); i++)
+    {
+        Node itemNode = rootNode.childAt("group", i).firstChild("item");
+        if (!optionsIndexEqual(index, query, itemNode)) { return false; }
+    }
+    return true;
+}
+
+void test_optionsIndexNodeChanges()
+{
+    std::unique_ptr<OakModel> model(createOptionsModel());
+    Node groupNode1 = insertOptionsGroup(model.get(), {3, 1, 3});
+    Node groupNode2 = insertOptionsGroup(model.get(), {2});
+
+    BOOST_REQUIRE(model->optionsIndex(optionsQuery(model.get())) != nullptr);
+    BOOST_CHECK(optionsIndexEqual(model.get()));
+
+    // Insert
+    int index = 1;
+    groupNode1.insertChild("option", index).leaf("name").setValue(5);
+    BOOST_CHECK(optionsIndexEqual(model.get()));
+
+    // Remove one of two options with the same name and the only option with a name
+    BOOST_CHECK(groupNode1.removeChild("option", 0));
+    BOOST_CHECK(optionsIndexEqual(model.get()));
+    BOOST_CHECK(groupNode1.removeChild("option", 0));
+    BOOST_CHECK(optionsIndexEqual(model.get()));
+
+    // Move to the other group
+    index = 0;
+    groupNode2.moveChild("option", index, groupNode1.childAt("option", 0));
+    BOOST_CHECK(optionsIndexEqual(model.get()));
+
+    // Clone to the other group
+    index = 0;
+    groupNode1.cloneChild("option", index, groupNode2.childAt("option", 1));
+    BOOST_CHECK(optionsIndexEqual(model.get()));
+
+    // Remove a scope
+    BOOST_CHECK(model->rootNode().removeChild("group", 0));
+    BOOST_CHECK(optionsIndexEqual(model.get()));
+}
+
+void test_optionsIndexLeafChanges()
+{
+    std::unique_ptr<OakModel> model(createOptionsModel());
+    Node groupNode = insertOptionsGroup(model.get(), {1, 2, 2});
+    BOOST_CHECK(optionsIndexEqual(model.get()));
+
+    groupNode.childAt("option", 0).leaf("name").setValue(4);
+    BOOST_CHECK(optionsIndexEqual(model.get()));
+    groupNode.childAt("option", 1).leaf("name").setValue(4);
+    BOOST_CHECK(optionsIndexEqual(model.get()));
+    groupNode.childAt("option", 2).leaf("name").setValue(4);
+    BOOST_CHECK(optionsIndexEqual(model.get()));
+    groupNode.childAt("option", 2).leaf("name").setValue(4);
+    BOOST_CHECK(optionsIndexEqual(model.get()));
+
+    // A change to a leaf that is not found by the query
+    groupNode.firstChild("item").leaf("choice").setValue(4);
+    BOOST_CHECK(optionsIndexEqual(model.get()));
+}
+
+void test_optionsIndexUnknownLeafChange()
+{
+    std::unique_ptr<OakModel> model(createOptionsModel());
+    Node groupNode = insertOptionsGroup(model.get(), {1, 2});
+    Node itemNode = groupNode.firstChild("item");
+
+    // An index that is not connected to the model, so it only gets the changes passed to it
+    const LeafQuery *query = optionsQuery(model.get());
+    OptionsIndex index(*query);
+    BOOST_REQUIRE(index.isValid());
+    BOOST_CHECK(optionsIndexEqual(&index, query, itemNode));
+
+    // The value before the change is read from another node, so all entries are build again
+    Node changeNode = groupNode.childAt("option", 1);
+    index.onLeafChangeBefore(groupNode.childAt("option", 0));
+    changeNode.leaf("name").setValue(7);
+    index.onLeafChangeAfter(changeNode);
+    BOOST_CHECK(optionsIndexEqual(&index, query, itemNode));
+
+    // The value before the change is unknown
+    changeNode.leaf("name").setValue(8);
+    index.onLeafChangeAfter(changeNode);
+    BOOST_CHECK(optionsIndexEqual(&index, query, itemNode));
+}
+
+void test_optionsIndexRootChange()
+{
+    std::unique_ptr<OakModel> model(createOptionsModel());
+    insertOptionsGroup(model.get(), {1, 2});
+    BOOST_CHECK(optionsIndexEqual(model.get()));
+
+    model->createNewRootDocument(NodeData::Type::XML);
+    Node groupNode = insertOptionsGroup(model.get(), {});
+    BOOST_CHECK(optionsIndexEqual(model.get()));
+
+    int index = 0;
+    groupNode.insertChild("option", index).leaf("name").setValue(3);
+    BOOST_CHECK(optionsIndexEqual(model.get()));
+}
+
+test_suite* Test_OptionsIndex()
+{
+    test_suite* test = BOOST_TEST_SUITE( "OptionsIndex" );
+
+    test->add(BOOST_TEST_CASE(&test_optionsIndexNodeChanges));
+    test->add(BOOST_TEST_CASE(&test_optionsIndexLeafChanges));
+    test->add(BOOST_TEST_CASE(&test_optionsIndexUnknownLeafChange));
+    test->add(BOOST_TEST_CASE(&test_optionsIndexRootChange));
+
+    return test;
+}
+
+#endif // XML_BACKEND
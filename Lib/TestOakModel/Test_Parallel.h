@@ -0,0 +1,224 @@
+/*
+ * OakModelView (http://oakmodelview.com/)
+ * Author: Mikkel Nøhr Løvgreen (mikkel@oakmodelview.com)
+ * ------------------------------------------------------------------------
+ * Licensed to Vilaversoftware IVS who licenses this file to you under the
+ * Apache License, Version 2.0 (the "License"); you may not use this file
+ * except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <boost/test/included/unit_test.hpp>
+using boost::unit_test_framework::test_suite;
+
+#ifdef XML_BACKEND
+
+#include <atomic>
+#include <mutex>
+#include <set>
+
+#include "OakModel.h"
+#include "NodeDefBuilder.h"
+#include "ContainerDefBuilder.h"
+#include "LeafDefBuilder.h"
+#include "QueryBuilder.h"
+#include "TableQuery.h"
+#include "ThreadPool.h"
+#include "Leaf.h"
+
+using namespace Oak::Model;
+
+// Groups of different sizes, some empty, with items where some leaves are missing
+OakModel *createParallelModel()
+{
+    auto item = NodeDefBuilder::create("item")
+        ->addLeafDef(LeafDefBuilder::create(UnionType::Integer, "number"))
+        ->addLeafDef(LeafDefBuilder::create(UnionType::String, "text"));
+    auto group = NodeDefBuilder::create("group")
+        ->addLeafDef(LeafDefBuilder::create(UnionType::String, "name"))
+        ->addContainerDef(ContainerDefBuilder::create(item));
+    auto root = NodeDefBuilder::create("model")
+        ->addContainerDef(ContainerDefBuilder::create(group));
+
+    OakModel *model = new OakModel();
+    model->setRootNodeDef(root->get());
+    model->createNewRootDocument(NodeData::Type::XML);
+
+    Node rootNode = model->rootNode();
+    for (int g = 0; g < 40; g++)
+    {
+        int index = g;
+        Node groupNode = rootNode.insertChild("group", index);
+        groupNode.leaf("name").setValue("group" + std::to_string(g % 7));
+        int count = (g % 9 == 0) ? 0 : (g * 37) % 300;
+        for (int i = 0; i < count; i++)
+        {
+            index = i;
+            Node itemNode = groupNode.insertChild("item", index);
+            if (i % 5 != 0) { itemNode.leaf("number").setValue(i * g); }
+            if (i % 3 != 0) { itemNode.leaf("text").setValue("text" + std::to_string((i * g) % 50)); }
+        }
+    }
+    return model;
+}
+
+bool parallelSnapshotEqual(const TableSnapshot &snapshot1, const TableSnapshot &snapshot2)
+{
+    if (snapshot1.rowCount() != snapshot2.rowCount() ||
+        snapshot1.columnCount() != snapshot2.columnCount() ||
+        snapshot1.stringDictionary() != snapshot2.stringDictionary()) {
+        return false;
+    }
+    for (int i = 0; i < snapshot1.columnCount(); i++)
+    {
+        const TableSnapshot::Column &column1 = snapshot1.column(i);
+        const TableSnapshot::Column &column2 = snapshot2.column(i);
+        if (column1.type() != column2.type() ||
+            column1.nullCount() != column2.nullCount() ||
+            column1.validBits() != column2.validBits() ||
+            column1.boolValues() != column2.boolValues() ||
+            column1.intValues() != column2.intValues() ||
+            column1.doubleValues() != column2.doubleValues() ||
+            column1.stringIds() != column2.stringIds()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void test_parallelNodeQuery()
+{
+    std::unique_ptr<OakModel> model(createParallelModel());
+    ThreadPool pool(3);
+
+    auto query = QueryBuilder::createChildren("group")->children("item")->UPtr();
+    std::vector<void*> serialList;
+    auto it = query->iterator(model->rootNode());
+    while (it->next()) {
+        serialList.push_back(it->node().nodeData().internalPtr());
+    }
+    BOOST_REQUIRE(!serialList.empty());
+
+    // Every node is visited once but not in order
+    std::mutex mutex;
+    std::vector<void*> parallelList;
+    query->forEachParallel(model->rootNode(), [&](const Node &node) {
+        std::lock_guard<std::mutex> lock(mutex);
+        parallelList.push_back(node.nodeData().internalPtr());
+    }, pool);
+    BOOST_CHECK(std::multiset<void*>(parallelList.begin(), parallelList.end()) ==
+                std::multiset<void*>(serialList.begin(), serialList.end()));
+
+    // The ranges follow the order of the query
+    std::vector<std::vector<void*>> rangeList;
+    query->forEachRangeParallel(model->rootNode(),
+        [&](int rangeCount) { rangeList.resize(static_cast<size_t>(rangeCount)); },
+        [&](int range, const Node &node) { rangeList[static_cast<size_t>(range)].push_back(node.nodeData().internalPtr()); },
+        pool);
+    std::vector<void*> orderedList;
+    for (const std::vector<void*> &list: rangeList)
+    {
+        orderedList.insert(orderedList.end(), list.begin(), list.end());
+    }
+    BOOST_CHECK(orderedList == serialList);
+}
+
+void test_parallelLeafQuery()
+{
+    std::unique_ptr<OakModel> model(createParallelModel());
+    ThreadPool pool(3);
+
+    for (const std::string &leafName: { "number", "text" })
+    {
+        auto query = QueryBuilder::createChildren("group")->children("item")->leafSPtr(leafName);
+        std::vector<UnionValue> serialList = query->valueList(model->rootNode());
+        BOOST_CHECK(!serialList.empty());
+        BOOST_CHECK(query->valueListParallel(model->rootNode(), pool) == serialList);
+    }
+
+    // A query without child steps
+    auto query = QueryBuilder::createChildren("group")->leafSPtr("name");
+    BOOST_CHECK(query->valueListParallel(model->rootNode(), pool) == query->valueList(model->rootNode()));
+}
+
+void test_parallelTableQuery()
+{
+    std::unique_ptr<OakModel> model(createParallelModel());
+    ThreadPool pool(3);
+
+    TableQuery itemQuery(QueryBuilder::createChildren("group")->children("item")->UPtr());
+    itemQuery.addValueQuery(QueryBuilder::createLeaf("number"));
+    itemQuery.addValueQuery(QueryBuilder::createLeaf("text"));
+    itemQuery.addValueQuery(QueryBuilder::createLeaf("missing"));
+    itemQuery.addValueQuery(QueryBuilder::createParent()->leafSPtr("name"));
+    TableSnapshot snapshot = itemQuery.materialize(model->rootNode());
+    BOOST_CHECK(snapshot.rowCount() > 0);
+    BOOST_CHECK(parallelSnapshotEqual(itemQuery.materializeParallel(model->rootNode(), pool), snapshot));
+
+    TableQuery groupQuery(QueryBuilder::createChildren("group")->UPtr());
+    groupQuery.addValueQuery(QueryBuilder::createLeaf("name"));
+    BOOST_CHECK(parallelSnapshotEqual(groupQuery.materializeParallel(model->rootNode(), pool),
+                                      groupQuery.materialize(model->rootNode())));
+
+    // A pool without worker threads reads the rows on the calling thread
+    ThreadPool serialPool(0);
+    BOOST_CHECK(parallelSnapshotEqual(itemQuery.materializeParallel(model->rootNode(), serialPool), snapshot));
+}
+
+void test_threadPoolShutdown()
+{
+    // Pools are destroyed while idle, right after they are created and after nested runs
+    for (int i = 0; i < 20; i++)
+    {
+        ThreadPool pool(4);
+        BOOST_CHECK(pool.threadCount() == 4);
+        if (i % 2 == 0) { continue; }
+
+        std::atomic<int> count(0);
+        std::vector<ThreadPool::Task> taskList;
+        for (int j = 0; j < 100; j++)
+        {
+            taskList.push_back([&count, &pool, j]() {
+                count++;
+                if (j % 10 == 0) {
+                    // Runs serially on the thread of the task
+                    std::vector<ThreadPool::Task> nestedList(2, [&count]() { count++; });
+                    pool.run(nestedList);
+                }
+            });
+        }
+        pool.run(taskList);
+        BOOST_CHECK(count == 120);
+    }
+
+    ThreadPool emptyPool(0);
+    BOOST_CHECK(emptyPool.threadCount() == 0);
+    int count = 0;
+    std::vector<ThreadPool::Task> taskList(3, [&count]() { count++; });
+    emptyPool.run(taskList);
+    BOOST_CHECK(count == 3);
+}
+
+test_suite* Test_Parallel()
+{
+    test_suite* test = BOOST_TEST_SUITE( "Parallel" );
+
+    test->add(BOOST_TEST_CASE(&test_parallelNodeQuery));
+    test->add(BOOST_TEST_CASE(&test_parallelLeafQuery));
+    test->add(BOOST_TEST_CASE(&test_parallelTableQuery));
+    test->add(BOOST_TEST_CASE(&test_threadPoolShutdown));
+
+    return test;
+}
+
+#endif // XML_BACKEND
@@ -0,0 +1,224 @@
+/*
+ * OakModelView (http://oakmodelview.com/)
+ * Author: Mikkel Nøhr Løvgreen (mikkel@oakmodelview.com)
+ * ------------------------------------------------------------------------
+ * Licensed to Vilaversoftware IVS who licenses this file to you under the
+ * Apache License, Version 2.0 (the "License"); you may not use this file
+ * except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <boost/test/included/unit_test.hpp>
+using boost::unit_test_framework::test_suite;
+
+#ifdef XML_BACKEND
+
+#include <functional>
+
+#include "OakModel.h"
+#include "NodeDefBuilder.h"
+#include "ContainerDefBuilder.h"
+#include "LeafDefBuilder.h"
+#include "Leaf.h"
+#include "UndoJournal.h"
+
+using namespace Oak::Model;
+
+// Items with a name that have values as children
+OakModel *createUndoModel()
+{
+    auto value = NodeDefBuilder::create("value")
+        ->addLeafDef(LeafDefBuilder::create(UnionType::Integer, "v"));
+    auto item = NodeDefBuilder::create("item")
+        ->addLeafDef(LeafDefBuilder::create(UnionType::String, "name"))
+        ->addContainerDef(ContainerDefBuilder::create(value));
+    auto root = NodeDefBuilder::create("model")
+        ->addContainerDef(ContainerDefBuilder::create(item));
+
+    OakModel *model = new OakModel();
+    model->setRootNodeDef(root->get());
+    model->createNewRootDocument(NodeData::Type::XML);
+
+    Node rootNode = model->rootNode();
+    for (int i = 0; i < 3; i++)
+    {
+        int index = i;
+        Node itemNode = rootNode.insertChild("item", index);
+        itemNode.leaf("name").setValue("item" + std::to_string(i));
+        for (int j = 0; j < 2; j++)
+        {
+            index = j;
+            itemNode.insertChild("value", index).leaf("v").setValue(i * 10 + j);
+        }
+    }
+    return model;
+}
+
+std::string undoModelText(const OakModel *model)
+{
+    std::string text;
+    model->rootNode().nodeData().xmlNode().save(text, -1);
+    return text;
+}
+
+// Makes the change and checks that it is undone and redone as one entry
+void checkUndoRoundTrip(const std::function<void(OakModel *model)> &change)
+{
+    std::unique_ptr<OakModel> model(createUndoModel());
+    UndoJournal journal(model.get());
+    journal.connect();
+
+    std::string textBefore = undoModelText(model.get());
+    change(model.get());
+    std::string textAfter = undoModelText(model.get());
+    BOOST_CHECK(textBefore != textAfter);
+    BOOST_CHECK(journal.undoCount() == 1);
+
+    BOOST_CHECK(journal.undo());
+    BOOST_CHECK(undoModelText(model.get()) == textBefore);
+    BOOST_CHECK(!journal.canUndo());
+    BOOST_CHECK(journal.redoCount() == 1);
+
+    BOOST_CHECK(journal.redo());
+    BOOST_CHECK(undoModelText(model.get()) == textAfter);
+    BOOST_CHECK(!journal.canRedo());
+
+    // The entry can be replayed again
+    BOOST_CHECK(journal.undo());
+    BOOST_CHECK(undoModelText(model.get()) == textBefore);
+    BOOST_CHECK(journal.redo());
+    BOOST_CHECK(undoModelText(model.get()) == textAfter);
+}
+
+void test_undoInserte()
+{
+    checkUndoRoundTrip([](OakModel *model) {
+        int index = 1;
+        model->rootNode().insertChild("item", index);
+    });
+}
+
+void test_undoRemove()
+{
+    // The removed node has leaves and children that must be restored
+    checkUndoRoundTrip([](OakModel *model) {
+        BOOST_CHECK(model->rootNode().removeChild("item", 1));
+    });
+}
+
+void test_undoMove()
+{
+    checkUndoRoundTrip([](OakModel *model) {
+        Node rootNode = model->rootNode();
+        int index = 2;
+        rootNode.moveChild("item", index, rootNode.childAt("item", 0));
+    });
+    checkUndoRoundTrip([](OakModel *model) {
+        Node rootNode = model->rootNode();
+        int index = 0;
+        rootNode.childAt("item", 2).moveChild("value", index, rootNode.childAt("item", 0).childAt("value", 1));
+    });
+}
+
+void test_undoClone()
+{
+    checkUndoRoundTrip([](OakModel *model) {
+        Node rootNode = model->rootNode();
+        int index = 1;
+        rootNode.cloneChild("item", index, rootNode.childAt("item", 2));
+    });
+}
+
+void test_undoLeafChange()
+{
+    checkUndoRoundTrip([](OakModel *model) {
+        model->rootNode().childAt("item", 1).leaf("name").setValue(std::string("changed"));
+    });
+    checkUndoRoundTrip([](OakModel *model) {
+        model->rootNode().childAt("item", 2).childAt("value", 0).leaf("v").setValue(100);
+    });
+}
+
+void test_undoBatch()
+{
+    checkUndoRoundTrip([](OakModel *model) {
+        OakModel::Batch batch(model);
+        Node rootNode = model->rootNode();
+        int index = 0;
+        Node itemNode = rootNode.insertChild("item", index);
+        itemNode.leaf("name").setValue(std::string("new"));
+        rootNode.childAt("item", 2).leaf("name").setValue(std::string("changed"));
+        index = 0;
+        rootNode.moveChild("item", index, rootNode.childAt("item", 3));
+        BOOST_CHECK(rootNode.removeChild("item", 2));
+        index = 0;
+        itemNode.cloneChild("value", index, rootNode.childAt("item", 0).childAt("value", 1));
+    });
+}
+
+void test_undoSequence()
+{
+    std::unique_ptr<OakModel> model(createUndoModel());
+    UndoJournal journal(model.get());
+    journal.connect();
+    Node rootNode = model->rootNode();
+
+    // Each change is one entry, so the states are visited in reverse by undo
+    std::vector<std::string> textList = { undoModelText(model.get()) };
+    int index = 0;
+    rootNode.insertChild("item", index);
+    textList.push_back(undoModelText(model.get()));
+    rootNode.childAt("item", 0).leaf("name").setValue(std::string("first"));
+    textList.push_back(undoModelText(model.get()));
+    index = 3;
+    rootNode.moveChild("item", index, rootNode.childAt("item", 0));
+    textList.push_back(undoModelText(model.get()));
+    BOOST_CHECK(rootNode.removeChild("item", 1));
+    textList.push_back(undoModelText(model.get()));
+    BOOST_REQUIRE(journal.undoCount() == 4);
+
+    for (size_t i = textList.size() - 1; i > 0; i--)
+    {
+        BOOST_CHECK(journal.undo());
+        BOOST_CHECK(undoModelText(model.get()) == textList[i - 1]);
+    }
+    BOOST_CHECK(!journal.undo());
+    for (size_t i = 1; i < textList.size(); i++)
+    {
+        BOOST_CHECK(journal.redo());
+        BOOST_CHECK(undoModelText(model.get()) == textList[i]);
+    }
+    BOOST_CHECK(!journal.redo());
+
+    // A new change clears the redo list
+    BOOST_CHECK(journal.undo());
+    rootNode.childAt("item", 0).leaf("name").setValue(std::string("other"));
+    BOOST_CHECK(!journal.canRedo());
+}
+
+test_suite* Test_UndoJournal()
+{
+    test_suite* test = BOOST_TEST_SUITE( "UndoJournal" );
+
+    test->add(BOOST_TEST_CASE(&test_undoInserte));
+    test->add(BOOST_TEST_CASE(&test_undoRemove));
+    test->add(BOOST_TEST_CASE(&test_undoMove));
+    test->add(BOOST_TEST_CASE(&test_undoClone));
+    test->add(BOOST_TEST_CASE(&test_undoLeafChange));
+    test->add(BOOST_TEST_CASE(&test_undoBatch));
+    test->add(BOOST_TEST_CASE(&test_undoSequence));
+
+    return test;
+}
+
+#endif // XML_BACKEND
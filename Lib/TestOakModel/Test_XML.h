@@ -29,6 +29,11 @@ using boost::unit_test_framework::test_suite;
 #include "Test_NodeDefinition.h"
 #include "Test_Item.h"
 #include "Test_ItemQuery.h"
+#include "Test_Node.h"
+#include "Test_Batch.h"
+#include "Test_OptionsIndex.h"
+#include "Test_UndoJournal.h"
+#include "Test_Parallel.h"
 
 test_suite* Test_XML()
 {
@@ -40,6 +45,11 @@ test_suite* Test_XML()
     test->add(Test_NodeDefinition());
     test->add(Test_Item());
     test->add(Test_ItemQuery());
+    test->add(Test_Node());
+    test->add(Test_Batch());
+    test->add(Test_OptionsIndex());
+    test->add(Test_UndoJournal());
+    test->add(Test_Parallel());
 
     return test;
 }
@@ -23,7 +23,11 @@ using boost::unit_test_framework::test_suite;
 
 #ifdef XML_BACKEND
 
+#include <cstdio>
+
 #include "XMLDocument.h"
+#include "XMLListRef.h"
+#include "XMLWriter.h"
 using namespace Oak;
 
 void test_OpenXMLDoc()
@@ -46,12 +50,214 @@ void test_OpenXMLDoc()
     BOOST_CHECK(document1 != document2);
 }
 
+// Returns the ids of the 'item' elements of the document element in list order
+std::string xmlItemOrder(XML::Element parent)
+{
+    std::string order;
+    XML::Element element = parent.firstChild("item");
+    while (!element.isNull()) {
+        order += element.attribute("id");
+        element = element.nextSibling("item");
+    }
+    return order;
+}
+
+// Returns the ids of the 'item' elements in the order XPath finds them
+std::string xmlItemXPathOrder(XML::Element parent)
+{
+    std::string order;
+    pugi::xpath_node_set nodeSet = parent.internalObject().select_nodes("//item");
+    nodeSet.sort();
+    for (const pugi::xpath_node &node: nodeSet) {
+        order += node.node().attribute("id").value();
+    }
+    return order;
+}
+
+void test_moveXMLElement()
+{
+    XML::Document document1;
+    BOOST_REQUIRE(document1.parse("<model><item id='a'/><item id='b'/><item id='c'/><item id='d'/></model>"));
+    XML::Element docElement = document1.documentElement();
+    pugi::xml_node docNode = docElement.internalObject();
+
+    // The document order of XPath is taken from the node order once nodes have been moved
+    BOOST_CHECK(xmlItemXPathOrder(docElement) == "abcd");
+
+    pugi::xml_node moved = docNode.append_move(docNode.first_child());
+    BOOST_CHECK(moved == docNode.last_child());
+    BOOST_CHECK(xmlItemOrder(docElement) == "bcda");
+    BOOST_CHECK(xmlItemXPathOrder(docElement) == "bcda");
+
+    moved = docNode.prepend_move(docNode.last_child());
+    BOOST_CHECK(moved == docNode.first_child());
+    BOOST_CHECK(xmlItemOrder(docElement) == "abcd");
+    BOOST_CHECK(xmlItemXPathOrder(docElement) == "abcd");
+
+    BOOST_CHECK(!docNode.insert_move_before(docNode.last_child(), docNode.first_child()).empty());
+    BOOST_CHECK(xmlItemOrder(docElement) == "dabc");
+    BOOST_CHECK(xmlItemXPathOrder(docElement) == "dabc");
+
+    BOOST_CHECK(!docNode.insert_move_after(docNode.first_child(), docNode.last_child()).empty());
+    BOOST_CHECK(xmlItemOrder(docElement) == "abcd");
+    BOOST_CHECK(xmlItemXPathOrder(docElement) == "abcd");
+
+    // A node can not be moved into itself
+    pugi::xml_node first = docNode.first_child();
+    BOOST_CHECK(first.append_move(docNode).empty());
+    BOOST_CHECK(first.append_move(first).empty());
+
+    // The moved element keeps its identity and the sibling index follows it
+    XML::ListRef listRef("item");
+    listRef.setIndexEnabled(true);
+    XML::Element elementB = listRef.at(docElement, 1);
+    BOOST_CHECK(listRef.indexOf(docElement, elementB) == 1);
+
+    XML::Element element = docElement.moveAfter(elementB, listRef.last(docElement));
+    BOOST_CHECK(element == elementB);
+    BOOST_CHECK(xmlItemOrder(docElement) == "acdb");
+    BOOST_CHECK(listRef.indexOf(docElement, elementB) == 3);
+    BOOST_CHECK(listRef.at(docElement, 1).attribute("id") == "c");
+
+    element = docElement.moveBefore(elementB, XML::Element());
+    BOOST_CHECK(element == elementB);
+    BOOST_CHECK(xmlItemOrder(docElement) == "bacd");
+    BOOST_CHECK(listRef.indexOf(docElement, elementB) == 0);
+    BOOST_CHECK(listRef.at(docElement, 3).attribute("id") == "d");
+    BOOST_CHECK(xmlItemXPathOrder(docElement) == "bacd");
+
+    // Moving a nested element also moves it in the document order
+    XML::Element child = listRef.at(docElement, 3).appendChild("item");
+    child.setAttribute("id", "e");
+    BOOST_CHECK(xmlItemXPathOrder(docElement) == "bacde");
+    BOOST_CHECK(!listRef.at(docElement, 0).moveBefore(child, XML::Element()).isNull());
+    BOOST_CHECK(xmlItemXPathOrder(docElement) == "beacd");
+}
+
+void test_moveXMLElementBetweenDocuments()
+{
+    XML::Document document1;
+    XML::Document document2;
+    BOOST_REQUIRE(document1.parse("<model><item id='a'/><item id='b'/></model>"));
+    BOOST_REQUIRE(document2.parse("<model><item id='c'/></model>"));
+    XML::Element docElement1 = document1.documentElement();
+    XML::Element docElement2 = document2.documentElement();
+
+    BOOST_CHECK(docElement1.isSameDocument(docElement1.firstChild()));
+    BOOST_CHECK(!docElement1.isSameDocument(docElement2));
+    BOOST_CHECK(!docElement1.isSameDocument(XML::Element()));
+
+    // Elements are relinked so they can not be moved to another document
+    BOOST_CHECK(docElement1.moveBefore(docElement2.firstChild(), XML::Element()).isNull());
+    BOOST_CHECK(xmlItemOrder(docElement1) == "ab");
+    BOOST_CHECK(xmlItemOrder(docElement2) == "c");
+}
+
+// Returns the document saved in the compact format
+std::string xmlDocText(const XML::Document &document)
+{
+    std::string text;
+    document.save(text, -1);
+    return text;
+}
+
+// Returns true if the file at 'filePath' exists
+bool xmlFileExists(const std::string &filePath)
+{
+    FILE *file = fopen(filePath.c_str(), "rb");
+    if (!file) { return false; }
+    fclose(file);
+    return true;
+}
+
+void test_saveXMLFileWriter()
+{
+    std::string filePath = std::string(RESOURCE_PATH) + "test_doc_writer.xml";
+
+    XML::Document document1;
+    BOOST_REQUIRE(document1.load(std::string(RESOURCE_PATH)+"test_doc.xml"));
+
+    for (XML::SaveFormat format: { XML::SaveFormat::Indented, XML::SaveFormat::Compact }) {
+        XML::FileWriter writer(filePath);
+        BOOST_REQUIRE(writer.isOpen());
+        BOOST_CHECK(document1.save(writer, format));
+        BOOST_CHECK(writer.finish());
+        BOOST_CHECK(!xmlFileExists(filePath + ".tmp"));
+
+        XML::Document document2;
+        BOOST_REQUIRE(document2.load(filePath));
+        BOOST_CHECK(xmlDocText(document1) == xmlDocText(document2));
+    }
+
+    // The file is only replaced when the writer is finished
+    {
+        XML::FileWriter writer(filePath);
+        BOOST_CHECK(document1.save(writer, XML::SaveFormat::Compact));
+    }
+    BOOST_CHECK(!xmlFileExists(filePath + ".tmp"));
+
+    // Saving a mapped document to its own file must not truncate the pages it reads from
+    XML::Document mappedDocument;
+    BOOST_REQUIRE(mappedDocument.load(filePath, XML::Document::LoadMode::Mapped));
+    BOOST_REQUIRE(mappedDocument.isMapped());
+    {
+        XML::FileWriter writer(filePath);
+        BOOST_CHECK(mappedDocument.save(writer));
+        BOOST_CHECK(writer.finish());
+    }
+    BOOST_CHECK(xmlDocText(mappedDocument) == xmlDocText(document1));
+    XML::Document document3;
+    BOOST_REQUIRE(document3.load(filePath));
+    BOOST_CHECK(xmlDocText(document3) == xmlDocText(document1));
+
+    mappedDocument.clear();
+    std::remove(filePath.c_str());
+}
+
+#ifdef OAK_ZLIB
+void test_saveXMLGZipWriter()
+{
+    std::string filePath = std::string(RESOURCE_PATH) + "test_doc_writer.xml.gz";
+
+    XML::Document document1;
+    BOOST_REQUIRE(document1.load(std::string(RESOURCE_PATH)+"test_doc.xml"));
+    {
+        XML::FileWriter fileWriter(filePath);
+        XML::GZipWriter writer(fileWriter);
+        BOOST_CHECK(document1.save(writer));
+        BOOST_CHECK(writer.finish());
+    }
+
+    std::string text;
+    gzFile file = gzopen(filePath.c_str(), "rb");
+    BOOST_REQUIRE(file != nullptr);
+    char buffer[4096];
+    int count;
+    while ((count = gzread(file, buffer, sizeof(buffer))) > 0) {
+        text.append(buffer, static_cast<size_t>(count));
+    }
+    BOOST_CHECK(count == 0);
+    BOOST_CHECK(gzclose(file) == Z_OK);
+
+    XML::Document document2;
+    BOOST_REQUIRE(document2.parse(text));
+    BOOST_CHECK(xmlDocText(document1) == xmlDocText(document2));
+
+    std::remove(filePath.c_str());
+}
+#endif // OAK_ZLIB
 
 test_suite* Test_XMLDoc()
 {
     test_suite* test = BOOST_TEST_SUITE( "XMLDoc" );
 
     test->add(BOOST_TEST_CASE(&test_OpenXMLDoc));
+    test->add(BOOST_TEST_CASE(&test_moveXMLElement));
+    test->add(BOOST_TEST_CASE(&test_moveXMLElementBetweenDocuments));
+    test->add(BOOST_TEST_CASE(&test_saveXMLFileWriter));
+#ifdef OAK_ZLIB
+    test->add(BOOST_TEST_CASE(&test_saveXMLGZipWriter));
+#endif // OAK_ZLIB
 
     return test;
 }
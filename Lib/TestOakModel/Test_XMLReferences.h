@@ -150,6 +150,58 @@ void test_elementListRef()
     BOOST_CHECK(element == eListRef.last(docElement));
 }
 
+void test_elementListRefIndex()
+{
+    XML::Document document1;
+
+    BOOST_REQUIRE(document1.load(std::string(RESOURCE_PATH)+"test_doc.xml"));
+
+    XML::Element docElement = document1.documentElement();
+
+    XML::ListRef eListRef(XML::ChildRef::MakeUPtr("model"), "nodeDefinition");
+    XML::ListRef eIndexRef(eListRef);
+    eIndexRef.setIndexEnabled(true);
+
+    auto isEqual = [&]() {
+        if (eListRef.count(docElement) != eIndexRef.count(docElement)) { return false; }
+        std::vector<XML::Element> eList = eListRef.list(docElement);
+        for (int i = 0; i < static_cast<int>(eList.size()); i++) {
+            if (eIndexRef.at(docElement, i) != eList.at(static_cast<XML::vSize>(i))) { return false; }
+            if (eIndexRef.indexOf(docElement, eList.at(static_cast<XML::vSize>(i))) != i) { return false; }
+        }
+        return true;
+    };
+
+    BOOST_CHECK(eIndexRef.count(docElement) == 5);
+    BOOST_CHECK(isEqual());
+
+    XML::Element element = eIndexRef.insert(docElement, 2);
+    BOOST_CHECK(eIndexRef.indexOf(docElement, element) == 2);
+    BOOST_CHECK(isEqual());
+
+    element = eIndexRef.clone(docElement, 0, eIndexRef.at(docElement, 4));
+    BOOST_CHECK(eIndexRef.indexOf(docElement, element) == 0);
+    BOOST_CHECK(isEqual());
+
+    element = eIndexRef.move(docElement, 5, eIndexRef.at(docElement, 1));
+    BOOST_CHECK(eIndexRef.indexOf(docElement, element) == 5);
+    BOOST_CHECK(isEqual());
+
+    element = eIndexRef.moveBefore(docElement, eIndexRef.at(docElement, 1), eIndexRef.at(docElement, 6));
+    BOOST_CHECK(eIndexRef.indexOf(docElement, element) == 1);
+    BOOST_CHECK(isEqual());
+
+    BOOST_CHECK(eIndexRef.remove(docElement, 3));
+    BOOST_CHECK(eIndexRef.remove(docElement, eIndexRef.last(docElement)));
+    BOOST_CHECK(eIndexRef.count(docElement) == 5);
+    BOOST_CHECK(isEqual());
+
+    // Changes made without the list reference discards the index
+    eListRef.listBaseRef().getTarget(docElement).appendChild("nodeDefinition");
+    BOOST_CHECK(eIndexRef.count(docElement) == 6);
+    BOOST_CHECK(isEqual());
+}
+
 test_suite* Test_XMLReferences()
 {
     test_suite* test = BOOST_TEST_SUITE( "XMLReferences" );
@@ -158,6 +210,7 @@ test_suite* Test_XMLReferences()
     test->add(BOOST_TEST_CASE(&test_elementRef));
     test->add(BOOST_TEST_CASE(&test_valueRef));
     test->add(BOOST_TEST_CASE(&test_elementListRef));
+    test->add(BOOST_TEST_CASE(&test_elementListRefIndex));
 
     return test;
 }
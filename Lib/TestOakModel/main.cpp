@@ -24,6 +24,8 @@
 #include "Test_XML.h"
 //#include "Test_Variant.h"
 #include "Test_Union.h"
+#include "Test_DateTime.h"
+#include "Test_FenwickTree.h"
 
 test_suite* init_unit_test_suite( int argc, char* argv[] )
 {
@@ -32,6 +34,8 @@ test_suite* init_unit_test_suite( int argc, char* argv[] )
     test_suite* test = BOOST_TEST_SUITE( "Master test suite" );
 
     test->add(Test_Union());
+    test->add(Test_DateTime());
+    test->add(Test_FenwickTree());
 #ifdef XML_BACKEND
     test->add(Test_XML());
 #endif